@@ -37,6 +37,14 @@ MeshLoader::Cancel() {
     }
 }
 
+//------------------------------------------------------------------------------
+bool
+MeshLoader::SetCompletionList(const Ptr<CompletionList>& list, uint64 tag) {
+    this->completionList = list;
+    this->completionTag = tag;
+    return true;
+}
+
 //------------------------------------------------------------------------------
 Id
 MeshLoader::Start() {
@@ -48,6 +56,9 @@ MeshLoader::Start() {
     this->ioRequest = IOProtocol::Request::Create();
     this->ioRequest->SetURL(setup.Locator.Location());
     this->ioRequest->SetLane(this->ioLane);
+    if (this->completionList) {
+        this->ioRequest->SetCompletionList(this->completionList, this->completionTag);
+    }
     IO::Put(this->ioRequest);
     
     return this->resId;
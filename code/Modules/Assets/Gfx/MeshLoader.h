@@ -28,6 +28,8 @@ public:
     virtual ResourceState::Code Continue() override;
     /// cancel the load process
     virtual void Cancel() override;
+    /// set completion list, the tag is pushed when the IO request has been handled
+    virtual bool SetCompletionList(const Ptr<CompletionList>& list, uint64 tag) override;
 private:
     Id resId;
     Ptr<IOProtocol::Request> ioRequest;
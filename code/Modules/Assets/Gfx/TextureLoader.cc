@@ -32,6 +32,14 @@ TextureLoader::Cancel() {
     }
 }
 
+//------------------------------------------------------------------------------
+bool
+TextureLoader::SetCompletionList(const Ptr<CompletionList>& list, uint64 tag) {
+    this->completionList = list;
+    this->completionTag = tag;
+    return true;
+}
+
 //------------------------------------------------------------------------------
 Id
 TextureLoader::Start() {
@@ -43,6 +51,9 @@ TextureLoader::Start() {
     this->ioRequest = IOProtocol::Request::Create();
     this->ioRequest->SetURL(setup.Locator.Location());
     this->ioRequest->SetLane(this->ioLane);
+    if (this->completionList) {
+        this->ioRequest->SetCompletionList(this->completionList, this->completionTag);
+    }
     IO::Put(this->ioRequest);
     
     return this->resId;
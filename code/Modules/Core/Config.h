@@ -46,6 +46,15 @@
 /// memory debug fill pattern (int)
 #define ORYOL_MEMORY_DEBUG_INT (0xBBBBBBBB)
 
+/// track per-tag memory statistics (adds a 16-byte header to each allocation)
+#ifndef ORYOL_MEMORY_STATS
+#if ORYOL_DEBUG || ORYOL_ALLOCATOR_DEBUG || ORYOL_UNITTESTS
+#define ORYOL_MEMORY_STATS (1)
+#else
+#define ORYOL_MEMORY_STATS (0)
+#endif
+#endif
+
 /// minimum grow size for dynamic container classes (num elements)
 #define ORYOL_CONTAINER_DEFAULT_MIN_GROW (16)
 /// maximum grow size for dynamic container classes (num elements)
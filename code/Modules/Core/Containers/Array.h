@@ -96,6 +96,8 @@ public:
     void Add(TYPE&& elm);
     /// construct-add new element at back of array
     template<class... ARGS> void Add(ARGS&&... args);
+    /// copy-add a range of elements to back of array (bulk copy for trivially copyable types)
+    void AddRange(const TYPE* elms, int32 num);
     /// copy-insert element at index, keep array order
     void Insert(int32 index, const TYPE& elm);
     /// move-insert element at index, keep array order
@@ -316,6 +318,18 @@ Array<TYPE>::Add(TYPE&& elm) {
     }
     this->buffer.pushBack(std::move(elm));
 }
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Array<TYPE>::AddRange(const TYPE* elms, int32 num) {
+    o_assert_dbg(num >= 0);
+    if (num > 0) {
+        if (this->buffer.backSpare() < num) {
+            this->adjustCapacity(this->buffer.size() + num);
+        }
+        this->buffer.pushBackRange(elms, num);
+    }
+}
     
 //------------------------------------------------------------------------------
 template<class TYPE> void
@@ -0,0 +1,593 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::HashMap
+    @ingroup Core
+    @brief open-addressing hash map with SIMD group probing
+
+    A key-value map with O(1) lookup, insertion and erase, using the
+    SwissTable design: next to the element slots, the map keeps one
+    control byte per slot which is either Empty, Deleted, or the lower
+    7 bits (H2) of the key's hash. Slots are organized in groups of 16,
+    a lookup probes whole groups by comparing all 16 control bytes
+    against H2 at once (SSE2/NEON), and only compares keys of slots
+    with a matching control byte. The remaining hash bits (H1) select
+    the first group to probe, further groups are probed quadratically.
+
+    Differences to Map:
+
+    - keys are unique, Add() asserts that the key doesn't exist yet
+    - elements are not sorted, and iteration order is undefined
+    - pointers to elements are invalidated when the map grows
+
+    The HASHER template argument must be a functor which returns an
+    integer hash for a key (std::hash is used by default), the result
+    is mixed before use, so simple identity hashes are ok.
+
+    Elements are stored in raw memory and move-constructed when the
+    map grows, like in elementBuffer.
+
+    @see Map, HashSet, KeyValuePair
+*/
+#include <functional>
+#include <new>
+#include <utility>
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Containers/KeyValuePair.h"
+#include "Core/Containers/hashMapGroup.h"
+
+namespace Oryol {
+
+template<class KEY, class VALUE, class HASHER=std::hash<KEY>> class HashMap {
+public:
+    /// default constructor
+    HashMap();
+    /// copy constructor
+    HashMap(const HashMap& rhs);
+    /// move constructor
+    HashMap(HashMap&& rhs);
+    /// destructor
+    ~HashMap();
+
+    /// copy-assignment operator
+    void operator=(const HashMap& rhs);
+    /// move-assignment operator
+    void operator=(HashMap&& rhs);
+
+    /// get number of elements in map
+    int32 Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get number of slots
+    int32 Capacity() const;
+
+    /// read/write access single element (must exist)
+    VALUE& operator[](const KEY& key);
+    /// read-only access single element (must exist)
+    const VALUE& operator[](const KEY& key) const;
+
+    /// make room for at least numElements more elements without rehashing
+    void Reserve(int32 numElements);
+    /// clear the map (deletes elements, keeps capacity)
+    void Clear();
+
+    /// test if an element exists
+    bool Contains(const KEY& key) const;
+    /// find element, return nullptr if not exists
+    VALUE* Find(const KEY& key);
+    /// find element, return nullptr if not exists
+    const VALUE* Find(const KEY& key) const;
+    /// add new element (key must not exist)
+    void Add(const KeyValuePair<KEY, VALUE>& kvp);
+    /// add new element with move-semantics (key must not exist)
+    void Add(KeyValuePair<KEY, VALUE>&& kvp);
+    /// add new element (key must not exist)
+    void Add(const KEY& key, const VALUE& value);
+    /// add new element, return false if element with key already existed
+    bool AddUnique(const KeyValuePair<KEY, VALUE>& kvp);
+    /// add new element with move-semantics, return false if element with key already existed
+    bool AddUnique(KeyValuePair<KEY, VALUE>&& kvp);
+    /// add new element, return false if element with key already existed
+    bool AddUnique(const KEY& key, const VALUE& value);
+    /// erase element, does nothing if key not contained
+    void Erase(const KEY& key);
+
+    /// forward iterator over all elements
+    template<class MAP, class KVP> class iteratorBase {
+    public:
+        /// constructor
+        iteratorBase(MAP* map_, int32 index_) : map(map_), index(index_) {
+            this->skip();
+        };
+        /// access element
+        KVP& operator*() const {
+            return this->map->slots[this->index];
+        };
+        /// access element
+        KVP* operator->() const {
+            return &this->map->slots[this->index];
+        };
+        /// go to next element
+        iteratorBase& operator++() {
+            this->index++;
+            this->skip();
+            return *this;
+        };
+        /// test equality
+        bool operator==(const iteratorBase& rhs) const {
+            return this->index == rhs.index;
+        };
+        /// test inequality
+        bool operator!=(const iteratorBase& rhs) const {
+            return this->index != rhs.index;
+        };
+    private:
+        /// skip empty and deleted slots
+        void skip() {
+            while ((this->index < this->map->capacity) && (this->map->ctrl[this->index] < 0)) {
+                this->index++;
+            }
+        };
+        MAP* map;
+        int32 index;
+    };
+    typedef iteratorBase<HashMap, KeyValuePair<KEY, VALUE>> iterator;
+    typedef iteratorBase<const HashMap, const KeyValuePair<KEY, VALUE>> const_iterator;
+
+    /// C++ conform begin
+    iterator begin();
+    /// C++ conform begin
+    const_iterator begin() const;
+    /// C++ conform end
+    iterator end();
+    /// C++ conform end
+    const_iterator end() const;
+
+private:
+    typedef _priv::hashMapGroup group;
+
+    /// hash a key
+    static uint64 hash(const KEY& key);
+    /// get H1 part of hash (selects first group)
+    static uint64 h1(uint64 hash);
+    /// get H2 part of hash (stored in control byte)
+    static int8 h2(uint64 hash);
+    /// max number of used (full or deleted) slots before rehash
+    static int32 maxLoad(int32 capacity);
+    /// find slot index of key, or InvalidIndex
+    int32 findIndex(const KEY& key) const;
+    /// find first empty or deleted slot for hash (no key compare)
+    int32 findFreeIndex(uint64 hash) const;
+    /// insert element, return false if key already existed
+    template<class KVP> bool insert(KVP&& kvp);
+    /// rehash into new capacity
+    void rehash(int32 newCapacity);
+    /// allocate memory for capacity, all slots are empty
+    void alloc(int32 newCapacity);
+    /// destroy content and free memory
+    void destroy();
+    /// copy content
+    void copy(const HashMap& rhs);
+    /// move content
+    void move(HashMap&& rhs);
+
+    int8* ctrl;
+    KeyValuePair<KEY, VALUE>* slots;
+    int32 capacity;
+    int32 size;
+    int32 numDeleted;
+};
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::HashMap() :
+ctrl(nullptr),
+slots(nullptr),
+capacity(0),
+size(0),
+numDeleted(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::HashMap(const HashMap& rhs) :
+ctrl(nullptr),
+slots(nullptr),
+capacity(0),
+size(0),
+numDeleted(0) {
+    this->copy(rhs);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::HashMap(HashMap&& rhs) {
+    this->move(std::move(rhs));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::~HashMap() {
+    this->destroy();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::operator=(const HashMap& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->copy(rhs);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::operator=(HashMap&& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->move(std::move(rhs));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int32
+HashMap<KEY, VALUE, HASHER>::Size() const {
+    return this->size;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::Empty() const {
+    return 0 == this->size;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int32
+HashMap<KEY, VALUE, HASHER>::Capacity() const {
+    return this->capacity;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> VALUE&
+HashMap<KEY, VALUE, HASHER>::operator[](const KEY& key) {
+    const int32 index = this->findIndex(key);
+    o_assert(InvalidIndex != index);    // not found if this triggers
+    return this->slots[index].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const VALUE&
+HashMap<KEY, VALUE, HASHER>::operator[](const KEY& key) const {
+    const int32 index = this->findIndex(key);
+    o_assert_dbg(InvalidIndex != index);    // not found if this triggers
+    return this->slots[index].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Reserve(int32 numElements) {
+    const int32 required = this->size + numElements;
+    int32 newCapacity = this->capacity > 0 ? this->capacity : group::Width;
+    while (maxLoad(newCapacity) < required) {
+        newCapacity <<= 1;
+    }
+    if (newCapacity > this->capacity) {
+        this->rehash(newCapacity);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Clear() {
+    for (int32 i = 0; i < this->capacity; i++) {
+        if (this->ctrl[i] >= 0) {
+            this->slots[i].~KeyValuePair<KEY, VALUE>();
+        }
+        this->ctrl[i] = _priv::hashMapCtrl::Empty;
+    }
+    this->size = 0;
+    this->numDeleted = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::Contains(const KEY& key) const {
+    return InvalidIndex != this->findIndex(key);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> VALUE*
+HashMap<KEY, VALUE, HASHER>::Find(const KEY& key) {
+    const int32 index = this->findIndex(key);
+    return (InvalidIndex != index) ? &this->slots[index].value : nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const VALUE*
+HashMap<KEY, VALUE, HASHER>::Find(const KEY& key) const {
+    const int32 index = this->findIndex(key);
+    return (InvalidIndex != index) ? &this->slots[index].value : nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Add(const KeyValuePair<KEY, VALUE>& kvp) {
+    bool added = this->insert(kvp);
+    o_assert(added);    // key already exists if this triggers
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Add(KeyValuePair<KEY, VALUE>&& kvp) {
+    bool added = this->insert(std::move(kvp));
+    o_assert(added);    // key already exists if this triggers
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Add(const KEY& key, const VALUE& value) {
+    this->Add(KeyValuePair<KEY, VALUE>(key, value));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::AddUnique(const KeyValuePair<KEY, VALUE>& kvp) {
+    return this->insert(kvp);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::AddUnique(KeyValuePair<KEY, VALUE>&& kvp) {
+    return this->insert(std::move(kvp));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::AddUnique(const KEY& key, const VALUE& value) {
+    return this->insert(KeyValuePair<KEY, VALUE>(key, value));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Erase(const KEY& key) {
+    const int32 index = this->findIndex(key);
+    if (InvalidIndex != index) {
+        this->slots[index].~KeyValuePair<KEY, VALUE>();
+        this->size--;
+        // a lookup stops at the first group with an empty slot, so if this
+        // group still has one, the slot can become empty again, otherwise
+        // it must be marked as deleted to keep probe sequences intact
+        const int32 groupStart = index & ~(group::Width - 1);
+        if (group(this->ctrl + groupStart).MatchEmpty()) {
+            this->ctrl[index] = _priv::hashMapCtrl::Empty;
+        }
+        else {
+            this->ctrl[index] = _priv::hashMapCtrl::Deleted;
+            this->numDeleted++;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> typename HashMap<KEY, VALUE, HASHER>::iterator
+HashMap<KEY, VALUE, HASHER>::begin() {
+    return iterator(this, 0);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> typename HashMap<KEY, VALUE, HASHER>::const_iterator
+HashMap<KEY, VALUE, HASHER>::begin() const {
+    return const_iterator(this, 0);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> typename HashMap<KEY, VALUE, HASHER>::iterator
+HashMap<KEY, VALUE, HASHER>::end() {
+    return iterator(this, this->capacity);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> typename HashMap<KEY, VALUE, HASHER>::const_iterator
+HashMap<KEY, VALUE, HASHER>::end() const {
+    return const_iterator(this, this->capacity);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> uint64
+HashMap<KEY, VALUE, HASHER>::hash(const KEY& key) {
+    // mix the hasher result (64-bit finalizer from MurmurHash3), many
+    // hashers are just the identity which would leave H2 useless
+    uint64 h = uint64(HASHER()(key));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> uint64
+HashMap<KEY, VALUE, HASHER>::h1(uint64 hash) {
+    return hash >> 7;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int8
+HashMap<KEY, VALUE, HASHER>::h2(uint64 hash) {
+    return int8(hash & 0x7F);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int32
+HashMap<KEY, VALUE, HASHER>::maxLoad(int32 capacity) {
+    // max load factor is 7/8
+    return capacity - (capacity >> 3);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int32
+HashMap<KEY, VALUE, HASHER>::findIndex(const KEY& key) const {
+    if (0 == this->size) {
+        return InvalidIndex;
+    }
+    const uint64 hsh = hash(key);
+    const int8 h2Val = h2(hsh);
+    const int32 groupMask = (this->capacity / group::Width) - 1;
+    int32 groupIndex = int32(h1(hsh)) & groupMask;
+    for (int32 probe = 1; ; probe++) {
+        const int32 groupStart = groupIndex * group::Width;
+        const group g(this->ctrl + groupStart);
+        for (auto match = g.Match(h2Val); match; match.ClearLowest()) {
+            const int32 index = groupStart + match.Lowest();
+            if (this->slots[index].key == key) {
+                return index;
+            }
+        }
+        if (g.MatchEmpty()) {
+            return InvalidIndex;
+        }
+        // triangular probing visits every group if the number of groups is a power of 2
+        groupIndex = (groupIndex + probe) & groupMask;
+        o_assert_dbg(probe <= groupMask + 1);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int32
+HashMap<KEY, VALUE, HASHER>::findFreeIndex(uint64 hsh) const {
+    const int32 groupMask = (this->capacity / group::Width) - 1;
+    int32 groupIndex = int32(h1(hsh)) & groupMask;
+    for (int32 probe = 1; ; probe++) {
+        const int32 groupStart = groupIndex * group::Width;
+        auto match = group(this->ctrl + groupStart).MatchEmptyOrDeleted();
+        if (match) {
+            return groupStart + match.Lowest();
+        }
+        groupIndex = (groupIndex + probe) & groupMask;
+        o_assert_dbg(probe <= groupMask + 1);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class KVP> bool
+HashMap<KEY, VALUE, HASHER>::insert(KVP&& kvp) {
+    if (InvalidIndex != this->findIndex(kvp.key)) {
+        return false;
+    }
+    if ((this->size + this->numDeleted) >= maxLoad(this->capacity)) {
+        if (0 == this->capacity) {
+            this->rehash(group::Width);
+        }
+        else if (this->size < (maxLoad(this->capacity) >> 1)) {
+            // many slots are only deleted, rehashing in place is enough
+            this->rehash(this->capacity);
+        }
+        else {
+            this->rehash(this->capacity << 1);
+        }
+    }
+    const uint64 hsh = hash(kvp.key);
+    const int32 index = this->findFreeIndex(hsh);
+    if (_priv::hashMapCtrl::Deleted == this->ctrl[index]) {
+        this->numDeleted--;
+    }
+    this->ctrl[index] = h2(hsh);
+    new(&this->slots[index]) KeyValuePair<KEY, VALUE>(std::forward<KVP>(kvp));
+    this->size++;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::rehash(int32 newCapacity) {
+    o_assert_dbg(maxLoad(newCapacity) > this->size);
+    int8* oldCtrl = this->ctrl;
+    KeyValuePair<KEY, VALUE>* oldSlots = this->slots;
+    const int32 oldCapacity = this->capacity;
+    this->alloc(newCapacity);
+
+    // move-construct elements over to the new buffer
+    for (int32 i = 0; i < oldCapacity; i++) {
+        if (oldCtrl[i] >= 0) {
+            const uint64 hsh = hash(oldSlots[i].key);
+            const int32 index = this->findFreeIndex(hsh);
+            this->ctrl[index] = h2(hsh);
+            new(&this->slots[index]) KeyValuePair<KEY, VALUE>(std::move(oldSlots[i]));
+            // must still call destructor on move-source
+            oldSlots[i].~KeyValuePair<KEY, VALUE>();
+        }
+    }
+    this->numDeleted = 0;
+    if (nullptr != oldCtrl) {
+        Memory::Free(oldCtrl);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Control bytes and slots live in one allocation, the control bytes
+ come first, since the capacity is always a multiple of 16 the slots
+ have the alignment of the allocation.
+*/
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::alloc(int32 newCapacity) {
+    o_assert_dbg((newCapacity >= group::Width) && (0 == (newCapacity & (newCapacity - 1))));
+    uint8* ptr = (uint8*) Memory::Alloc(newCapacity + newCapacity * int32(sizeof(KeyValuePair<KEY, VALUE>)));
+    this->ctrl = (int8*) ptr;
+    this->slots = (KeyValuePair<KEY, VALUE>*) (ptr + newCapacity);
+    this->capacity = newCapacity;
+    Memory::Fill(this->ctrl, newCapacity, uint8(_priv::hashMapCtrl::Empty));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::destroy() {
+    if (nullptr != this->ctrl) {
+        this->Clear();
+        Memory::Free(this->ctrl);
+    }
+    this->ctrl = nullptr;
+    this->slots = nullptr;
+    this->capacity = 0;
+    this->size = 0;
+    this->numDeleted = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::copy(const HashMap& rhs) {
+    o_assert_dbg(nullptr == this->ctrl);
+    if (rhs.capacity > 0) {
+        // keep the same layout, so no rehashing is needed
+        this->alloc(rhs.capacity);
+        Memory::Copy(rhs.ctrl, this->ctrl, rhs.capacity);
+        for (int32 i = 0; i < rhs.capacity; i++) {
+            if (rhs.ctrl[i] >= 0) {
+                new(&this->slots[i]) KeyValuePair<KEY, VALUE>(rhs.slots[i]);
+            }
+        }
+        this->size = rhs.size;
+        this->numDeleted = rhs.numDeleted;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::move(HashMap&& rhs) {
+    this->ctrl = rhs.ctrl;
+    this->slots = rhs.slots;
+    this->capacity = rhs.capacity;
+    this->size = rhs.size;
+    this->numDeleted = rhs.numDeleted;
+    rhs.ctrl = nullptr;
+    rhs.slots = nullptr;
+    rhs.capacity = 0;
+    rhs.size = 0;
+    rhs.numDeleted = 0;
+}
+
+} // namespace Oryol
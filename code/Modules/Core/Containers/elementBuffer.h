@@ -19,7 +19,9 @@
     '----' - empty memory slot (guaranteed to be destructed)
     'XXXX' - valid element (guaranteed to be constructed)
 */
+#include <cstring>
 #include <new>
+#include <type_traits>
 #include <utility>
 #include "Core/Types.h"
 #include "Core/Assertion.h"
@@ -82,6 +84,10 @@ public:
     static bool overlaps(const TYPE* from, const TYPE* to, int32 num);
     /// copy-construct element range
     static void copyConstruct(const TYPE* from, TYPE* to, int32 num);
+    /// copy-construct element range of trivially copyable elements with memcpy
+    static void copyConstructRange(const TYPE* from, TYPE* to, int32 num, std::true_type);
+    /// copy-construct element range of other elements one by one
+    static void copyConstructRange(const TYPE* from, TYPE* to, int32 num, std::false_type);
     /// copy-assign element range UNTESTED
     static void copyAssign(const TYPE* from, TYPE* to, int32 num);
     
@@ -91,6 +97,8 @@ public:
     void pushBack(TYPE&& elm);
     /// emplace element at back (backSpare must be > 0!)
     template<class... ARGS> void emplaceBack(ARGS&&... args);
+    /// copy-construct a range of elements at back (backSpare must be >= num!)
+    void pushBackRange(const TYPE* elms, int32 num);
     /// pop back element
     TYPE popBack();
 
@@ -373,6 +381,19 @@ elementBuffer<TYPE>::copyConstruct(const TYPE* from, TYPE* to, int32 num) {
     }
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE> void
+elementBuffer<TYPE>::copyConstructRange(const TYPE* from, TYPE* to, int32 num, std::true_type) {
+    o_assert_dbg(!overlaps(from, to, num));
+    std::memcpy(to, from, num * sizeof(TYPE));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+elementBuffer<TYPE>::copyConstructRange(const TYPE* from, TYPE* to, int32 num, std::false_type) {
+    copyConstruct(from, to, num);
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE> void
 elementBuffer<TYPE>::copyAssign(const TYPE* from, TYPE* to, int32 num) {
@@ -409,6 +430,16 @@ elementBuffer<TYPE>::emplaceBack(ARGS&&... args) {
     new(this->elmEnd++) TYPE(std::forward<ARGS>(args)...);
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE> void
+elementBuffer<TYPE>::pushBackRange(const TYPE* elms, int32 num) {
+    o_assert_dbg((nullptr != this->elmEnd) && ((this->elmEnd + num) <= this->bufEnd));
+    o_assert_dbg(!overlaps(elms, this->elmEnd, num));
+    // trivially copyable elements don't need to be constructed one by one
+    copyConstructRange(elms, this->elmEnd, num, std::integral_constant<bool, std::is_trivially_copyable<TYPE>::value>());
+    this->elmEnd += num;
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE> void
 elementBuffer<TYPE>::pushFront(const TYPE& elm) {
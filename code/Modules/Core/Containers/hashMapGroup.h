@@ -0,0 +1,163 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::hashMapGroup
+    @ingroup _priv
+    @brief match a group of 16 HashMap control bytes at once
+
+    HashMap keeps one control byte per slot, a control byte is either
+    Empty, Deleted or (for full slots) the 7-bit H2 part of the key's
+    hash. hashMapGroup loads 16 control bytes and compares them in
+    parallel, returning a bitMask with one entry per matching slot.
+    Uses SSE2 on x86, NEON on ARM and a scalar loop everywhere else.
+*/
+#include "Core/Types.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define ORYOL_HASHMAP_SSE2 (1)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ORYOL_HASHMAP_NEON (1)
+#include <arm_neon.h>
+#endif
+#if ORYOL_WINDOWS
+#include <intrin.h>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+/// control byte values, full slots store the 7-bit H2 hash (0..127)
+namespace hashMapCtrl {
+    static const int8 Empty = -128;     // 0x80
+    static const int8 Deleted = -2;     // 0xFE
+}
+
+//------------------------------------------------------------------------------
+/**
+    Iterate over the set bits in a group match result, each matching
+    slot occupies (1 << SHIFT) bits, of which only the highest is set.
+*/
+template<int32 SHIFT> class hashMapBitMask {
+public:
+    /// construct from mask bits
+    explicit hashMapBitMask(uint64 bits_) : bits(bits_) { };
+    /// return true if any slot matches
+    explicit operator bool() const {
+        return 0 != this->bits;
+    };
+    /// get slot index of lowest match (mask must not be empty)
+    int32 Lowest() const {
+        #if ORYOL_WINDOWS && defined(_WIN64)
+        unsigned long index;
+        _BitScanForward64(&index, this->bits);
+        return int32(index) >> SHIFT;
+        #elif defined(__GNUC__)
+        return __builtin_ctzll(this->bits) >> SHIFT;
+        #else
+        int32 index = 0;
+        while (0 == (this->bits & (uint64(1) << index))) {
+            index++;
+        }
+        return index >> SHIFT;
+        #endif
+    };
+    /// remove lowest match
+    void ClearLowest() {
+        this->bits &= (this->bits - 1);
+    };
+private:
+    uint64 bits;
+};
+
+//------------------------------------------------------------------------------
+class hashMapGroup {
+public:
+    /// number of slots in a group
+    static const int32 Width = 16;
+    #if ORYOL_HASHMAP_NEON
+    typedef hashMapBitMask<2> BitMask;
+    #else
+    typedef hashMapBitMask<0> BitMask;
+    #endif
+
+    /// load a group of 16 control bytes
+    explicit hashMapGroup(const int8* ctrl);
+    /// get slots matching a H2 hash
+    BitMask Match(int8 h2) const;
+    /// get empty slots
+    BitMask MatchEmpty() const;
+    /// get empty or deleted slots
+    BitMask MatchEmptyOrDeleted() const;
+
+private:
+    #if ORYOL_HASHMAP_SSE2
+    __m128i ctrl;
+    #elif ORYOL_HASHMAP_NEON
+    int8x16_t ctrl;
+    /// convert byte-wise comparison result to a bit mask with 4 bits per slot
+    static BitMask toMask(uint8x16_t cmp) {
+        uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+        return BitMask(vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ull);
+    };
+    #else
+    const int8* ctrl;
+    #endif
+};
+
+//------------------------------------------------------------------------------
+inline
+hashMapGroup::hashMapGroup(const int8* ctrl_) {
+    #if ORYOL_HASHMAP_SSE2
+    this->ctrl = _mm_loadu_si128((const __m128i*)ctrl_);
+    #elif ORYOL_HASHMAP_NEON
+    this->ctrl = vld1q_s8(ctrl_);
+    #else
+    this->ctrl = ctrl_;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+inline hashMapGroup::BitMask
+hashMapGroup::Match(int8 h2) const {
+    #if ORYOL_HASHMAP_SSE2
+    return BitMask(uint32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), this->ctrl))));
+    #elif ORYOL_HASHMAP_NEON
+    return toMask(vceqq_s8(vdupq_n_s8(h2), this->ctrl));
+    #else
+    uint64 bits = 0;
+    for (int32 i = 0; i < Width; i++) {
+        if (this->ctrl[i] == h2) {
+            bits |= uint64(1) << i;
+        }
+    }
+    return BitMask(bits);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+inline hashMapGroup::BitMask
+hashMapGroup::MatchEmpty() const {
+    return this->Match(hashMapCtrl::Empty);
+}
+
+//------------------------------------------------------------------------------
+inline hashMapGroup::BitMask
+hashMapGroup::MatchEmptyOrDeleted() const {
+    // Empty and Deleted are the only control bytes with the sign bit set
+    #if ORYOL_HASHMAP_SSE2
+    return BitMask(uint32(_mm_movemask_epi8(this->ctrl)));
+    #elif ORYOL_HASHMAP_NEON
+    return toMask(vcltq_s8(this->ctrl, vdupq_n_s8(0)));
+    #else
+    uint64 bits = 0;
+    for (int32 i = 0; i < Width; i++) {
+        if (this->ctrl[i] < 0) {
+            bits |= uint64(1) << i;
+        }
+    }
+    return BitMask(bits);
+    #endif
+}
+
+} // namespace _priv
+} // namespace Oryol
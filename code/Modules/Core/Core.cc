@@ -5,6 +5,8 @@
 #include "Core.h"
 #include "Core/RunLoop.h"
 #include "Core/Ptr.h"
+#include "Core/Memory/poolAllocator.h"
+#include "Core/logQueue.h"
 
 namespace Oryol {
     
@@ -28,6 +30,11 @@ Core::Setup() {
     ptr = RunLoop::Create();
     ptr->addRef();
     threadPostRunLoop = ptr.get();
+
+    // release the per-frame memory arena at the end of each frame
+    threadPostRunLoop->Add([] {
+        Memory::ResetFrameArena();
+    });
 }
 
 //------------------------------------------------------------------------------
@@ -44,8 +51,8 @@ Core::Discard() {
     Memory::Delete(state);
     state = nullptr;
 
-    // do NOT destroy the thread-local string atom table to
-    // ensure that string atom data pointers still point to valid data!!!    
+    // do NOT destroy the global string atom table to
+    // ensure that string atom data pointers still point to valid data!!!
 }
 
 //------------------------------------------------------------------------------
@@ -107,8 +114,11 @@ Core::LeaveThread() {
     threadPostRunLoop->release();
     threadPostRunLoop = nullptr;
 
-    // do NOT destroy the thread-local string atom table to
-    // ensure that string atom data pointers still point to valid data
+    // give up the thread's pool allocator magazines
+    _priv::poolThreadSlot::Release();
+
+    // give up the thread's asynchronous log ring
+    _priv::logQueue::leaveThread();
     #endif
 }
 
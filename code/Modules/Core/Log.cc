@@ -8,6 +8,7 @@
 #include "Core/Logger.h"
 #include "Core/Threading/RWLock.h"
 #include "Core/Containers/Array.h"
+#include "Core/logQueue.h"
 #if ORYOL_WINDOWS
 #include <Windows.h>
 #endif
@@ -65,6 +66,40 @@ Log::GetLogLevel() {
     return curLogLevel;
 }
 
+//------------------------------------------------------------------------------
+void
+Log::EnableAsync(int32 numRecords) {
+    if (!logQueue::isValid()) {
+        logQueue::setup(numRecords, &Log::printSync);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+Log::DisableAsync() {
+    if (logQueue::isValid()) {
+        logQueue::discard();
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+Log::IsAsync() {
+    return logQueue::isValid();
+}
+
+//------------------------------------------------------------------------------
+void
+Log::Flush() {
+    logQueue::flush();
+}
+
+//------------------------------------------------------------------------------
+int64
+Log::NumDroppedRecords() {
+    return logQueue::numDropped();
+}
+
 //------------------------------------------------------------------------------
 void
 Log::Dbg(const char* msg, ...) {
@@ -112,6 +147,36 @@ Log::Error(const char* msg, ...) {
 //------------------------------------------------------------------------------
 void
 Log::vprint(Level lvl, const char* msg, va_list args) {
+    if (logQueue::isValid()) {
+        if (Level::Error != lvl) {
+            // push() consumes the va_list, keep a copy in case the message is too long
+            va_list argsCopy;
+            va_copy(argsCopy, args);
+            const bool queued = logQueue::push(lvl, msg, argsCopy);
+            va_end(argsCopy);
+            if (queued) {
+                return;
+            }
+        }
+        // errors usually abort the program, and long messages don't fit
+        // into a record, write everything now to keep the order
+        logQueue::flush();
+    }
+    Log::vprintSync(lvl, logQueue::timestamp(), logQueue::threadId(), msg, args);
+}
+
+//------------------------------------------------------------------------------
+void
+Log::printSync(Level lvl, int64 timeNs, uint64 threadId, const char* msg, ...) {
+    va_list args;
+    va_start(args, msg);
+    Log::vprintSync(lvl, timeNs, threadId, msg, args);
+    va_end(args);
+}
+
+//------------------------------------------------------------------------------
+void
+Log::vprintSync(Level lvl, int64 timeNs, uint64 threadId, const char* msg, va_list args) {
     lock.LockRead();
     if (loggers.Empty()) {
         #if ORYOL_ANDROID
@@ -159,7 +224,7 @@ Log::vprint(Level lvl, const char* msg, va_list args) {
     }
     else {
         for (auto l : loggers) {
-            l->VPrint(lvl, msg, args);
+            l->VPrintRecord(lvl, timeNs, threadId, msg, args);
         }
     }
     lock.UnlockRead();
@@ -168,6 +233,7 @@ Log::vprint(Level lvl, const char* msg, va_list args) {
 //------------------------------------------------------------------------------
 void
 Log::AssertMsg(const char* cond, const char* msg, const char* file, int32 line, const char* func) {
+    logQueue::flush();
     lock.LockRead();
     if (loggers.Empty()) {
         #if ORYOL_ANDROID
@@ -9,6 +9,24 @@
     output is logged to stdout and stderr, but custom Logger objects
     can be attached to handle log output differently.
 
+    By default, messages are formatted and written to the loggers
+    synchronously on the calling thread. After EnableAsync(), the
+    calling thread only formats the message into a record in its own
+    lock-free ring buffer, and a background thread writes the records
+    to the loggers. Records are dropped (and counted) instead of
+    blocking when a thread's ring buffer is full. Errors and assert
+    messages are always written synchronously after flushing pending
+    records, so that they are not lost when the program aborts.
+    Asynchronous records hold at most MaxAsyncMsgLength characters,
+    longer messages are also written synchronously (after flushing
+    pending records) instead of being truncated.
+
+    Loggers get the time and thread a message was logged from through
+    Logger::VPrintRecord(), for asynchronous records this is the time
+    and thread of the original log call, not of the background thread.
+    EnableAsync() and DisableAsync() must not be called while other
+    threads are logging.
+
     @see Logger
 */
 #include <cstdarg>
@@ -45,6 +63,20 @@ public:
     static void SetLogLevel(Level l);
     /// get current log level
     static Level GetLogLevel();
+
+    /// max length of an asynchronous message, longer messages are written synchronously
+    static const int32 MaxAsyncMsgLength = 240;
+    /// enable asynchronous logging with a ring buffer of numRecords per thread
+    static void EnableAsync(int32 numRecords=1024);
+    /// disable asynchronous logging (writes pending records)
+    static void DisableAsync();
+    /// return true if asynchronous logging is enabled
+    static bool IsAsync();
+    /// write pending asynchronous records on the calling thread
+    static void Flush();
+    /// get number of asynchronous records dropped because a ring buffer was full
+    static int64 NumDroppedRecords();
+
     /// print a debug message
     static void Dbg(const char* msg, ...) __attribute__((format(printf, 1, 2)));
     /// print an info message
@@ -59,6 +91,10 @@ public:
 private:
     /// generic vprint-style method
     static void vprint(Level l, const char* msg, va_list args) __attribute__((format(printf, 2, 0)));
+    /// write a message to the loggers on the calling thread
+    static void vprintSync(Level l, int64 timeNs, uint64 threadId, const char* msg, va_list args) __attribute__((format(printf, 4, 0)));
+    /// printf-style wrapper for vprintSync, used to output asynchronous records
+    static void printSync(Level l, int64 timeNs, uint64 threadId, const char* msg, ...) __attribute__((format(printf, 4, 5)));
 };
 
 /// shortcut for Log::Dbg()
@@ -25,6 +25,12 @@ Logger::VPrint(Log::Level /*l*/, const char* /*msg*/, va_list /*args*/) {
     // we can't do an o_error() here since it would recurse
 }
 
+//------------------------------------------------------------------------------
+void
+Logger::VPrintRecord(Log::Level l, int64 /*timeNs*/, uint64 /*threadId*/, const char* msg, va_list args) {
+    this->VPrint(l, msg, args);
+}
+
 //------------------------------------------------------------------------------
 /**
  */
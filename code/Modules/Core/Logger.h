@@ -25,6 +25,8 @@ public:
     virtual ~Logger();
     /// generic vprint-style method
     virtual void VPrint(Log::Level l, const char* msg, va_list args);
+    /// vprint-style method with time (ns, steady clock) and thread of the log call, default calls VPrint()
+    virtual void VPrintRecord(Log::Level l, int64 timeNs, uint64 threadId, const char* msg, va_list args);
     /// print an assert message
     virtual void AssertMsg(const char* cond, const char* msg, const char* file, int32 line, const char* func);
 };
@@ -4,21 +4,259 @@
 #include <memory>
 #include <cstdlib>
 #include <cstring>
+#include <atomic>
+#include <mutex>
 #include "Memory.h"
+#include "Core/Assertion.h"
+#include "Core/Log.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include "Core/Memory/tlsfHeap.h"
+#include "Core/Memory/frameArena.h"
+#include "Core/Memory/poolAllocator.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
 #if ORYOL_USE_VLD
 #include "vld.h"
 #endif
 
 namespace Oryol {
-    
+
+using namespace _priv;
+
+namespace {
+
+#if ORYOL_MEMORY_STATS
+// with memory statistics, each allocation is prefixed with this header
+// (16 bytes to keep alignment)
+struct allocHeader {
+    int32 size;
+    Memory::Tag tag;
+    uint8 padding0;
+    uint16 magic;
+    uint8 padding1[8];
+};
+static_assert(sizeof(allocHeader) == 16, "Memory: allocHeader must be 16 bytes!");
+const uint16 headerMagic = 0x0A11;
+const int32 headerSize = int32(sizeof(allocHeader));
+
+// per-tag counters, each thread with a pool slot has its own set which
+// is only written by that thread, so no atomic read-modify-write is needed
+struct tagCounters {
+    std::atomic<int64> numBytes;
+    std::atomic<int64> numAllocs;
+    std::atomic<int64> numFrees;
+};
+struct statsBlock {
+    tagCounters tags[Memory::MaxNumTags];
+};
+// frame arena allocations per tag which haven't been freed yet, these
+// are subtracted from the stats when the arena is reset (arena thread only)
+struct frameCounters {
+    int64 numBytes;
+    int64 numAllocs;
+};
+#else
+const int32 headerSize = 0;
+#endif
+
+struct tagEntry {
+    const char* name;
+};
+struct backendEntry {
+    Memory::Backend::Code code;
+};
+
+// NOTE: Memory::Alloc() may be called during static initialization,
+// everything here must be zero- or constant-initialized
+tagEntry tags[Memory::MaxNumTags];
+std::atomic<int32> numTags{1};
+#if ORYOL_MEMORY_STATS
+statsBlock threadStats[poolThreadSlot::MaxSlots];
+statsBlock sharedStats;     // for threads without pool slot
+frameCounters frameStats[Memory::MaxNumTags];
+#endif
+backendEntry backends[Memory::Backend::NumBackends] = {
+    { Memory::Backend::Malloc },
+    { Memory::Backend::TLSF },
+};
+std::atomic<int32> globalBackend{Memory::Backend::Malloc};
+std::mutex tlsfLock;
+tlsfHeap tlsf;
+frameArena arena;
+#if ORYOL_HAS_THREADS
+std::thread::id arenaThread;    // the thread which called SetupFrameArena()
+#endif
+
+#if ORYOL_THREADLOCAL_PTHREAD
+// construct thread-local pointers on first use, see note above
+ThreadLocalPtr<tagEntry>& threadTag() {
+    static ThreadLocalPtr<tagEntry> ptr;
+    return ptr;
+}
+ThreadLocalPtr<backendEntry>& threadBackend() {
+    static ThreadLocalPtr<backendEntry> ptr;
+    return ptr;
+}
+#else
+ORYOL_THREADLOCAL_PTR(tagEntry) threadTagPtr = nullptr;
+ORYOL_THREADLOCAL_PTR(backendEntry) threadBackendPtr = nullptr;
+inline tagEntry*& threadTag() {
+    return threadTagPtr;
+}
+inline backendEntry*& threadBackend() {
+    return threadBackendPtr;
+}
+#endif
+
 //------------------------------------------------------------------------------
-void*
-Memory::Alloc(int32 numBytes) {
-    void* ptr = std::malloc(numBytes);
-#if ORYOL_ALLOCATOR_DEBUG || ORYOL_UNITTESTS
-    Memory::Fill(ptr, numBytes, ORYOL_MEMORY_DEBUG_BYTE);
+inline Memory::Backend::Code
+currentBackend() {
+    backendEntry* entry = threadBackend();
+    if (entry) {
+        return entry->code;
+    }
+    else {
+        return (Memory::Backend::Code) globalBackend.load(std::memory_order_relaxed);
+    }
+}
+
+//------------------------------------------------------------------------------
+inline Memory::Tag
+currentTag() {
+    tagEntry* entry = threadTag();
+    return entry ? Memory::Tag(entry - tags) : Memory::DefaultTag;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+isArenaThread() {
+    #if ORYOL_HAS_THREADS
+    return std::this_thread::get_id() == arenaThread;
+    #else
+    return true;
+    #endif
+}
+
+#if ORYOL_MEMORY_STATS
+//------------------------------------------------------------------------------
+inline void
+addCounter(std::atomic<int64>& counter, int64 val, bool shared) {
+    if (shared) {
+        counter.fetch_add(val, std::memory_order_relaxed);
+    }
+    else {
+        counter.store(counter.load(std::memory_order_relaxed) + val, std::memory_order_relaxed);
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+addStats(Memory::Tag tag, int32 numBytes, int32 numAllocs, int32 numFrees) {
+    const int32 slot = poolThreadSlot::Index();
+    const bool shared = poolThreadSlot::InvalidIndex == slot;
+    tagCounters& counters = (shared ? sharedStats : threadStats[slot]).tags[tag];
+    addCounter(counters.numBytes, numBytes, shared);
+    if (numAllocs) {
+        addCounter(counters.numAllocs, numAllocs, shared);
+    }
+    if (numFrees) {
+        addCounter(counters.numFrees, numFrees, shared);
+    }
+}
 #endif
+
+//------------------------------------------------------------------------------
+/**
+ Turn a raw block from a backend into the pointer returned to the caller.
+*/
+inline void*
+initBlock(void* block, int32 numBytes, Memory::Tag tag) {
+    o_assert_range_dbg(tag, Memory::MaxNumTags);
+    #if ORYOL_MEMORY_STATS
+    allocHeader* hdr = (allocHeader*) block;
+    hdr->size = numBytes;
+    hdr->tag = tag;
+    hdr->magic = headerMagic;
+    addStats(tag, numBytes, 1, 0);
+    void* ptr = (void*) (hdr + 1);
+    #else
+    void* ptr = block;
+    #endif
+    #if ORYOL_ALLOCATOR_DEBUG || ORYOL_UNITTESTS
+    Memory::Fill(ptr, numBytes, ORYOL_MEMORY_DEBUG_BYTE);
+    #endif
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+inline void*
+blockFromPtr(void* ptr) {
+    #if ORYOL_MEMORY_STATS
+    allocHeader* hdr = ((allocHeader*)ptr) - 1;
+    o_assert_dbg(headerMagic == hdr->magic);
+    return hdr;
+    #else
     return ptr;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void*
+allocImpl(int32 numBytes, Memory::Tag tag) {
+    o_assert_dbg(numBytes >= 0);
+    const int32 allocSize = numBytes + headerSize;
+    void* block = nullptr;
+    if (Memory::Backend::TLSF == currentBackend()) {
+        std::lock_guard<std::mutex> lock(tlsfLock);
+        if (tlsf.IsValid()) {
+            block = tlsf.Alloc(allocSize);
+        }
+    }
+    if (nullptr == block) {
+        // malloc backend, or TLSF heap exhausted
+        block = std::malloc(allocSize);
+    }
+    return initBlock(block, numBytes, tag);
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+void*
+Memory::Alloc(int32 numBytes) {
+    return allocImpl(numBytes, currentTag());
+}
+
+//------------------------------------------------------------------------------
+void*
+Memory::Alloc(int32 numBytes, Tag tag) {
+    return allocImpl(numBytes, tag);
+}
+
+//------------------------------------------------------------------------------
+/**
+ Frame allocations are never routed through BackendScope or SetBackend(),
+ so that allocations which outlive the frame can't end up in the arena
+ by accident. There is no fallback to malloc(), since frame memory
+ doesn't need to be freed, nullptr is returned if the arena is exhausted.
+ Frame memory can't be re-allocated.
+*/
+void*
+Memory::AllocFrame(int32 numBytes) {
+    o_assert_dbg(numBytes >= 0);
+    o_assert2(arena.IsValid(), "Memory::AllocFrame(): frame arena not setup!\n");
+    o_assert2_dbg(isArenaThread(), "Memory::AllocFrame(): must be called on the main thread!\n");
+    void* block = arena.Alloc(numBytes + headerSize);
+    if (nullptr == block) {
+        return nullptr;
+    }
+    const Tag tag = currentTag();
+    #if ORYOL_MEMORY_STATS
+    frameStats[tag].numBytes += numBytes;
+    frameStats[tag].numAllocs++;
+    #endif
+    return initBlock(block, numBytes, tag);
 }
 
 //------------------------------------------------------------------------------
@@ -28,16 +266,88 @@ Memory::Fill(void* ptr, int32 numBytes, uint8 value) {
 }
 
 //------------------------------------------------------------------------------
+/**
+ The memory stays in the backend it has been allocated from.
+*/
 void*
 Memory::ReAlloc(void* ptr, int32 s) {
-    /// @todo: HMM need to fix fill with debug pattern...
-    return std::realloc(ptr, s);
+    if (nullptr == ptr) {
+        return Memory::Alloc(s);
+    }
+    void* block = blockFromPtr(ptr);
+    if (arena.Owns(block)) {
+        o_error("Memory::ReAlloc(): frame arena memory can't be re-allocated!\n");
+    }
+    if (!tlsf.Owns(block)) {
+        /// @todo: HMM need to fix fill with debug pattern...
+        #if ORYOL_MEMORY_STATS
+        allocHeader* hdr = (allocHeader*) block;
+        const int32 oldSize = hdr->size;
+        hdr = (allocHeader*) std::realloc(hdr, s + headerSize);
+        hdr->size = s;
+        addStats(hdr->tag, s - oldSize, 0, 0);
+        return (void*) (hdr + 1);
+        #else
+        return std::realloc(block, s);
+        #endif
+    }
+    else {
+        // allocate a new TLSF block and copy
+        #if ORYOL_MEMORY_STATS
+        const int32 oldSize = ((allocHeader*)block)->size;
+        const Tag tag = ((allocHeader*)block)->tag;
+        #else
+        int32 oldSize = 0;
+        const Tag tag = DefaultTag;
+        #endif
+        void* newBlock = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(tlsfLock);
+            #if !ORYOL_MEMORY_STATS
+            oldSize = tlsf.Size(block);
+            #endif
+            newBlock = tlsf.Alloc(s + headerSize);
+        }
+        if (nullptr == newBlock) {
+            // TLSF heap exhausted
+            newBlock = std::malloc(s + headerSize);
+        }
+        void* newPtr = initBlock(newBlock, s, tag);
+        Memory::Copy(ptr, newPtr, oldSize < s ? oldSize : s);
+        Memory::Free(ptr);
+        return newPtr;
+    }
 }
 
 //------------------------------------------------------------------------------
 void
 Memory::Free(void* p) {
-    std::free(p);
+    if (nullptr == p) {
+        return;
+    }
+    void* block = blockFromPtr(p);
+    #if ORYOL_MEMORY_STATS
+    allocHeader* hdr = (allocHeader*) block;
+    addStats(hdr->tag, -hdr->size, 0, 1);
+    #if ORYOL_ALLOCATOR_DEBUG
+    hdr->magic = 0;
+    #endif
+    #endif
+    if (arena.Owns(block)) {
+        o_assert2_dbg(isArenaThread(), "Memory::Free(): frame arena memory must be freed on the main thread!\n");
+        #if ORYOL_MEMORY_STATS
+        frameStats[hdr->tag].numBytes -= hdr->size;
+        frameStats[hdr->tag].numAllocs--;
+        #endif
+        arena.Free(block);
+    }
+    else if (tlsf.Owns(block)) {
+        std::lock_guard<std::mutex> lock(tlsfLock);
+        tlsf.Free(block);
+    }
+    else {
+        std::free(block);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -58,6 +368,155 @@ Memory::Clear(void* ptr, int32 numBytes) {
     std::memset(ptr, 0, numBytes);
 }
 
+//------------------------------------------------------------------------------
+/**
+ NOTE: the heap memory is never released, since allocations may
+ still be alive when the application shuts down.
+*/
+void
+Memory::SetupTLSF(int32 heapSize) {
+    std::lock_guard<std::mutex> lock(tlsfLock);
+    o_assert(!tlsf.IsValid());
+    tlsf.Setup(std::malloc(heapSize), heapSize);
+}
+
+//------------------------------------------------------------------------------
+/**
+ The calling thread owns the frame arena, only this thread may call
+ AllocFrame() and ResetFrameArena().
+*/
+void
+Memory::SetupFrameArena(int32 arenaSize) {
+    o_assert(!arena.IsValid());
+    #if ORYOL_HAS_THREADS
+    arenaThread = std::this_thread::get_id();
+    #endif
+    arena.Setup(std::malloc(arenaSize), arenaSize);
+}
+
+//------------------------------------------------------------------------------
+void
+Memory::SetBackend(Backend::Code backend) {
+    o_assert_range(backend, Backend::NumBackends);
+    o_assert((Backend::TLSF != backend) || tlsf.IsValid());
+    globalBackend.store(backend, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+Memory::Backend::Code
+Memory::GetBackend() {
+    return currentBackend();
+}
+
+//------------------------------------------------------------------------------
+/**
+ All memory from the frame arena is released, including frame
+ allocations which haven't been freed with Free(). Those are
+ removed from the tag statistics here.
+*/
+void
+Memory::ResetFrameArena() {
+    if (arena.IsValid()) {
+        o_assert2(isArenaThread(), "Memory::ResetFrameArena(): must be called on the main thread!\n");
+        arena.Reset();
+        #if ORYOL_MEMORY_STATS
+        for (int32 tag = 0; tag < MaxNumTags; tag++) {
+            frameCounters& counters = frameStats[tag];
+            if (counters.numAllocs > 0) {
+                addStats(Tag(tag), int32(-counters.numBytes), 0, int32(counters.numAllocs));
+                counters.numBytes = 0;
+                counters.numAllocs = 0;
+            }
+        }
+        #endif
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ NOTE: the name string is not copied and must be static.
+*/
+Memory::Tag
+Memory::RegisterTag(const char* name) {
+    o_assert(nullptr != name);
+    const int32 index = numTags.fetch_add(1);
+    o_assert(index < MaxNumTags);
+    tags[index].name = name;
+    return Tag(index);
+}
+
+//------------------------------------------------------------------------------
+int32
+Memory::NumTags() {
+    return numTags.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+/**
+ NOTE: the counters of other threads are read without synchronization,
+ the result is only exact if no other thread is allocating memory.
+ Without ORYOL_MEMORY_STATS, all counters are 0.
+*/
+Memory::TagStats
+Memory::GetTagStats(Tag tag) {
+    o_assert_range(tag, NumTags());
+    TagStats stats;
+    stats.Name = tags[tag].name ? tags[tag].name : "default";
+    #if ORYOL_MEMORY_STATS
+    int64 numBytes = 0;
+    int64 numAllocs = 0;
+    int64 numFrees = 0;
+    for (int32 i = 0; i <= poolThreadSlot::MaxSlots; i++) {
+        const tagCounters& counters = (i < poolThreadSlot::MaxSlots ? threadStats[i] : sharedStats).tags[tag];
+        numBytes += counters.numBytes.load(std::memory_order_relaxed);
+        numAllocs += counters.numAllocs.load(std::memory_order_relaxed);
+        numFrees += counters.numFrees.load(std::memory_order_relaxed);
+    }
+    stats.NumBytes = numBytes;
+    stats.NumAllocs = int32(numAllocs - numFrees);
+    stats.TotalAllocs = numAllocs;
+    #endif
+    return stats;
+}
+
+//------------------------------------------------------------------------------
+int32
+Memory::swapThreadBackend(int32 backend) {
+    backendEntry* prev = threadBackend();
+    threadBackend() = (backend < 0) ? nullptr : &backends[backend];
+    return prev ? int32(prev->code) : -1;
+}
+
+//------------------------------------------------------------------------------
+Memory::Tag
+Memory::swapThreadTag(Tag tag) {
+    o_assert_range_dbg(tag, NumTags());
+    tagEntry* prev = threadTag();
+    threadTag() = &tags[tag];
+    return prev ? Tag(prev - tags) : DefaultTag;
+}
+
+//------------------------------------------------------------------------------
+Memory::BackendScope::BackendScope(Backend::Code backend) {
+    o_assert_range(backend, Backend::NumBackends);
+    this->prevBackend = Memory::swapThreadBackend(backend);
+}
+
+//------------------------------------------------------------------------------
+Memory::BackendScope::~BackendScope() {
+    Memory::swapThreadBackend(this->prevBackend);
+}
+
+//------------------------------------------------------------------------------
+Memory::TagScope::TagScope(Tag tag) {
+    this->prevTag = Memory::swapThreadTag(tag);
+}
+
+//------------------------------------------------------------------------------
+Memory::TagScope::~TagScope() {
+    Memory::swapThreadTag(this->prevTag);
+}
+
 } // namespace Oryol
 
 
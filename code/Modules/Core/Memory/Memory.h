@@ -9,8 +9,34 @@
     differs by platforms (e.g. platforms with SSE support return 16-byte
     aligned memory.
     
-    @todo for now this simply calls malloc()/free(), may be more
-    advanced in the future.
+    Allocations are routed to one of several backends:
+    
+    - Backend::Malloc: the C runtime's malloc() (the default)
+    - Backend::TLSF: a Two-Level Segregated Fit heap with O(1) alloc
+      and free over a reserved region (see SetupTLSF())
+    
+    The global backend is selected with SetBackend(), and can be overridden
+    for the current thread with a BackendScope object. The backend of an
+    allocation is found by its address, so that memory can be freed
+    regardless of the currently selected backend, ReAlloc() keeps memory
+    in the backend it was allocated from. If the TLSF heap is exhausted,
+    the allocation falls back to malloc().
+    
+    Short-lived memory which is only used during the current frame can
+    be allocated explicitly with AllocFrame() from a linear frame arena
+    (see SetupFrameArena()). The frame arena belongs to the thread which
+    called SetupFrameArena(), this must be the main thread, since the
+    arena is reset from the Core post-RunLoop at the end of each frame,
+    which releases all frame allocations at once (calling Free() on them
+    is optional). AllocFrame() returns nullptr if the arena is exhausted.
+    
+    Each allocation is also associated with a tag for per-subsystem memory
+    statistics. Tags are registered with RegisterTag(), and are either
+    passed directly to Alloc(), or set for the current thread with a
+    TagScope object. GetTagStats() returns the current number of
+    bytes and allocations per tag. The statistics need a 16-byte header
+    in front of each allocation and are only tracked if ORYOL_MEMORY_STATS
+    is enabled (the default in debug builds and unit tests).
 */
 #include "Core/Types.h"
 #include "Core/Config.h"
@@ -21,8 +47,39 @@ namespace Oryol {
     
 class Memory {
 public:
+    /// memory allocator backends
+    struct Backend {
+        enum Code : uint8 {
+            Malloc = 0,
+            TLSF,
+            
+            NumBackends,
+        };
+    };
+    /// memory tag for per-subsystem statistics
+    typedef uint8 Tag;
+    /// the default tag
+    static const Tag DefaultTag = 0;
+    /// max number of tags
+    static const int32 MaxNumTags = 32;
+    /// per-tag allocation statistics
+    struct TagStats {
+        /// tag name
+        const char* Name = nullptr;
+        /// current number of allocated bytes
+        int64 NumBytes = 0;
+        /// current number of allocations
+        int32 NumAllocs = 0;
+        /// total number of allocations since start
+        int64 TotalAllocs = 0;
+    };
+
     /// allocate a raw chunk of memory
     static void* Alloc(int32 numBytes);
+    /// allocate a raw chunk of memory with explicit tag
+    static void* Alloc(int32 numBytes, Tag tag);
+    /// allocate memory from the frame arena, valid until the end of the frame
+    static void* AllocFrame(int32 numBytes);
     /// re-allocate a raw chunk of memory
     static void* ReAlloc(void* ptr, int32 numBytes);
     /// free a raw chunk of memory
@@ -49,6 +106,50 @@ public:
         ptr->~TYPE();
         Memory::Free(ptr);
     };
+    
+    /// reserve memory for the TLSF heap (call once before using Backend::TLSF)
+    static void SetupTLSF(int32 heapSize);
+    /// reserve memory for the frame arena (call once on the main thread)
+    static void SetupFrameArena(int32 arenaSize);
+    /// set the global allocator backend
+    static void SetBackend(Backend::Code backend);
+    /// get the allocator backend for the current thread
+    static Backend::Code GetBackend();
+    /// reset the frame arena, called at end of frame from Core post-RunLoop on the main thread
+    static void ResetFrameArena();
+    /// register a new tag
+    static Tag RegisterTag(const char* name);
+    /// get number of registered tags
+    static int32 NumTags();
+    /// get statistics of a tag
+    static TagStats GetTagStats(Tag tag);
+    
+    /// override the allocator backend for the current thread in a scope
+    class BackendScope {
+    public:
+        /// constructor
+        BackendScope(Backend::Code backend);
+        /// destructor
+        ~BackendScope();
+    private:
+        int32 prevBackend;
+    };
+    /// set the allocation tag for the current thread in a scope
+    class TagScope {
+    public:
+        /// constructor
+        TagScope(Tag tag);
+        /// destructor
+        ~TagScope();
+    private:
+        Tag prevTag;
+    };
+    
+private:
+    /// set thread-local backend override, return previous (-1 for none)
+    static int32 swapThreadBackend(int32 backend);
+    /// set thread-local tag, return previous
+    static Tag swapThreadTag(Tag tag);
 };
 
 //------------------------------------------------------------------------------
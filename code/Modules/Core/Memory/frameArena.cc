@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------
+//  frameArena.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "frameArena.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+frameArena::frameArena() :
+regionStart(nullptr),
+capacity(0),
+offset(0),
+numLiveAllocs(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+void
+frameArena::Setup(void* region, int32 regionSize) {
+    o_assert(!this->IsValid());
+    o_assert(nullptr != region);
+    uint8* start = (uint8*) Memory::Align(region, Alignment);
+    this->capacity = (regionSize - int32(start - (uint8*)region)) & ~(Alignment - 1);
+    o_assert(this->capacity > 0);
+    this->regionStart = start;
+    this->offset = 0;
+    this->numLiveAllocs = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+frameArena::Discard() {
+    o_assert(this->IsValid());
+    this->regionStart = nullptr;
+    this->capacity = 0;
+    this->offset = 0;
+    this->numLiveAllocs = 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+frameArena::IsValid() const {
+    return nullptr != this->regionStart;
+}
+
+//------------------------------------------------------------------------------
+void*
+frameArena::Alloc(int32 numBytes) {
+    o_assert_dbg(numBytes >= 0);
+    if (!this->IsValid()) {
+        return nullptr;
+    }
+    const int32 size = Memory::RoundUp(numBytes, Alignment);
+    if ((this->offset + size) > this->capacity) {
+        return nullptr;
+    }
+    const int32 start = this->offset;
+    this->offset += size;
+    this->numLiveAllocs++;
+    return this->regionStart + start;
+}
+
+//------------------------------------------------------------------------------
+void
+frameArena::Free(void* ptr) {
+    o_assert_dbg(this->Owns(ptr));
+    o_assert_dbg(this->numLiveAllocs > 0);
+    this->numLiveAllocs--;
+}
+
+//------------------------------------------------------------------------------
+int32
+frameArena::Reset() {
+    const int32 numLive = this->numLiveAllocs;
+    this->offset = 0;
+    this->numLiveAllocs = 0;
+    return numLive;
+}
+
+//------------------------------------------------------------------------------
+bool
+frameArena::Owns(const void* ptr) const {
+    return (ptr >= this->regionStart) && (ptr < (this->regionStart + this->capacity));
+}
+
+//------------------------------------------------------------------------------
+int32
+frameArena::UsedBytes() const {
+    return this->offset;
+}
+
+//------------------------------------------------------------------------------
+int32
+frameArena::Capacity() const {
+    return this->capacity;
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,58 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::frameArena
+    @ingroup _priv
+    @brief linear allocator which is reset once per frame
+
+    Allocation only bumps the current offset, Free() does nothing
+    except for book-keeping. All allocations are released at once by
+    Reset(), which Memory calls from the Core post-RunLoop at the end
+    of each frame. Reset() returns the number of allocations which
+    haven't been freed before the reset.
+
+    The arena is NOT thread-safe, Memory only uses it on the main thread.
+
+    All allocations are 16-byte aligned.
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+namespace _priv {
+
+class frameArena {
+public:
+    /// constructor
+    frameArena();
+
+    /// setup the arena in a memory region (the arena doesn't own the memory)
+    void Setup(void* region, int32 regionSize);
+    /// discard the arena
+    void Discard();
+    /// return true if the arena has been setup
+    bool IsValid() const;
+    /// allocate memory, return nullptr if the arena is exhausted
+    void* Alloc(int32 numBytes);
+    /// free memory (only book-keeping)
+    void Free(void* ptr);
+    /// reset the arena, return number of allocations which are still alive
+    int32 Reset();
+    /// return true if a pointer is inside the arena
+    bool Owns(const void* ptr) const;
+    /// get number of bytes allocated since last reset
+    int32 UsedBytes() const;
+    /// get the capacity of the arena in bytes
+    int32 Capacity() const;
+
+    /// alignment of all allocations
+    static const int32 Alignment = 16;
+
+private:
+    uint8* regionStart;
+    int32 capacity;
+    int32 offset;
+    int32 numLiveAllocs;
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+//  poolAllocator.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "poolAllocator.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#if ORYOL_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+namespace {
+struct slotEntry {
+    std::atomic<bool> used;
+};
+// NOTE: zero-initialized before any static constructors run
+slotEntry slots[poolThreadSlot::MaxSlots];
+// assigned to threads which didn't get a free slot
+slotEntry noSlot;
+}
+
+#if ORYOL_THREADLOCAL_PTHREAD
+// construct on first use, Memory::Alloc() may be called during static initialization
+static ThreadLocalPtr<slotEntry>& curSlotPtr() {
+    static ThreadLocalPtr<slotEntry> ptr;
+    return ptr;
+}
+#define curSlot curSlotPtr()
+#else
+static ORYOL_THREADLOCAL_PTR(slotEntry) curSlot = nullptr;
+#endif
+
+//------------------------------------------------------------------------------
+/**
+ Threads which don't go through Core::LeaveThread() (e.g. raw std::threads)
+ give their slot back in a thread-exit destructor, otherwise the slots
+ would leak until all threads fall back to the shared lists.
+*/
+#if ORYOL_HAS_THREADS
+static void releaseSlot(slotEntry* slot) {
+    if (slot && (&noSlot != slot)) {
+        slot->used.store(false, std::memory_order_release);
+    }
+    curSlot = &noSlot;
+}
+#if ORYOL_WINDOWS
+static DWORD exitKey = FLS_OUT_OF_INDEXES;
+static void NTAPI onThreadExit(void* ptr) {
+    releaseSlot((slotEntry*) ptr);
+}
+static void setThreadExitSlot(slotEntry* slot) {
+    static std::once_flag once;
+    std::call_once(once, [] { exitKey = FlsAlloc(onThreadExit); });
+    if (FLS_OUT_OF_INDEXES != exitKey) {
+        FlsSetValue(exitKey, slot);
+    }
+}
+#else
+static pthread_key_t exitKey;
+static void onThreadExit(void* ptr) {
+    releaseSlot((slotEntry*) ptr);
+}
+static void setThreadExitSlot(slotEntry* slot) {
+    static std::once_flag once;
+    std::call_once(once, [] { pthread_key_create(&exitKey, onThreadExit); });
+    pthread_setspecific(exitKey, slot);
+}
+#endif
+#endif
+
+//------------------------------------------------------------------------------
+int32
+poolThreadSlot::Index() {
+    slotEntry* slot = curSlot;
+    if (nullptr == slot) {
+        return acquire();
+    }
+    else if (&noSlot == slot) {
+        return InvalidIndex;
+    }
+    else {
+        return int32(slot - slots);
+    }
+}
+
+//------------------------------------------------------------------------------
+int32
+poolThreadSlot::acquire() {
+    for (int32 i = 0; i < MaxSlots; i++) {
+        if (!slots[i].used.load(std::memory_order_relaxed) &&
+            !slots[i].used.exchange(true, std::memory_order_acquire)) {
+            curSlot = &slots[i];
+            #if ORYOL_HAS_THREADS
+            setThreadExitSlot(&slots[i]);
+            #endif
+            return i;
+        }
+    }
+    curSlot = &noSlot;
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+void
+poolThreadSlot::Release() {
+    #if ORYOL_HAS_THREADS
+    slotEntry* slot = curSlot;
+    if (slot && (&noSlot != slot)) {
+        setThreadExitSlot(nullptr);
+    }
+    // don't grab a new slot if pool objects are destroyed after this point
+    releaseSlot(slot);
+    #else
+    curSlot = &noSlot;
+    #endif
+}
+
+} // namespace _priv
+} // namespace Oryol
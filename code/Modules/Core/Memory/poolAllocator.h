@@ -3,79 +3,127 @@
 /*
     @class Oryol::_priv::poolAllocator
     @ingroup _priv
- 
-    Thread-safe pool allocator with placement-new/delete. Uses 32-bit
-    tags with a unique-count masked-in for its forward-linked list 
-    instead of pointers because of the ABA problem (which I was actually 
-    running into with many threads and high object reuse). The pool
-    is split into up to 256 "puddles", where each puddle can hold
-    up to 256 elements. When no elements are in the free list, 
-    a new puddle is allocated. Thus one pool can hold up to
-    65536 elements.
+
+    Thread-safe pool allocator with placement-new/delete. Uses 64-bit
+    tags with a per-node generation count masked-in for its forward-linked
+    lists instead of pointers because of the ABA problem (which I was
+    actually running into with many threads and high object reuse).
+    The pool is split into up to 256 "puddles", the first puddle holds
+    256 elements, and each new puddle is twice as big as the previous
+    one (up to 64k elements per puddle), so that one pool can hold
+    around 16 million elements.
+
+    To reduce contention on the shared lists, each thread has a small
+    private cache of free elements (a "magazine") per pool. Create()
+    and Destroy() only work on the magazine, which doesn't need any
+    atomic operations. When a magazine runs empty it is refilled with
+    a whole chain of elements from the shared "depot" list, and when
+    it is full, half of it is moved back to the depot as one chain,
+    so that the shared state is only touched with one CAS operation
+    per chain of elements.
+
+    Threads get a magazine slot on first use and give it back in
+    Core::LeaveThread(), or in a thread-exit destructor for threads
+    which were not started through Oryol. If all slots are taken,
+    Create() and Destroy() fall back to the shared lists.
 */
 #include <atomic>
 #include <utility>
 #include "Core/Types.h"
+#include "Core/Config.h"
+#include "Core/Assertion.h"
 #include "Core/Memory/Memory.h"
 
 namespace Oryol {
 namespace _priv {
-    
+
+class poolThreadSlot {
+public:
+    /// max number of threads with magazines
+    static const int32 MaxSlots = 64;
+    /// get the current thread's slot index, return InvalidIndex if none available
+    static int32 Index();
+    /// give up the slot of the current thread (also called on thread exit)
+    static void Release();
+    /// invalid slot index
+    static const int32 InvalidIndex = -1;
+private:
+    /// acquire a new slot for the current thread
+    static int32 acquire();
+};
+
 template<class TYPE> class poolAllocator {
 public:
     /// constructor
     poolAllocator();
     /// destructor
     ~poolAllocator();
-    
+
     /// allocate and construct an object of type T
     template<typename... ARGS> TYPE* Create(ARGS&&... args);
     /// delete and free an object
     void Destroy(TYPE* obj);
-    
+    /// get number of allocated puddles
+    int32 NumPuddles() const;
+    /// get max number of elements in the currently allocated puddles
+    int32 Capacity() const;
+
 private:
     enum class nodeState : uint8 {
         init, free, used,
     };
-    
-    typedef uint32 nodeTag;    // [16bit counter] | [8bit puddle index ] | [8bit elm_index])
-    static const uint32 invalidTag = 0xFFFFFFFF;
+
+    typedef uint64 nodeTag;    // [16bit generation] | [8bit puddle index] | [24bit elm index]
+    static const nodeTag invalidTag = 0xFFFFFFFFFFFFFFFFULL;
 
     struct node {
-        nodeTag next;          // tag of next node
-        nodeTag myTag;        // my own tag
-        nodeState state;       // current state
-        uint8 padding[16 - (2*sizeof(nodeTag) + sizeof(nodeState))];      // pad to 16 bytes
+        std::atomic<nodeTag> next;  // tag of next node in free-list or depot
+        uint32 index;               // [8bit puddle index] | [24bit elm index]
+        uint16 generation;          // incremented each time the node is pushed
+        nodeState state;            // current state
+        uint8 padding;              // pad to 16 bytes
     };
 
-    /// pop a new node from the free-list, return 0 if empty
-    node* pop();
-    /// push a node onto the free-list
-    void push(node*);
-    /// allocate a new puddle and add entries to free-list
-    void allocPuddle();
+    static const int32 MagazineSize = 32;
+    struct magazine {
+        int32 num;
+        node* nodes[MagazineSize];
+    };
+
+    /// pop a node from a list, return nullptr if empty
+    node* pop(std::atomic<nodeTag>& head);
+    /// push a node (or the first node of a chain) onto a list
+    void push(std::atomic<nodeTag>& head, node* n);
+    /// link an array of nodes into a chain, return the chain head
+    static node* linkChain(node** nodes, int32 num);
+    /// link an array of nodes into a chain and push it to the depot
+    void pushChain(node** nodes, int32 num);
+    /// get pointer to the chain-link of a free node (stored in the object area)
+    static node** chainLink(node* n);
+    /// get the magazine of the current thread, or nullptr
+    magazine* threadMagazine();
+    /// allocate a new puddle, add all but the first chain to the depot and return the first chain
+    node* allocPuddle();
+    /// get number of elements in a puddle
+    static uint32 puddleNumElements(uint32 puddleIndex);
     /// get node address from a tag
     node* addressFromTag(nodeTag tag) const;
     /// get tag from a node address
     nodeTag tagFromAddress(node* n) const;
     /// test if a pointer is owned by this allocator (SLOW)
     bool isOwned(TYPE* obj) const;
-    
+
     static const uint32 MaxNumPuddles = 256;
-    static const uint32 NumPuddleElements = 256;
-    
+    static const uint32 MinPuddleElements = 256;
+    static const uint32 MaxPuddleElements = (1<<16);
+
     int32 elmSize;                      // offset to next element in bytes
 
-    #if ORYOL_HAS_ATOMIC
-        std::atomic<uint32> uniqueCount;
-        std::atomic<nodeTag> head;          // free-list head
-        std::atomic<uint32> numPuddles;     // current number of puddles
-    #else
-        uint32 uniqueCount;
-        nodeTag head;
-        uint32 numPuddles;
-    #endif
+    std::atomic<nodeTag> head;          // free-list head (single nodes)
+    std::atomic<nodeTag> depot;         // depot head (chains of up to MagazineSize nodes)
+    std::atomic<uint32> numPuddles;     // current number of puddles
     uint8* puddles[MaxNumPuddles];
+    magazine* magazines[poolThreadSlot::MaxSlots];
 };
 
 //------------------------------------------------------------------------------
@@ -83,20 +131,28 @@ template<class TYPE>
 poolAllocator<TYPE>::poolAllocator()
 {
     static_assert(sizeof(node) == 16, "pool_allocator::node should be 16 bytes!");
+    static_assert((MinPuddleElements % MagazineSize) == 0, "puddle size must be multiple of MagazineSize!");
 
     Memory::Clear(this->puddles, sizeof(this->puddles));
+    Memory::Clear(this->magazines, sizeof(this->magazines));
     this->numPuddles = 0;
     this->elmSize = Memory::RoundUp(sizeof(node) + sizeof(TYPE), sizeof(node));
     o_assert((this->elmSize & (sizeof(node) - 1)) == 0);
     o_assert(this->elmSize >= (int32)(2*sizeof(node)));
-    this->uniqueCount = 0;
     this->head = invalidTag;
+    this->depot = invalidTag;
 }
 
 //------------------------------------------------------------------------------
 template<class TYPE>
 poolAllocator<TYPE>::~poolAllocator() {
 
+    for (int32 i = 0; i < poolThreadSlot::MaxSlots; i++) {
+        if (this->magazines[i]) {
+            Memory::Free(this->magazines[i]);
+            this->magazines[i] = nullptr;
+        }
+    }
     const uint32 num = this->numPuddles;
     for (uint32 i = 0; i < num; i++) {
         Memory::Free(this->puddles[i]);
@@ -104,12 +160,35 @@ poolAllocator<TYPE>::~poolAllocator() {
     }
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+poolAllocator<TYPE>::NumPuddles() const {
+    return this->numPuddles.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+poolAllocator<TYPE>::Capacity() const {
+    const uint32 num = this->numPuddles.load(std::memory_order_relaxed);
+    int32 capacity = 0;
+    for (uint32 i = 0; i < num; i++) {
+        capacity += puddleNumElements(i);
+    }
+    return capacity;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> uint32
+poolAllocator<TYPE>::puddleNumElements(uint32 puddleIndex) {
+    return (puddleIndex < 8) ? (MinPuddleElements << puddleIndex) : MaxPuddleElements;
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE>
 typename poolAllocator<TYPE>::node*
 poolAllocator<TYPE>::addressFromTag(nodeTag tag) const {
-    uint32 elmIndex = tag & 0xFF;
-    uint32 puddleIndex = (tag & 0xFF00) >> 8;
+    uint32 elmIndex = tag & 0x00FFFFFF;
+    uint32 puddleIndex = (tag & 0xFF000000) >> 24;
     uint8* ptr = this->puddles[puddleIndex] + elmIndex * elmSize;
     return (node*) ptr;
 }
@@ -119,7 +198,7 @@ template<class TYPE>
 typename poolAllocator<TYPE>::nodeTag
 poolAllocator<TYPE>::tagFromAddress(node* n) const {
     o_assert(nullptr != n);
-    nodeTag tag = n->myTag;
+    nodeTag tag = (nodeTag(n->generation) << 32) | n->index;
     #if ORYOL_ALLOCATOR_DEBUG
     o_assert(n == addressFromTag(tag));
     #endif
@@ -127,115 +206,176 @@ poolAllocator<TYPE>::tagFromAddress(node* n) const {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
+template<class TYPE>
+typename poolAllocator<TYPE>::node**
+poolAllocator<TYPE>::chainLink(node* n) {
+    return (node**) (n + 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+typename poolAllocator<TYPE>::magazine*
+poolAllocator<TYPE>::threadMagazine() {
+    const int32 slot = poolThreadSlot::Index();
+    if (poolThreadSlot::InvalidIndex == slot) {
+        return nullptr;
+    }
+    // a slot is only owned by one thread at a time, so no need to synchronize
+    magazine* mag = this->magazines[slot];
+    if (nullptr == mag) {
+        mag = (magazine*) Memory::Alloc(sizeof(magazine));
+        mag->num = 0;
+        this->magazines[slot] = mag;
+    }
+    return mag;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+typename poolAllocator<TYPE>::node*
 poolAllocator<TYPE>::allocPuddle() {
 
     // increment the puddle-counter (this must happen first because the
     // method can be called from different threads
-    #if ORYOL_HAS_ATOMIC
-        uint32 newPuddleIndex = this->numPuddles.fetch_add(1, std::memory_order_relaxed);
-    #else 
-        uint32 newPuddleIndex = this->numPuddles++;
-    #endif
+    uint32 newPuddleIndex = this->numPuddles.fetch_add(1, std::memory_order_relaxed);
     o_assert(newPuddleIndex < MaxNumPuddles);
-    
+
     // allocate new puddle
-    const uint32 puddleByteSize = NumPuddleElements * this->elmSize;
+    const uint32 numElements = puddleNumElements(newPuddleIndex);
+    const uint32 puddleByteSize = numElements * this->elmSize;
     this->puddles[newPuddleIndex] = (uint8*) Memory::Alloc(puddleByteSize);
     Memory::Clear(this->puddles[newPuddleIndex], puddleByteSize);
-    
-    // populate the free stack
-    for (int32 elmIndex = (NumPuddleElements - 1); elmIndex >= 0; elmIndex--) {
+
+    // populate the depot with chains of MagazineSize elements, the first
+    // chain is returned to the caller, so that other threads can't steal it
+    node* firstChain = nullptr;
+    node* chain[MagazineSize];
+    for (uint32 elmIndex = 0; elmIndex < numElements; elmIndex++) {
         uint8* ptr = this->puddles[newPuddleIndex] + elmIndex * this->elmSize;
         node* nodePtr = (node*) ptr;
-        nodePtr->next  = invalidTag;
-        nodePtr->myTag = (newPuddleIndex << 8) | elmIndex;
-        nodePtr->state = nodeState::init;
-        this->push(nodePtr);
+        nodePtr->next = invalidTag;
+        nodePtr->index = (newPuddleIndex << 24) | elmIndex;
+        nodePtr->generation = 0;
+        nodePtr->state = nodeState::free;
+        chain[elmIndex % MagazineSize] = nodePtr;
+        if ((MagazineSize - 1) == (elmIndex % MagazineSize)) {
+            if (nullptr == firstChain) {
+                firstChain = linkChain(chain, MagazineSize);
+            }
+            else {
+                this->pushChain(chain, MagazineSize);
+            }
+        }
     }
+    return firstChain;
 }
 
 //------------------------------------------------------------------------------
 template<class TYPE> void
-poolAllocator<TYPE>::push(node* newHead) {
-    
+poolAllocator<TYPE>::push(std::atomic<nodeTag>& listHead, node* newHead) {
+
     // see http://www.boost.org/doc/libs/1_53_0/boost/lockfree/stack.hpp
-    o_assert((nodeState::init == newHead->state) || (nodeState::used == newHead->state));
-    
-    o_assert(invalidTag == newHead->next);
-    #if ORYOL_ALLOCATOR_DEBUG
-    Memory::Fill((void*) (newHead + 1), sizeof(TYPE), 0xAA);
-    #endif
-    
-    newHead->state = nodeState::free;
-    newHead->myTag = (newHead->myTag & 0x0000FFFF) | (++this->uniqueCount & 0xFFFF) << 16;
-    #if ORYOL_HAS_ATOMIC
-        nodeTag oldHeadTag = this->head.load(std::memory_order_relaxed);
-        for (;;) {
-            newHead->next = oldHeadTag;
-            if (this->head.compare_exchange_weak(oldHeadTag, newHead->myTag)) {
-                break;
-            }
+    o_assert(nodeState::free == newHead->state);
+    newHead->generation++;
+    const nodeTag newHeadTag = this->tagFromAddress(newHead);
+    nodeTag oldHeadTag = listHead.load(std::memory_order_relaxed);
+    for (;;) {
+        newHead->next.store(oldHeadTag, std::memory_order_relaxed);
+        if (listHead.compare_exchange_weak(oldHeadTag, newHeadTag, std::memory_order_release, std::memory_order_relaxed)) {
+            break;
         }
-    #else
-        nodeTag oldHeadTag = this->head;
-        newHead->next = oldHeadTag;
-        this->head = newHead->myTag;
-    #endif
+    }
 }
 
 //------------------------------------------------------------------------------
 template<class TYPE>
 typename poolAllocator<TYPE>::node*
-poolAllocator<TYPE>::pop()
+poolAllocator<TYPE>::pop(std::atomic<nodeTag>& listHead)
 {
     // see http://www.boost.org/doc/libs/1_53_0/boost/lockfree/stack.hpp
+    nodeTag oldHeadTag = listHead.load(std::memory_order_acquire);
     for (;;) {
-        #if ORYOL_HAS_ATOMIC
-            nodeTag oldHeadTag = this->head.load(std::memory_order_consume);
-        #else 
-            nodeTag oldHeadTag = this->head;
-        #endif
         if (invalidTag == oldHeadTag) {
             return nullptr;
         }
-        nodeTag newHeadTag = this->addressFromTag(oldHeadTag)->next;
-        #if ORYOL_HAS_ATOMIC
-        if (this->head.compare_exchange_weak(oldHeadTag, newHeadTag)) {
-        #else
-        this->head = newHeadTag;
-        #endif
-            o_assert(invalidTag != oldHeadTag);
+        // NOTE: the node may be popped and reused by another thread
+        // at any time, in this case the next-tag is garbage, but the
+        // compare-exchange will fail because of the generation count
+        nodeTag newHeadTag = this->addressFromTag(oldHeadTag)->next.load(std::memory_order_relaxed);
+        if (listHead.compare_exchange_weak(oldHeadTag, newHeadTag, std::memory_order_acquire, std::memory_order_acquire)) {
             node* nodePtr = this->addressFromTag(oldHeadTag);
             o_assert(nodeState::free == nodePtr->state);
-            #if ORYOL_ALLOCATOR_DEBUG
-            Memory::Fill((void*) (nodePtr+ 1), sizeof(TYPE), 0xBB);
-            #endif
-            nodePtr->next = invalidTag;
-            nodePtr->state = nodeState::used;
             return nodePtr;
-        #if ORYOL_HAS_ATOMIC
         }
-        #endif
     }
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE>
+typename poolAllocator<TYPE>::node*
+poolAllocator<TYPE>::linkChain(node** nodes, int32 num) {
+    o_assert_dbg((num > 0) && (num <= MagazineSize));
+
+    // the chain links are stored in the unused object area of the free
+    // nodes, they are only read by the thread which owns the chain
+    for (int32 i = 0; i < (num - 1); i++) {
+        *chainLink(nodes[i]) = nodes[i + 1];
+    }
+    *chainLink(nodes[num - 1]) = nullptr;
+    return nodes[0];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+poolAllocator<TYPE>::pushChain(node** nodes, int32 num) {
+    this->push(this->depot, linkChain(nodes, num));
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE>
 template<typename... ARGS> TYPE*
 poolAllocator<TYPE>::Create(ARGS&&... args) {
-    
-    // pop a new node from the free-stack
-    node* n = this->pop();
-    if (nullptr == n) {
-        // need to allocate a new puddle
-        this->allocPuddle();
-        n = this->pop();
+
+    node* n = nullptr;
+    magazine* mag = this->threadMagazine();
+    if (mag && (mag->num > 0)) {
+        // fast path: take a node from the thread's magazine
+        n = mag->nodes[--mag->num];
+    }
+    else {
+        // try single nodes first (only used by threads without magazines)
+        n = this->pop(this->head);
+        if (nullptr == n) {
+            // grab a chain from the depot, allocate a new puddle if empty
+            node* chain = this->pop(this->depot);
+            if (nullptr == chain) {
+                chain = this->allocPuddle();
+            }
+            o_assert(nullptr != chain);
+            n = chain;
+            chain = *chainLink(chain);
+            if (mag) {
+                // move the rest of the chain into the magazine
+                while (chain) {
+                    mag->nodes[mag->num++] = chain;
+                    chain = *chainLink(chain);
+                }
+            }
+            else if (chain) {
+                // no magazine, put the rest back as a shorter chain
+                this->push(this->depot, chain);
+            }
+        }
     }
     o_assert(nullptr != n);
-    
+    o_assert(nodeState::free == n->state);
+    n->state = nodeState::used;
+
     // construct with placement new
     void* objPtr = (void*) (n + 1);
+    #if ORYOL_ALLOCATOR_DEBUG
+    Memory::Fill(objPtr, sizeof(TYPE), 0xBB);
+    #endif
     TYPE* obj = new(objPtr) TYPE(std::forward<ARGS>(args)...);
     o_assert(obj == objPtr);
     return obj;
@@ -247,7 +387,7 @@ poolAllocator<TYPE>::isOwned(TYPE* obj) const {
     const uint32 num = this->numPuddles;
     for (uint32 i = 0; i < num; i++) {
         const uint8* start = this->puddles[i];
-        const uint8* end = this->puddles[i] + NumPuddleElements * this->elmSize;
+        const uint8* end = this->puddles[i] + puddleNumElements(i) * this->elmSize;
         const uint8* ptr = (uint8*) obj;
         if ((ptr >= start) && (ptr < end)) {
             return true;
@@ -259,18 +399,36 @@ poolAllocator<TYPE>::isOwned(TYPE* obj) const {
 //------------------------------------------------------------------------------
 template<class TYPE> void
 poolAllocator<TYPE>::Destroy(TYPE* obj) {
-    
+
     #if ORYOL_ALLOCATOR_DEBUG
     // make sure this object has been allocated by us
     o_assert(this->isOwned(obj));
     #endif
-    
+
     // call destructor on obj
     obj->~TYPE();
-    
-    // push the pool element back on the free-stack
+
     node* n = ((node*)obj) - 1;
-    push(n);
+    o_assert(nodeState::used == n->state);
+    n->state = nodeState::free;
+    #if ORYOL_ALLOCATOR_DEBUG
+    Memory::Fill((void*) (n + 1), sizeof(TYPE), 0xAA);
+    #endif
+
+    magazine* mag = this->threadMagazine();
+    if (mag) {
+        if (MagazineSize == mag->num) {
+            // magazine is full, move the upper half to the depot
+            const int32 half = MagazineSize / 2;
+            this->pushChain(&mag->nodes[half], half);
+            mag->num = half;
+        }
+        mag->nodes[mag->num++] = n;
+    }
+    else {
+        // push the pool element back on the free-stack
+        this->push(this->head, n);
+    }
 }
 
 } // namespace _priv
@@ -0,0 +1,407 @@
+//------------------------------------------------------------------------------
+//  tlsfHeap.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "tlsfHeap.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#if ORYOL_WINDOWS
+#include <intrin.h>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+/**
+ Find last (most significant) set bit, val must not be 0.
+*/
+static inline int32
+tlsf_fls(uint64 val) {
+    #if defined(__GNUC__)
+    return 63 - __builtin_clzll(val);
+    #elif ORYOL_WINDOWS && defined(_WIN64)
+    unsigned long index;
+    _BitScanReverse64(&index, val);
+    return int32(index);
+    #else
+    int32 bit = 63;
+    while (0 == (val & (uint64(1) << bit))) {
+        bit--;
+    }
+    return bit;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+ Find first (least significant) set bit, val must not be 0.
+*/
+static inline int32
+tlsf_ffs(uint32 val) {
+    #if defined(__GNUC__)
+    return __builtin_ctz(val);
+    #elif ORYOL_WINDOWS
+    unsigned long index;
+    _BitScanForward(&index, val);
+    return int32(index);
+    #else
+    int32 bit = 0;
+    while (0 == (val & (1 << bit))) {
+        bit++;
+    }
+    return bit;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+tlsfHeap::tlsfHeap() :
+regionStart(nullptr),
+regionEnd(nullptr),
+usedBytes(0),
+flBitmap(0) {
+    Memory::Clear(this->slBitmap, sizeof(this->slBitmap));
+    Memory::Clear(this->blocks, sizeof(this->blocks));
+}
+
+//------------------------------------------------------------------------------
+inline uint64
+tlsfHeap::blockSize(const block* b) {
+    return b->sizeAndFlags & ~flagMask;
+}
+
+//------------------------------------------------------------------------------
+inline void
+tlsfHeap::setBlockSize(block* b, uint64 size) {
+    b->sizeAndFlags = size | (b->sizeAndFlags & flagMask);
+}
+
+//------------------------------------------------------------------------------
+inline bool
+tlsfHeap::isFree(const block* b) {
+    return 0 != (b->sizeAndFlags & freeBit);
+}
+
+//------------------------------------------------------------------------------
+inline bool
+tlsfHeap::isPrevFree(const block* b) {
+    return 0 != (b->sizeAndFlags & prevFreeBit);
+}
+
+//------------------------------------------------------------------------------
+inline void
+tlsfHeap::setFlag(block* b, uint64 flag, bool set) {
+    if (set) {
+        b->sizeAndFlags |= flag;
+    }
+    else {
+        b->sizeAndFlags &= ~flag;
+    }
+}
+
+//------------------------------------------------------------------------------
+inline tlsfHeap::freeLinks*
+tlsfHeap::links(block* b) {
+    return (freeLinks*) (b + 1);
+}
+
+//------------------------------------------------------------------------------
+inline void*
+tlsfHeap::payload(block* b) {
+    return (void*) (b + 1);
+}
+
+//------------------------------------------------------------------------------
+inline tlsfHeap::block*
+tlsfHeap::fromPayload(void* ptr) {
+    return ((block*)ptr) - 1;
+}
+
+//------------------------------------------------------------------------------
+inline tlsfHeap::block*
+tlsfHeap::nextPhys(const block* b) {
+    return (block*) (((uint8*)(b + 1)) + blockSize(b));
+}
+
+//------------------------------------------------------------------------------
+void
+tlsfHeap::mappingInsert(uint64 size, int32& outFl, int32& outSl) {
+    if (size < uint64(smallBlockSize)) {
+        // small blocks are stored in the first list
+        outFl = 0;
+        outSl = int32(size) / (smallBlockSize / slIndexCount);
+    }
+    else {
+        const int32 fl = tlsf_fls(size);
+        outSl = int32(size >> (fl - slIndexCountLog2)) ^ slIndexCount;
+        outFl = fl - (flIndexShift - 1);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+tlsfHeap::mappingSearch(uint64 size, int32& outFl, int32& outSl) {
+    // round up to the next list, so that any block in that list is big enough
+    if (size >= uint64(smallBlockSize)) {
+        const uint64 round = (uint64(1) << (tlsf_fls(size) - slIndexCountLog2)) - 1;
+        size += round;
+    }
+    mappingInsert(size, outFl, outSl);
+}
+
+//------------------------------------------------------------------------------
+tlsfHeap::block*
+tlsfHeap::searchSuitableBlock(int32& fl, int32& sl) {
+    if (fl >= flIndexCount) {
+        return nullptr;
+    }
+    // first search in the second-level list of the same first-level
+    uint32 slMap = this->slBitmap[fl] & (~0u << sl);
+    if (0 == slMap) {
+        // no block there, search the next bigger first-level list
+        const uint32 flMap = (fl + 1) < 32 ? (this->flBitmap & (~0u << (fl + 1))) : 0;
+        if (0 == flMap) {
+            // out of memory
+            return nullptr;
+        }
+        fl = tlsf_ffs(flMap);
+        slMap = this->slBitmap[fl];
+    }
+    o_assert_dbg(0 != slMap);
+    sl = tlsf_ffs(slMap);
+    return this->blocks[fl][sl];
+}
+
+//------------------------------------------------------------------------------
+void
+tlsfHeap::insertBlock(block* b) {
+    int32 fl, sl;
+    mappingInsert(blockSize(b), fl, sl);
+    block* cur = this->blocks[fl][sl];
+    links(b)->next = cur;
+    links(b)->prev = nullptr;
+    if (cur) {
+        links(cur)->prev = b;
+    }
+    this->blocks[fl][sl] = b;
+    this->flBitmap |= (1u << fl);
+    this->slBitmap[fl] |= (1u << sl);
+}
+
+//------------------------------------------------------------------------------
+void
+tlsfHeap::removeBlock(block* b) {
+    int32 fl, sl;
+    mappingInsert(blockSize(b), fl, sl);
+    block* prev = links(b)->prev;
+    block* next = links(b)->next;
+    if (next) {
+        links(next)->prev = prev;
+    }
+    if (prev) {
+        links(prev)->next = next;
+    }
+    else {
+        // block was list head
+        o_assert_dbg(this->blocks[fl][sl] == b);
+        this->blocks[fl][sl] = next;
+        if (nullptr == next) {
+            this->slBitmap[fl] &= ~(1u << sl);
+            if (0 == this->slBitmap[fl]) {
+                this->flBitmap &= ~(1u << fl);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+tlsfHeap::Setup(void* region, int32 regionSize) {
+    o_assert(!this->IsValid());
+    o_assert(nullptr != region);
+
+    // align the region start and end
+    uint8* start = (uint8*) Memory::Align(region, Alignment);
+    uint8* end = (uint8*) ((intptr(region) + regionSize) & ~intptr(Alignment - 1));
+    o_assert((end - start) >= (2 * headerSize + minBlockSize));
+    this->regionStart = start;
+    this->regionEnd = end;
+    this->usedBytes = 0;
+
+    // one big free block, followed by a zero-size used sentinel block
+    block* b = (block*) start;
+    b->sizeAndFlags = 0;
+    b->prevPhys = nullptr;
+    setBlockSize(b, uint64((end - start) - 2 * headerSize));
+    setFlag(b, freeBit, true);
+    this->insertBlock(b);
+
+    block* sentinel = nextPhys(b);
+    o_assert_dbg((uint8*)(sentinel + 1) == end);
+    sentinel->sizeAndFlags = 0;
+    sentinel->prevPhys = b;
+    setFlag(sentinel, prevFreeBit, true);
+}
+
+//------------------------------------------------------------------------------
+void
+tlsfHeap::Discard() {
+    o_assert(this->IsValid());
+    this->regionStart = nullptr;
+    this->regionEnd = nullptr;
+    this->usedBytes = 0;
+    this->flBitmap = 0;
+    Memory::Clear(this->slBitmap, sizeof(this->slBitmap));
+    Memory::Clear(this->blocks, sizeof(this->blocks));
+}
+
+//------------------------------------------------------------------------------
+bool
+tlsfHeap::IsValid() const {
+    return nullptr != this->regionStart;
+}
+
+//------------------------------------------------------------------------------
+bool
+tlsfHeap::Owns(const void* ptr) const {
+    return (ptr >= this->regionStart) && (ptr < this->regionEnd);
+}
+
+//------------------------------------------------------------------------------
+int32
+tlsfHeap::Size(const void* ptr) const {
+    o_assert_dbg(this->Owns(ptr));
+    const block* b = fromPayload((void*)ptr);
+    o_assert_dbg(!isFree(b));
+    return int32(blockSize(b));
+}
+
+//------------------------------------------------------------------------------
+int32
+tlsfHeap::UsedBytes() const {
+    return this->usedBytes;
+}
+
+//------------------------------------------------------------------------------
+void*
+tlsfHeap::Alloc(int32 numBytes) {
+    o_assert_dbg(this->IsValid());
+    o_assert_dbg(numBytes >= 0);
+    uint64 size = Memory::RoundUp(numBytes, Alignment);
+    if (size < uint64(minBlockSize)) {
+        size = minBlockSize;
+    }
+
+    // find a free block
+    int32 fl = 0, sl = 0;
+    mappingSearch(size, fl, sl);
+    block* b = this->searchSuitableBlock(fl, sl);
+    if (nullptr == b) {
+        return nullptr;
+    }
+    o_assert_dbg(isFree(b) && (blockSize(b) >= size));
+    this->removeBlock(b);
+
+    // split off the remainder if it is big enough for another block
+    block* next = nextPhys(b);
+    const uint64 remainSize = blockSize(b) - size;
+    if (remainSize >= uint64(headerSize + minBlockSize)) {
+        setBlockSize(b, size);
+        block* remain = nextPhys(b);
+        remain->sizeAndFlags = 0;
+        remain->prevPhys = b;
+        setBlockSize(remain, remainSize - headerSize);
+        setFlag(remain, freeBit, true);
+        next->prevPhys = remain;
+        this->insertBlock(remain);
+        next = remain;
+    }
+    else {
+        setFlag(next, prevFreeBit, false);
+    }
+    setFlag(b, freeBit, false);
+    this->usedBytes += int32(blockSize(b));
+    return payload(b);
+}
+
+//------------------------------------------------------------------------------
+void
+tlsfHeap::Free(void* ptr) {
+    o_assert_dbg(this->Owns(ptr));
+    block* b = fromPayload(ptr);
+    o_assert_dbg(!isFree(b));
+    this->usedBytes -= int32(blockSize(b));
+    setFlag(b, freeBit, true);
+
+    // merge with previous block
+    if (isPrevFree(b)) {
+        block* prev = b->prevPhys;
+        o_assert_dbg(prev && isFree(prev));
+        this->removeBlock(prev);
+        setBlockSize(prev, blockSize(prev) + headerSize + blockSize(b));
+        nextPhys(prev)->prevPhys = prev;
+        b = prev;
+    }
+    // merge with next block
+    block* next = nextPhys(b);
+    if (isFree(next)) {
+        this->removeBlock(next);
+        setBlockSize(b, blockSize(b) + headerSize + blockSize(next));
+        next = nextPhys(b);
+        next->prevPhys = b;
+    }
+    setFlag(next, prevFreeBit, true);
+    this->insertBlock(b);
+}
+
+//------------------------------------------------------------------------------
+bool
+tlsfHeap::Check() const {
+    o_assert(this->IsValid());
+    const block* prev = nullptr;
+    const block* b = (const block*) this->regionStart;
+    int32 used = 0;
+    for (;;) {
+        if (b->prevPhys != prev) {
+            return false;
+        }
+        if (prev && (isFree(prev) != isPrevFree(b))) {
+            return false;
+        }
+        if (0 == blockSize(b)) {
+            // reached the sentinel
+            break;
+        }
+        if (isFree(b)) {
+            // 2 free blocks must never be neighbours
+            if (prev && isFree(prev)) {
+                return false;
+            }
+            // must be in the right free list
+            int32 fl, sl;
+            mappingInsert(blockSize(b), fl, sl);
+            bool found = false;
+            for (const block* cur = this->blocks[fl][sl]; cur; cur = links((block*)cur)->next) {
+                if (cur == b) {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                return false;
+            }
+        }
+        else {
+            used += int32(blockSize(b));
+        }
+        prev = b;
+        b = nextPhys(b);
+        if ((const uint8*)b >= this->regionEnd) {
+            return false;
+        }
+    }
+    return ((const uint8*)(b + 1) == this->regionEnd) && (used == this->usedBytes);
+}
+
+} // namespace _priv
+} // namespace Oryol
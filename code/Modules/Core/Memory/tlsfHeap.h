@@ -0,0 +1,107 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::tlsfHeap
+    @ingroup _priv
+    @brief Two-Level Segregated Fit heap over a fixed memory region
+
+    A general-purpose heap with O(1) allocation and free, see
+    "TLSF: a New Dynamic Memory Allocator for Real-Time Systems"
+    (Masmano, Ripoll, Crespo, Real). Free blocks are kept in
+    segregated lists, the first level splits by power-of-2 size
+    classes, the second level splits each first level class linearly
+    into 16 lists. Two bitmaps allow to find a matching non-empty list
+    with a couple of bit-scan instructions. Neighbouring free blocks
+    are merged immediately.
+
+    All allocations are 16-byte aligned. The heap is NOT thread-safe,
+    Memory wraps it with a lock.
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+namespace _priv {
+
+class tlsfHeap {
+public:
+    /// constructor
+    tlsfHeap();
+
+    /// setup the heap in a memory region (the heap doesn't own the memory)
+    void Setup(void* region, int32 regionSize);
+    /// discard the heap
+    void Discard();
+    /// return true if the heap has been setup
+    bool IsValid() const;
+    /// allocate memory block, return nullptr if heap is exhausted
+    void* Alloc(int32 numBytes);
+    /// free a memory block
+    void Free(void* ptr);
+    /// return true if a pointer is inside the heap region
+    bool Owns(const void* ptr) const;
+    /// get the payload size of an allocated block (at least the requested size)
+    int32 Size(const void* ptr) const;
+    /// get number of bytes in allocated blocks (without block headers)
+    int32 UsedBytes() const;
+    /// walk all blocks and check heap consistency (SLOW)
+    bool Check() const;
+
+    /// alignment of all blocks
+    static const int32 Alignment = 16;
+
+private:
+    /// block header, 16 bytes on all platforms to keep payload alignment
+    struct alignas(16) block {
+        uint64 sizeAndFlags;        // payload size | free bit | prev-free bit
+        block* prevPhys;            // previous physical block
+    };
+    /// free-list links, stored in the payload of free blocks
+    struct freeLinks {
+        block* next;
+        block* prev;
+    };
+
+    static const uint64 freeBit = 1;
+    static const uint64 prevFreeBit = 2;
+    static const uint64 flagMask = 3;
+    static const int32 headerSize = sizeof(block);
+    static const int32 minBlockSize = sizeof(freeLinks) > 16 ? sizeof(freeLinks) : 16;
+    static const int32 slIndexCountLog2 = 4;
+    static const int32 slIndexCount = 1 << slIndexCountLog2;
+    static const int32 flIndexShift = slIndexCountLog2 + 4;    // log2(Alignment)
+    static const int32 flIndexMax = 31;
+    static const int32 flIndexCount = flIndexMax - flIndexShift + 1;
+    static const int32 smallBlockSize = 1 << flIndexShift;
+
+    /// block helpers
+    static uint64 blockSize(const block* b);
+    static void setBlockSize(block* b, uint64 size);
+    static bool isFree(const block* b);
+    static bool isPrevFree(const block* b);
+    static void setFlag(block* b, uint64 flag, bool set);
+    static freeLinks* links(block* b);
+    static void* payload(block* b);
+    static block* fromPayload(void* ptr);
+    static block* nextPhys(const block* b);
+
+    /// find first-/second-level index for a size
+    static void mappingInsert(uint64 size, int32& outFl, int32& outSl);
+    /// round up size to next list and find first-/second-level index
+    static void mappingSearch(uint64 size, int32& outFl, int32& outSl);
+    /// find a free block of at least the size class of fl/sl
+    block* searchSuitableBlock(int32& fl, int32& sl);
+    /// insert a free block into the free lists
+    void insertBlock(block* b);
+    /// remove a free block from the free lists
+    void removeBlock(block* b);
+
+    uint8* regionStart;
+    uint8* regionEnd;
+    int32 usedBytes;
+    uint32 flBitmap;
+    uint32 slBitmap[flIndexCount];
+    block* blocks[flIndexCount][slIndexCount];
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -53,7 +53,10 @@ RefCounted::addRef() const {
 inline void
 RefCounted::release() const {
     #if ORYOL_HAS_ATOMIC
-    if (1 == this->refCount.fetch_sub(1, std::memory_order_relaxed)) {
+    // the decrement must be acq_rel, so that all accesses to the object from
+    // other threads happen-before the destruction (messages are handed
+    // between threads through lock-free queues)
+    if (1 == this->refCount.fetch_sub(1, std::memory_order_acq_rel)) {
     #else
     if (1 == this->refCount--) {
     #endif
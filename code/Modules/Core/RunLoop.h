@@ -27,6 +27,7 @@
 #include "Core/RefCounted.h"
 #include "Core/String/StringAtom.h"
 #include "Core/Containers/Map.h"
+#include "Core/Containers/Set.h"
 
 namespace Oryol {
 
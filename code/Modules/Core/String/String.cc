@@ -143,7 +143,8 @@ void
 String::release() {
     if (nullptr != this->data) {
         #if ORYOL_HAS_ATOMIC
-        if (1 == this->data->refCount.fetch_sub(1, std::memory_order_relaxed)) {
+        // acq_rel so that the last owner sees all writes before destroying the data
+        if (1 == this->data->refCount.fetch_sub(1, std::memory_order_acq_rel)) {
         #else
         if (1 == this->data->refCount--) {
         #endif
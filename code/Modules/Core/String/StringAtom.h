@@ -6,8 +6,10 @@
     @brief immutable, unique strings for fast comparison
     
     A unique string, relatively slow on creation, but fast for comparison.
-    String atoms are stored in thread-local stringAtomTables and comparison
-    is fastest in the creator thread.
+    String atoms are stored in a process-global stringAtomTable, so
+    StringAtoms from different threads can be compared by pointer.
+    Creating an atom for a string which already exists in the table
+    never takes a lock.
     
     @see String
 */
@@ -28,7 +30,9 @@ public:
     StringAtom(const char* str);
     /// construct from raw string (slow)
     StringAtom(const uchar* str);
-    /// copy-constructor (fast if rhs was created in same thread)
+    /// construct from len characters, str doesn't need to be null-terminated (slow)
+    StringAtom(const char* str, int32 len);
+    /// copy-constructor (fast)
     StringAtom(const StringAtom& rhs);
     /// move-constructor
     StringAtom(StringAtom&& rhs);
@@ -80,10 +84,10 @@ public:
     String AsString() const;
 
 private:
-    /// copy content
-    void copy(const StringAtom& rhs);
     /// setup from C string
     void setupFromCString(const char* str);
+    /// setup from character range
+    void setupFromChars(const char* str, int32 len);
     
     const stringAtomBuffer::Header* data;
     static const char* emptyString;
@@ -116,14 +120,21 @@ StringAtom::StringAtom(const uchar* rhs) {
 
 //------------------------------------------------------------------------------
 inline
-StringAtom::StringAtom(const StringAtom& rhs) {
-    this->copy(rhs);
+StringAtom::StringAtom(const char* str, int32 len) {
+    this->setupFromChars(str, len);
 }
 
 //------------------------------------------------------------------------------
 inline
-StringAtom::StringAtom(StringAtom&& rhs) {
-    this->copy(rhs);
+StringAtom::StringAtom(const StringAtom& rhs) :
+data(rhs.data) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline
+StringAtom::StringAtom(StringAtom&& rhs) :
+data(rhs.data) {
     rhs.data = nullptr;
 }
 
@@ -136,18 +147,14 @@ StringAtom::~StringAtom() {
 //------------------------------------------------------------------------------
 inline void
 StringAtom::operator=(const StringAtom& rhs) {
-    if (&rhs != this) {
-        this->Clear();
-        this->copy(rhs);
-    }
+    this->data = rhs.data;
 }
 
 //------------------------------------------------------------------------------
 inline void
 StringAtom::operator=(StringAtom&& rhs) {
     if (&rhs != this) {
-        this->Clear();
-        this->copy(rhs);
+        this->data = rhs.data;
         rhs.data = nullptr;
     }
 }
@@ -166,6 +173,12 @@ StringAtom::operator=(const uchar* rhs) {
     this->setupFromCString((const char*)rhs);
 }
 
+//------------------------------------------------------------------------------
+inline bool
+StringAtom::operator==(const StringAtom& rhs) const {
+    return this->data == rhs.data;
+}
+
 //------------------------------------------------------------------------------
 inline bool
 StringAtom::operator!=(const StringAtom& rhs) const {
@@ -175,10 +188,6 @@ StringAtom::operator!=(const StringAtom& rhs) const {
 //------------------------------------------------------------------------------
 inline bool
 StringAtom::operator<(const StringAtom& rhs) const {
-    if (rhs.data && this->data) {
-        // it is forbidden to compare string from different threads!
-        o_assert(this->data->table == rhs.data->table);
-    }
     return this->data < rhs.data;
 }
 
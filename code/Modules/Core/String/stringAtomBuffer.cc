@@ -34,9 +34,9 @@ stringAtomBuffer::allocChunk() {
 
 //------------------------------------------------------------------------------
 const stringAtomBuffer::Header*
-stringAtomBuffer::AddString(stringAtomTable* table, int32 hash, const char* str) {
-    o_assert(nullptr != table);
+stringAtomBuffer::AddString(int32 hash, const char* str, int32 strLen, const Header* next) {
     o_assert(nullptr != str);
+    o_assert(strLen >= 0);
     
     // no chunks allocated yet?
     if (0 == this->curPointer) {
@@ -44,7 +44,6 @@ stringAtomBuffer::AddString(stringAtomTable* table, int32 hash, const char* str)
     }
     
     // compute length of new entry (header + string len + 0 terminator byte)
-    const int32 strLen = int32(std::strlen(str));
     size_t requiredSize = strLen + sizeof(Header) + 1;
     o_assert(requiredSize < this->chunkSize);
     
@@ -55,16 +54,12 @@ stringAtomBuffer::AddString(stringAtomTable* table, int32 hash, const char* str)
     
     // copy over data
     Header* head = (Header*) this->curPointer;
-    head->table = table;
+    head->next = next;
     head->hash = hash;
     head->length  = strLen;
     head->str  = (char*) this->curPointer + sizeof(Header);
-    #if ORYOL_WINDOWS
-    errno_t res = strcpy_s((char*)head->str, strLen + 1, str);
-    o_assert(0 == res);
-    #else
-    std::strcpy((char*)head->str, str);
-    #endif
+    std::memcpy((char*)head->str, str, strLen);
+    ((char*)head->str)[strLen] = 0;
 
     // set curPointer to the next aligned position
     this->curPointer = (int8*) Memory::Align(this->curPointer + requiredSize, sizeof(Header));
@@ -2,69 +2,72 @@
 //  stringAtomTable.cc
 //------------------------------------------------------------------------------
 #include "Pre.h"
+#include <atomic>
 #include <cstring>
+#include <mutex>
 #include "stringAtomTable.h"
+#include "Core/Memory/Memory.h"
 #if ORYOL_USE_VLD
 #include "vld.h"
 #endif
 
 namespace Oryol {
 
-ORYOL_THREADLOCAL_PTR(stringAtomTable) stringAtomTable::ptr = nullptr;
+namespace {
+// NOTE: all of these must be constant-initialized since StringAtoms
+// may be created during static initialization
+std::atomic<const stringAtomBuffer::Header*> buckets[stringAtomTable::NumBuckets];
+std::mutex addLock;
+stringAtomBuffer* buffer = nullptr;
 
 //------------------------------------------------------------------------------
-stringAtomTable*
-stringAtomTable::threadLocalPtr() {
-    // NOTE: this object can never be released, even if a thread is left
-    // since StringAtom object can move to other threads, thus memory
-    // leak detectors will complain about these allocations on program
-    // exit
-    if (!ptr) {
-        #if ORYOL_USE_VLD
-        VLDDisable();
-        #endif
-        ptr = Memory::New<stringAtomTable>();
-        #if ORYOL_USE_VLD
-        VLDEnable();
-        #endif
-    }
-    return ptr;
+std::atomic<const stringAtomBuffer::Header*>&
+bucketForHash(int32 hash) {
+    return buckets[uint32(hash) & (stringAtomTable::NumBuckets - 1)];
 }
+} // anonymous namespace
 
 //------------------------------------------------------------------------------
 const stringAtomBuffer::Header*
-stringAtomTable::Find(int32 hash, const char* str) const {
-    
-    // need to create a temp object for searching in the set
-    stringAtomBuffer::Header dummyHead(this, hash, 0, str);
-    Entry dummyEntry(&dummyHead);
-    auto ptr = this->table.Find(dummyEntry);
-    if (nullptr == ptr) {
-        return nullptr;
-    }
-    else {
-        o_assert(nullptr != ptr->header);
-        return ptr->header;
+stringAtomTable::Find(int32 hash, const char* str, int32 len) {
+    // the acquire-load pairs with the release-store in Add(), which
+    // guarantees that the header content is visible
+    const stringAtomBuffer::Header* head = bucketForHash(hash).load(std::memory_order_acquire);
+    for (; head; head = head->next) {
+        if ((head->hash == hash) && (head->length == len) && (0 == std::memcmp(head->str, str, len))) {
+            return head;
+        }
     }
+    return nullptr;
 }
 
 //------------------------------------------------------------------------------
 const stringAtomBuffer::Header*
-stringAtomTable::Add(int32 hash, const char* str) {
-    
-    #if ORYOL_DEBUG
-    o_assert(nullptr == this->Find(hash, str));
-    #endif    
+stringAtomTable::Add(int32 hash, const char* str, int32 len) {
+    std::lock_guard<std::mutex> lock(addLock);
+
+    // another thread might have added the same string in the meantime
+    const stringAtomBuffer::Header* existing = Find(hash, str, len);
+    if (existing) {
+        return existing;
+    }
+
     #if ORYOL_USE_VLD
     VLDDisable();
     #endif
 
-    // add new string to the string buffer
-    const stringAtomBuffer::Header* newHeader = this->buffer.AddString(this, hash, str);
+    // NOTE: the string buffer is never released, since StringAtoms
+    // may live until the very end of the program, thus memory
+    // leak detectors will complain about these allocations on exit
+    if (nullptr == buffer) {
+        buffer = Memory::New<stringAtomBuffer>();
+    }
+
+    // add new string to the string buffer and link it into its bucket
+    auto& bucket = bucketForHash(hash);
+    const stringAtomBuffer::Header* newHeader = buffer->AddString(hash, str, len, bucket.load(std::memory_order_relaxed));
     o_assert(nullptr != newHeader);
-    
-    // add new entry to our lookup table
-    this->table.Add(Entry(newHeader));
+    bucket.store(newHeader, std::memory_order_release);
 
     #if ORYOL_USE_VLD
     VLDEnable();
@@ -74,15 +77,13 @@ stringAtomTable::Add(int32 hash, const char* str) {
 
 //------------------------------------------------------------------------------
 int32
-stringAtomTable::HashForString(const char* str) {
+stringAtomTable::HashForString(const char* str, int32 len) {
 
     // see here: http://eternallyconfuzzled.com/tuts/algorithms/jsw_tut_hashing.aspx
-    const char* p = str;
     int32 h = 0;
-    char c;
-    while (0 != (c = *p++))
+    for (int32 i = 0; i < len; i++)
     {
-        h += c;
+        h += str[i];
         h += (h << 10);
         h ^= (h >> 6);
     }
@@ -92,38 +93,6 @@ stringAtomTable::HashForString(const char* str) {
     return h;
 }
 
-//------------------------------------------------------------------------------
-bool
-stringAtomTable::Entry::operator==(const Entry& rhs) const {
-
-    #if ORYOL_DEBUG
-    o_assert(this->header != 0 && rhs.header != 0);
-    o_assert(this->header->hash != 0 && rhs.header->hash != 0);
-    o_assert(this->header->str != 0 && rhs.header->str != 0);
-    #endif
-    
-    if (this->header->hash != rhs.header->hash) {
-        // if hashes differ, the entries are definitely not equal
-        return false;
-    }
-    else {
-        // if hashes are identical, need to do a strcmp
-        return (0 == std::strcmp(this->header->str, rhs.header->str));
-    }
-}
-
-//------------------------------------------------------------------------------
-bool
-stringAtomTable::Entry::operator<(const Entry& rhs) const {
-        
-    #if ORYOL_DEBUG
-    o_assert(this->header != 0 && rhs.header != 0);
-    o_assert(this->header->hash != 0 && rhs.header->hash != 0);
-    o_assert(this->header->str != 0 && rhs.header->str != 0);
-    #endif
-    return std::strcmp(this->header->str, rhs.header->str) < 0;
-}
-
 } // namespace Oryol
 
 
@@ -3,51 +3,32 @@
 /*
     private class, do not use
     
-    A thread-local StringAtom table.
+    The process-global StringAtom table.
+
+    The table is a fixed array of buckets, each bucket is a singly linked
+    list of string buffer headers (the link is stored in the header).
+    Headers are never removed or modified once they are linked into a
+    bucket, so Find() walks the lists without taking a lock. Add() takes
+    a lock, checks again whether the string has been added by another
+    thread in the meantime, and links the new header at the front of its
+    bucket list.
 */
 #include "Core/Types.h"
 #include "Core/String/stringAtomBuffer.h"
-#include "Core/Containers/HashSet.h"
-#include "Core/Threading/ThreadLocalPtr.h"
 
 namespace Oryol {
 
 class stringAtomTable {
 public:
-    /// access to thread-local stringAtomTable (created on demand)
-    static stringAtomTable* threadLocalPtr();
-    /// compute hash value for string
-    static int32 HashForString(const char* str);
-    /// find a matching buffer header in the table
-    const stringAtomBuffer::Header* Find(int32 hash, const char* str) const;
-    /// add a string to the atom table
-    const stringAtomBuffer::Header* Add(int32 hash, const char* str);
-    
-private:
-    static ORYOL_THREADLOCAL_PTR(stringAtomTable) ptr;
-
-    /// a bucket entry
-    struct Entry {
-        /// default constructor
-        Entry() : header(0) { };
-        /// constructor with header ptr
-        Entry(const stringAtomBuffer::Header* h) : header(h) { };
-        /// equality operator
-        bool operator==(const Entry& rhs) const;
-        /// less-then operator
-        bool operator<(const Entry& rhs) const;
-        
-        const stringAtomBuffer::Header* header;
-    };
+    /// compute hash value for string of len characters
+    static int32 HashForString(const char* str, int32 len);
+    /// find a matching buffer header in the table (lock-free)
+    static const stringAtomBuffer::Header* Find(int32 hash, const char* str, int32 len);
+    /// add a string to the atom table, returns existing header if another thread was faster
+    static const stringAtomBuffer::Header* Add(int32 hash, const char* str, int32 len);
     
-    /// hash function for bucket entry
-    struct Hasher {
-        int32 operator()(const Entry& e) const {
-            return e.header->hash;
-        };
-    };
-    stringAtomBuffer buffer;
-    HashSet<Entry, Hasher, 1024> table;
+    /// number of hash buckets
+    static const int32 NumBuckets = 4096;
 };
 
 } // namespace Oryol
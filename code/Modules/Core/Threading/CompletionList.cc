@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+//  CompletionList.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "CompletionList.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+
+OryolClassImpl(CompletionList);
+
+//------------------------------------------------------------------------------
+CompletionList::CompletionList() :
+head(nullptr) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+CompletionList::~CompletionList() {
+    node* n = this->head.exchange(nullptr, std::memory_order_acquire);
+    while (n) {
+        node* next = n->next;
+        Memory::Free(n);
+        n = next;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Pushes onto a lock-free stack, the consumer always takes the whole
+ stack at once, so there is no ABA problem.
+*/
+void
+CompletionList::Push(uint64 tag) {
+    node* n = (node*) Memory::Alloc(sizeof(node));
+    n->tag = tag;
+    n->next = this->head.load(std::memory_order_relaxed);
+    while (!this->head.compare_exchange_weak(n->next, n, std::memory_order_release, std::memory_order_relaxed)) {
+        // n->next has been updated with the current head, try again
+    }
+}
+
+//------------------------------------------------------------------------------
+int32
+CompletionList::TakeAll(Array<uint64>& outTags) {
+    if (nullptr == this->head.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+    node* n = this->head.exchange(nullptr, std::memory_order_acquire);
+
+    // the stack is newest-first, reverse it
+    node* prev = nullptr;
+    while (n) {
+        node* next = n->next;
+        n->next = prev;
+        prev = n;
+        n = next;
+    }
+    int32 num = 0;
+    n = prev;
+    while (n) {
+        node* next = n->next;
+        outTags.Add(n->tag);
+        Memory::Free(n);
+        n = next;
+        num++;
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+bool
+CompletionList::Empty() const {
+    return nullptr == this->head.load(std::memory_order_relaxed);
+}
+
+} // namespace Oryol
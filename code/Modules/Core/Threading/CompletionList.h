@@ -0,0 +1,47 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::CompletionList
+    @ingroup Core
+    @brief lock-free list of completion notifications
+
+    Any number of threads push 64-bit tags (for instance the serial id
+    of a finished request) with Push(), and a single consumer thread
+    takes all tags which have been pushed since the last call with
+    TakeAll(). Push() never blocks, and TakeAll() is a single atomic
+    exchange if nothing has been pushed, so that a consumer which is
+    called every frame only pays for work which actually completed.
+
+    Messages push their completion tag into a CompletionList when they
+    are handled (see Message::SetCompletionList()).
+*/
+#include "Core/RefCounted.h"
+#include "Core/Containers/Array.h"
+#include <atomic>
+
+namespace Oryol {
+
+class CompletionList : public RefCounted {
+    OryolClassDecl(CompletionList);
+public:
+    /// constructor
+    CompletionList();
+    /// destructor
+    virtual ~CompletionList();
+
+    /// push a tag (any thread, lock-free)
+    void Push(uint64 tag);
+    /// append all pushed tags to outTags, oldest first, return number of tags (consumer thread)
+    int32 TakeAll(Array<uint64>& outTags);
+    /// return true if no tags are pending
+    bool Empty() const;
+
+private:
+    struct node {
+        node* next;
+        uint64 tag;
+    };
+    std::atomic<node*> head;
+};
+
+} // namespace Oryol
@@ -0,0 +1,58 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::JobCounter
+    @ingroup Core
+    @brief tracks completion of a group of jobs
+
+    Each job started with JobSystem::Run() increments the counter it
+    has been started with, and decrements it again when it is finished.
+    JobSystem::Wait() blocks until a counter reaches zero (and executes
+    other jobs in the meantime). A counter can also be used as a
+    dependency for new jobs, these will only be scheduled once the
+    counter has reached zero.
+
+    A JobCounter must outlive all jobs which reference it.
+*/
+#include "Core/Types.h"
+#include "Core/Assertion.h"
+#include "Core/Containers/Array.h"
+#include <atomic>
+#include <mutex>
+
+namespace Oryol {
+
+class JobSystem;
+namespace _priv {
+struct job;
+}
+
+class JobCounter {
+public:
+    /// constructor
+    JobCounter() : count(0) { };
+    /// destructor
+    ~JobCounter() {
+        o_assert_dbg(this->waiting.Empty());
+    };
+
+    /// get the number of unfinished jobs
+    int32 Get() const {
+        return this->count.load(std::memory_order_acquire);
+    };
+    /// return true if all jobs have finished
+    bool IsDone() const {
+        return 0 == this->Get();
+    };
+
+private:
+    friend class JobSystem;
+    JobCounter(const JobCounter& rhs) = delete;
+    void operator=(const JobCounter& rhs) = delete;
+
+    std::atomic<int32> count;
+    std::mutex waitingLock;
+    Array<_priv::job*> waiting;     // jobs which depend on this counter
+};
+
+} // namespace Oryol
@@ -0,0 +1,367 @@
+//------------------------------------------------------------------------------
+//  JobSystem.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "JobSystem.h"
+#include "Core/Core.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include "Core/Threading/mpmcQueue.h"
+#include "Core/Threading/workStealingDeque.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <condition_variable>
+#endif
+
+namespace Oryol {
+
+namespace _priv {
+
+struct job {
+    JobSystem::Func func;
+    JobCounter* counter = nullptr;
+};
+
+#if ORYOL_HAS_THREADS
+struct jobWorker {
+    static const int32 DequeCapacity = 4096;
+
+    jobWorker(int32 index_) :
+        index(index_),
+        randSeed(uint32(index_) * 2654435761u + 1),
+        deque(DequeCapacity) { };
+
+    /// xorshift random number for picking steal victims
+    uint32 rand() {
+        this->randSeed ^= this->randSeed << 13;
+        this->randSeed ^= this->randSeed >> 17;
+        this->randSeed ^= this->randSeed << 5;
+        return this->randSeed;
+    };
+
+    int32 index;
+    uint32 randSeed;
+    workStealingDeque<job*> deque;
+    std::thread thread;
+};
+#endif
+
+} // namespace _priv
+
+using namespace _priv;
+
+struct JobSystem::_state {
+    #if ORYOL_HAS_THREADS
+    static const int32 InjectCapacity = 4096;
+    static const int32 SpinCount = 64;
+    _state() : injectQueue(InjectCapacity) { };
+
+    mpmcQueue<job*> injectQueue;    // jobs started from non-worker threads
+    Array<jobWorker*> workers;
+    std::atomic<bool> stopRequested{false};
+    std::atomic<int32> numSleeping{0};
+    std::mutex wakeupMutex;
+    std::condition_variable wakeup;
+    #endif
+};
+JobSystem::_state* JobSystem::state = nullptr;
+
+#if ORYOL_HAS_THREADS
+// the worker object of the current thread, nullptr on non-worker threads
+static ORYOL_THREADLOCAL_PTR(jobWorker) curWorker = nullptr;
+#endif
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Setup(int32 numWorkers) {
+    o_assert(!IsValid());
+    o_assert(numWorkers >= 0);
+    state = Memory::New<_state>();
+    #if ORYOL_HAS_THREADS
+    if (0 == numWorkers) {
+        numWorkers = int32(std::thread::hardware_concurrency()) - 1;
+        if (numWorkers < 1) {
+            numWorkers = 1;
+        }
+    }
+    // first create all workers, then start threads, since
+    // workers look at each other's deques
+    state->workers.Reserve(numWorkers);
+    for (int32 i = 0; i < numWorkers; i++) {
+        state->workers.Add(Memory::New<jobWorker>(i));
+    }
+    for (jobWorker* worker : state->workers) {
+        worker->thread = std::thread(workerFunc, worker);
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Discard() {
+    o_assert(IsValid());
+    #if ORYOL_HAS_THREADS
+    state->stopRequested = true;
+    {
+        std::lock_guard<std::mutex> lock(state->wakeupMutex);
+        state->wakeup.notify_all();
+    }
+    for (jobWorker* worker : state->workers) {
+        worker->thread.join();
+    }
+    // execute any remaining jobs on this thread
+    job* j = nullptr;
+    while ((j = findJob(nullptr))) {
+        execute(j);
+    }
+    for (jobWorker* worker : state->workers) {
+        Memory::Delete(worker);
+    }
+    state->workers.Clear();
+    #endif
+    Memory::Delete(state);
+    state = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+JobSystem::IsValid() {
+    return nullptr != state;
+}
+
+//------------------------------------------------------------------------------
+int32
+JobSystem::NumWorkers() {
+    o_assert_dbg(IsValid());
+    #if ORYOL_HAS_THREADS
+    return state->workers.Size();
+    #else
+    return 0;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Run(Func func, JobCounter* counter, JobCounter* dependency) {
+    o_assert_dbg(IsValid());
+    #if ORYOL_HAS_THREADS
+    job* j = Memory::New<job>();
+    j->func = std::move(func);
+    j->counter = counter;
+    if (counter) {
+        counter->count.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (dependency) {
+        // the dependency counter only reaches zero while its waitingLock
+        // is held (see finish()), so either it is done, or the job will
+        // be picked up when it is done
+        std::lock_guard<std::mutex> lock(dependency->waitingLock);
+        if (!dependency->IsDone()) {
+            dependency->waiting.Add(j);
+            return;
+        }
+    }
+    schedule(j);
+    #else
+    // no threads, everything is done synchronously
+    o_assert_dbg((nullptr == dependency) || dependency->IsDone());
+    func();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+ NOTE: a JobCounter must not be destroyed before Wait() has returned,
+ even if JobCounter::IsDone() returns true.
+*/
+void
+JobSystem::Wait(JobCounter* counter) {
+    o_assert_dbg(IsValid());
+    o_assert_dbg(counter);
+    #if ORYOL_HAS_THREADS
+    jobWorker* self = curWorker;
+    while (!counter->IsDone()) {
+        job* j = findJob(self);
+        if (j) {
+            execute(j);
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    // synchronize with the thread which finished the last job, it may
+    // still be touching the counter (see finish())
+    std::lock_guard<std::mutex> lock(counter->waitingLock);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+ The range is split into chunks of grainSize items, the last chunk
+ is executed on the calling thread. With a grainSize of 0, a chunk
+ size is picked which creates about 4 jobs per thread.
+*/
+void
+JobSystem::ParallelFor(int32 begin, int32 end, int32 grainSize, RangeFunc func) {
+    o_assert_dbg(IsValid());
+    o_assert_dbg(grainSize >= 0);
+    if (end <= begin) {
+        return;
+    }
+    const int32 num = end - begin;
+    if (0 == grainSize) {
+        grainSize = num / ((NumWorkers() + 1) * 4);
+        if (grainSize < 1) {
+            grainSize = 1;
+        }
+    }
+    JobCounter counter;
+    int32 first = begin;
+    for (; (end - first) > grainSize; first += grainSize) {
+        const int32 last = first + grainSize;
+        Run([&func, first, last]() {
+            func(first, last);
+        }, &counter);
+    }
+    func(first, end);
+    Wait(&counter);
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+void
+JobSystem::schedule(job* j) {
+    jobWorker* self = curWorker;
+    if (!(self && self->deque.Push(j)) && !state->injectQueue.Enqueue(j)) {
+        // all queues full, just run the job right here
+        execute(j);
+        return;
+    }
+    wakeupWorker();
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::execute(job* j) {
+    j->func();
+    JobCounter* counter = j->counter;
+    Memory::Delete(j);
+    if (counter) {
+        finish(counter);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Decrementing to zero only happens while the counter's waitingLock is
+ held, this guarantees that dependent jobs are either added before the
+ counter reaches zero (and are scheduled here), or see the counter at
+ zero in Run() and are scheduled immediately.
+*/
+void
+JobSystem::finish(JobCounter* counter) {
+    int32 count = counter->count.load(std::memory_order_relaxed);
+    while (count > 1) {
+        if (counter->count.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+    Array<job*> ready;
+    {
+        std::lock_guard<std::mutex> lock(counter->waitingLock);
+        if (1 == counter->count.fetch_sub(1, std::memory_order_acq_rel)) {
+            ready = std::move(counter->waiting);
+        }
+    }
+    for (job* j : ready) {
+        schedule(j);
+    }
+}
+
+//------------------------------------------------------------------------------
+job*
+JobSystem::findJob(jobWorker* self) {
+    job* j = nullptr;
+    if (self && self->deque.Pop(j)) {
+        return j;
+    }
+    if (state->injectQueue.Dequeue(j)) {
+        return j;
+    }
+    // try to steal from the other workers, start at a random victim
+    const int32 numWorkers = state->workers.Size();
+    const int32 start = self ? int32(self->rand() % numWorkers) : 0;
+    for (int32 i = 0; i < numWorkers; i++) {
+        jobWorker* victim = state->workers[(start + i) % numWorkers];
+        if ((victim != self) && victim->deque.Steal(j)) {
+            return j;
+        }
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+JobSystem::hasPendingJobs() {
+    if (!state->injectQueue.Empty()) {
+        return true;
+    }
+    for (const jobWorker* worker : state->workers) {
+        if (!worker->deque.Empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+ NOTE: the memory fence between publishing the job and checking the
+ number of sleeping workers pairs with the fence in workerFunc(), so
+ either the worker sees the new job, or we see the sleeping worker.
+*/
+void
+JobSystem::wakeupWorker() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (state->numSleeping.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(state->wakeupMutex);
+        state->wakeup.notify_one();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::workerFunc(jobWorker* self) {
+    // setup thread-local RunLoops etc...
+    Core::EnterThread();
+    curWorker = self;
+
+    int32 numEmptyPolls = 0;
+    while (!state->stopRequested.load(std::memory_order_relaxed)) {
+        job* j = findJob(self);
+        if (j) {
+            execute(j);
+            numEmptyPolls = 0;
+        }
+        else if (numEmptyPolls++ < _state::SpinCount) {
+            std::this_thread::yield();
+        }
+        else {
+            // nothing to do, go to sleep until new jobs are scheduled
+            numEmptyPolls = 0;
+            std::unique_lock<std::mutex> lock(state->wakeupMutex);
+            state->numSleeping.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!hasPendingJobs() && !state->stopRequested) {
+                state->wakeup.wait(lock);
+            }
+            state->numSleeping.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    curWorker = nullptr;
+    Core::LeaveThread();
+}
+#endif
+
+} // namespace Oryol
@@ -0,0 +1,90 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::JobSystem
+    @ingroup Core
+    @brief fan out CPU work to a pool of worker threads
+
+    The JobSystem owns a fixed number of worker threads, each with its
+    own work-stealing deque. Jobs started from a worker thread are
+    pushed to the worker's own deque, jobs started from other threads
+    (e.g. the main thread) go into a shared injection queue. Idle
+    workers first look into their own deque, then into the injection
+    queue, and finally try to steal jobs from other workers before
+    they go to sleep.
+
+    Worker threads call Core::EnterThread() on startup, so jobs can
+    use the per-thread RunLoops.
+
+    Example:
+
+        JobCounter counter;
+        JobSystem::Run([]() { ... }, &counter);
+        JobSystem::Run([]() { ... }, &counter);
+        // this job will only start after the first two have finished
+        JobCounter finalCounter;
+        JobSystem::Run([]() { ... }, &finalCounter, &counter);
+        JobSystem::Wait(&finalCounter);
+
+        JobSystem::ParallelFor(0, numItems, 64, [](int32 first, int32 last) {
+            for (int32 i = first; i < last; i++) { ... }
+        });
+
+    On platforms without threading support, jobs are executed
+    immediately inside Run().
+*/
+#include "Core/Types.h"
+#include "Core/Config.h"
+#include "Core/Threading/JobCounter.h"
+#include <functional>
+
+namespace Oryol {
+
+namespace _priv {
+struct jobWorker;
+}
+
+class JobSystem {
+public:
+    /// job function typedef
+    typedef std::function<void()> Func;
+    /// ParallelFor function typedef, called with a [first, last) range
+    typedef std::function<void(int32 first, int32 last)> RangeFunc;
+
+    /// setup the job system (0 workers: one per CPU core minus one)
+    static void Setup(int32 numWorkers=0);
+    /// discard the job system (executes remaining jobs)
+    static void Discard();
+    /// check if the job system has been setup
+    static bool IsValid();
+    /// get number of worker threads
+    static int32 NumWorkers();
+
+    /// start a job, optional counter to wait on, optional dependency
+    static void Run(Func func, JobCounter* counter=nullptr, JobCounter* dependency=nullptr);
+    /// wait until counter reaches zero, executes pending jobs while waiting
+    static void Wait(JobCounter* counter);
+    /// split a [begin, end) range into jobs and wait for completion (grainSize 0: automatic)
+    static void ParallelFor(int32 begin, int32 end, int32 grainSize, RangeFunc func);
+
+private:
+    /// push a ready job to the current worker's deque or the injection queue
+    static void schedule(_priv::job* j);
+    /// execute a job and update its counter
+    static void execute(_priv::job* j);
+    /// decrement a counter, schedule dependent jobs if it reaches zero
+    static void finish(JobCounter* counter);
+    /// find a job to execute (own deque, injection queue, steal)
+    static _priv::job* findJob(_priv::jobWorker* self);
+    /// return true if any jobs are pending
+    static bool hasPendingJobs();
+    /// wake up a sleeping worker thread
+    static void wakeupWorker();
+    /// worker thread function
+    static void workerFunc(_priv::jobWorker* self);
+
+    struct _state;
+    static _state* state;
+};
+
+} // namespace Oryol
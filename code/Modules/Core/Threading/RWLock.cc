@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------------
+//  RWLock.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "RWLock.h"
+#include "Core/Assertion.h"
+#include "Core/Threading/futex.h"
+#include <chrono>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+#if ORYOL_WINDOWS
+#include <intrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+#include <xmmintrin.h>
+#endif
+
+namespace Oryol {
+
+using namespace _priv;
+
+namespace {
+const int32 SpinCount = 64;
+const int32 YieldCount = 16;
+
+//------------------------------------------------------------------------------
+/**
+ Hint the CPU that we're in a spin-wait loop.
+*/
+inline void
+cpuRelax() {
+    #if ORYOL_WINDOWS || defined(__i386__) || defined(__x86_64__)
+    _mm_pause();
+    #elif defined(__arm__) || defined(__aarch64__)
+    __asm__ __volatile__("yield");
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+ Map a wait time to a histogram bucket, bucket i counts waits
+ shorter than 2^i microseconds, the last bucket also counts all
+ longer waits.
+*/
+int32
+waitBucket(std::chrono::steady_clock::time_point start) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    int32 bucket = 0;
+    while ((us > 0) && (bucket < (RWLock::NumWaitBuckets - 1))) {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Wait for a state change: spin first, then yield, then park on the
+ futex. The parked bit is set before parking so that the unlocking
+ thread knows it has to wake us up.
+*/
+bool
+backoff(std::atomic<uint32>& state, uint32 cur, uint32 parkedBit, int32 iteration) {
+    if (iteration < SpinCount) {
+        cpuRelax();
+    }
+    else if (iteration < (SpinCount + YieldCount)) {
+        #if ORYOL_HAS_THREADS
+        std::this_thread::yield();
+        #endif
+    }
+    else {
+        if (0 == (cur & parkedBit)) {
+            if (!state.compare_exchange_weak(cur, cur | parkedBit, std::memory_order_relaxed)) {
+                return false;
+            }
+            cur |= parkedBit;
+        }
+        futex::Wait(&state, cur);
+        return true;
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+void
+RWLock::lockWriteSlow() {
+    const auto start = std::chrono::steady_clock::now();
+    for (int32 i = 0; ; i++) {
+        uint32 cur = this->state.load(std::memory_order_relaxed);
+        if (0 == (cur & (ReaderMask|WriteLockedBit))) {
+            // lock is free, grab it (other waiting writers set their pending bit again)
+            if (this->state.compare_exchange_weak(cur, (cur | WriteLockedBit) & ~WriterPendingBit, std::memory_order_acquire, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (0 == (cur & WriterPendingBit)) {
+            // keep new readers out while we're waiting
+            this->state.compare_exchange_weak(cur, cur | WriterPendingBit, std::memory_order_relaxed);
+        }
+        else if (backoff(this->state, cur, ParkedBit, i)) {
+            this->numParks.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    this->numContendedWriteLocks.fetch_add(1, std::memory_order_relaxed);
+    this->writeWaitHistogram[waitBucket(start)].fetch_add(1, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void
+RWLock::lockReadSlow() {
+    const auto start = std::chrono::steady_clock::now();
+    for (int32 i = 0; ; i++) {
+        uint32 cur = this->state.load(std::memory_order_relaxed);
+        if (0 == (cur & (WriteLockedBit|WriterPendingBit))) {
+            o_assert_dbg((cur & ReaderMask) < ReaderMask);
+            if (this->state.compare_exchange_weak(cur, cur + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (backoff(this->state, cur, ParkedBit, i)) {
+            this->numParks.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    this->numContendedReadLocks.fetch_add(1, std::memory_order_relaxed);
+    this->readWaitHistogram[waitBucket(start)].fetch_add(1, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void
+RWLock::wakeParked() {
+    // clear the parked bit first, threads which park after this
+    // will set it again and are woken by the next unlock
+    this->state.fetch_and(~ParkedBit, std::memory_order_relaxed);
+    futex::WakeAll(&this->state);
+}
+
+//------------------------------------------------------------------------------
+RWLock::Stats
+RWLock::GetStats() const {
+    Stats stats;
+    stats.NumReadLocks = this->numReadLocks.load(std::memory_order_relaxed);
+    stats.NumWriteLocks = this->numWriteLocks.load(std::memory_order_relaxed);
+    stats.NumContendedReadLocks = this->numContendedReadLocks.load(std::memory_order_relaxed);
+    stats.NumContendedWriteLocks = this->numContendedWriteLocks.load(std::memory_order_relaxed);
+    stats.NumParks = this->numParks.load(std::memory_order_relaxed);
+    for (int32 i = 0; i < NumWaitBuckets; i++) {
+        stats.ReadWaitHistogram[i] = this->readWaitHistogram[i].load(std::memory_order_relaxed);
+        stats.WriteWaitHistogram[i] = this->writeWaitHistogram[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+//------------------------------------------------------------------------------
+void
+RWLock::ResetStats() {
+    this->numReadLocks.store(0, std::memory_order_relaxed);
+    this->numWriteLocks.store(0, std::memory_order_relaxed);
+    this->numContendedReadLocks.store(0, std::memory_order_relaxed);
+    this->numContendedWriteLocks.store(0, std::memory_order_relaxed);
+    this->numParks.store(0, std::memory_order_relaxed);
+    for (int32 i = 0; i < NumWaitBuckets; i++) {
+        this->readWaitHistogram[i].store(0, std::memory_order_relaxed);
+        this->writeWaitHistogram[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace Oryol
@@ -4,17 +4,50 @@
     @class Oryol::RWLock
     @ingroup Core
     @brief single-write / multiple-reader lock
+
+    The complete lock state lives in a single 32-bit atomic (reader
+    count, write-locked bit, writer-pending bit and parked bit), so
+    taking the lock is always a single compare-and-swap. A waiting
+    writer sets the writer-pending bit which keeps new readers out,
+    so that writers can't be starved by a constant stream of readers.
+
+    Contended lock attempts first spin for a short while, then yield
+    the thread a couple of times and finally park the thread on a
+    futex until the lock is released.
+
+    The lock keeps acquisition counters and histograms of the time
+    spent waiting on contended acquisitions, see GetStats().
+
+    NOTE: the lock is not recursive, also not for readers (a nested
+    LockRead() dead-locks if a writer is waiting in between).
 */
 #include "Core/Config.h"
 #include "Core/Types.h"
-#if ORYOL_HAS_ATOMIC
 #include <atomic>
-#endif
 
 namespace Oryol {
 
 class RWLock {
 public:
+    /// number of wait-time histogram buckets
+    static const int32 NumWaitBuckets = 16;
+    /// lock statistics
+    struct Stats {
+        /// number of read-lock acquisitions
+        uint32 NumReadLocks = 0;
+        /// number of write-lock acquisitions
+        uint32 NumWriteLocks = 0;
+        /// number of read-lock acquisitions which had to wait
+        uint32 NumContendedReadLocks = 0;
+        /// number of write-lock acquisitions which had to wait
+        uint32 NumContendedWriteLocks = 0;
+        /// number of times a thread was parked
+        uint32 NumParks = 0;
+        /// wait-time histograms of contended acquisitions, bucket i counts waits < 2^i microseconds
+        uint32 ReadWaitHistogram[NumWaitBuckets] = { };
+        uint32 WriteWaitHistogram[NumWaitBuckets] = { };
+    };
+
     /// lock for writing
     void LockWrite();
     /// unlock from writing
@@ -23,57 +56,72 @@ public:
     void LockRead();
     /// unlock from reading
     void UnlockRead();
-    
+
+    /// get a snapshot of the lock statistics
+    Stats GetStats() const;
+    /// reset the lock statistics
+    void ResetStats();
+
 private:
-#if ORYOL_HAS_ATOMIC
-    std::atomic<bool> writeLock{false};
-    std::atomic<int32> readCount{0};
-#endif
+    static const uint32 ReaderMask = (1u << 29) - 1;
+    static const uint32 WriterPendingBit = 1u << 29;
+    static const uint32 WriteLockedBit = 1u << 30;
+    static const uint32 ParkedBit = 1u << 31;
+
+    /// contended write-lock path
+    void lockWriteSlow();
+    /// contended read-lock path
+    void lockReadSlow();
+    /// wake up parked threads
+    void wakeParked();
+
+    std::atomic<uint32> state{0};
+    std::atomic<uint32> numReadLocks{0};
+    std::atomic<uint32> numWriteLocks{0};
+    std::atomic<uint32> numContendedReadLocks{0};
+    std::atomic<uint32> numContendedWriteLocks{0};
+    std::atomic<uint32> numParks{0};
+    std::atomic<uint32> readWaitHistogram[NumWaitBuckets] = { };
+    std::atomic<uint32> writeWaitHistogram[NumWaitBuckets] = { };
 };
 
 //------------------------------------------------------------------------------
 inline void
 RWLock::LockWrite() {
-#if ORYOL_HAS_ATOMIC
-    /// acquire the write-lock
-    while (std::atomic_exchange_explicit(&this->writeLock, true, std::memory_order_acquire)) {
-        // spinning...
-    }
-    /// spin until no-one's reading anymore
-    while (this->readCount > 0) {
-        // spinning...
+    uint32 expected = 0;
+    if (!this->state.compare_exchange_strong(expected, WriteLockedBit, std::memory_order_acquire, std::memory_order_relaxed)) {
+        this->lockWriteSlow();
     }
-#endif
+    this->numWriteLocks.fetch_add(1, std::memory_order_relaxed);
 }
 
 //------------------------------------------------------------------------------
 inline void
 RWLock::UnlockWrite() {
-#if ORYOL_HAS_ATOMIC
-    std::atomic_store_explicit(&this->writeLock, false, std::memory_order_release);
-#endif
+    uint32 cur = this->state.fetch_and(~WriteLockedBit, std::memory_order_release);
+    if (cur & ParkedBit) {
+        this->wakeParked();
+    }
 }
 
 //------------------------------------------------------------------------------
 inline void
 RWLock::LockRead() {
-#if ORYOL_HAS_ATOMIC
-    /// spin until no one is writing anymore
-    while (this->writeLock) {
-        // spinning...
+    uint32 cur = this->state.load(std::memory_order_relaxed);
+    if ((cur & (WriteLockedBit|WriterPendingBit)) ||
+        !this->state.compare_exchange_weak(cur, cur + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+        this->lockReadSlow();
     }
-    /// increment the read-count
-    ++this->readCount;
-#endif
+    this->numReadLocks.fetch_add(1, std::memory_order_relaxed);
 }
 
 //------------------------------------------------------------------------------
 inline void
 RWLock::UnlockRead() {
-#if ORYOL_HAS_ATOMIC
-    --this->readCount;
-#endif
+    uint32 cur = this->state.fetch_sub(1, std::memory_order_release);
+    if (((cur & ReaderMask) == 1) && (cur & ParkedBit)) {
+        this->wakeParked();
+    }
 }
 
 } // namespace Oryol
-
@@ -3,7 +3,7 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "ThreadLocalData.h"
-#include "Core/Memory/Memory.h"
+#include <cstdlib>
 #include "Core/Assertion.h"
 
 #if ORYOL_THREADLOCAL_PTHREAD
@@ -31,9 +31,9 @@ ThreadLocalData::PointerTable() {
     if (0 == table) {
         // not assigned yet, allocate thread-specific table and
         // associate with key
-        int tableSize = MaxNumSlots * sizeof(void*);
-        table = (void**) Memory::Alloc(tableSize);
-        Memory::Clear(table, tableSize);
+        // NOTE: this doesn't go through Memory::Alloc() since Memory
+        // itself uses thread-local data
+        table = (void**) std::calloc(MaxNumSlots, sizeof(void*));
         pthread_setspecific(key, table);
     }
     return table;
@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+//  futex.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "futex.h"
+#include "Core/Config.h"
+#if ORYOL_HAS_THREADS
+#if ORYOL_LINUX || ORYOL_ANDROID
+#define ORYOL_FUTEX_SYSCALL (1)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <climits>
+#else
+#include <mutex>
+#include <condition_variable>
+#endif
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+#if ORYOL_HAS_THREADS && !ORYOL_FUTEX_SYSCALL
+namespace {
+// emulated futex: waiters on the same address share a bucket
+struct bucket {
+    std::mutex mutex;
+    std::condition_variable cond;
+};
+const int32 NumBuckets = 64;
+bucket buckets[NumBuckets];
+
+bucket& lookupBucket(const void* addr) {
+    const uintptr h = uintptr(addr) >> 4;
+    return buckets[(h ^ (h >> 6)) & (NumBuckets - 1)];
+}
+} // anonymous namespace
+#endif
+
+//------------------------------------------------------------------------------
+void
+futex::Wait(std::atomic<uint32>* addr, uint32 expected) {
+    #if ORYOL_FUTEX_SYSCALL
+    syscall(SYS_futex, (uint32*)addr, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+    #elif ORYOL_HAS_THREADS
+    bucket& b = lookupBucket(addr);
+    std::unique_lock<std::mutex> lock(b.mutex);
+    // the value check must happen under the bucket lock, otherwise
+    // a wakeup between check and wait would get lost
+    if (addr->load(std::memory_order_relaxed) == expected) {
+        b.cond.wait(lock);
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+futex::WakeOne(std::atomic<uint32>* addr) {
+    #if ORYOL_FUTEX_SYSCALL
+    syscall(SYS_futex, (uint32*)addr, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    #elif ORYOL_HAS_THREADS
+    // different addresses may share the bucket, so this must wake everybody
+    bucket& b = lookupBucket(addr);
+    std::lock_guard<std::mutex> lock(b.mutex);
+    b.cond.notify_all();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+futex::WakeAll(std::atomic<uint32>* addr) {
+    #if ORYOL_FUTEX_SYSCALL
+    syscall(SYS_futex, (uint32*)addr, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    #elif ORYOL_HAS_THREADS
+    bucket& b = lookupBucket(addr);
+    std::lock_guard<std::mutex> lock(b.mutex);
+    b.cond.notify_all();
+    #endif
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,34 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::futex
+    @ingroup _priv
+    @brief park threads on the value of a 32-bit atomic
+
+    Wait() blocks the calling thread as long as the atomic has the
+    expected value, Wake() wakes up threads blocked on the same
+    atomic. On Linux and Android this maps directly to the futex
+    syscall, other platforms emulate it with a small table of
+    mutex/condition-variable pairs hashed by address. Wait() may return
+    spuriously, callers must always re-check their condition.
+
+    On platforms without threads Wait() returns immediately.
+*/
+#include "Core/Types.h"
+#include <atomic>
+
+namespace Oryol {
+namespace _priv {
+
+class futex {
+public:
+    /// block while value at addr equals expected (may return spuriously)
+    static void Wait(std::atomic<uint32>* addr, uint32 expected);
+    /// wake up one thread waiting on addr
+    static void WakeOne(std::atomic<uint32>* addr);
+    /// wake up all threads waiting on addr
+    static void WakeAll(std::atomic<uint32>* addr);
+};
+
+} // namespace _priv
+} // namespace Oryol
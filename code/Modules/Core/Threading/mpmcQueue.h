@@ -0,0 +1,197 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::mpmcQueue
+    @ingroup _priv
+    @brief bounded, lock-free multi-producer/multi-consumer ring buffer
+
+    A fixed-capacity ring buffer which can be written and read from
+    any number of threads without locking. Each slot carries a
+    sequence number which tells producers and consumers whether the slot
+    is ready for writing or reading (see Dmitry Vyukov's bounded MPMC
+    queue: http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue).
+
+    Values are moved in and out of the slots, so for Ptr<> elements
+    no additional reference counting happens inside the queue.
+    The capacity must be a power of 2.
+*/
+#include "Core/Types.h"
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include <atomic>
+#include <utility>
+
+namespace Oryol {
+namespace _priv {
+
+template<class TYPE> class mpmcQueue {
+public:
+    /// constructor with capacity (must be power of 2)
+    mpmcQueue(int32 capacity);
+    /// destructor
+    ~mpmcQueue();
+
+    /// copy-enqueue a value, return false if queue is full
+    bool Enqueue(const TYPE& val);
+    /// move-enqueue a value, return false if queue is full
+    bool Enqueue(TYPE&& val);
+    /// dequeue a value, return false if queue is empty
+    bool Dequeue(TYPE& outVal);
+    /// get the capacity
+    int32 Capacity() const;
+    /// get approximate number of queued values (only exact if no other thread is accessing the queue)
+    int32 Size() const;
+    /// return true if the queue is (approximately) empty
+    bool Empty() const;
+
+private:
+    /// find and reserve a free slot for writing, return nullptr if full
+    struct slot;
+    slot* reserveWrite(uintptr& outPos);
+
+    struct slot {
+        std::atomic<uintptr> sequence;
+        TYPE value;
+    };
+    static const int32 cacheLineSize = 64;
+
+    slot* slots;
+    uintptr mask;
+    // head and tail live on separate cache lines to prevent false sharing
+    uint8 pad0[cacheLineSize];
+    std::atomic<uintptr> enqueuePos;
+    uint8 pad1[cacheLineSize - sizeof(std::atomic<uintptr>)];
+    std::atomic<uintptr> dequeuePos;
+    uint8 pad2[cacheLineSize - sizeof(std::atomic<uintptr>)];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+mpmcQueue<TYPE>::mpmcQueue(int32 capacity) :
+slots(nullptr),
+mask(capacity - 1),
+enqueuePos(0),
+dequeuePos(0) {
+    o_assert((capacity >= 2) && (0 == (capacity & (capacity - 1))));
+    this->slots = (slot*) Memory::Alloc(capacity * sizeof(slot));
+    for (int32 i = 0; i < capacity; i++) {
+        new(&this->slots[i]) slot();
+        this->slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+mpmcQueue<TYPE>::~mpmcQueue() {
+    const int32 capacity = this->Capacity();
+    for (int32 i = 0; i < capacity; i++) {
+        this->slots[i].~slot();
+    }
+    Memory::Free(this->slots);
+    this->slots = nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+mpmcQueue<TYPE>::Capacity() const {
+    return int32(this->mask + 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+mpmcQueue<TYPE>::Size() const {
+    const uintptr tail = this->dequeuePos.load(std::memory_order_relaxed);
+    const uintptr head = this->enqueuePos.load(std::memory_order_relaxed);
+    return (head > tail) ? int32(head - tail) : 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+mpmcQueue<TYPE>::Empty() const {
+    return 0 == this->Size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> typename mpmcQueue<TYPE>::slot*
+mpmcQueue<TYPE>::reserveWrite(uintptr& outPos) {
+    uintptr pos = this->enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        slot* s = &this->slots[pos & this->mask];
+        const uintptr seq = s->sequence.load(std::memory_order_acquire);
+        const intptr diff = intptr(seq) - intptr(pos);
+        if (0 == diff) {
+            // slot is free, try to claim it
+            if (this->enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                outPos = pos;
+                return s;
+            }
+        }
+        else if (diff < 0) {
+            // queue is full
+            return nullptr;
+        }
+        else {
+            // another producer was faster
+            pos = this->enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+mpmcQueue<TYPE>::Enqueue(const TYPE& val) {
+    uintptr pos = 0;
+    slot* s = this->reserveWrite(pos);
+    if (s) {
+        s->value = val;
+        s->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+mpmcQueue<TYPE>::Enqueue(TYPE&& val) {
+    uintptr pos = 0;
+    slot* s = this->reserveWrite(pos);
+    if (s) {
+        s->value = std::move(val);
+        s->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+mpmcQueue<TYPE>::Dequeue(TYPE& outVal) {
+    uintptr pos = this->dequeuePos.load(std::memory_order_relaxed);
+    slot* s = nullptr;
+    for (;;) {
+        s = &this->slots[pos & this->mask];
+        const uintptr seq = s->sequence.load(std::memory_order_acquire);
+        const intptr diff = intptr(seq) - intptr(pos + 1);
+        if (0 == diff) {
+            // slot has been written, try to claim it
+            if (this->dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // queue is empty
+            return false;
+        }
+        else {
+            // another consumer was faster
+            pos = this->dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    outVal = std::move(s->value);
+    s->sequence.store(pos + this->mask + 1, std::memory_order_release);
+    return true;
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,157 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::workStealingDeque
+    @ingroup _priv
+    @brief fixed-capacity Chase-Lev work-stealing deque
+
+    The owner thread pushes and pops values at the bottom end (LIFO,
+    good for cache locality), any other thread may steal values from
+    the top end (FIFO) without locking. The implementation follows
+    "Correct and Efficient Work-Stealing for Weak Memory Models"
+    (Le, Pop, Cohen, Zappa Nardelli, PPoPP 2013), but doesn't grow
+    the buffer, Push() returns false when the deque is full.
+
+    TYPE must be trivially copyable (usually a pointer), and the
+    capacity must be a power of 2.
+*/
+#include "Core/Types.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include <atomic>
+
+namespace Oryol {
+namespace _priv {
+
+template<class TYPE> class workStealingDeque {
+public:
+    /// constructor with capacity (must be power of 2)
+    workStealingDeque(int32 capacity);
+    /// destructor
+    ~workStealingDeque();
+
+    /// push a value to the bottom (owner thread only), return false if full
+    bool Push(TYPE val);
+    /// pop a value from the bottom (owner thread only), return false if empty
+    bool Pop(TYPE& outVal);
+    /// steal a value from the top (any thread), return false if empty or lost a race
+    bool Steal(TYPE& outVal);
+    /// get the capacity
+    int32 Capacity() const;
+    /// get approximate number of values in the deque
+    int32 Size() const;
+    /// return true if the deque is (approximately) empty
+    bool Empty() const;
+
+private:
+    static const int32 cacheLineSize = 64;
+
+    std::atomic<TYPE>* buffer;
+    int64 mask;
+    uint8 pad0[cacheLineSize];
+    std::atomic<int64> top;
+    uint8 pad1[cacheLineSize - sizeof(std::atomic<int64>)];
+    std::atomic<int64> bottom;
+    uint8 pad2[cacheLineSize - sizeof(std::atomic<int64>)];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+workStealingDeque<TYPE>::workStealingDeque(int32 capacity) :
+buffer(nullptr),
+mask(capacity - 1),
+top(0),
+bottom(0) {
+    o_assert((capacity >= 2) && (0 == (capacity & (capacity - 1))));
+    this->buffer = (std::atomic<TYPE>*) Memory::Alloc(capacity * sizeof(std::atomic<TYPE>));
+    for (int32 i = 0; i < capacity; i++) {
+        new(&this->buffer[i]) std::atomic<TYPE>();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+workStealingDeque<TYPE>::~workStealingDeque() {
+    Memory::Free(this->buffer);
+    this->buffer = nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+workStealingDeque<TYPE>::Capacity() const {
+    return int32(this->mask + 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+workStealingDeque<TYPE>::Size() const {
+    const int64 b = this->bottom.load(std::memory_order_relaxed);
+    const int64 t = this->top.load(std::memory_order_relaxed);
+    return (b > t) ? int32(b - t) : 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+workStealingDeque<TYPE>::Empty() const {
+    return 0 == this->Size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+workStealingDeque<TYPE>::Push(TYPE val) {
+    const int64 b = this->bottom.load(std::memory_order_relaxed);
+    const int64 t = this->top.load(std::memory_order_acquire);
+    if ((b - t) > this->mask) {
+        // deque is full
+        return false;
+    }
+    this->buffer[b & this->mask].store(val, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    this->bottom.store(b + 1, std::memory_order_relaxed);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+workStealingDeque<TYPE>::Pop(TYPE& outVal) {
+    const int64 b = this->bottom.load(std::memory_order_relaxed) - 1;
+    this->bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64 t = this->top.load(std::memory_order_relaxed);
+    bool success = false;
+    if (t <= b) {
+        outVal = this->buffer[b & this->mask].load(std::memory_order_relaxed);
+        success = true;
+        if (t == b) {
+            // last value in deque, race against thieves
+            if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                success = false;
+            }
+            this->bottom.store(b + 1, std::memory_order_relaxed);
+        }
+    }
+    else {
+        // deque was empty
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return success;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+workStealingDeque<TYPE>::Steal(TYPE& outVal) {
+    int64 t = this->top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64 b = this->bottom.load(std::memory_order_acquire);
+    if (t < b) {
+        TYPE val = this->buffer[t & this->mask].load(std::memory_order_relaxed);
+        if (this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            outVal = val;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -307,3 +307,26 @@ TEST(ArrayTest) {
     CHECK(array5[1].Value() == String("Blub"));
 }
 
+TEST(ArrayAddRangeTest) {
+    // POD elements are copied in bulk
+    const int32 ints[] = { 1, 2, 3, 4, 5 };
+    Array<int32> array0;
+    array0.AddRange(ints, 0);
+    CHECK(array0.Empty());
+    array0.Add(0);
+    array0.AddRange(ints, 5);
+    CHECK(array0.Size() == 6);
+    for (int32 i = 0; i < 6; i++) {
+        CHECK(array0[i] == i);
+    }
+
+    // non-POD elements are copy-constructed
+    const String strs[] = { "Bla", "Blub" };
+    Array<String> array1;
+    array1.AddRange(strs, 2);
+    array1.AddRange(strs, 1);
+    CHECK(array1.Size() == 3);
+    CHECK(array1[0] == "Bla");
+    CHECK(array1[1] == "Blub");
+    CHECK(array1[2] == "Bla");
+}
@@ -0,0 +1,202 @@
+//------------------------------------------------------------------------------
+//  AsyncLogTest.cc
+//  Test asynchronous logging.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
+#include "Core/Log.h"
+#include "Core/Logger.h"
+#include "Core/Ptr.h"
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Oryol;
+
+namespace {
+
+// captures test messages, and prints everything else like the default output
+class captureLogger : public Logger {
+    OryolClassDecl(captureLogger);
+public:
+    virtual void VPrintRecord(Log::Level l, int64 timeNs, uint64 threadId, const char* msg, va_list args) override {
+        this->curTimeNs = timeNs;
+        this->curThreadId = threadId;
+        this->VPrint(l, msg, args);
+    }
+    virtual void VPrint(Log::Level l, const char* msg, va_list args) override {
+        char buf[1024];
+        std::vsnprintf(buf, sizeof(buf), msg, args);
+        if (0 == std::strncmp(buf, "asynclog:", 9)) {
+            {
+                std::lock_guard<std::mutex> guard(this->lock);
+                this->threadIds.push_back(0);
+                this->indices.push_back(0);
+                std::sscanf(buf, "asynclog: t=%d i=%d", &this->threadIds.back(), &this->indices.back());
+                this->levels.push_back(l);
+                this->timeNs.push_back(this->curTimeNs);
+                this->nativeThreadIds.push_back(this->curThreadId);
+                this->lengths.push_back(int(std::strlen(buf)));
+            }
+            // an error logged from a logger must not deadlock the drain thread
+            if (std::strstr(buf, "reenter")) {
+                Log::Error("asynclog: t=0 i=7\n");
+            }
+        }
+        else {
+            std::printf("%s", buf);
+        }
+    }
+    void clear() {
+        this->threadIds.clear();
+        this->indices.clear();
+        this->levels.clear();
+        this->timeNs.clear();
+        this->nativeThreadIds.clear();
+        this->lengths.clear();
+    }
+    virtual void AssertMsg(const char* cond, const char* msg, const char* file, int32 line, const char* func) override {
+        std::printf("oryol assert: cond='%s'\nmsg='%s'\nfile='%s'\nline='%d'\nfunc='%s'\n",
+                    cond, msg ? msg : "none", file, line, func);
+    }
+    std::mutex lock;
+    std::vector<int> threadIds;
+    std::vector<int> indices;
+    std::vector<Log::Level> levels;
+    std::vector<int64> timeNs;
+    std::vector<uint64> nativeThreadIds;
+    std::vector<int> lengths;
+    int64 curTimeNs = 0;
+    uint64 curThreadId = 0;
+};
+OryolClassImpl(captureLogger);
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(AsyncLogTest) {
+    Ptr<captureLogger> logger = captureLogger::Create();
+    Log::AddLogger(logger);
+
+    CHECK(!Log::IsAsync());
+    Log::EnableAsync(64);
+    CHECK(Log::IsAsync());
+    CHECK(Log::NumDroppedRecords() == 0);
+
+    // log from several threads, each thread's messages must arrive in order
+    const int numThreads = 4;
+    const int numMessages = 2000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.push_back(std::thread([t]() {
+            Core::EnterThread();
+            for (int i = 0; i < numMessages; i++) {
+                Log::Info("asynclog: t=%d i=%d\n", t, i);
+            }
+            Core::LeaveThread();
+        }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    Log::Flush();
+    {
+        std::lock_guard<std::mutex> guard(logger->lock);
+        const int64 numReceived = int64(logger->indices.size());
+        CHECK(numReceived + Log::NumDroppedRecords() == numThreads * numMessages);
+        CHECK(numReceived > 0);
+        int lastIndex[numThreads] = { -1, -1, -1, -1 };
+        int64 lastTime[numThreads] = { 0, 0, 0, 0 };
+        std::map<int, uint64> nativeIds;
+        bool ordered = true;
+        bool timeOrdered = true;
+        bool sameThread = true;
+        for (size_t i = 0; i < logger->indices.size(); i++) {
+            const int t = logger->threadIds[i];
+            ordered &= logger->indices[i] > lastIndex[t];
+            lastIndex[t] = logger->indices[i];
+            // records carry the time and thread of the log call
+            timeOrdered &= logger->timeNs[i] >= lastTime[t];
+            lastTime[t] = logger->timeNs[i];
+            if (nativeIds.count(t)) {
+                sameThread &= nativeIds[t] == logger->nativeThreadIds[i];
+            }
+            else {
+                nativeIds[t] = logger->nativeThreadIds[i];
+            }
+        }
+        CHECK(ordered);
+        CHECK(timeOrdered);
+        CHECK(sameThread);
+        for (const auto& a : nativeIds) {
+            for (const auto& b : nativeIds) {
+                CHECK((a.first == b.first) || (a.second != b.second));
+            }
+        }
+        logger->clear();
+    }
+
+    // errors are written synchronously after the pending records
+    Log::Warn("asynclog: t=0 i=1\n");
+    Log::Error("asynclog: t=0 i=2\n");
+    {
+        std::lock_guard<std::mutex> guard(logger->lock);
+        CHECK(logger->indices.size() == 2);
+        if (logger->indices.size() == 2) {
+            CHECK(logger->indices[0] == 1);
+            CHECK(logger->levels[0] == Log::Level::Warn);
+            CHECK(logger->indices[1] == 2);
+            CHECK(logger->levels[1] == Log::Level::Error);
+        }
+        logger->clear();
+    }
+
+    // messages which don't fit into a record are written synchronously, not truncated
+    const std::string longStr(2 * Log::MaxAsyncMsgLength, 'x');
+    Log::Info("asynclog: t=0 i=5\n");
+    Log::Info("asynclog: t=0 i=6 %s\n", longStr.c_str());
+    {
+        std::lock_guard<std::mutex> guard(logger->lock);
+        CHECK(logger->indices.size() == 2);
+        if (logger->indices.size() == 2) {
+            CHECK(logger->indices[0] == 5);
+            CHECK(logger->indices[1] == 6);
+            CHECK(logger->lengths[1] == int(std::strlen("asynclog: t=0 i=6 \n") + longStr.size()));
+            CHECK(logger->nativeThreadIds[1] == logger->nativeThreadIds[0]);
+        }
+        logger->clear();
+    }
+
+    // a logger which logs an error while a record is output
+    Log::Info("asynclog: t=0 i=6 reenter\n");
+    Log::Flush();
+    {
+        std::lock_guard<std::mutex> guard(logger->lock);
+        CHECK(logger->indices.size() == 2);
+        if (logger->indices.size() == 2) {
+            CHECK(logger->indices[0] == 6);
+            CHECK(logger->indices[1] == 7);
+            CHECK(logger->levels[1] == Log::Level::Error);
+        }
+        logger->clear();
+    }
+
+    // disabling writes the pending records, and switches back to synchronous
+    Log::Info("asynclog: t=0 i=3\n");
+    Log::DisableAsync();
+    CHECK(!Log::IsAsync());
+    Log::Info("asynclog: t=0 i=4\n");
+    {
+        std::lock_guard<std::mutex> guard(logger->lock);
+        CHECK(logger->indices.size() == 2);
+        if (logger->indices.size() == 2) {
+            CHECK(logger->indices[0] == 3);
+            CHECK(logger->indices[1] == 4);
+        }
+    }
+}
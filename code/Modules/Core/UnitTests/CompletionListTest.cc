@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------
+//  CompletionListTest.cc
+//  Test CompletionList functionality.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Threading/CompletionList.h"
+#include <thread>
+
+using namespace Oryol;
+
+TEST(CompletionListTest) {
+    Ptr<CompletionList> list = CompletionList::Create();
+    Array<uint64> tags;
+    CHECK(list->Empty());
+    CHECK(list->TakeAll(tags) == 0);
+    CHECK(tags.Empty());
+
+    // tags come out oldest first
+    list->Push(1);
+    list->Push(2);
+    list->Push(3);
+    CHECK(!list->Empty());
+    CHECK(list->TakeAll(tags) == 3);
+    CHECK(tags.Size() == 3);
+    CHECK(tags[0] == 1 && tags[1] == 2 && tags[2] == 3);
+    CHECK(list->Empty());
+    list->Push(4);
+    CHECK(list->TakeAll(tags) == 1);
+    CHECK(tags.Size() == 4);
+    CHECK(tags[3] == 4);
+
+    // pushed tags which are never taken are freed by the destructor
+    list->Push(5);
+    list = nullptr;
+
+    // concurrent producers, every tag must arrive exactly once
+    list = CompletionList::Create();
+    const int32 numThreads = 4;
+    const int32 numTags = 10000;
+    std::thread threads[numThreads];
+    for (int32 t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([list, t, numTags] {
+            for (int32 i = 0; i < numTags; i++) {
+                list->Push(uint64(t * numTags + i));
+            }
+        });
+    }
+    Array<uint64> all;
+    while (all.Size() < numThreads * numTags) {
+        list->TakeAll(all);
+        std::this_thread::yield();
+    }
+    for (int32 t = 0; t < numThreads; t++) {
+        threads[t].join();
+    }
+    Array<int32> counts;
+    for (int32 i = 0; i < numThreads * numTags; i++) {
+        counts.Add(0);
+    }
+    bool ordered = true;
+    Array<int64> last;
+    for (int32 t = 0; t < numThreads; t++) {
+        last.Add(-1);
+    }
+    for (uint64 tag : all) {
+        counts[int32(tag)]++;
+        // tags of the same producer keep their order
+        const int32 t = int32(tag / numTags);
+        ordered &= int64(tag) > last[t];
+        last[t] = int64(tag);
+    }
+    bool once = true;
+    for (int32 c : counts) {
+        once &= (1 == c);
+    }
+    CHECK(once);
+    CHECK(ordered);
+    CHECK(list->Empty());
+}
@@ -0,0 +1,240 @@
+//------------------------------------------------------------------------------
+//  HashMapTest.cc
+//  Test HashMap functionality.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/Containers/HashSet.h"
+#include "Core/Containers/Map.h"
+#include "Core/String/String.h"
+#include "Core/Log.h"
+#include <chrono>
+
+using namespace Oryol;
+using namespace Oryol::_priv;
+
+// a really bad hasher to force collisions
+struct BadHasher {
+    uint32 operator()(int32 val) const {
+        return val & 3;
+    };
+};
+
+struct IntHasher {
+    uint32 operator()(int32 val) const {
+        return uint32(val);
+    };
+};
+
+//------------------------------------------------------------------------------
+TEST(hashMapGroupTest) {
+    int8 ctrl[16];
+    for (int32 i = 0; i < 16; i++) {
+        ctrl[i] = hashMapCtrl::Empty;
+    }
+    ctrl[1] = 5;
+    ctrl[7] = 5;
+    ctrl[9] = hashMapCtrl::Deleted;
+    ctrl[15] = 127;
+    hashMapGroup g(ctrl);
+    auto match = g.Match(5);
+    CHECK(match && (match.Lowest() == 1));
+    match.ClearLowest();
+    CHECK(match && (match.Lowest() == 7));
+    match.ClearLowest();
+    CHECK(!match);
+    CHECK(g.Match(127).Lowest() == 15);
+    CHECK(!g.Match(0));
+    CHECK(g.MatchEmpty().Lowest() == 0);
+    auto free = g.MatchEmptyOrDeleted();
+    int32 numFree = 0;
+    for (; free; free.ClearLowest()) {
+        numFree++;
+    }
+    CHECK(numFree == 13);
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapTest) {
+    HashMap<int32, String> map;
+    CHECK(map.Empty());
+    CHECK(map.Size() == 0);
+    CHECK(map.Capacity() == 0);
+    CHECK(!map.Contains(1));
+    CHECK(map.Find(1) == nullptr);
+    CHECK(map.begin() == map.end());
+
+    map.Add(1, "one");
+    map.Add(KeyValuePair<int32, String>(2, "two"));
+    CHECK(map.AddUnique(3, "three"));
+    CHECK(!map.AddUnique(3, "drei"));
+    CHECK(map.Size() == 3);
+    CHECK(map.Capacity() == 16);
+    CHECK(map[1] == "one");
+    CHECK(map[2] == "two");
+    CHECK(map[3] == "three");
+    CHECK(*map.Find(2) == "two");
+    map[2] = "zwei";
+    CHECK(map[2] == "zwei");
+
+    // iteration
+    int32 keySum = 0;
+    for (const auto& kvp : map) {
+        keySum += kvp.key;
+    }
+    CHECK(keySum == 6);
+
+    // copy and move
+    HashMap<int32, String> map1(map);
+    CHECK(map1.Size() == 3);
+    CHECK(map1[3] == "three");
+    HashMap<int32, String> map2(std::move(map1));
+    CHECK(map1.Empty());
+    CHECK(map1.Capacity() == 0);
+    CHECK(map2[1] == "one");
+    map1 = map2;
+    CHECK(map1[2] == "zwei");
+    map2 = std::move(map1);
+    CHECK(map2.Size() == 3);
+
+    // erase
+    map.Erase(2);
+    map.Erase(4);
+    CHECK(map.Size() == 2);
+    CHECK(!map.Contains(2));
+    CHECK(map.Contains(1));
+    CHECK(map.Contains(3));
+    map.Clear();
+    CHECK(map.Empty());
+    CHECK(map.Capacity() == 16);
+
+    // grow with many elements
+    for (int32 i = 0; i < 10000; i++) {
+        map.Add(i, String("bla"));
+    }
+    CHECK(map.Size() == 10000);
+    CHECK(map.Capacity() == 16384);
+    bool allFound = true;
+    for (int32 i = 0; i < 10000; i++) {
+        allFound &= map.Contains(i);
+    }
+    CHECK(allFound);
+    CHECK(!map.Contains(10000));
+    for (int32 i = 0; i < 10000; i += 2) {
+        map.Erase(i);
+    }
+    CHECK(map.Size() == 5000);
+    bool allOk = true;
+    for (int32 i = 0; i < 10000; i++) {
+        allOk &= (map.Contains(i) == (0 != (i & 1)));
+    }
+    CHECK(allOk);
+    int32 numIterated = 0;
+    for (auto& kvp : map) {
+        CHECK(kvp.key & 1);
+        CHECK(kvp.value == "bla");
+        numIterated++;
+    }
+    CHECK(numIterated == 5000);
+
+    // reserve
+    HashMap<int32, int32> map3;
+    map3.Reserve(1000);
+    const int32 capacity = map3.Capacity();
+    CHECK(capacity == 2048);
+    for (int32 i = 0; i < 1000; i++) {
+        map3.Add(i, i);
+    }
+    CHECK(map3.Capacity() == capacity);
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapCollisionTest) {
+    // all keys land in only 4 hash values, erase and reinsert over and
+    // over to create lots of deleted slots
+    HashMap<int32, int32, BadHasher> map;
+    for (int32 i = 0; i < 500; i++) {
+        map.Add(i, i * 2);
+    }
+    for (int32 round = 0; round < 10; round++) {
+        for (int32 i = 0; i < 500; i += 3) {
+            map.Erase(i);
+        }
+        for (int32 i = 0; i < 500; i += 3) {
+            map.Add(i, i * 2);
+        }
+    }
+    CHECK(map.Size() == 500);
+    CHECK(map.Capacity() <= 1024);
+    bool allOk = true;
+    for (int32 i = 0; i < 500; i++) {
+        allOk &= (map[i] == i * 2);
+    }
+    CHECK(allOk);
+    CHECK(!map.Contains(500));
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapBenchmark) {
+    typedef std::chrono::high_resolution_clock clock;
+    const int32 sizes[] = { 1000, 100000, 1000000 };
+    for (int32 numKeys : sizes) {
+        // pseudo-random unique keys
+        Array<int32> keys;
+        keys.Reserve(numKeys);
+        for (int32 i = 0; i < numKeys; i++) {
+            keys.Add(int32((uint32(i) * 2654435761u) & 0x7FFFFFFF));
+        }
+        int32 found = 0;
+
+        // Map, filled in bulk mode (random single inserts are O(n))
+        auto t0 = clock::now();
+        Map<int32, int32> map;
+        map.Reserve(numKeys);
+        map.BeginBulk();
+        for (int32 key : keys) {
+            map.AddBulk(KeyValuePair<int32, int32>(key, key));
+        }
+        map.EndBulk();
+        auto t1 = clock::now();
+        for (int32 key : keys) {
+            found += map.Contains(key) ? 1 : 0;
+        }
+        auto t2 = clock::now();
+        const double mapAdd = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        const double mapFind = std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+        // HashSet (same bucket count as stringAtomTable)
+        t0 = clock::now();
+        HashSet<int32, IntHasher, 1024> hashSet;
+        for (int32 key : keys) {
+            hashSet.Add(key);
+        }
+        t1 = clock::now();
+        for (int32 key : keys) {
+            found += hashSet.Contains(key) ? 1 : 0;
+        }
+        t2 = clock::now();
+        const double setAdd = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        const double setFind = std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+        // HashMap
+        t0 = clock::now();
+        HashMap<int32, int32> hashMap;
+        for (int32 key : keys) {
+            hashMap.Add(key, key);
+        }
+        t1 = clock::now();
+        for (int32 key : keys) {
+            found += hashMap.Contains(key) ? 1 : 0;
+        }
+        t2 = clock::now();
+        const double hashAdd = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        const double hashFind = std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+        CHECK(found == 3 * numKeys);
+        Log::Info("%7d keys: Map add %8.3fms find %8.3fms, HashSet add %8.3fms find %8.3fms, HashMap add %8.3fms find %8.3fms\n",
+            numKeys, mapAdd, mapFind, setAdd, setFind, hashAdd, hashFind);
+    }
+}
@@ -0,0 +1,161 @@
+//------------------------------------------------------------------------------
+//  JobSystemTest.cc
+//  Test JobSystem functionality.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Threading/JobSystem.h"
+#include "Core/Threading/workStealingDeque.h"
+#include "Core/String/StringAtom.h"
+#include <atomic>
+#include <chrono>
+
+using namespace Oryol;
+using namespace Oryol::_priv;
+
+//------------------------------------------------------------------------------
+TEST(workStealingDequeTest) {
+    workStealingDeque<int32*> deque(4);
+    int32 vals[5] = { 0, 1, 2, 3, 4 };
+    int32* ptr = nullptr;
+    CHECK(deque.Capacity() == 4);
+    CHECK(deque.Empty());
+    CHECK(!deque.Pop(ptr));
+    CHECK(!deque.Steal(ptr));
+    CHECK(deque.Push(&vals[0]));
+    CHECK(deque.Push(&vals[1]));
+    CHECK(deque.Push(&vals[2]));
+    CHECK(deque.Push(&vals[3]));
+    CHECK(!deque.Push(&vals[4]));
+    CHECK(deque.Size() == 4);
+    // owner pops from the bottom, thieves steal from the top
+    CHECK(deque.Pop(ptr) && (ptr == &vals[3]));
+    CHECK(deque.Steal(ptr) && (ptr == &vals[0]));
+    CHECK(deque.Push(&vals[4]));
+    CHECK(deque.Steal(ptr) && (ptr == &vals[1]));
+    CHECK(deque.Pop(ptr) && (ptr == &vals[4]));
+    CHECK(deque.Pop(ptr) && (ptr == &vals[2]));
+    CHECK(!deque.Pop(ptr));
+    CHECK(!deque.Steal(ptr));
+    CHECK(deque.Empty());
+}
+
+//------------------------------------------------------------------------------
+TEST(JobSystemTest) {
+    JobSystem::Setup(4);
+    CHECK(JobSystem::IsValid());
+    CHECK(JobSystem::NumWorkers() == 4);
+
+    // run many small jobs from the main thread
+    std::atomic<int32> sum{0};
+    JobCounter counter;
+    for (int32 i = 0; i < 10000; i++) {
+        JobSystem::Run([&sum, i]() {
+            sum += i;
+        }, &counter);
+    }
+    JobSystem::Wait(&counter);
+    CHECK(counter.IsDone());
+    CHECK(sum == (10000 * 9999) / 2);
+
+    // jobs spawning jobs (these go into the workers' own deques)
+    std::atomic<int32> numLeafJobs{0};
+    JobCounter outerCounter;
+    JobCounter innerCounter;
+    for (int32 i = 0; i < 16; i++) {
+        JobSystem::Run([&numLeafJobs, &innerCounter]() {
+            for (int32 j = 0; j < 256; j++) {
+                JobSystem::Run([&numLeafJobs]() {
+                    numLeafJobs++;
+                }, &innerCounter);
+            }
+        }, &outerCounter);
+    }
+    JobSystem::Wait(&outerCounter);
+    JobSystem::Wait(&innerCounter);
+    CHECK(numLeafJobs == 16 * 256);
+
+    // dependencies: the second stage must only start after the first has finished
+    for (int32 round = 0; round < 100; round++) {
+        std::atomic<int32> stage0{0};
+        std::atomic<int32> stage1Errors{0};
+        JobCounter stage0Counter;
+        JobCounter stage1Counter;
+        for (int32 i = 0; i < 8; i++) {
+            JobSystem::Run([&stage0]() {
+                std::this_thread::yield();
+                stage0++;
+            }, &stage0Counter);
+        }
+        for (int32 i = 0; i < 8; i++) {
+            JobSystem::Run([&stage0, &stage1Errors]() {
+                if (stage0 != 8) {
+                    stage1Errors++;
+                }
+            }, &stage1Counter, &stage0Counter);
+        }
+        JobSystem::Wait(&stage1Counter);
+        JobSystem::Wait(&stage0Counter);
+        CHECK(stage1Errors == 0);
+    }
+
+    // worker threads have thread-local RunLoops and StringAtom tables
+    std::atomic<int32> numValid{0};
+    JobCounter tlsCounter;
+    for (int32 i = 0; i < 64; i++) {
+        JobSystem::Run([&numValid]() {
+            StringAtom atom("JobSystemTest");
+            if ((nullptr != Core::PreRunLoop()) && (atom == "JobSystemTest")) {
+                numValid++;
+            }
+        }, &tlsCounter);
+    }
+    JobSystem::Wait(&tlsCounter);
+    CHECK(numValid == 64);
+
+    JobSystem::Discard();
+    CHECK(!JobSystem::IsValid());
+}
+
+//------------------------------------------------------------------------------
+TEST(ParallelForTest) {
+    JobSystem::Setup();
+    CHECK(JobSystem::NumWorkers() >= 1);
+
+    const int32 num = 100000;
+    int32* values = (int32*) Memory::Alloc(num * sizeof(int32));
+    Memory::Clear(values, num * sizeof(int32));
+    for (int32 grainSize : { 0, 1, 100, 99999, 200000 }) {
+        JobSystem::ParallelFor(0, num, grainSize, [values](int32 first, int32 last) {
+            for (int32 i = first; i < last; i++) {
+                values[i]++;
+            }
+        });
+    }
+    bool allValid = true;
+    for (int32 i = 0; i < num; i++) {
+        allValid &= (values[i] == 5);
+    }
+    CHECK(allValid);
+    Memory::Free(values);
+
+    // empty range does nothing
+    bool called = false;
+    JobSystem::ParallelFor(10, 10, 0, [&called](int32, int32) { called = true; });
+    CHECK(!called);
+
+    // nested ParallelFor inside jobs
+    std::atomic<int64> total{0};
+    JobSystem::ParallelFor(0, 64, 1, [&total](int32 first, int32 last) {
+        for (int32 i = first; i < last; i++) {
+            JobSystem::ParallelFor(0, 1000, 0, [&total](int32 first, int32 last) {
+                total += last - first;
+            });
+        }
+    });
+    CHECK(total == 64 * 1000);
+
+    JobSystem::Discard();
+}
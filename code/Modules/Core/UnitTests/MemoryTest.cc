@@ -5,7 +5,10 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/Memory/Memory.h"
+#include "Core/Memory/tlsfHeap.h"
 #include "Core/Assertion.h"
+#include "Core/Containers/Array.h"
+#include <cstdlib>
 
 using namespace Oryol;
 
@@ -75,4 +78,180 @@ TEST(Memory) {
     CHECK((intptr(ptr) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
 }
 
+//------------------------------------------------------------------------------
+TEST(tlsfHeap) {
+    const int32 regionSize = 1024 * 1024;
+    void* region = std::malloc(regionSize);
+    _priv::tlsfHeap heap;
+    heap.Setup(region, regionSize);
+    CHECK(heap.IsValid());
+    CHECK(heap.Check());
+    CHECK(heap.UsedBytes() == 0);
+
+    // simple alloc/free, alignment and merging
+    void* p0 = heap.Alloc(1);
+    void* p1 = heap.Alloc(100);
+    void* p2 = heap.Alloc(1000);
+    CHECK(p0 && p1 && p2);
+    CHECK((intptr(p0) & 15) == 0);
+    CHECK((intptr(p1) & 15) == 0);
+    CHECK((intptr(p2) & 15) == 0);
+    CHECK(heap.Owns(p0) && heap.Owns(p1) && heap.Owns(p2));
+    CHECK(heap.UsedBytes() == 16 + 112 + 1008);
+    CHECK(heap.Check());
+    heap.Free(p1);
+    CHECK(heap.Check());
+    heap.Free(p0);
+    CHECK(heap.Check());
+    heap.Free(p2);
+    CHECK(heap.Check());
+    CHECK(heap.UsedBytes() == 0);
 
+    // a block which is too big must fail, the whole heap must succeed after merging
+    CHECK(nullptr == heap.Alloc(2 * regionSize));
+    void* big = heap.Alloc(regionSize / 2);
+    CHECK(nullptr != big);
+    heap.Free(big);
+
+    // random alloc/free
+    const int32 numSlots = 512;
+    void* ptrs[numSlots] = { };
+    srand(1234);
+    bool valid = true;
+    for (int32 i = 0; i < 20000; i++) {
+        const int32 slot = rand() % numSlots;
+        if (ptrs[slot]) {
+            heap.Free(ptrs[slot]);
+            ptrs[slot] = nullptr;
+        }
+        else {
+            const int32 size = (rand() & 1) ? (rand() % 256) : (rand() % 8192);
+            ptrs[slot] = heap.Alloc(size);
+            valid &= (nullptr != ptrs[slot]);
+            if (ptrs[slot]) {
+                Memory::Fill(ptrs[slot], size, 0xAB);
+            }
+        }
+        if (0 == (i % 1000)) {
+            valid &= heap.Check();
+        }
+    }
+    CHECK(valid);
+    for (int32 i = 0; i < numSlots; i++) {
+        if (ptrs[i]) {
+            heap.Free(ptrs[i]);
+        }
+    }
+    CHECK(heap.Check());
+    CHECK(heap.UsedBytes() == 0);
+    heap.Discard();
+    std::free(region);
+}
+
+//------------------------------------------------------------------------------
+TEST(MemoryBackends) {
+    CHECK(Memory::GetBackend() == Memory::Backend::Malloc);
+    Memory::SetupTLSF(4 * 1024 * 1024);
+    Memory::SetupFrameArena(64 * 1024);
+
+    // allocate from the TLSF heap and resize through all backends
+    uint8* p0 = nullptr;
+    {
+        Memory::BackendScope scope(Memory::Backend::TLSF);
+        CHECK(Memory::GetBackend() == Memory::Backend::TLSF);
+        p0 = (uint8*) Memory::Alloc(64);
+        CHECK((intptr(p0) & 15) == 0);
+        for (int32 i = 0; i < 64; i++) {
+            p0[i] = uint8(i);
+        }
+        p0 = (uint8*) Memory::ReAlloc(p0, 128);
+    }
+    CHECK(Memory::GetBackend() == Memory::Backend::Malloc);
+    p0 = (uint8*) Memory::ReAlloc(p0, 256);
+    bool check = true;
+    for (int32 i = 0; i < 64; i++) {
+        check &= (p0[i] == i);
+    }
+    CHECK(check);
+    Memory::Free(p0);
+
+    // containers work on the TLSF heap, and can be freed from any backend
+    Array<int32>* array = Memory::New<Array<int32>>();
+    {
+        Memory::BackendScope scope(Memory::Backend::TLSF);
+        for (int32 i = 0; i < 10000; i++) {
+            array->Add(i);
+        }
+    }
+    CHECK((*array)[9999] == 9999);
+    Memory::Delete(array);
+
+    // frame arena allocations are explicit, the backend doesn't matter
+    {
+        Memory::BackendScope scope(Memory::Backend::TLSF);
+        void* f0 = Memory::AllocFrame(1000);
+        void* f1 = Memory::AllocFrame(1000);
+        CHECK(f0 && f1 && (f0 != f1));
+        CHECK((intptr(f0) & 15) == 0);
+        CHECK((intptr(f1) & 15) == 0);
+        Memory::Free(f0);
+        Memory::Free(f1);
+        Memory::ResetFrameArena();
+        // after reset, the same memory is handed out again
+        void* f2 = Memory::AllocFrame(1000);
+        CHECK(f2 == f0);
+        Memory::Free(f2);
+        // an exhausted arena returns nullptr
+        CHECK(nullptr == Memory::AllocFrame(128 * 1024));
+        // the reset also releases frame allocations which haven't been freed
+        CHECK(nullptr != Memory::AllocFrame(1000));
+        Memory::ResetFrameArena();
+        CHECK(Memory::AllocFrame(1000) == f0);
+        Memory::ResetFrameArena();
+    }
+
+    // per-tag statistics
+    #if ORYOL_MEMORY_STATS
+    const Memory::Tag tag = Memory::RegisterTag("MemoryTest");
+    CHECK(Memory::NumTags() >= 2);
+    Memory::TagStats stats = Memory::GetTagStats(tag);
+    CHECK(0 == std::strcmp(stats.Name, "MemoryTest"));
+    CHECK(stats.NumBytes == 0);
+    CHECK(stats.NumAllocs == 0);
+    void* t0 = Memory::Alloc(100, tag);
+    void* t1 = nullptr;
+    {
+        Memory::TagScope tagScope(tag);
+        Memory::BackendScope scope(Memory::Backend::TLSF);
+        t1 = Memory::Alloc(50);
+    }
+    stats = Memory::GetTagStats(tag);
+    CHECK(stats.NumBytes == 150);
+    CHECK(stats.NumAllocs == 2);
+    CHECK(stats.TotalAllocs == 2);
+    t1 = Memory::ReAlloc(t1, 70);
+    stats = Memory::GetTagStats(tag);
+    CHECK(stats.NumBytes == 170);
+    CHECK(stats.NumAllocs == 2);
+    Memory::Free(t0);
+    Memory::Free(t1);
+    stats = Memory::GetTagStats(tag);
+    CHECK(stats.NumBytes == 0);
+    CHECK(stats.NumAllocs == 0);
+    CHECK(stats.TotalAllocs == 3);
+
+    // frame allocations are removed from the stats by the reset
+    {
+        Memory::TagScope tagScope(tag);
+        Memory::AllocFrame(100);
+        Memory::Free(Memory::AllocFrame(200));
+    }
+    stats = Memory::GetTagStats(tag);
+    CHECK(stats.NumBytes == 100);
+    CHECK(stats.NumAllocs == 1);
+    Memory::ResetFrameArena();
+    stats = Memory::GetTagStats(tag);
+    CHECK(stats.NumBytes == 0);
+    CHECK(stats.NumAllocs == 0);
+    #endif
+}
@@ -9,6 +9,10 @@
 #include "Core/RefCounted.h"
 #include "Core/Ptr.h"
 #include "Core/Memory/poolAllocator.h"
+#include "Core/Core.h"
+#include "Core/Threading/mpmcQueue.h"
+#include <chrono>
+#include <thread>
 
 using namespace Oryol;
 using namespace Oryol::_priv;
@@ -28,3 +32,161 @@ TEST(PoolAllocator) {
     CHECK(obj == obj1);
     allocatorOne.Destroy(obj1);
 }
+
+//------------------------------------------------------------------------------
+struct poolTestObj {
+    poolTestObj(int32 val_) : val(val_) { };
+    int32 val;
+    int32 pad[3];
+};
+
+TEST(PoolAllocatorGrow) {
+
+    // allocate more than the old 256x256 element limit
+    poolAllocator<poolTestObj> allocator;
+    const int32 num = 100000;
+    poolTestObj** objs = (poolTestObj**) Memory::Alloc(num * sizeof(poolTestObj*));
+    for (int32 i = 0; i < num; i++) {
+        objs[i] = allocator.Create(i);
+    }
+    CHECK(allocator.Capacity() >= num);
+    const int32 numPuddles = allocator.NumPuddles();
+    CHECK(numPuddles < 16);
+    bool allValid = true;
+    for (int32 i = 0; i < num; i++) {
+        allValid &= (objs[i]->val == i);
+        allValid &= (0 == (intptr(objs[i]) & 15));
+    }
+    CHECK(allValid);
+
+    // destroy and re-create, no new puddles must be allocated
+    for (int32 i = 0; i < num; i++) {
+        allocator.Destroy(objs[i]);
+    }
+    for (int32 i = 0; i < num; i++) {
+        objs[i] = allocator.Create(i);
+    }
+    CHECK(allocator.NumPuddles() == numPuddles);
+    for (int32 i = 0; i < num; i++) {
+        allocator.Destroy(objs[i]);
+    }
+    Memory::Free(objs);
+}
+
+//------------------------------------------------------------------------------
+//  Multithreaded throughput: each thread creates and destroys objects
+//  in batches, compared against Memory::New/Delete. A second pass
+//  creates objects on producer threads and destroys them on consumer
+//  threads, so that elements wander between the thread magazines.
+//
+template<class CREATE, class DESTROY> static double
+poolBenchRun(int32 numThreads, int32 numIters, CREATE createFunc, DESTROY destroyFunc) {
+    const int32 batchSize = 64;
+    std::thread threads[8];
+    auto start = std::chrono::steady_clock::now();
+    for (int32 t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([=] {
+            Core::EnterThread();
+            poolTestObj* objs[batchSize];
+            for (int32 i = 0; i < numIters; i++) {
+                for (int32 j = 0; j < batchSize; j++) {
+                    objs[j] = createFunc(j);
+                }
+                for (int32 j = 0; j < batchSize; j++) {
+                    o_assert(objs[j]->val == j);
+                    destroyFunc(objs[j]);
+                }
+            }
+            Core::LeaveThread();
+        });
+    }
+    for (int32 t = 0; t < numThreads; t++) {
+        threads[t].join();
+    }
+    std::chrono::duration<double> dur = std::chrono::steady_clock::now() - start;
+    return double(numThreads * numIters * batchSize) / dur.count();
+}
+
+TEST(PoolAllocatorThreaded) {
+    const int32 numIters = 10000;
+    for (int32 numThreads : { 1, 2, 4, 8 }) {
+        poolAllocator<poolTestObj> allocator;
+        const double poolOps = poolBenchRun(numThreads, numIters,
+            [&allocator](int32 i) { return allocator.Create(i); },
+            [&allocator](poolTestObj* obj) { allocator.Destroy(obj); });
+        const double mallocOps = poolBenchRun(numThreads, numIters,
+            [](int32 i) { return Memory::New<poolTestObj>(i); },
+            [](poolTestObj* obj) { Memory::Delete(obj); });
+        Log::Info("poolAllocator: %d threads: %10.0f create/destroy per sec (Memory::New/Delete: %10.0f)\n",
+            numThreads, poolOps, mallocOps);
+        CHECK(allocator.NumPuddles() <= 4);
+    }
+
+    // cross-thread: producers create, consumers destroy
+    poolAllocator<poolTestObj> allocator;
+    mpmcQueue<poolTestObj*> queue(1024);
+    const int32 numProducers = 4;
+    const int32 numObjsPerProducer = 100000;
+    std::atomic<int32> numDestroyed{0};
+    std::atomic<int32> numErrors{0};
+    std::thread threads[2 * numProducers];
+    auto start = std::chrono::steady_clock::now();
+    for (int32 t = 0; t < numProducers; t++) {
+        threads[t] = std::thread([&allocator, &queue] {
+            Core::EnterThread();
+            for (int32 i = 0; i < numObjsPerProducer; i++) {
+                poolTestObj* obj = allocator.Create(i);
+                while (!queue.Enqueue(obj)) {
+                    std::this_thread::yield();
+                }
+            }
+            Core::LeaveThread();
+        });
+        threads[numProducers + t] = std::thread([&allocator, &queue, &numDestroyed, &numErrors] {
+            Core::EnterThread();
+            poolTestObj* obj = nullptr;
+            while (numDestroyed < numProducers * numObjsPerProducer) {
+                if (queue.Dequeue(obj)) {
+                    if ((obj->val < 0) || (obj->val >= numObjsPerProducer)) {
+                        numErrors++;
+                    }
+                    allocator.Destroy(obj);
+                    numDestroyed++;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+            Core::LeaveThread();
+        });
+    }
+    for (int32 t = 0; t < 2 * numProducers; t++) {
+        threads[t].join();
+    }
+    std::chrono::duration<double> dur = std::chrono::steady_clock::now() - start;
+    Log::Info("poolAllocator: %d producers/%d consumers: %10.0f objs per sec\n",
+        numProducers, numProducers, double(numProducers * numObjsPerProducer) / dur.count());
+    CHECK(numErrors == 0);
+    CHECK(numDestroyed == numProducers * numObjsPerProducer);
+}
+
+//------------------------------------------------------------------------------
+//  Raw std::threads which never call Core::LeaveThread() must give their
+//  magazine slot back on thread exit, otherwise later threads run out
+//  of slots.
+//
+TEST(PoolAllocatorRawThreads) {
+    poolAllocator<poolTestObj> allocator;
+    int32 numWithoutSlot = 0;
+    for (int32 t = 0; t < 2 * poolThreadSlot::MaxSlots; t++) {
+        std::thread thread([&allocator, &numWithoutSlot, t] {
+            poolTestObj* obj = allocator.Create(t);
+            if (poolThreadSlot::InvalidIndex == poolThreadSlot::Index()) {
+                numWithoutSlot++;
+            }
+            allocator.Destroy(obj);
+        });
+        thread.join();
+    }
+    CHECK(numWithoutSlot == 0);
+}
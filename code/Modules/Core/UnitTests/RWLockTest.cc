@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+//  RWLockTest.cc
+//  Test RWLock functionality.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Log.h"
+#include "Core/Threading/RWLock.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(RWLockTest) {
+    RWLock lock;
+
+    // uncontended locking
+    lock.LockRead();
+    lock.LockRead();
+    lock.UnlockRead();
+    lock.UnlockRead();
+    lock.LockWrite();
+    lock.UnlockWrite();
+    RWLock::Stats stats = lock.GetStats();
+    CHECK(stats.NumReadLocks == 2);
+    CHECK(stats.NumWriteLocks == 1);
+    CHECK(stats.NumContendedReadLocks == 0);
+    CHECK(stats.NumContendedWriteLocks == 0);
+    lock.ResetStats();
+    CHECK(lock.GetStats().NumReadLocks == 0);
+
+    // readers check that the 2 values are always consistent,
+    // writers update them non-atomically
+    const int32 numReaders = 6;
+    const int32 numWriters = 2;
+    const int32 numIters = 20000;
+    int32 val0 = 0;
+    int32 val1 = 0;
+    std::atomic<int32> numActiveReaders{0};
+    std::atomic<int32> numErrors{0};
+    std::vector<std::thread> threads;
+    for (int32 i = 0; i < numReaders; i++) {
+        threads.emplace_back([&]() {
+            for (int32 j = 0; j < numIters; j++) {
+                lock.LockRead();
+                numActiveReaders++;
+                if (val0 != val1) {
+                    numErrors++;
+                }
+                numActiveReaders--;
+                lock.UnlockRead();
+            }
+        });
+    }
+    for (int32 i = 0; i < numWriters; i++) {
+        threads.emplace_back([&]() {
+            for (int32 j = 0; j < numIters; j++) {
+                lock.LockWrite();
+                if (numActiveReaders != 0) {
+                    numErrors++;
+                }
+                val0++;
+                std::this_thread::yield();
+                val1++;
+                lock.UnlockWrite();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CHECK(numErrors == 0);
+    CHECK(val0 == (numWriters * numIters));
+    CHECK(val1 == (numWriters * numIters));
+
+    // every contended acquisition must show up in exactly one histogram bucket
+    stats = lock.GetStats();
+    CHECK(stats.NumReadLocks == uint32(numReaders * numIters));
+    CHECK(stats.NumWriteLocks == uint32(numWriters * numIters));
+    uint32 numReadWaits = 0;
+    uint32 numWriteWaits = 0;
+    for (int32 i = 0; i < RWLock::NumWaitBuckets; i++) {
+        numReadWaits += stats.ReadWaitHistogram[i];
+        numWriteWaits += stats.WriteWaitHistogram[i];
+    }
+    CHECK(numReadWaits == stats.NumContendedReadLocks);
+    CHECK(numWriteWaits == stats.NumContendedWriteLocks);
+    Log::Info("RWLock: %d contended reads, %d contended writes, %d parks\n",
+        stats.NumContendedReadLocks, stats.NumContendedWriteLocks, stats.NumParks);
+}
@@ -9,6 +9,7 @@
 #include "Core/Core.h"
 
 #include <cstring>
+#include <cstdio>
 #include <thread>
 #include <array>
 
@@ -53,20 +54,29 @@ TEST(StringAtomSingleThreaded) {
     CHECK(atom0 == atom1);
     atom0.Clear();
     CHECK(!atom0.IsValid());
+
+    // construct from a character range which isn't null-terminated
+    const char* chars = "BLUBBER";
+    StringAtom atom5(chars, 4);
+    CHECK(atom5.Length() == 4);
+    CHECK(atom5 == atom4);
+    CHECK(atom5.AsCStr() == atom4.AsCStr());
+    StringAtom atom6(chars, 0);
+    CHECK(!atom6.IsValid());
 }
 
 #if ORYOL_HAS_THREADS
-// must use reference, the copy would fail since there is no thread-local
-// string-atom table yet
 static void threadFunc(const StringAtom& a0) {
     
     Oryol::Core::EnterThread();
     
-    // transfer into a thread-local string atom
+    // atoms are shared between threads, so the copy and a
+    // new atom created in this thread are pointer-identical
     StringAtom a1(a0);
-    StringAtom a2(a0);
+    StringAtom a2("BLOB");
     CHECK(a0 == a1);
     CHECK(a1 == a2);
+    CHECK(a0.AsCStr() == a2.AsCStr());
     CHECK(a1.AsString() == "BLOB");
     CHECK(a0.AsString() == "BLOB");
     CHECK(a2.AsString() == "BLOB");
@@ -81,6 +91,41 @@ TEST(StringAtomMultiThreaded) {
     std::thread t1(threadFunc, std::ref(atom0));
     t1.join();
 }
+
+// many threads concurrently intern the same strings
+TEST(StringAtomConcurrentIntern) {
+    const int32 numThreads = 8;
+    const int32 numStrings = 2000;
+    std::array<Array<StringAtom>, numThreads> atoms;
+    std::array<std::thread, numThreads> threads;
+    for (int32 i = 0; i < numThreads; i++) {
+        threads[i] = std::thread([&atoms, i]() {
+            Oryol::Core::EnterThread();
+            char buf[32];
+            // each thread goes through the strings in a different order
+            for (int32 j = 0; j < numStrings; j++) {
+                const int32 k = (j * 7 + i * 131) % numStrings;
+                std::snprintf(buf, sizeof(buf), "concurrent_%d", k);
+                atoms[i].Add(StringAtom(buf));
+            }
+            Oryol::Core::LeaveThread();
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    bool allIdentical = true;
+    char buf[32];
+    for (int32 k = 0; k < numStrings; k++) {
+        std::snprintf(buf, sizeof(buf), "concurrent_%d", k);
+        StringAtom atom(buf);
+        for (int32 i = 0; i < numThreads; i++) {
+            const int32 j = ((k - i * 131) % numStrings + numStrings) * 1143 % numStrings;
+            allIdentical &= (atoms[i][j] == atom) && (atoms[i][j].AsCStr() == atom.AsCStr());
+        }
+    }
+    CHECK(allIdentical);
+}
 #endif
 
 // test string atom creation performance
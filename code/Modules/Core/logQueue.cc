@@ -0,0 +1,328 @@
+//------------------------------------------------------------------------------
+//  logQueue.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "logQueue.h"
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Containers/Array.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include "Core/Threading/futex.h"
+#include <cstdio>
+#include <chrono>
+#if ORYOL_HAS_THREADS
+#include <atomic>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+#if ORYOL_HAS_THREADS
+namespace {
+
+struct logRecord {
+    uint64 seq;
+    int64 timeNs;
+    uint64 threadId;
+    Log::Level level;
+    char msg[logQueue::MaxMsgLength + 1];
+};
+
+struct logRing {
+    std::atomic<uint32> head;       // written by producer thread
+    std::atomic<uint32> tail;       // written by drain thread
+    std::atomic<bool> orphaned;     // producer thread has left
+    uint32 mask;
+    logRecord* records;
+};
+
+struct threadSlot {
+    logRing* ring;
+    uint32 generation;
+};
+
+struct queueState {
+    std::atomic<bool> valid{false};
+    std::atomic<uint32> generation{0};
+    logQueue::OutputFunc outputFunc = nullptr;
+    uint32 numRecords = 0;
+    std::atomic<uint64> seq{0};
+    std::atomic<int64> dropped{0};
+    std::atomic<uint32> wakeup{0};
+    std::atomic<bool> stopRequested{false};
+    std::mutex registryLock;    // protects rings
+    std::mutex drainLock;       // only one thread drains at a time
+    Array<logRing*> rings;
+    Array<logRing*> drainRings; // drain thread's snapshot of rings
+    std::thread drainThread;
+};
+queueState state;
+
+ORYOL_THREADLOCAL_PTR(threadSlot) curSlot = nullptr;
+// points to state while the current thread is draining, protects from recursive drains
+ORYOL_THREADLOCAL_PTR(queueState) curDraining = nullptr;
+
+//------------------------------------------------------------------------------
+logRing*
+createRing(uint32 numRecords) {
+    logRing* ring = Memory::New<logRing>();
+    ring->head.store(0, std::memory_order_relaxed);
+    ring->tail.store(0, std::memory_order_relaxed);
+    ring->orphaned.store(false, std::memory_order_relaxed);
+    ring->mask = numRecords - 1;
+    ring->records = (logRecord*) Memory::Alloc(numRecords * sizeof(logRecord));
+    return ring;
+}
+
+//------------------------------------------------------------------------------
+void
+destroyRing(logRing* ring) {
+    Memory::Free(ring->records);
+    Memory::Delete(ring);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Get the current thread's ring, create a new one if the thread hasn't
+    logged yet since the queue was setup.
+*/
+logRing*
+threadRing() {
+    threadSlot* slot = curSlot;
+    const uint32 gen = state.generation.load(std::memory_order_relaxed);
+    if (slot && (slot->generation == gen)) {
+        return slot->ring;
+    }
+    if (!slot) {
+        slot = Memory::New<threadSlot>();
+        curSlot = slot;
+    }
+    slot->ring = createRing(state.numRecords);
+    slot->generation = gen;
+    std::lock_guard<std::mutex> guard(state.registryLock);
+    state.rings.Add(slot->ring);
+    return slot->ring;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Output all pending records, oldest first. Must be called with
+    drainLock held.
+*/
+void
+drainAll() {
+    curDraining = &state;
+    {
+        std::lock_guard<std::mutex> guard(state.registryLock);
+        state.drainRings.Clear();
+        for (logRing* ring : state.rings) {
+            state.drainRings.Add(ring);
+        }
+    }
+
+    // merge the per-thread rings by sequence number
+    for (;;) {
+        logRing* oldest = nullptr;
+        uint64 oldestSeq = 0;
+        for (logRing* ring : state.drainRings) {
+            const uint32 tail = ring->tail.load(std::memory_order_relaxed);
+            if (tail != ring->head.load(std::memory_order_acquire)) {
+                const uint64 seq = ring->records[tail & ring->mask].seq;
+                if (!oldest || (seq < oldestSeq)) {
+                    oldest = ring;
+                    oldestSeq = seq;
+                }
+            }
+        }
+        if (!oldest) {
+            break;
+        }
+        const uint32 tail = oldest->tail.load(std::memory_order_relaxed);
+        const logRecord& rec = oldest->records[tail & oldest->mask];
+        state.outputFunc(rec.level, rec.timeNs, rec.threadId, "%s", rec.msg);
+        oldest->tail.store(tail + 1, std::memory_order_release);
+    }
+
+    curDraining = nullptr;
+
+    // free the rings of threads which have left
+    std::lock_guard<std::mutex> guard(state.registryLock);
+    for (int32 i = state.rings.Size() - 1; i >= 0; i--) {
+        logRing* ring = state.rings[i];
+        if (ring->orphaned.load(std::memory_order_acquire) &&
+            (ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire))) {
+            state.rings.Erase(i);
+            destroyRing(ring);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+drainThreadFunc() {
+    while (!state.stopRequested.load(std::memory_order_acquire)) {
+        if (0 == state.wakeup.exchange(0, std::memory_order_acquire)) {
+            futex::Wait(&state.wakeup, 0);
+            continue;
+        }
+        std::lock_guard<std::mutex> guard(state.drainLock);
+        drainAll();
+    }
+}
+
+} // anonymous namespace
+#endif
+
+//------------------------------------------------------------------------------
+void
+logQueue::setup(int32 numRecords, OutputFunc func) {
+    o_assert(!isValid());
+    o_assert(numRecords > 0);
+    o_assert(nullptr != func);
+    #if ORYOL_HAS_THREADS
+    uint32 pow2 = 16;
+    while (pow2 < uint32(numRecords)) {
+        pow2 <<= 1;
+    }
+    state.numRecords = pow2;
+    state.outputFunc = func;
+    state.dropped.store(0, std::memory_order_relaxed);
+    state.wakeup.store(0, std::memory_order_relaxed);
+    state.stopRequested.store(false, std::memory_order_relaxed);
+    state.rings.SetAllocStrategy(16);
+    state.generation.fetch_add(1, std::memory_order_relaxed);
+    state.drainThread = std::thread(drainThreadFunc);
+    state.valid.store(true, std::memory_order_release);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::discard() {
+    o_assert(isValid());
+    #if ORYOL_HAS_THREADS
+    state.valid.store(false, std::memory_order_release);
+    state.stopRequested.store(true, std::memory_order_release);
+    state.wakeup.store(1, std::memory_order_release);
+    futex::WakeOne(&state.wakeup);
+    state.drainThread.join();
+
+    std::lock_guard<std::mutex> drainGuard(state.drainLock);
+    drainAll();
+    std::lock_guard<std::mutex> guard(state.registryLock);
+    for (logRing* ring : state.rings) {
+        destroyRing(ring);
+    }
+    state.rings.Clear();
+    state.drainRings.Clear();
+    // outdate the thread slots, so that threads create new rings on next setup
+    state.generation.fetch_add(1, std::memory_order_relaxed);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+bool
+logQueue::isValid() {
+    #if ORYOL_HAS_THREADS
+    return state.valid.load(std::memory_order_acquire);
+    #else
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+bool
+logQueue::push(Log::Level lvl, const char* msg, va_list args) {
+    #if ORYOL_HAS_THREADS
+    const int64 timeNs = timestamp();
+    logRing* ring = threadRing();
+    const uint32 head = ring->head.load(std::memory_order_relaxed);
+    const uint32 tail = ring->tail.load(std::memory_order_acquire);
+    if ((head - tail) > ring->mask) {
+        // ring is full, drop the record rather than blocking
+        state.dropped.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    logRecord& rec = ring->records[head & ring->mask];
+    const int len = std::vsnprintf(rec.msg, sizeof(rec.msg), msg, args);
+    if ((len < 0) || (len > MaxMsgLength)) {
+        // don't truncate, the record slot is reused by the next push
+        return false;
+    }
+    rec.timeNs = timeNs;
+    rec.threadId = threadId();
+    rec.level = lvl;
+    rec.seq = state.seq.fetch_add(1, std::memory_order_relaxed);
+    ring->head.store(head + 1, std::memory_order_release);
+
+    // only wake up the drain thread if it isn't already awake
+    if ((0 == state.wakeup.load(std::memory_order_relaxed)) &&
+        (0 == state.wakeup.exchange(1, std::memory_order_release))) {
+        futex::WakeOne(&state.wakeup);
+    }
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::flush() {
+    #if ORYOL_HAS_THREADS
+    // a logger may log an error or assert while a record is output,
+    // draining again would deadlock on drainLock
+    if (isValid() && (nullptr == curDraining)) {
+        std::lock_guard<std::mutex> guard(state.drainLock);
+        drainAll();
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int64
+logQueue::numDropped() {
+    #if ORYOL_HAS_THREADS
+    return state.dropped.load(std::memory_order_relaxed);
+    #else
+    return 0;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::leaveThread() {
+    #if ORYOL_HAS_THREADS
+    threadSlot* slot = curSlot;
+    if (slot) {
+        if (isValid() && (slot->generation == state.generation.load(std::memory_order_relaxed))) {
+            // the drain thread frees the ring once it is empty
+            slot->ring->orphaned.store(true, std::memory_order_release);
+        }
+        Memory::Delete(slot);
+        curSlot = nullptr;
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int64
+logQueue::timestamp() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//------------------------------------------------------------------------------
+uint64
+logQueue::threadId() {
+    #if ORYOL_HAS_THREADS
+    return std::hash<std::thread::id>()(std::this_thread::get_id());
+    #else
+    return 0;
+    #endif
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,61 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::logQueue
+    @ingroup _priv
+    @brief private: asynchronous log record queue
+
+    Each logging thread formats its messages into fixed-size records
+    in its own single-producer/single-consumer ring buffer, this only
+    takes a vsnprintf() and two atomic operations, and never blocks.
+    A background thread drains the rings and hands the records in
+    global sequence order to an output function, together with the
+    time and thread they were logged from. If a thread's ring is full,
+    the record is dropped and counted. Messages which don't fit into
+    a record are rejected, and must be written synchronously.
+
+    The drain thread must not drain recursively, so flush() does
+    nothing when a logger calls it (e.g. through an assert) while
+    a record is being output.
+
+    A thread's ring is created on its first log call, and given up
+    in Core::LeaveThread().
+*/
+#include "Core/Types.h"
+#include "Core/Log.h"
+#include <cstdarg>
+
+namespace Oryol {
+namespace _priv {
+
+class logQueue {
+public:
+    /// printf-style function which outputs a drained record
+    typedef void (*OutputFunc)(Log::Level lvl, int64 timeNs, uint64 threadId, const char* msg, ...);
+    /// max length of a queued message (longer messages are rejected by push)
+    static const int32 MaxMsgLength = Log::MaxAsyncMsgLength;
+
+    /// start the drain thread (numRecords per thread, rounded up to pow2)
+    static void setup(int32 numRecords, OutputFunc func);
+    /// drain remaining records and stop the drain thread
+    static void discard();
+    /// return true if setup
+    static bool isValid();
+
+    /// format and push a record from the current thread, false if the message is too long
+    static bool push(Log::Level lvl, const char* msg, va_list args);
+    /// drain all pending records on the calling thread (does nothing while draining)
+    static void flush();
+    /// number of dropped records since setup
+    static int64 numDropped();
+    /// give up the current thread's ring (called from Core::LeaveThread)
+    static void leaveThread();
+
+    /// get the current time in nanoseconds (steady clock)
+    static int64 timestamp();
+    /// get an id of the calling thread
+    static uint64 threadId();
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -121,8 +121,14 @@ debugTextRenderer::drawTextBuffer() {
     this->stringBuilder.Clear();
     this->rwLock.UnlockWrite();
     
-    // convert string into vertices
-    int32 numVertices = this->convertStringToVertices(str);
+    // convert string directly into the mapped vertex buffer
+    if (str.Empty()) {
+        return;
+    }
+    const int32 vertexSize = this->vertexLayout.ByteSize();
+    Vertex* vertices = (Vertex*) Gfx::MapVertices(this->textMesh, MaxNumVertices * vertexSize);
+    int32 numVertices = this->convertStringToVertices(str, vertices);
+    Gfx::UnmapVertices(this->textMesh, numVertices * vertexSize);
 
     // draw the vertices
     if (numVertices > 0) {
@@ -137,7 +143,6 @@ debugTextRenderer::drawTextBuffer() {
         vsParams.GlyphSize = glm::vec2(w * 2.0f, h * 2.0f) * this->textScale;
         fsParams.Texture = this->fontTexture;
     
-        Gfx::UpdateVertices(this->textMesh, this->vertexData, numVertices * this->vertexLayout.ByteSize());
         Gfx::ApplyDrawState(this->textDrawState);
         Gfx::ApplyUniformBlock(vsParams);
         Gfx::ApplyUniformBlock(fsParams);
@@ -203,7 +208,7 @@ debugTextRenderer::setupTextMesh() {
         .Add(VertexAttr::Position, VertexFormat::Float4)
         .Add(VertexAttr::Color0, VertexFormat::UByte4N);
 
-    o_assert(sizeof(this->vertexData) == maxNumVerts * this->vertexLayout.ByteSize());
+    o_assert(sizeof(Vertex) == this->vertexLayout.ByteSize());
     MeshSetup setup = MeshSetup::Empty(maxNumVerts, Usage::Stream);
     setup.Layout = this->vertexLayout;
     this->textMesh = Gfx::CreateResource(setup);
@@ -232,22 +237,22 @@ debugTextRenderer::setupTextDrawState() {
 
 //------------------------------------------------------------------------------
 int32
-debugTextRenderer::writeVertex(int32 index, uint8 x, uint8 y, uint8 u, uint8 v, uint32 rgba) {
-    this->vertexData[index].x = (float) x;
-    this->vertexData[index].y = (float) y;
-    this->vertexData[index].u = (float) u;
-    this->vertexData[index].v = (float) v;
-    this->vertexData[index].color = rgba;
+debugTextRenderer::writeVertex(Vertex* vertices, int32 index, uint8 x, uint8 y, uint8 u, uint8 v, uint32 rgba) {
+    vertices[index].x = (float) x;
+    vertices[index].y = (float) y;
+    vertices[index].u = (float) u;
+    vertices[index].v = (float) v;
+    vertices[index].color = rgba;
 /*
-    this->vertexData[index][0] = (v << 24) | (u << 16) | (y << 8) | x;
-    this->vertexData[index][1] = rgba;
+    vertices[index][0] = (v << 24) | (u << 16) | (y << 8) | x;
+    vertices[index][1] = rgba;
 */
     return index + 1;
 }
 
 //------------------------------------------------------------------------------
 int32
-debugTextRenderer::convertStringToVertices(const String& str) {
+debugTextRenderer::convertStringToVertices(const String& str, Vertex* vertices) {
 
     int32 cursorX = 0;
     int32 cursorY = 0;
@@ -312,12 +317,12 @@ debugTextRenderer::convertStringToVertices(const String& str) {
                 c &= 0x7F;
                 
                 // write 6 vertices
-                vIndex = this->writeVertex(vIndex, cursorX, cursorY, c, 0, rgba);
-                vIndex = this->writeVertex(vIndex, cursorX+1, cursorY, c+1, 0, rgba);
-                vIndex = this->writeVertex(vIndex, cursorX+1, cursorY+1, c+1, 1, rgba);
-                vIndex = this->writeVertex(vIndex, cursorX, cursorY, c, 0, rgba);
-                vIndex = this->writeVertex(vIndex, cursorX+1, cursorY+1, c+1, 1, rgba);
-                vIndex = this->writeVertex(vIndex, cursorX, cursorY+1, c, 1, rgba);
+                vIndex = this->writeVertex(vertices, vIndex, cursorX, cursorY, c, 0, rgba);
+                vIndex = this->writeVertex(vertices, vIndex, cursorX+1, cursorY, c+1, 0, rgba);
+                vIndex = this->writeVertex(vertices, vIndex, cursorX+1, cursorY+1, c+1, 1, rgba);
+                vIndex = this->writeVertex(vertices, vIndex, cursorX, cursorY, c, 0, rgba);
+                vIndex = this->writeVertex(vertices, vIndex, cursorX+1, cursorY+1, c+1, 1, rgba);
+                vIndex = this->writeVertex(vertices, vIndex, cursorX, cursorY+1, c, 1, rgba);
                 
                 // advance horizontal cursor position
                 cursorX++;
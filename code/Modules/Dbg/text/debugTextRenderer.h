@@ -56,10 +56,15 @@ private:
     void setupTextMesh();
     /// setup the text draw state
     void  setupTextDrawState();
+    /// a text vertex
+    struct Vertex {
+        float x, y, u, v;
+        uint32 color;
+    };
     /// convert the provides string object into vertices, and return number of vertices
-    int32 convertStringToVertices(const String& str);
+    int32 convertStringToVertices(const String& str, Vertex* vertices);
     /// write one glyph vertex, returns next vertex index
-    int32 writeVertex(int32 vertexIndex, uint8 x, uint8 y, uint8 u, uint8 v, uint32 rgba);
+    int32 writeVertex(Vertex* vertices, int32 vertexIndex, uint8 x, uint8 y, uint8 u, uint8 v, uint32 rgba);
     
     static const int32 MaxNumColumns = 120;
     static const int32 MaxNumLines = 80;
@@ -75,14 +80,6 @@ private:
     StringBuilder stringBuilder;
     bool valid;
     ResourceLabel resourceLabel;
-    
-    // 6 vertices per character, 2 uint32's per vertex (pos+uv, color)
-//    uint32 vertexData[MaxNumVertices][2];
-    struct Vertex {
-        float x, y, u, v;
-        uint32 color;
-    };
-    struct Vertex vertexData[MaxNumVertices];
 };
 
 } // namespace _priv
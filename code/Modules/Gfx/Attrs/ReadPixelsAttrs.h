@@ -0,0 +1,37 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::ReadPixelsAttrs
+    @ingroup Gfx
+    @brief describes the pixels of an asynchronous pixel readback
+    
+    Passed to the callback of Gfx::ReadPixelsAsync() together with
+    the pixel data.
+
+    @see Gfx::ReadPixelsAsync
+*/
+#include "Core/Types.h"
+#include "Gfx/Core/Enums.h"
+#include <functional>
+
+namespace Oryol {
+    
+struct ReadPixelsAttrs {
+    /// the ticket returned by Gfx::ReadPixelsAsync()
+    int32 Ticket{InvalidIndex};
+    /// width of the read pixel rectangle
+    int32 Width{0};
+    /// height of the read pixel rectangle
+    int32 Height{0};
+    /// pixel format of the read pixels
+    PixelFormat::Code ColorFormat{PixelFormat::InvalidPixelFormat};
+    /// computes the byte size of the read pixels
+    int32 ByteSize() const {
+        return Width * Height * PixelFormat::ByteSize(ColorFormat);
+    };
+};
+
+/// callback for Gfx::ReadPixelsAsync(), the pixel data is only valid during the call
+typedef std::function<void(const ReadPixelsAttrs& attrs, const void* pixels)> ReadPixelsCallback;
+    
+} // namespace Oryol
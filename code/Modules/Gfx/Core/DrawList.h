@@ -0,0 +1,230 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::DrawList
+    @ingroup Gfx
+    @brief a list of draw calls recorded on any thread
+
+    A DrawList records draw states, uniform blocks and draw calls into
+    its own command buffer. Recording doesn't touch the Gfx module, so
+    several worker threads can each fill their own DrawList in parallel
+    (a single DrawList must only be recorded by one thread at a time).
+
+    Finished draw lists are handed to Gfx::Enqueue() from any thread.
+    The render thread merges all enqueued lists by their order (lower
+    order first, lists with the same order in enqueue order) and
+    executes them in Gfx::FlushDrawLists(), or at the latest in
+    Gfx::CommitFrame(). An enqueued list must not be modified or
+    destroyed until it has been flushed.
+
+    Draw lists render into the render target which is current at
+    flush time, and must apply their own draw state before the
+    first draw.
+
+    A list which is Reset() with sortDraws=true doesn't execute its
+    draws in recording order. Its draws are sorted together with the
+    draws of all sorted lists which have the same order. They are
+    sorted by a 64-bit key (program, draw state, first texture, and
+    the depth set with SetDepth()), and redundant draw state and
+    uniform block applies are then dropped. Each draw keeps the draw
+    state and uniform blocks which were current when it was recorded.
+    A sorted list can only record draw states, uniform blocks and
+    draws. The number of state changes avoided by sorting is counted
+    in GfxFrameStats::NumStateChangesAvoided.
+
+    @see GfxCommandBuffer, Gfx::Enqueue()
+*/
+#include "Gfx/Core/GfxCommandBuffer.h"
+#include "Core/Containers/Array.h"
+
+namespace Oryol {
+
+class DrawList {
+public:
+    /// constructor
+    DrawList();
+
+    /// remove all recorded commands, set the merge order, and whether the draws are sorted
+    void Reset(int32 order=0, bool sortDraws=false);
+    /// get the merge order
+    int32 Order() const;
+    /// return true if the draws are sorted before execution
+    bool SortDraws() const;
+    /// set the view depth for sorting the following draws (smaller depth is drawn first)
+    void SetDepth(float32 depth);
+    /// get the sort depth of a recorded draw (only sorted lists)
+    float32 DrawDepth(int32 drawIndex) const;
+    /// get number of recorded draw calls
+    int32 NumDraws() const;
+    /// get the recorded commands
+    const GfxCommandBuffer& CommandBuffer() const;
+
+    /// record applying the view port
+    void ApplyViewPort(int32 x, int32 y, int32 width, int32 height);
+    /// record applying the scissor rect
+    void ApplyScissorRect(int32 x, int32 y, int32 width, int32 height);
+    /// record applying a draw state
+    void ApplyDrawState(const Id& id);
+    /// record applying a uniform block
+    template<class T> void ApplyUniformBlock(const T& value);
+    /// record updating dynamic vertex data
+    void UpdateVertices(const Id& id, const void* data, int32 numBytes);
+    /// record a draw call with primitive group index in current mesh
+    void Draw(int32 primGroupIndex);
+    /// record a draw call with direct primitive group
+    void Draw(const PrimitiveGroup& primGroup);
+    /// record an instanced draw call with primitive group index in current mesh
+    void DrawInstanced(int32 primGroupIndex, int32 numInstances);
+    /// record an instanced draw call with direct primitive group
+    void DrawInstanced(const PrimitiveGroup& primGroup, int32 numInstances);
+
+private:
+    /// count a new draw, and record its sort depth
+    void addDraw();
+
+    GfxCommandBuffer cmdBuffer;
+    Array<float32> drawDepths;
+    int32 order;
+    int32 numDraws;
+    float32 depth;
+    bool sortDraws;
+    bool hasDrawState;
+};
+
+//------------------------------------------------------------------------------
+inline
+DrawList::DrawList() :
+order(0),
+numDraws(0),
+depth(0.0f),
+sortDraws(false),
+hasDrawState(false) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline void
+DrawList::Reset(int32 order_, bool sortDraws_) {
+    this->cmdBuffer.Reset();
+    this->drawDepths.Clear();
+    this->order = order_;
+    this->numDraws = 0;
+    this->depth = 0.0f;
+    this->sortDraws = sortDraws_;
+    this->hasDrawState = false;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+DrawList::Order() const {
+    return this->order;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+DrawList::SortDraws() const {
+    return this->sortDraws;
+}
+
+//------------------------------------------------------------------------------
+inline void
+DrawList::SetDepth(float32 depth_) {
+    this->depth = depth_;
+}
+
+//------------------------------------------------------------------------------
+inline float32
+DrawList::DrawDepth(int32 drawIndex) const {
+    return this->drawDepths[drawIndex];
+}
+
+//------------------------------------------------------------------------------
+inline void
+DrawList::addDraw() {
+    if (this->sortDraws) {
+        this->drawDepths.Add(this->depth);
+    }
+    this->numDraws++;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+DrawList::NumDraws() const {
+    return this->numDraws;
+}
+
+//------------------------------------------------------------------------------
+inline const GfxCommandBuffer&
+DrawList::CommandBuffer() const {
+    return this->cmdBuffer;
+}
+
+//------------------------------------------------------------------------------
+inline void
+DrawList::ApplyViewPort(int32 x, int32 y, int32 width, int32 height) {
+    o_assert2_dbg(!this->sortDraws, "DrawList: sorted lists can't apply a view port!\n");
+    this->cmdBuffer.ApplyViewPort(x, y, width, height);
+}
+
+//------------------------------------------------------------------------------
+inline void
+DrawList::ApplyScissorRect(int32 x, int32 y, int32 width, int32 height) {
+    o_assert2_dbg(!this->sortDraws, "DrawList: sorted lists can't apply a scissor rect!\n");
+    this->cmdBuffer.ApplyScissorRect(x, y, width, height);
+}
+
+//------------------------------------------------------------------------------
+inline void
+DrawList::ApplyDrawState(const Id& id) {
+    o_assert_dbg(id.IsValid());
+    this->cmdBuffer.ApplyDrawState(id);
+    this->hasDrawState = true;
+}
+
+//------------------------------------------------------------------------------
+template<class T> inline void
+DrawList::ApplyUniformBlock(const T& value) {
+    o_assert2_dbg(this->hasDrawState, "DrawList: apply a draw state before uniform blocks!\n");
+    this->cmdBuffer.ApplyUniformBlock(value);
+}
+
+//------------------------------------------------------------------------------
+inline void
+DrawList::UpdateVertices(const Id& id, const void* data, int32 numBytes) {
+    o_assert2_dbg(!this->sortDraws, "DrawList: sorted lists can't update vertices!\n");
+    this->cmdBuffer.UpdateVertices(id, data, numBytes);
+}
+
+//------------------------------------------------------------------------------
+inline void
+DrawList::Draw(int32 primGroupIndex) {
+    o_assert2_dbg(this->hasDrawState, "DrawList: apply a draw state before drawing!\n");
+    this->cmdBuffer.Draw(primGroupIndex);
+    this->addDraw();
+}
+
+//------------------------------------------------------------------------------
+inline void
+DrawList::Draw(const PrimitiveGroup& primGroup) {
+    o_assert2_dbg(this->hasDrawState, "DrawList: apply a draw state before drawing!\n");
+    this->cmdBuffer.Draw(primGroup);
+    this->addDraw();
+}
+
+//------------------------------------------------------------------------------
+inline void
+DrawList::DrawInstanced(int32 primGroupIndex, int32 numInstances) {
+    o_assert2_dbg(this->hasDrawState, "DrawList: apply a draw state before drawing!\n");
+    this->cmdBuffer.DrawInstanced(primGroupIndex, numInstances);
+    this->addDraw();
+}
+
+//------------------------------------------------------------------------------
+inline void
+DrawList::DrawInstanced(const PrimitiveGroup& primGroup, int32 numInstances) {
+    o_assert2_dbg(this->hasDrawState, "DrawList: apply a draw state before drawing!\n");
+    this->cmdBuffer.DrawInstanced(primGroup, numInstances);
+    this->addDraw();
+}
+
+} // namespace Oryol
@@ -7,7 +7,8 @@
 #include "Core/Types.h"
 #include "Core/Assertion.h"
 #include "Resource/Id.h"
-#if ORYOL_OPENGL
+#if (ORYOL_OPENGL || ORYOL_NULL_GFX)
+// the null backend uses the GL enum values
 #include "Gfx/gl/glEnums.h"
 #elif ORYOL_D3D11
 #include "Gfx/d3d11/d3d11Enums.h"
@@ -21,7 +22,7 @@ namespace Oryol {
     @ingroup Gfx
     @brief selects 16- or 32-bit indices
 */
-#if ORYOL_OPENGL
+#if (ORYOL_OPENGL || ORYOL_NULL_GFX)
 class IndexType : public _priv::glIndexType {
 #elif ORYOL_D3D11
 class IndexType : public _priv::d3d11IndexType {
@@ -364,7 +365,7 @@ public:
     @ingroup Gfx
     @brief primitive type enum (triangle strips, lists, etc...)
 */
-#if ORYOL_OPENGL
+#if (ORYOL_OPENGL || ORYOL_NULL_GFX)
 class PrimitiveType : public _priv::glPrimitiveType { };
 #elif ORYOL_D3D11
 class PrimitiveType : public _priv::d3d11PrimitiveType { };
@@ -403,7 +404,7 @@ public:
     @ingroup Gfx
     @brief shader types (vertex shader, fragment shader)
 */
-#if ORYOL_OPENGL
+#if (ORYOL_OPENGL || ORYOL_NULL_GFX)
 class ShaderType : public _priv::glShaderType { };
 #elif ORYOL_D3D11
 class ShaderType : public _priv::d3d11ShaderType { };
@@ -417,7 +418,7 @@ class ShaderType : public _priv::d3d11ShaderType { };
     @ingroup Gfx
     @brief texture sampling filter mode
 */
-#if ORYOL_OPENGL
+#if (ORYOL_OPENGL || ORYOL_NULL_GFX)
 class TextureFilterMode  : public _priv::glTextureFilterMode { };
 #elif ORYOL_D3D11
 class TextureFilterMode : public _priv::d3d11TextureFilterMode { };
@@ -431,7 +432,7 @@ class TextureFilterMode : public _priv::d3d11TextureFilterMode { };
     @ingroup Gfx
     @brief texture type (2D, 3D, Cube)
 */
-#if ORYOL_OPENGL
+#if (ORYOL_OPENGL || ORYOL_NULL_GFX)
 class TextureType : public _priv::glTextureType { };
 #elif ORYOL_D3D11
 class TextureType : public _priv::d3d11TextureType { };
@@ -445,7 +446,7 @@ class TextureType : public _priv::d3d11TextureType { };
     @ingroup Gfx
     @brief texture coordinate wrapping modes
 */
-#if ORYOL_OPENGL
+#if (ORYOL_OPENGL || ORYOL_NULL_GFX)
 class TextureWrapMode : public _priv::glTextureWrapMode { };
 #elif ORYOL_D3D11
 class TextureWrapMode : public _priv::d3d11TextureWrapMode { };
@@ -459,7 +460,7 @@ class TextureWrapMode : public _priv::d3d11TextureWrapMode { };
     @ingroup Gfx
     @brief graphics resource usage types
 */
-#if ORYOL_OPENGL
+#if (ORYOL_OPENGL || ORYOL_NULL_GFX)
 class Usage : public _priv::glUsage { };
 #elif ORYOL_D3D11
 class Usage : public _priv::d3d11Usage { };
@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+//  GfxCommandBuffer.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "GfxCommandBuffer.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+GfxCommandBuffer::GfxCommandBuffer() :
+buffer(nullptr),
+size(0),
+capacity(0),
+numCommands(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+GfxCommandBuffer::GfxCommandBuffer(GfxCommandBuffer&& rhs) :
+buffer(rhs.buffer),
+size(rhs.size),
+capacity(rhs.capacity),
+numCommands(rhs.numCommands) {
+    rhs.buffer = nullptr;
+    rhs.size = 0;
+    rhs.capacity = 0;
+    rhs.numCommands = 0;
+}
+
+//------------------------------------------------------------------------------
+GfxCommandBuffer::~GfxCommandBuffer() {
+    if (this->buffer) {
+        Memory::Free(this->buffer);
+        this->buffer = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+GfxCommandBuffer::operator=(GfxCommandBuffer&& rhs) {
+    if (this != &rhs) {
+        if (this->buffer) {
+            Memory::Free(this->buffer);
+        }
+        this->buffer = rhs.buffer;
+        this->size = rhs.size;
+        this->capacity = rhs.capacity;
+        this->numCommands = rhs.numCommands;
+        rhs.buffer = nullptr;
+        rhs.size = 0;
+        rhs.capacity = 0;
+        rhs.numCommands = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+GfxCommandBuffer::Reserve(int32 numBytes) {
+    o_assert_dbg(numBytes >= 0);
+    if ((this->size + numBytes) > this->capacity) {
+        this->grow(this->size + numBytes);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+GfxCommandBuffer::Reset() {
+    this->size = 0;
+    this->numCommands = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+GfxCommandBuffer::grow(int32 minCapacity) {
+    int32 newCapacity = this->capacity > 0 ? this->capacity * 2 : 4096;
+    while (newCapacity < minCapacity) {
+        newCapacity *= 2;
+    }
+    this->buffer = (uint8*) Memory::ReAlloc(this->buffer, newCapacity);
+    this->capacity = newCapacity;
+}
+
+//------------------------------------------------------------------------------
+void
+GfxCommandBuffer::ApplyDefaultRenderTarget() {
+    put(this->begin(Cmd::ApplyRenderTarget, sizeof(uint64)), Id::InvalidId().Value);
+}
+
+//------------------------------------------------------------------------------
+void
+GfxCommandBuffer::ApplyOffscreenRenderTarget(const Id& id) {
+    o_assert_dbg(id.IsValid());
+    put(this->begin(Cmd::ApplyRenderTarget, sizeof(uint64)), id.Value);
+}
+
+//------------------------------------------------------------------------------
+void
+GfxCommandBuffer::ApplyViewPort(int32 x, int32 y, int32 width, int32 height) {
+    uint8* ptr = this->begin(Cmd::ApplyViewPort, 4 * sizeof(int32));
+    ptr = put(ptr, x);
+    ptr = put(ptr, y);
+    ptr = put(ptr, width);
+    put(ptr, height);
+}
+
+//------------------------------------------------------------------------------
+void
+GfxCommandBuffer::ApplyScissorRect(int32 x, int32 y, int32 width, int32 height) {
+    uint8* ptr = this->begin(Cmd::ApplyScissorRect, 4 * sizeof(int32));
+    ptr = put(ptr, x);
+    ptr = put(ptr, y);
+    ptr = put(ptr, width);
+    put(ptr, height);
+}
+
+//------------------------------------------------------------------------------
+void
+GfxCommandBuffer::UpdateVertices(const Id& id, const void* data, int32 numBytes) {
+    o_assert_dbg(nullptr != data);
+    o_assert_dbg(numBytes > 0);
+    uint8* ptr = this->begin(Cmd::UpdateVertices, sizeof(uint64) + sizeof(int32) + numBytes);
+    ptr = put(ptr, id.Value);
+    ptr = put(ptr, numBytes);
+    std::memcpy(ptr, data, numBytes);
+}
+
+//------------------------------------------------------------------------------
+void
+GfxCommandBuffer::Clear(ClearTarget::Mask clearMask, const glm::vec4& color, float32 depth, uint8 stencil) {
+    uint8* ptr = this->begin(Cmd::Clear, sizeof(uint32) + 5 * sizeof(float32) + sizeof(uint8));
+    ptr = put(ptr, uint32(clearMask));
+    ptr = put(ptr, color.x);
+    ptr = put(ptr, color.y);
+    ptr = put(ptr, color.z);
+    ptr = put(ptr, color.w);
+    ptr = put(ptr, depth);
+    put(ptr, stencil);
+}
+
+} // namespace Oryol
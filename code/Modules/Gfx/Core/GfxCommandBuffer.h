@@ -0,0 +1,228 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::GfxCommandBuffer
+    @ingroup Gfx
+    @brief record Gfx commands for later submission
+
+    A GfxCommandBuffer records the same rendering commands as the
+    immediate-mode Gfx methods (ApplyDrawState, ApplyUniformBlock,
+    Draw, ...) into a compact binary command stream without touching
+    any renderer state. Since recording doesn't access the Gfx module,
+    command buffers can be filled on any thread, the recorded
+    commands are executed on the Gfx thread with Gfx::Submit().
+
+    Each command is a 1-byte command code followed by its tightly
+    packed arguments. Uniform block and vertex data is copied into
+    the command stream, so the source data doesn't need to be
+    kept alive until the command buffer is submitted.
+
+    Resources are recorded by Id and resolved during submission.
+
+    @see Gfx::Submit(), GfxFrameStats
+*/
+#include "Core/Types.h"
+#include "Core/Assertion.h"
+#include "Resource/Id.h"
+#include "Gfx/Core/Enums.h"
+#include "Gfx/Core/PrimitiveGroup.h"
+#include "glm/vec4.hpp"
+#include <cstring>
+
+namespace Oryol {
+
+class GfxCommandBuffer {
+public:
+    /// command codes and their arguments in the command stream
+    struct Cmd {
+        enum Code : uint8 {
+            ApplyRenderTarget,          ///< Id (invalid Id for default render target)
+            ApplyViewPort,              ///< int32 x, y, width, height
+            ApplyScissorRect,           ///< int32 x, y, width, height
+            ApplyDrawState,             ///< Id
+            ApplyUniformBlock,          ///< int32 blockIndex, int64 layoutHash, int32 byteSize, uint8 data[byteSize]
+            UpdateVertices,             ///< Id, int32 numBytes, uint8 data[numBytes]
+            Clear,                      ///< uint32 mask, float32 color[4], float32 depth, uint8 stencil
+            Draw,                       ///< int32 primGroupIndex
+            DrawPrimGroup,              ///< PrimitiveGroup
+            DrawInstanced,              ///< int32 primGroupIndex, int32 numInstances
+            DrawInstancedPrimGroup,     ///< PrimitiveGroup, int32 numInstances
+
+            NumCmds,
+            InvalidCmd = 0xFF
+        };
+    };
+
+    /// constructor
+    GfxCommandBuffer();
+    /// move constructor
+    GfxCommandBuffer(GfxCommandBuffer&& rhs);
+    /// destructor
+    ~GfxCommandBuffer();
+    /// move-assignment
+    void operator=(GfxCommandBuffer&& rhs);
+
+    /// make sure that numBytes can be recorded without growing
+    void Reserve(int32 numBytes);
+    /// remove all recorded commands (keeps the allocated memory)
+    void Reset();
+    /// return true if no commands have been recorded
+    bool Empty() const;
+    /// number of recorded commands
+    int32 NumCommands() const;
+    /// size of the recorded command stream in bytes
+    int32 Size() const;
+    /// allocated size in bytes
+    int32 Capacity() const;
+    /// direct read access to the command stream
+    const uint8* Data() const;
+
+    /// record making the default render target current
+    void ApplyDefaultRenderTarget();
+    /// record applying an offscreen render target
+    void ApplyOffscreenRenderTarget(const Id& id);
+    /// record applying the view port
+    void ApplyViewPort(int32 x, int32 y, int32 width, int32 height);
+    /// record applying the scissor rect
+    void ApplyScissorRect(int32 x, int32 y, int32 width, int32 height);
+    /// record applying a draw state
+    void ApplyDrawState(const Id& id);
+    /// record applying a uniform block
+    template<class T> void ApplyUniformBlock(const T& value);
+    /// record applying a uniform block from raw data
+    void ApplyUniformBlock(int32 blockIndex, int64 layoutHash, const void* data, int32 byteSize);
+    /// record updating dynamic vertex data
+    void UpdateVertices(const Id& id, const void* data, int32 numBytes);
+    /// record clearing the current render target
+    void Clear(ClearTarget::Mask clearMask, const glm::vec4& color, float32 depth=1.0f, uint8 stencil=0);
+    /// record a draw call with primitive group index in current mesh
+    void Draw(int32 primGroupIndex);
+    /// record a draw call with direct primitive group
+    void Draw(const PrimitiveGroup& primGroup);
+    /// record an instanced draw call with primitive group index in current mesh
+    void DrawInstanced(int32 primGroupIndex, int32 numInstances);
+    /// record an instanced draw call with direct primitive group
+    void DrawInstanced(const PrimitiveGroup& primGroup, int32 numInstances);
+
+private:
+    /// prevent copying
+    GfxCommandBuffer(const GfxCommandBuffer& rhs) = delete;
+    void operator=(const GfxCommandBuffer& rhs) = delete;
+
+    /// begin a new command, returns write pointer for numArgBytes argument bytes
+    uint8* begin(Cmd::Code cmd, int32 numArgBytes);
+    /// grow the buffer to hold at least minCapacity bytes
+    void grow(int32 minCapacity);
+    /// append a value at write pointer and advance
+    template<class T> static uint8* put(uint8* ptr, const T& val);
+
+    uint8* buffer;
+    int32 size;
+    int32 capacity;
+    int32 numCommands;
+};
+
+//------------------------------------------------------------------------------
+template<class T> inline uint8*
+GfxCommandBuffer::put(uint8* ptr, const T& val) {
+    std::memcpy(ptr, &val, sizeof(T));
+    return ptr + sizeof(T);
+}
+
+//------------------------------------------------------------------------------
+inline uint8*
+GfxCommandBuffer::begin(Cmd::Code cmd, int32 numArgBytes) {
+    const int32 numBytes = 1 + numArgBytes;
+    if ((this->size + numBytes) > this->capacity) {
+        this->grow(this->size + numBytes);
+    }
+    uint8* ptr = this->buffer + this->size;
+    *ptr++ = cmd;
+    this->size += numBytes;
+    this->numCommands++;
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+GfxCommandBuffer::Empty() const {
+    return 0 == this->numCommands;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+GfxCommandBuffer::NumCommands() const {
+    return this->numCommands;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+GfxCommandBuffer::Size() const {
+    return this->size;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+GfxCommandBuffer::Capacity() const {
+    return this->capacity;
+}
+
+//------------------------------------------------------------------------------
+inline const uint8*
+GfxCommandBuffer::Data() const {
+    return this->buffer;
+}
+
+//------------------------------------------------------------------------------
+inline void
+GfxCommandBuffer::ApplyDrawState(const Id& id) {
+    put(this->begin(Cmd::ApplyDrawState, sizeof(uint64)), id.Value);
+}
+
+//------------------------------------------------------------------------------
+template<class T> inline void
+GfxCommandBuffer::ApplyUniformBlock(const T& value) {
+    this->ApplyUniformBlock(T::_uniformBlockIndex, T::_layoutHash, &value, sizeof(value));
+}
+
+//------------------------------------------------------------------------------
+inline void
+GfxCommandBuffer::ApplyUniformBlock(int32 blockIndex, int64 layoutHash, const void* data, int32 byteSize) {
+    o_assert_dbg(nullptr != data);
+    o_assert_dbg(byteSize > 0);
+    uint8* ptr = this->begin(Cmd::ApplyUniformBlock, 2 * sizeof(int32) + sizeof(int64) + byteSize);
+    ptr = put(ptr, blockIndex);
+    ptr = put(ptr, layoutHash);
+    ptr = put(ptr, byteSize);
+    std::memcpy(ptr, data, byteSize);
+}
+
+//------------------------------------------------------------------------------
+inline void
+GfxCommandBuffer::Draw(int32 primGroupIndex) {
+    put(this->begin(Cmd::Draw, sizeof(int32)), primGroupIndex);
+}
+
+//------------------------------------------------------------------------------
+inline void
+GfxCommandBuffer::Draw(const PrimitiveGroup& primGroup) {
+    put(this->begin(Cmd::DrawPrimGroup, sizeof(PrimitiveGroup)), primGroup);
+}
+
+//------------------------------------------------------------------------------
+inline void
+GfxCommandBuffer::DrawInstanced(int32 primGroupIndex, int32 numInstances) {
+    uint8* ptr = this->begin(Cmd::DrawInstanced, 2 * sizeof(int32));
+    ptr = put(ptr, primGroupIndex);
+    put(ptr, numInstances);
+}
+
+//------------------------------------------------------------------------------
+inline void
+GfxCommandBuffer::DrawInstanced(const PrimitiveGroup& primGroup, int32 numInstances) {
+    uint8* ptr = this->begin(Cmd::DrawInstancedPrimGroup, sizeof(PrimitiveGroup) + sizeof(int32));
+    ptr = put(ptr, primGroup);
+    put(ptr, numInstances);
+}
+
+} // namespace Oryol
@@ -0,0 +1,56 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::GfxFrameStats
+    @ingroup Gfx
+    @brief per-frame statistics of submitted command buffers
+
+    Counted while executing command buffers in Gfx::Submit(), a bind is
+    redundant if it applies the same render target, view port, scissor
+    rect, draw state or uniform block data which is already current.
+    Immediate-mode Gfx calls are not counted, applying state through
+    them resets the redundancy tracking of the next Gfx::Submit().
+
+    The uniform buffer counters are provided by the renderer and
+    include immediate-mode applies, they are only non-zero on
+    renderers which write uniform blocks into a uniform buffer ring
+    (currently the GL core profile renderer).
+
+    The sorted draw counters are only non-zero if sorted DrawLists
+    have been flushed in the frame.
+
+    @see Gfx::FrameStats(), GfxCommandBuffer
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+
+class GfxFrameStats {
+public:
+    /// number of submitted command buffers
+    int32 NumCommandBuffers = 0;
+    /// number of executed commands
+    int32 NumCommands = 0;
+    /// number of draw calls (including instanced draws)
+    int32 NumDraws = 0;
+    /// number of rendered instances (1 per non-instanced draw)
+    int32 NumInstances = 0;
+    /// number of applies which changed state
+    int32 NumStateChanges = 0;
+    /// number of applies which didn't change state
+    int32 NumRedundantBinds = 0;
+    /// number of uniform bytes applied
+    int32 NumUniformBytes = 0;
+    /// number of vertex bytes updated
+    int32 NumVertexBytes = 0;
+    /// number of bytes consumed in the uniform buffer ring (including alignment padding)
+    int32 NumUniformBufferBytes = 0;
+    /// number of times the uniform buffer ring wrapped around
+    int32 NumUniformBufferWraps = 0;
+    /// number of draws from sorted DrawLists
+    int32 NumSortedDraws = 0;
+    /// number of state changes saved by sorting draws (negative if sorting added changes)
+    int32 NumStateChangesAvoided = 0;
+};
+
+} // namespace Oryol
@@ -9,7 +9,13 @@
     GL context creation, and usually processes host window system
     events (such as input events) and forwards them to Oryol.
 */
-#if ORYOL_D3D11
+#if ORYOL_NULL_GFX
+#include "Gfx/Core/displayMgrBase.h"
+namespace Oryol {
+namespace _priv {
+class displayMgr : public displayMgrBase { };
+} }
+#elif ORYOL_D3D11
 #include "Gfx/d3d11/d3d11DisplayMgr.h"
 namespace Oryol {
 namespace _priv {
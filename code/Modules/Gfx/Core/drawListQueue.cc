@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+//  drawListQueue.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "drawListQueue.h"
+#include "Gfx/Core/gfxCmdReplay.h"
+#include <algorithm>
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+drawListQueue::drawListQueue() {
+    this->pending.SetAllocStrategy(64, 64);
+    this->merged.SetAllocStrategy(64, 64);
+}
+
+//------------------------------------------------------------------------------
+drawListQueue::~drawListQueue() {
+    o_assert_dbg(this->pending.Empty());
+}
+
+//------------------------------------------------------------------------------
+void
+drawListQueue::enqueue(const DrawList* drawList) {
+    o_assert_dbg(nullptr != drawList);
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> guard(this->lock);
+    #endif
+    this->pending.Add(drawList);
+}
+
+//------------------------------------------------------------------------------
+void
+drawListQueue::flush(gfxCmdReplay* replay) {
+    o_assert_dbg(nullptr != replay);
+    {
+        #if ORYOL_HAS_THREADS
+        std::lock_guard<std::mutex> guard(this->lock);
+        #endif
+        if (this->pending.Empty()) {
+            return;
+        }
+        for (const DrawList* drawList : this->pending) {
+            this->merged.Add(drawList);
+        }
+        this->pending.Clear();
+    }
+
+    // stable sort keeps the enqueue order of lists with the same order
+    std::stable_sort(this->merged.begin(), this->merged.end(),
+        [](const DrawList* a, const DrawList* b) {
+            return a->Order() < b->Order();
+        });
+    for (int32 i = 0; i < this->merged.Size(); i++) {
+        const DrawList* drawList = this->merged[i];
+        if (!drawList->SortDraws()) {
+            replay->execute(drawList->CommandBuffer());
+            continue;
+        }
+        // sort the draws of all following sorted lists with the same order together
+        this->sorter.add(drawList);
+        const bool lastInBatch = (i + 1 == this->merged.Size()) ||
+            !this->merged[i + 1]->SortDraws() ||
+            (this->merged[i + 1]->Order() != drawList->Order());
+        if (lastInBatch) {
+            replay->executeSorted(this->sorter);
+        }
+    }
+    this->merged.Clear();
+}
+
+//------------------------------------------------------------------------------
+void
+drawListQueue::clear() {
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> guard(this->lock);
+    #endif
+    this->pending.Clear();
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,51 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::drawListQueue
+    @ingroup _priv
+    @brief private: collect DrawLists from any thread and execute them
+
+    Enqueueing is guarded by a lock, the lock is only held to append
+    or take out list pointers, never while executing commands.
+
+    Consecutive sorted lists with the same order are executed as one
+    batch through a gfxDrawSorter.
+*/
+#include "Core/Config.h"
+#include "Core/Containers/Array.h"
+#include "Gfx/Core/DrawList.h"
+#include "Gfx/Core/gfxDrawSorter.h"
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+class gfxCmdReplay;
+
+class drawListQueue {
+public:
+    /// constructor
+    drawListQueue();
+    /// destructor
+    ~drawListQueue();
+
+    /// add a draw list (thread-safe)
+    void enqueue(const DrawList* drawList);
+    /// merge and execute all enqueued draw lists (render thread)
+    void flush(gfxCmdReplay* replay);
+    /// drop enqueued draw lists without executing them (render thread)
+    void clear();
+
+private:
+    #if ORYOL_HAS_THREADS
+    std::mutex lock;
+    #endif
+    Array<const DrawList*> pending;
+    Array<const DrawList*> merged;
+    gfxDrawSorter sorter;
+};
+
+} // namespace _priv
+} // namespace Oryol
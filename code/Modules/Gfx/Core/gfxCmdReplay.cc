@@ -0,0 +1,308 @@
+//------------------------------------------------------------------------------
+//  gfxCmdReplay.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "gfxCmdReplay.h"
+#include "Core/Trace.h"
+#include "Gfx/Core/renderer.h"
+#include "Gfx/Core/gfxDrawSorter.h"
+#include "Gfx/Resource/gfxResourceContainer.h"
+
+namespace Oryol {
+namespace _priv {
+
+namespace {
+
+//------------------------------------------------------------------------------
+template<class T> inline const uint8*
+get(const uint8* ptr, T& val) {
+    std::memcpy(&val, ptr, sizeof(T));
+    return ptr + sizeof(T);
+}
+
+//------------------------------------------------------------------------------
+inline const uint8*
+getId(const uint8* ptr, Id& id) {
+    return get(ptr, id.Value);
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+gfxCmdReplay::gfxCmdReplay() :
+rendr(nullptr),
+resContainer(nullptr),
+valid(false) {
+    this->invalidate();
+}
+
+//------------------------------------------------------------------------------
+gfxCmdReplay::~gfxCmdReplay() {
+    o_assert_dbg(!this->valid);
+}
+
+//------------------------------------------------------------------------------
+void
+gfxCmdReplay::setup(class renderer* rendr_, gfxResourceContainer* resContainer_) {
+    o_assert_dbg(!this->valid);
+    o_assert_dbg(nullptr != rendr_);
+    o_assert_dbg(nullptr != resContainer_);
+    this->rendr = rendr_;
+    this->resContainer = resContainer_;
+    this->curStats = GfxFrameStats();
+    this->lastStats = GfxFrameStats();
+    this->invalidate();
+    this->valid = true;
+}
+
+//------------------------------------------------------------------------------
+void
+gfxCmdReplay::discard() {
+    o_assert_dbg(this->valid);
+    this->rendr = nullptr;
+    this->resContainer = nullptr;
+    this->valid = false;
+}
+
+//------------------------------------------------------------------------------
+bool
+gfxCmdReplay::isValid() const {
+    return this->valid;
+}
+
+//------------------------------------------------------------------------------
+void
+gfxCmdReplay::invalidate() {
+    this->externalChange = false;
+    this->renderTargetValid = false;
+    this->curRenderTarget.Invalidate();
+    this->curDrawState.Invalidate();
+    for (int32 i = 0; i < 4; i++) {
+        this->viewPort[i] = -1;
+        this->scissorRect[i] = -1;
+    }
+    for (auto& cache : this->uniforms) {
+        cache.layoutHash = 0;
+        cache.byteSize = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+gfxCmdReplay::commitFrame() {
+    this->rendr->addFrameStats(this->curStats);
+    this->lastStats = this->curStats;
+    this->curStats = GfxFrameStats();
+    this->invalidate();
+}
+
+//------------------------------------------------------------------------------
+bool
+gfxCmdReplay::updateUniformCache(int32 blockIndex, int64 layoutHash, const uint8* data, int32 byteSize) {
+    o_assert_range_dbg(blockIndex, ProgramBundleSetup::MaxNumUniformBlocks);
+    uniformCache& cache = this->uniforms[blockIndex];
+    if (byteSize > MaxCachedUniformBytes) {
+        cache.layoutHash = 0;
+        cache.byteSize = 0;
+        return true;
+    }
+    if ((cache.layoutHash == layoutHash) &&
+        (cache.byteSize == byteSize) &&
+        (0 == std::memcmp(cache.data, data, byteSize))) {
+        return false;
+    }
+    cache.layoutHash = layoutHash;
+    cache.byteSize = byteSize;
+    std::memcpy(cache.data, data, byteSize);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+gfxCmdReplay::execute(const GfxCommandBuffer& cmdBuffer) {
+    o_trace_scoped(Gfx_ExecuteCommandBuffer);
+    o_assert_dbg(this->valid);
+
+    typedef GfxCommandBuffer::Cmd Cmd;
+    class renderer* r = this->rendr;
+    GfxFrameStats& stats = this->curStats;
+    stats.NumCommandBuffers++;
+    stats.NumCommands += cmdBuffer.NumCommands();
+    if (this->externalChange) {
+        this->invalidate();
+    }
+
+    const uint8* ptr = cmdBuffer.Data();
+    const uint8* end = ptr + cmdBuffer.Size();
+    while (ptr < end) {
+        const Cmd::Code cmd = (Cmd::Code) *ptr++;
+        switch (cmd) {
+            case Cmd::ApplyRenderTarget:
+                {
+                    Id id;
+                    ptr = getId(ptr, id);
+                    this->countBind(!this->renderTargetValid || (id != this->curRenderTarget));
+                    texture* rt = nullptr;
+                    if (id.IsValid()) {
+                        rt = this->resContainer->lookupTexture(id);
+                        o_assert_dbg(nullptr != rt);
+                    }
+                    r->applyRenderTarget(rt);
+                    this->renderTargetValid = true;
+                    this->curRenderTarget = id;
+                    // applying a render target resets the view port and scissor test
+                    const DisplayAttrs& rtAttrs = r->renderTargetAttrs();
+                    this->viewPort[0] = 0;
+                    this->viewPort[1] = 0;
+                    this->viewPort[2] = rtAttrs.FramebufferWidth;
+                    this->viewPort[3] = rtAttrs.FramebufferHeight;
+                }
+                break;
+
+            case Cmd::ApplyViewPort:
+            case Cmd::ApplyScissorRect:
+                {
+                    int32 rect[4];
+                    ptr = get(ptr, rect);
+                    int32* cur = (Cmd::ApplyViewPort == cmd) ? this->viewPort : this->scissorRect;
+                    const bool changed = 0 != std::memcmp(cur, rect, sizeof(rect));
+                    this->countBind(changed);
+                    std::memcpy(cur, rect, sizeof(rect));
+                    if (Cmd::ApplyViewPort == cmd) {
+                        r->applyViewPort(rect[0], rect[1], rect[2], rect[3]);
+                    }
+                    else {
+                        r->applyScissorRect(rect[0], rect[1], rect[2], rect[3]);
+                    }
+                }
+                break;
+
+            case Cmd::ApplyDrawState:
+                {
+                    Id id;
+                    ptr = getId(ptr, id);
+                    const bool changed = id != this->curDrawState;
+                    this->countBind(changed);
+                    if (changed) {
+                        // a new draw state may select a different program,
+                        // so all uniform blocks must be applied again
+                        this->curDrawState = id;
+                        for (auto& cache : this->uniforms) {
+                            cache.layoutHash = 0;
+                            cache.byteSize = 0;
+                        }
+                    }
+                    r->applyDrawState(this->resContainer->lookupDrawState(id));
+                }
+                break;
+
+            case Cmd::ApplyUniformBlock:
+                {
+                    int32 blockIndex, byteSize;
+                    int64 layoutHash;
+                    ptr = get(ptr, blockIndex);
+                    ptr = get(ptr, layoutHash);
+                    ptr = get(ptr, byteSize);
+                    this->countBind(this->updateUniformCache(blockIndex, layoutHash, ptr, byteSize));
+                    stats.NumUniformBytes += byteSize;
+                    r->applyUniformBlock(blockIndex, layoutHash, ptr, byteSize);
+                    ptr += byteSize;
+                }
+                break;
+
+            case Cmd::UpdateVertices:
+                {
+                    Id id;
+                    int32 numBytes;
+                    ptr = getId(ptr, id);
+                    ptr = get(ptr, numBytes);
+                    stats.NumVertexBytes += numBytes;
+                    r->updateVertices(this->resContainer->lookupMesh(id), ptr, numBytes);
+                    ptr += numBytes;
+                }
+                break;
+
+            case Cmd::Clear:
+                {
+                    uint32 mask;
+                    glm::vec4 color;
+                    float32 depth;
+                    uint8 stencil;
+                    ptr = get(ptr, mask);
+                    ptr = get(ptr, color.x);
+                    ptr = get(ptr, color.y);
+                    ptr = get(ptr, color.z);
+                    ptr = get(ptr, color.w);
+                    ptr = get(ptr, depth);
+                    ptr = get(ptr, stencil);
+                    r->clear(mask, color, depth, stencil);
+                }
+                break;
+
+            case Cmd::Draw:
+                {
+                    int32 primGroupIndex;
+                    ptr = get(ptr, primGroupIndex);
+                    stats.NumDraws++;
+                    stats.NumInstances++;
+                    r->draw(primGroupIndex);
+                }
+                break;
+
+            case Cmd::DrawPrimGroup:
+                {
+                    PrimitiveGroup primGroup;
+                    ptr = get(ptr, primGroup);
+                    stats.NumDraws++;
+                    stats.NumInstances++;
+                    r->draw(primGroup);
+                }
+                break;
+
+            case Cmd::DrawInstanced:
+                {
+                    int32 primGroupIndex, numInstances;
+                    ptr = get(ptr, primGroupIndex);
+                    ptr = get(ptr, numInstances);
+                    stats.NumDraws++;
+                    stats.NumInstances += numInstances;
+                    r->drawInstanced(primGroupIndex, numInstances);
+                }
+                break;
+
+            case Cmd::DrawInstancedPrimGroup:
+                {
+                    PrimitiveGroup primGroup;
+                    int32 numInstances;
+                    ptr = get(ptr, primGroup);
+                    ptr = get(ptr, numInstances);
+                    stats.NumDraws++;
+                    stats.NumInstances += numInstances;
+                    r->drawInstanced(primGroup, numInstances);
+                }
+                break;
+
+            default:
+                o_error("gfxCmdReplay::execute(): invalid command code '%d'!\n", cmd);
+                return;
+        }
+    }
+    o_assert_dbg(ptr == end);
+}
+
+//------------------------------------------------------------------------------
+void
+gfxCmdReplay::executeSorted(gfxDrawSorter& sorter) {
+    o_assert_dbg(this->valid);
+    if (sorter.empty()) {
+        return;
+    }
+    sorter.sort(this->resContainer);
+    this->curStats.NumSortedDraws += sorter.numDraws();
+    this->curStats.NumStateChangesAvoided += sorter.numStateChangesAvoided();
+    this->execute(sorter.commandBuffer());
+    sorter.clear();
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,105 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::gfxCmdReplay
+    @ingroup _priv
+    @brief private: execute GfxCommandBuffers on the renderer
+
+    Decodes the command stream of a GfxCommandBuffer, resolves resource
+    Ids and calls the matching renderer methods. Keeps track of the
+    high-level state applied through command buffers to count state
+    changes and redundant binds for the GfxFrameStats.
+*/
+#include "Gfx/Core/GfxCommandBuffer.h"
+#include "Gfx/Core/GfxFrameStats.h"
+#include "Gfx/Setup/ProgramBundleSetup.h"
+
+namespace Oryol {
+namespace _priv {
+
+class renderer;
+class gfxResourceContainer;
+class gfxDrawSorter;
+
+class gfxCmdReplay {
+public:
+    /// constructor
+    gfxCmdReplay();
+    /// destructor
+    ~gfxCmdReplay();
+
+    /// setup the replay object
+    void setup(renderer* rendr, gfxResourceContainer* resContainer);
+    /// discard the replay object
+    void discard();
+    /// return true if setup
+    bool isValid() const;
+
+    /// execute all commands in a command buffer
+    void execute(const GfxCommandBuffer& cmdBuffer);
+    /// sort the draws collected in a draw sorter, execute them and clear the sorter
+    void executeSorted(gfxDrawSorter& sorter);
+    /// forget tracked state
+    void invalidate();
+    /// notify that renderer state was changed outside of command buffers
+    void externalStateChanged();
+    /// finish the current frame statistics (call before renderer::commitFrame)
+    void commitFrame();
+    /// get statistics of the last committed frame
+    const GfxFrameStats& frameStats() const;
+
+private:
+    /// uniform blocks larger than this are not checked for redundancy
+    static const int32 MaxCachedUniformBytes = 256;
+
+    /// count a state change or redundant bind
+    void countBind(bool changed);
+    /// check if a uniform block apply would change state, and update cache
+    bool updateUniformCache(int32 blockIndex, int64 layoutHash, const uint8* data, int32 byteSize);
+
+    renderer* rendr;
+    gfxResourceContainer* resContainer;
+    bool valid;
+
+    GfxFrameStats curStats;
+    GfxFrameStats lastStats;
+
+    // tracked state
+    bool externalChange;
+    bool renderTargetValid;
+    Id curRenderTarget;
+    Id curDrawState;
+    int32 viewPort[4];
+    int32 scissorRect[4];
+    struct uniformCache {
+        int64 layoutHash;
+        int32 byteSize;
+        uint8 data[MaxCachedUniformBytes];
+    } uniforms[ProgramBundleSetup::MaxNumUniformBlocks];
+};
+
+//------------------------------------------------------------------------------
+inline const GfxFrameStats&
+gfxCmdReplay::frameStats() const {
+    return this->lastStats;
+}
+
+//------------------------------------------------------------------------------
+inline void
+gfxCmdReplay::externalStateChanged() {
+    this->externalChange = true;
+}
+
+//------------------------------------------------------------------------------
+inline void
+gfxCmdReplay::countBind(bool changed) {
+    if (changed) {
+        this->curStats.NumStateChanges++;
+    }
+    else {
+        this->curStats.NumRedundantBinds++;
+    }
+}
+
+} // namespace _priv
+} // namespace Oryol
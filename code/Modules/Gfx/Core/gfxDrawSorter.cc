@@ -0,0 +1,363 @@
+//------------------------------------------------------------------------------
+//  gfxDrawSorter.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "gfxDrawSorter.h"
+#include "Core/Trace.h"
+#include "Gfx/Core/DrawList.h"
+#include "Gfx/Resource/gfxResourceContainer.h"
+#include <cstring>
+
+namespace Oryol {
+namespace _priv {
+
+namespace {
+
+typedef GfxCommandBuffer::Cmd Cmd;
+
+//------------------------------------------------------------------------------
+template<class T> inline const uint8*
+get(const uint8* ptr, T& val) {
+    std::memcpy(&val, ptr, sizeof(T));
+    return ptr + sizeof(T);
+}
+
+//------------------------------------------------------------------------------
+/// decode the header of an ApplyUniformBlock command, returns pointer to the data
+inline const uint8*
+getUniformBlock(const uint8* cmd, int32& blockIndex, int64& layoutHash, int32& byteSize) {
+    o_assert_dbg(Cmd::ApplyUniformBlock == *cmd);
+    const uint8* ptr = get(cmd + 1, blockIndex);
+    ptr = get(ptr, layoutHash);
+    return get(ptr, byteSize);
+}
+
+//------------------------------------------------------------------------------
+/// total size of an ApplyUniformBlock command in bytes
+inline int32
+uniformBlockCmdSize(const uint8* cmd) {
+    int32 blockIndex, byteSize;
+    int64 layoutHash;
+    const uint8* data = getUniformBlock(cmd, blockIndex, layoutHash, byteSize);
+    return int32(data - cmd) + byteSize;
+}
+
+//------------------------------------------------------------------------------
+/// check if 2 ApplyUniformBlock commands apply the same data
+inline bool
+sameUniformBlock(const uint8* cmd0, const uint8* cmd1) {
+    if (cmd0 == cmd1) {
+        return true;
+    }
+    if ((nullptr == cmd0) || (nullptr == cmd1)) {
+        return false;
+    }
+    const int32 size = uniformBlockCmdSize(cmd0);
+    return (size == uniformBlockCmdSize(cmd1)) && (0 == std::memcmp(cmd0, cmd1, size));
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+void
+gfxDrawSorter::stateTracker::reset() {
+    this->drawState.Invalidate();
+    for (auto& block : this->uniformBlocks) {
+        block = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+int32
+gfxDrawSorter::stateTracker::apply(const packet& p, bool* outApplyDrawState, bool* outApplyUniformBlocks) {
+    int32 numChanges = 0;
+    *outApplyDrawState = p.drawState != this->drawState;
+    if (*outApplyDrawState) {
+        // a new draw state may select a different program,
+        // so all uniform blocks must be applied again
+        this->drawState = p.drawState;
+        for (auto& block : this->uniformBlocks) {
+            block = nullptr;
+        }
+        numChanges++;
+    }
+    for (int32 i = 0; i < ProgramBundleSetup::MaxNumUniformBlocks; i++) {
+        outApplyUniformBlocks[i] = false;
+        if (p.uniformBlocks[i] && !sameUniformBlock(p.uniformBlocks[i], this->uniformBlocks[i])) {
+            outApplyUniformBlocks[i] = true;
+            this->uniformBlocks[i] = p.uniformBlocks[i];
+            numChanges++;
+        }
+    }
+    return numChanges;
+}
+
+//------------------------------------------------------------------------------
+void
+gfxDrawSorter::add(const DrawList* drawList) {
+    o_assert_dbg(nullptr != drawList);
+    o_assert_dbg(drawList->SortDraws());
+
+    const GfxCommandBuffer& src = drawList->CommandBuffer();
+    packet cur;
+    cur.drawState.Invalidate();
+    for (auto& block : cur.uniformBlocks) {
+        block = nullptr;
+    }
+    cur.draw = nullptr;
+    cur.depth = 0.0f;
+
+    int32 drawIndex = 0;
+    const uint8* ptr = src.Data();
+    const uint8* end = ptr + src.Size();
+    while (ptr < end) {
+        const uint8* cmdStart = ptr;
+        const Cmd::Code cmd = (Cmd::Code) *ptr++;
+        switch (cmd) {
+            case Cmd::ApplyDrawState:
+                {
+                    Id id;
+                    ptr = get(ptr, id.Value);
+                    if (id != cur.drawState) {
+                        cur.drawState = id;
+                        for (auto& block : cur.uniformBlocks) {
+                            block = nullptr;
+                        }
+                    }
+                }
+                break;
+
+            case Cmd::ApplyUniformBlock:
+                {
+                    int32 blockIndex, byteSize;
+                    int64 layoutHash;
+                    ptr = getUniformBlock(cmdStart, blockIndex, layoutHash, byteSize) + byteSize;
+                    o_assert_range_dbg(blockIndex, ProgramBundleSetup::MaxNumUniformBlocks);
+                    cur.uniformBlocks[blockIndex] = cmdStart;
+                }
+                break;
+
+            case Cmd::Draw:
+            case Cmd::DrawPrimGroup:
+            case Cmd::DrawInstanced:
+            case Cmd::DrawInstancedPrimGroup:
+                {
+                    if (Cmd::Draw == cmd) {
+                        ptr += sizeof(int32);
+                    }
+                    else if (Cmd::DrawPrimGroup == cmd) {
+                        ptr += sizeof(PrimitiveGroup);
+                    }
+                    else if (Cmd::DrawInstanced == cmd) {
+                        ptr += 2 * sizeof(int32);
+                    }
+                    else {
+                        ptr += sizeof(PrimitiveGroup) + sizeof(int32);
+                    }
+                    cur.draw = cmdStart;
+                    cur.depth = drawList->DrawDepth(drawIndex++);
+                    this->packets.Add(cur);
+                }
+                break;
+
+            default:
+                o_error("gfxDrawSorter: sorted DrawLists can only record draw states, uniform blocks and draws!\n");
+                return;
+        }
+    }
+    o_assert_dbg(ptr == end);
+    o_assert_dbg(drawIndex == drawList->NumDraws());
+}
+
+//------------------------------------------------------------------------------
+uint64
+gfxDrawSorter::sortKey(uint16 progSlot, uint16 drawStateSlot, uint16 textureSlot, float32 depth) {
+    // the bit pattern of a positive float sorts like its value,
+    // the upper 16 bits are precise enough for front-to-back sorting
+    uint32 depthBits = 0;
+    if (depth > 0.0f) {
+        std::memcpy(&depthBits, &depth, sizeof(depthBits));
+    }
+    return (uint64(progSlot) << 48) |
+           (uint64(drawStateSlot) << 32) |
+           (uint64(textureSlot) << 16) |
+           uint64(depthBits >> 16);
+}
+
+//------------------------------------------------------------------------------
+uint64
+gfxDrawSorter::packetKey(const packet& p, gfxResourceContainer* resContainer) {
+    uint16 progSlot = Id::InvalidSlotIndex;
+    uint16 texSlot = Id::InvalidSlotIndex;
+    const drawState* ds = resContainer->lookupDrawState(p.drawState);
+    if (ds) {
+        progSlot = ds->Setup.Program.SlotIndex;
+        if (ds->prog) {
+            const ProgramBundleSetup& progSetup = ds->prog->Setup;
+            for (int32 i = 0; (i < progSetup.NumUniformBlocks()) && (Id::InvalidSlotIndex == texSlot); i++) {
+                if (nullptr == p.uniformBlocks[i]) {
+                    continue;
+                }
+                int32 blockIndex, byteSize;
+                int64 layoutHash;
+                const uint8* data = getUniformBlock(p.uniformBlocks[i], blockIndex, layoutHash, byteSize);
+                const UniformLayout& layout = progSetup.UniformBlockLayout(i);
+                for (int32 compIndex = 0; compIndex < layout.NumComponents(); compIndex++) {
+                    if (UniformType::Texture == layout.ComponentAt(compIndex).Type) {
+                        Id texId;
+                        get(data + layout.ComponentByteOffset(compIndex), texId.Value);
+                        texSlot = texId.SlotIndex;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return sortKey(progSlot, p.drawState.SlotIndex, texSlot, p.depth);
+}
+
+//------------------------------------------------------------------------------
+void
+gfxDrawSorter::radixSort(sortItem* items, sortItem* tmp, int32 num) {
+    if (num < 2) {
+        return;
+    }
+    sortItem* src = items;
+    sortItem* dst = tmp;
+    for (int32 shift = 0; shift < 64; shift += 8) {
+        int32 offsets[256] = { };
+        for (int32 i = 0; i < num; i++) {
+            offsets[(src[i].key >> shift) & 0xFF]++;
+        }
+        // skip the pass if all keys have the same byte
+        if (num == offsets[(src[0].key >> shift) & 0xFF]) {
+            continue;
+        }
+        int32 offset = 0;
+        for (int32 digit = 0; digit < 256; digit++) {
+            const int32 count = offsets[digit];
+            offsets[digit] = offset;
+            offset += count;
+        }
+        for (int32 i = 0; i < num; i++) {
+            dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+        sortItem* swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != items) {
+        std::memcpy(items, src, num * sizeof(sortItem));
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+gfxDrawSorter::record(const packet& p, const bool* applyUniformBlocks, bool applyDrawState) {
+    if (applyDrawState) {
+        this->cmdBuffer.ApplyDrawState(p.drawState);
+    }
+    for (int32 i = 0; i < ProgramBundleSetup::MaxNumUniformBlocks; i++) {
+        if (applyUniformBlocks[i]) {
+            int32 blockIndex, byteSize;
+            int64 layoutHash;
+            const uint8* data = getUniformBlock(p.uniformBlocks[i], blockIndex, layoutHash, byteSize);
+            this->cmdBuffer.ApplyUniformBlock(blockIndex, layoutHash, data, byteSize);
+        }
+    }
+    const uint8* ptr = p.draw + 1;
+    switch ((Cmd::Code) *p.draw) {
+        case Cmd::Draw:
+            {
+                int32 primGroupIndex;
+                get(ptr, primGroupIndex);
+                this->cmdBuffer.Draw(primGroupIndex);
+            }
+            break;
+        case Cmd::DrawPrimGroup:
+            {
+                PrimitiveGroup primGroup;
+                get(ptr, primGroup);
+                this->cmdBuffer.Draw(primGroup);
+            }
+            break;
+        case Cmd::DrawInstanced:
+            {
+                int32 primGroupIndex, numInstances;
+                ptr = get(ptr, primGroupIndex);
+                get(ptr, numInstances);
+                this->cmdBuffer.DrawInstanced(primGroupIndex, numInstances);
+            }
+            break;
+        case Cmd::DrawInstancedPrimGroup:
+            {
+                PrimitiveGroup primGroup;
+                int32 numInstances;
+                ptr = get(ptr, primGroup);
+                get(ptr, numInstances);
+                this->cmdBuffer.DrawInstanced(primGroup, numInstances);
+            }
+            break;
+        default:
+            o_error("gfxDrawSorter: invalid draw command!\n");
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+gfxDrawSorter::sort(gfxResourceContainer* resContainer) {
+    o_trace_scoped(Gfx_SortDraws);
+    o_assert_dbg(nullptr != resContainer);
+    o_assert_dbg(!this->packets.Empty());
+
+    stateTracker tracker;
+    bool applyDrawState;
+    bool applyUniformBlocks[ProgramBundleSetup::MaxNumUniformBlocks];
+
+    // count state changes in recording order
+    const int32 num = this->packets.Size();
+    int32 numRecordedChanges = 0;
+    tracker.reset();
+    for (const packet& p : this->packets) {
+        numRecordedChanges += tracker.apply(p, &applyDrawState, applyUniformBlocks);
+    }
+
+    // compute sort keys and sort
+    this->items.Clear();
+    this->tmpItems.Clear();
+    this->items.Reserve(num);
+    this->tmpItems.Reserve(num);
+    for (int32 i = 0; i < num; i++) {
+        sortItem item;
+        item.key = packetKey(this->packets[i], resContainer);
+        item.index = i;
+        this->items.Add(item);
+        this->tmpItems.Add(item);
+    }
+    radixSort(this->items.begin(), this->tmpItems.begin(), num);
+
+    // record the sorted draws without redundant applies
+    int32 numSortedChanges = 0;
+    tracker.reset();
+    this->cmdBuffer.Reset();
+    for (const sortItem& item : this->items) {
+        const packet& p = this->packets[item.index];
+        numSortedChanges += tracker.apply(p, &applyDrawState, applyUniformBlocks);
+        this->record(p, applyUniformBlocks, applyDrawState);
+    }
+    this->numAvoided = numRecordedChanges - numSortedChanges;
+}
+
+//------------------------------------------------------------------------------
+void
+gfxDrawSorter::clear() {
+    this->packets.Clear();
+    this->items.Clear();
+    this->tmpItems.Clear();
+    this->cmdBuffer.Reset();
+    this->numAvoided = 0;
+}
+
+} // namespace _priv
+} // namespace Oryol
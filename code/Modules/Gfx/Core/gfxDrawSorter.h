@@ -0,0 +1,121 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::gfxDrawSorter
+    @ingroup _priv
+    @brief private: sort the draws of sorted DrawLists by state
+
+    Splits the command streams of sorted draw lists into one packet
+    per draw (the draw state and uniform blocks which are current
+    for the draw, and the draw command itself), computes a 64-bit
+    sort key for each packet and radix-sorts the packets. The sorted
+    packets are recorded into a new command buffer, leaving out
+    draw state and uniform block applies which wouldn't change
+    state, the command buffer is then executed by gfxCmdReplay.
+
+    The sort key is (from most to least significant 16 bits):
+    program slot, draw state slot, slot of the first texture in
+    the uniform blocks, and the draw depth (front to back). The
+    render target and pass are constant for a sort (sorting only
+    happens within lists of the same order in one flush), so they
+    are not part of the key.
+
+    @see DrawList
+*/
+#include "Core/Types.h"
+#include "Core/Containers/Array.h"
+#include "Resource/Id.h"
+#include "Gfx/Core/GfxCommandBuffer.h"
+#include "Gfx/Setup/ProgramBundleSetup.h"
+
+namespace Oryol {
+
+class DrawList;
+
+namespace _priv {
+
+class gfxResourceContainer;
+
+class gfxDrawSorter {
+public:
+    /// a sort key and the index of its draw
+    struct sortItem {
+        uint64 key;
+        int32 index;
+    };
+
+    /// add the draws of a sorted draw list
+    void add(const DrawList* drawList);
+    /// return true if no draws have been added
+    bool empty() const;
+    /// sort the added draws and record them into the sorted command buffer
+    void sort(gfxResourceContainer* resContainer);
+    /// get the sorted command buffer
+    const GfxCommandBuffer& commandBuffer() const;
+    /// number of sorted draws
+    int32 numDraws() const;
+    /// number of state changes in recording order minus state changes in sorted order
+    int32 numStateChangesAvoided() const;
+    /// remove all added draws
+    void clear();
+
+    /// build a sort key
+    static uint64 sortKey(uint16 progSlot, uint16 drawStateSlot, uint16 textureSlot, float32 depth);
+    /// stable radix sort of sort items by key, tmp must hold num items
+    static void radixSort(sortItem* items, sortItem* tmp, int32 num);
+
+private:
+    /// a draw with the state it was recorded with
+    struct packet {
+        Id drawState;
+        const uint8* uniformBlocks[ProgramBundleSetup::MaxNumUniformBlocks];    // ApplyUniformBlock commands
+        const uint8* draw;      // draw command
+        float32 depth;
+    };
+    /// state tracking for counting and dropping redundant applies
+    struct stateTracker {
+        Id drawState;
+        const uint8* uniformBlocks[ProgramBundleSetup::MaxNumUniformBlocks];
+        /// reset tracked state
+        void reset();
+        /// number of applies needed to draw a packet, and update tracked state
+        int32 apply(const packet& p, bool* outApplyDrawState, bool* outApplyUniformBlocks);
+    };
+    /// compute the sort key of a packet
+    static uint64 packetKey(const packet& p, gfxResourceContainer* resContainer);
+    /// record a packet into the sorted command buffer
+    void record(const packet& p, const bool* applyUniformBlocks, bool applyDrawState);
+
+    Array<packet> packets;
+    Array<sortItem> items;
+    Array<sortItem> tmpItems;
+    GfxCommandBuffer cmdBuffer;
+    int32 numAvoided = 0;
+};
+
+//------------------------------------------------------------------------------
+inline bool
+gfxDrawSorter::empty() const {
+    return this->packets.Empty();
+}
+
+//------------------------------------------------------------------------------
+inline const GfxCommandBuffer&
+gfxDrawSorter::commandBuffer() const {
+    return this->cmdBuffer;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+gfxDrawSorter::numDraws() const {
+    return this->packets.Size();
+}
+
+//------------------------------------------------------------------------------
+inline int32
+gfxDrawSorter::numStateChangesAvoided() const {
+    return this->numAvoided;
+}
+
+} // namespace _priv
+} // namespace Oryol
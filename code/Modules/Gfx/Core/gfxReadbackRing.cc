@@ -0,0 +1,140 @@
+//------------------------------------------------------------------------------
+//  gfxReadbackRing.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "gfxReadbackRing.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+gfxReadbackRing::gfxReadbackRing() :
+valid(false),
+head(0),
+tail(0),
+pending(0),
+nextTicket(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+gfxReadbackRing::~gfxReadbackRing() {
+    o_assert_dbg(!this->valid);
+}
+
+//------------------------------------------------------------------------------
+void
+gfxReadbackRing::setup(int32 numSlots_) {
+    o_assert_dbg(!this->valid);
+    o_assert(numSlots_ > 0);
+    this->slots.Reserve(numSlots_);
+    for (int32 i = 0; i < numSlots_; i++) {
+        this->slots.Add(slot());
+    }
+    this->head = 0;
+    this->tail = 0;
+    this->pending = 0;
+    this->valid = true;
+}
+
+//------------------------------------------------------------------------------
+void
+gfxReadbackRing::discard() {
+    o_assert_dbg(this->valid);
+    for (auto& s : this->slots) {
+        if (s.memory) {
+            Memory::Free(s.memory);
+        }
+    }
+    this->slots.Clear();
+    this->valid = false;
+}
+
+//------------------------------------------------------------------------------
+int32
+gfxReadbackRing::alloc(int32 width, int32 height, PixelFormat::Code colorFormat, ReadPixelsCallback callback) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg((width > 0) && (height > 0));
+
+    slot& s = this->slots[this->head];
+    if (InvalidIndex != s.attrs.Ticket) {
+        return InvalidIndex;
+    }
+    const int32 slotIndex = this->head;
+    if (++this->head == this->slots.Size()) {
+        this->head = 0;
+    }
+    if (0 == this->pending++) {
+        this->tail = slotIndex;
+    }
+    s.attrs.Ticket = this->nextTicket;
+    s.attrs.Width = width;
+    s.attrs.Height = height;
+    s.attrs.ColorFormat = colorFormat;
+    s.callback = callback;
+    this->nextTicket = (this->nextTicket + 1) & 0x7FFFFFFF;
+    return slotIndex;
+}
+
+//------------------------------------------------------------------------------
+void
+gfxReadbackRing::free(int32 slotIndex) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(InvalidIndex != this->slots[slotIndex].attrs.Ticket);
+
+    slot& s = this->slots[slotIndex];
+    s.attrs.Ticket = InvalidIndex;
+    s.callback = nullptr;
+    this->pending--;
+
+    // skip over freed slots, requests may be polled out of order
+    while ((this->pending > 0) && (InvalidIndex == this->slots[this->tail].attrs.Ticket)) {
+        if (++this->tail == this->slots.Size()) {
+            this->tail = 0;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+int32
+gfxReadbackRing::find(int32 ticket) const {
+    o_assert_dbg(this->valid);
+    if (InvalidIndex != ticket) {
+        for (int32 i = 0; i < this->slots.Size(); i++) {
+            if (ticket == this->slots[i].attrs.Ticket) {
+                return i;
+            }
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+int32
+gfxReadbackRing::oldest() const {
+    o_assert_dbg(this->valid);
+    return (this->pending > 0) ? this->tail : InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+uint8*
+gfxReadbackRing::clientMemory(int32 slotIndex) {
+    o_assert_dbg(this->valid);
+    slot& s = this->slots[slotIndex];
+    o_assert_dbg(InvalidIndex != s.attrs.Ticket);
+
+    const int32 numBytes = s.attrs.ByteSize();
+    if (numBytes > s.memorySize) {
+        if (s.memory) {
+            Memory::Free(s.memory);
+        }
+        s.memory = (uint8*) Memory::Alloc(numBytes);
+        s.memorySize = numBytes;
+    }
+    return s.memory;
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,106 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::gfxReadbackRing
+    @ingroup _priv
+    @brief private: bookkeeping for asynchronous pixel readbacks
+
+    Manages a fixed number of readback slots, one per pending
+    Gfx::ReadPixelsAsync() request. A slot holds the ticket, the
+    pixel rectangle attributes and the optional callback of the
+    request. Slots are handed out in ring order, so that the oldest
+    pending request is always found first, if the next slot is still
+    pending all readback buffers are busy and the request fails.
+
+    The renderer owns the GPU side (one pixel pack buffer and fence
+    per slot on GL), backends which can't read back asynchronously
+    use the per-slot client memory.
+*/
+#include "Core/Types.h"
+#include "Core/Containers/Array.h"
+#include "Gfx/Attrs/ReadPixelsAttrs.h"
+
+namespace Oryol {
+namespace _priv {
+
+class gfxReadbackRing {
+public:
+    /// constructor
+    gfxReadbackRing();
+    /// destructor
+    ~gfxReadbackRing();
+
+    /// setup with number of slots
+    void setup(int32 numSlots);
+    /// discard the ring, drops pending requests
+    void discard();
+    /// return true if setup
+    bool isValid() const;
+
+    /// allocate a slot for a new request, returns InvalidIndex if all slots are busy
+    int32 alloc(int32 width, int32 height, PixelFormat::Code colorFormat, ReadPixelsCallback callback);
+    /// free a slot after its pixels have been delivered
+    void free(int32 slotIndex);
+    /// find the slot of a pending request by ticket, InvalidIndex if not pending
+    int32 find(int32 ticket) const;
+    /// get the oldest pending slot, InvalidIndex if none
+    int32 oldest() const;
+
+    /// get number of slots
+    int32 numSlots() const;
+    /// get number of pending requests
+    int32 numPending() const;
+    /// get the attributes of a pending slot
+    const ReadPixelsAttrs& attrs(int32 slotIndex) const;
+    /// get the callback of a pending slot (may be empty)
+    const ReadPixelsCallback& callback(int32 slotIndex) const;
+    /// get client memory of a pending slot, big enough for its pixels
+    uint8* clientMemory(int32 slotIndex);
+
+private:
+    struct slot {
+        ReadPixelsAttrs attrs;
+        ReadPixelsCallback callback;
+        uint8* memory = nullptr;
+        int32 memorySize = 0;
+    };
+    bool valid;
+    Array<slot> slots;
+    int32 head;         // next slot to allocate
+    int32 tail;         // oldest pending slot
+    int32 pending;
+    int32 nextTicket;
+};
+
+//------------------------------------------------------------------------------
+inline bool
+gfxReadbackRing::isValid() const {
+    return this->valid;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+gfxReadbackRing::numSlots() const {
+    return this->slots.Size();
+}
+
+//------------------------------------------------------------------------------
+inline int32
+gfxReadbackRing::numPending() const {
+    return this->pending;
+}
+
+//------------------------------------------------------------------------------
+inline const ReadPixelsAttrs&
+gfxReadbackRing::attrs(int32 slotIndex) const {
+    return this->slots[slotIndex].attrs;
+}
+
+//------------------------------------------------------------------------------
+inline const ReadPixelsCallback&
+gfxReadbackRing::callback(int32 slotIndex) const {
+    return this->slots[slotIndex].callback;
+}
+
+} // namespace _priv
+} // namespace Oryol
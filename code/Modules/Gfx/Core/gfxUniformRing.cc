@@ -0,0 +1,128 @@
+//------------------------------------------------------------------------------
+//  gfxUniformRing.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "gfxUniformRing.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+gfxUniformRing::gfxUniformRing() :
+valid(false),
+bufSize(0),
+align(1),
+head(0),
+numFrameBytes(0),
+numFrameWraps(0) {
+    for (auto& b : this->bindings) {
+        b.offset = 0;
+        b.numBytes = 0;
+        b.dataSize = 0;
+        b.capacity = 0;
+        b.data = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+gfxUniformRing::~gfxUniformRing() {
+    o_assert_dbg(!this->valid);
+}
+
+//------------------------------------------------------------------------------
+void
+gfxUniformRing::setup(int32 size_, int32 alignment_) {
+    o_assert_dbg(!this->valid);
+    o_assert(size_ > 0);
+    o_assert((alignment_ > 0) && (0 == (alignment_ & (alignment_ - 1))));
+    this->bufSize = size_;
+    this->align = alignment_;
+    this->head = 0;
+    this->numFrameBytes = 0;
+    this->numFrameWraps = 0;
+    this->valid = true;
+}
+
+//------------------------------------------------------------------------------
+void
+gfxUniformRing::discard() {
+    o_assert_dbg(this->valid);
+    for (auto& b : this->bindings) {
+        if (b.data) {
+            Memory::Free(b.data);
+        }
+        b.offset = 0;
+        b.numBytes = 0;
+        b.dataSize = 0;
+        b.capacity = 0;
+        b.data = nullptr;
+    }
+    this->valid = false;
+}
+
+//------------------------------------------------------------------------------
+int32
+gfxUniformRing::alloc(int32 numBytes, bool& outWrapped) {
+    o_assert_dbg(this->valid);
+    o_assert2(numBytes <= this->bufSize, "uniform block doesn't fit into uniform buffer (GfxSetup::UniformBufferSize)!\n");
+
+    int32 offset = (this->head + this->align - 1) & ~(this->align - 1);
+    outWrapped = (offset + numBytes) > this->bufSize;
+    if (outWrapped) {
+        this->numFrameBytes += this->bufSize - this->head;
+        this->numFrameWraps++;
+        this->head = 0;
+        offset = 0;
+    }
+    this->numFrameBytes += (offset + numBytes) - this->head;
+    this->head = offset + numBytes;
+    return offset;
+}
+
+//------------------------------------------------------------------------------
+int32
+gfxUniformRing::allocBinding(int32 bindIndex, int32 numBytes, const void* data, int32 dataSize, bool& outWrapped) {
+    o_assert_range_dbg(bindIndex, MaxNumBindings);
+    o_assert_dbg(numBytes > 0);
+    o_assert_dbg(data && (dataSize > 0) && (dataSize <= numBytes));
+
+    binding& b = this->bindings[bindIndex];
+    if (b.capacity < dataSize) {
+        if (b.data) {
+            Memory::Free(b.data);
+        }
+        b.data = (uint8*) Memory::Alloc(dataSize);
+        b.capacity = dataSize;
+    }
+    Memory::Copy(data, b.data, dataSize);
+    b.dataSize = dataSize;
+    b.numBytes = numBytes;
+    b.offset = this->alloc(numBytes, outWrapped);
+    if (outWrapped) {
+        // the orphaned storage is lost for all other bound ranges too,
+        // move them behind the new range, they all fit without wrapping
+        // again since a program has at most MaxNumBindings uniform blocks
+        for (int32 i = 0; i < MaxNumBindings; i++) {
+            binding& other = this->bindings[i];
+            if ((i != bindIndex) && (other.numBytes > 0)) {
+                bool otherWrapped = false;
+                other.offset = this->alloc(other.numBytes, otherWrapped);
+                o_assert2(!otherWrapped, "bound uniform blocks don't fit into uniform buffer (GfxSetup::UniformBufferSize)!\n");
+            }
+        }
+    }
+    return b.offset;
+}
+
+//------------------------------------------------------------------------------
+void
+gfxUniformRing::commitFrame() {
+    o_assert_dbg(this->valid);
+    this->numFrameBytes = 0;
+    this->numFrameWraps = 0;
+}
+
+} // namespace _priv
+} // namespace Oryol
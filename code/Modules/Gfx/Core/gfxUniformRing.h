@@ -0,0 +1,132 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::gfxUniformRing
+    @ingroup _priv
+    @brief private: ring allocator for uniform buffer ranges
+
+    Hands out aligned byte ranges from a fixed-size uniform buffer,
+    one range per applied uniform block. Allocation is linear, when
+    a range doesn't fit into the rest of the buffer, the ring wraps
+    around to the start, the renderer must then orphan the buffer
+    storage so that draws still in flight keep their uniform data.
+
+    Orphaning also throws away the ranges of uniform blocks which
+    are still bound but not applied again (e.g. because identical
+    blocks are skipped), so the ring keeps a CPU shadow copy of the
+    last data bound to each binding point. After a wrap, allocBinding()
+    moves the ranges of all bound binding points into the new storage,
+    and the renderer must upload and bind them again from their
+    shadow copies.
+
+    The allocator doesn't touch any GPU resources, it only does the
+    bookkeeping and counts the consumed bytes and wraps per frame.
+*/
+#include "Core/Types.h"
+#include "Core/Assertion.h"
+#include "Gfx/Setup/ProgramBundleSetup.h"
+
+namespace Oryol {
+namespace _priv {
+
+class gfxUniformRing {
+public:
+    /// number of uniform block binding points
+    static const int32 MaxNumBindings = ProgramBundleSetup::MaxNumUniformBlocks;
+    /// the range and shadow data bound to a binding point
+    struct binding {
+        int32 offset;
+        int32 numBytes;         // 0 if nothing bound
+        int32 dataSize;
+        int32 capacity;
+        uint8* data;
+    };
+
+    /// constructor
+    gfxUniformRing();
+    /// destructor
+    ~gfxUniformRing();
+
+    /// setup with buffer size and offset alignment (must be power of 2)
+    void setup(int32 size, int32 alignment);
+    /// discard the ring
+    void discard();
+    /// return true if setup
+    bool isValid() const;
+
+    /// allocate a range, returns byte offset, outWrapped is true if the ring wrapped around
+    int32 alloc(int32 numBytes, bool& outWrapped);
+    /// allocate a range for a binding point and keep a copy of its data, on wrap also moves all other bound ranges
+    int32 allocBinding(int32 bindIndex, int32 numBytes, const void* data, int32 dataSize, bool& outWrapped);
+    /// return true if a range is bound to a binding point
+    bool isBound(int32 bindIndex) const;
+    /// get the range and shadow data of a binding point
+    const binding& bindingAt(int32 bindIndex) const;
+    /// finish the current frame, resets the per-frame counters
+    void commitFrame();
+
+    /// get the buffer size
+    int32 size() const;
+    /// get the offset alignment
+    int32 alignment() const;
+    /// get bytes consumed in the current frame (including alignment padding)
+    int32 frameBytes() const;
+    /// get number of wrap-arounds in the current frame
+    int32 frameWraps() const;
+
+private:
+    bool valid;
+    int32 bufSize;
+    int32 align;
+    int32 head;
+    int32 numFrameBytes;
+    int32 numFrameWraps;
+    binding bindings[MaxNumBindings];
+};
+
+//------------------------------------------------------------------------------
+inline bool
+gfxUniformRing::isValid() const {
+    return this->valid;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+gfxUniformRing::size() const {
+    return this->bufSize;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+gfxUniformRing::alignment() const {
+    return this->align;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+gfxUniformRing::frameBytes() const {
+    return this->numFrameBytes;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+gfxUniformRing::frameWraps() const {
+    return this->numFrameWraps;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+gfxUniformRing::isBound(int32 bindIndex) const {
+    o_assert_range_dbg(bindIndex, MaxNumBindings);
+    return this->bindings[bindIndex].numBytes > 0;
+}
+
+//------------------------------------------------------------------------------
+inline const gfxUniformRing::binding&
+gfxUniformRing::bindingAt(int32 bindIndex) const {
+    o_assert_range_dbg(bindIndex, MaxNumBindings);
+    return this->bindings[bindIndex];
+}
+
+} // namespace _priv
+} // namespace Oryol
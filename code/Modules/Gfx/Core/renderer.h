@@ -17,6 +17,12 @@ namespace Oryol {
 namespace _priv {
 class renderer : public d3d11Renderer { };
 } }
+#elif ORYOL_NULL_GFX
+#include "Gfx/null/nullRenderer.h"
+namespace Oryol {
+namespace _priv {
+class renderer : public nullRenderer { };
+} }
 #else
 #error "Target platform not yet supported!"
 #endif
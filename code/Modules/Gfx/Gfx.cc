@@ -18,8 +18,9 @@ Gfx::Setup(const class GfxSetup& setup) {
     state = Memory::New<_state>();
     state->gfxSetup = setup;
     state->displayManager.SetupDisplay(setup);
-    state->renderer.setup(&state->displayManager, &state->resourceContainer.meshPool, &state->resourceContainer.texturePool);
+    state->renderer.setup(setup, &state->displayManager, &state->resourceContainer.meshPool, &state->resourceContainer.texturePool);
     state->resourceContainer.setup(setup, &state->renderer, &state->displayManager);
+    state->cmdReplay.setup(&state->renderer, &state->resourceContainer);
     state->runLoopId = Core::PreRunLoop()->Add([] {
         state->displayManager.ProcessSystemEvents();
     });
@@ -31,6 +32,8 @@ Gfx::Discard() {
     o_assert_dbg(IsValid());
     state->resourceContainer.Destroy(ResourceLabel::All);
     Core::PreRunLoop()->Remove(state->runLoopId);
+    state->drawLists.clear();
+    state->cmdReplay.discard();
     state->renderer.discard();
     state->resourceContainer.discard();
     state->displayManager.DiscardDisplay();
@@ -92,6 +95,7 @@ Gfx::RenderTargetAttrs() {
 void
 Gfx::ApplyDefaultRenderTarget() {
     o_assert_dbg(IsValid());
+    state->cmdReplay.externalStateChanged();
     state->renderer.applyRenderTarget(nullptr);
 }
 
@@ -103,6 +107,7 @@ Gfx::ApplyOffscreenRenderTarget(const Id& id) {
 
     texture* renderTarget = state->resourceContainer.lookupTexture(id);
     o_assert_dbg(nullptr != renderTarget);
+    state->cmdReplay.externalStateChanged();
     state->renderer.applyRenderTarget(renderTarget);
 }
 
@@ -111,6 +116,7 @@ void
 Gfx::ApplyDrawState(const Id& id) {
     o_trace_scoped(Gfx_ApplyDrawState);
     o_assert_dbg(IsValid());
+    state->cmdReplay.externalStateChanged();
     state->renderer.applyDrawState(state->resourceContainer.lookupDrawState(id));
 }
 
@@ -195,6 +201,7 @@ Gfx::resource() {
 void
 Gfx::ApplyViewPort(int32 x, int32 y, int32 width, int32 height) {
     o_assert_dbg(IsValid());
+    state->cmdReplay.externalStateChanged();
     state->renderer.applyViewPort(x, y, width, height);
 }
 
@@ -202,6 +209,7 @@ Gfx::ApplyViewPort(int32 x, int32 y, int32 width, int32 height) {
 void
 Gfx::ApplyScissorRect(int32 x, int32 y, int32 width, int32 height) {
     o_assert_dbg(IsValid());
+    state->cmdReplay.externalStateChanged();
     state->renderer.applyScissorRect(x, y, width, height);
 }
 
@@ -210,6 +218,8 @@ void
 Gfx::CommitFrame() {
     o_trace_scoped(Gfx_CommitFrame);
     o_assert_dbg(IsValid());
+    state->drawLists.flush(&state->cmdReplay);
+    state->cmdReplay.commitFrame();
     state->renderer.commitFrame();
     state->displayManager.Present();
 }
@@ -220,6 +230,7 @@ Gfx::ResetStateCache() {
     o_trace_scoped(Gfx_ResetStateCache);
     o_assert_dbg(IsValid());
     state->renderer.resetStateCache();
+    state->cmdReplay.invalidate();
 }
 
 //------------------------------------------------------------------------------
@@ -231,6 +242,51 @@ Gfx::UpdateVertices(const Id& id, const void* data, int32 numBytes) {
     state->renderer.updateVertices(msh, data, numBytes);
 }
 
+//------------------------------------------------------------------------------
+void
+Gfx::UpdateVertices(const Id& id, int32 offset, const void* data, int32 numBytes) {
+    o_trace_scoped(Gfx_UpdateVertices);
+    o_assert_dbg(IsValid());
+    mesh* msh = state->resourceContainer.lookupMesh(id);
+    state->renderer.updateVertices(msh, offset, data, numBytes);
+}
+
+//------------------------------------------------------------------------------
+void
+Gfx::UpdateIndices(const Id& id, const void* data, int32 numBytes) {
+    o_trace_scoped(Gfx_UpdateIndices);
+    o_assert_dbg(IsValid());
+    mesh* msh = state->resourceContainer.lookupMesh(id);
+    state->renderer.updateIndices(msh, 0, data, numBytes);
+}
+
+//------------------------------------------------------------------------------
+void
+Gfx::UpdateIndices(const Id& id, int32 offset, const void* data, int32 numBytes) {
+    o_trace_scoped(Gfx_UpdateIndices);
+    o_assert_dbg(IsValid());
+    mesh* msh = state->resourceContainer.lookupMesh(id);
+    state->renderer.updateIndices(msh, offset, data, numBytes);
+}
+
+//------------------------------------------------------------------------------
+void*
+Gfx::MapVertices(const Id& id, int32 maxNumBytes) {
+    o_trace_scoped(Gfx_MapVertices);
+    o_assert_dbg(IsValid());
+    mesh* msh = state->resourceContainer.lookupMesh(id);
+    return state->renderer.mapVertices(msh, maxNumBytes);
+}
+
+//------------------------------------------------------------------------------
+void
+Gfx::UnmapVertices(const Id& id, int32 numBytes) {
+    o_trace_scoped(Gfx_UnmapVertices);
+    o_assert_dbg(IsValid());
+    mesh* msh = state->resourceContainer.lookupMesh(id);
+    state->renderer.unmapVertices(msh, numBytes);
+}
+
 //------------------------------------------------------------------------------
 void
 Gfx::ReadPixels(void* buf, int32 bufNumBytes) {
@@ -239,6 +295,22 @@ Gfx::ReadPixels(void* buf, int32 bufNumBytes) {
     state->renderer.readPixels(&state->displayManager, buf, bufNumBytes);
 }
 
+//------------------------------------------------------------------------------
+int32
+Gfx::ReadPixelsAsync(ReadPixelsCallback callback) {
+    o_trace_scoped(Gfx_ReadPixelsAsync);
+    o_assert_dbg(IsValid());
+    return state->renderer.readPixelsAsync(&state->displayManager, callback);
+}
+
+//------------------------------------------------------------------------------
+bool
+Gfx::PollReadPixels(int32 ticket, void* buf, int32 bufNumBytes) {
+    o_trace_scoped(Gfx_PollReadPixels);
+    o_assert_dbg(IsValid());
+    return state->renderer.pollReadPixels(ticket, buf, bufNumBytes);
+}
+
 //------------------------------------------------------------------------------
 void
 Gfx::Clear(ClearTarget::Mask clearMask, const glm::vec4& color, float32 depth, uint8 stencil) {
@@ -278,4 +350,34 @@ Gfx::DrawInstanced(const PrimitiveGroup& primGroup, int32 numInstances) {
     state->renderer.drawInstanced(primGroup, numInstances);
 }
 
+//------------------------------------------------------------------------------
+void
+Gfx::Submit(const GfxCommandBuffer& cmdBuffer) {
+    o_trace_scoped(Gfx_Submit);
+    o_assert_dbg(IsValid());
+    state->cmdReplay.execute(cmdBuffer);
+}
+
+//------------------------------------------------------------------------------
+const GfxFrameStats&
+Gfx::FrameStats() {
+    o_assert_dbg(IsValid());
+    return state->cmdReplay.frameStats();
+}
+
+//------------------------------------------------------------------------------
+void
+Gfx::Enqueue(const DrawList& drawList) {
+    o_assert_dbg(IsValid());
+    state->drawLists.enqueue(&drawList);
+}
+
+//------------------------------------------------------------------------------
+void
+Gfx::FlushDrawLists() {
+    o_trace_scoped(Gfx_FlushDrawLists);
+    o_assert_dbg(IsValid());
+    state->drawLists.flush(&state->cmdReplay);
+}
+
 } // namespace Oryol
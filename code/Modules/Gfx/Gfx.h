@@ -16,7 +16,13 @@
 #include "Gfx/Core/Enums.h"
 #include "Gfx/Core/PrimitiveGroup.h"
 #include "Gfx/Core/renderer.h"
+#include "Gfx/Core/GfxCommandBuffer.h"
+#include "Gfx/Core/GfxFrameStats.h"
+#include "Gfx/Core/gfxCmdReplay.h"
+#include "Gfx/Core/DrawList.h"
+#include "Gfx/Core/drawListQueue.h"
 #include "Gfx/Setup/MeshSetup.h"
+#include "Gfx/Attrs/ReadPixelsAttrs.h"
 #include "glm/vec4.hpp"
 
 namespace Oryol {
@@ -87,12 +93,24 @@ public:
     /// apply a uniform block
     template<class T> static void ApplyUniformBlock(const T& value);
 
-    /// update dynamic vertex data (only complete replace possible at the moment)
+    /// replace dynamic vertex data (stream meshes switch to their next vertex buffer)
     static void UpdateVertices(const Id& id, const void* data, int32 numBytes);
-    /// update dynamic index data (only complete replace possible at the moment)
+    /// update a byte range of dynamic vertex data in place
+    static void UpdateVertices(const Id& id, int32 offset, const void* data, int32 numBytes);
+    /// replace dynamic index data
     static void UpdateIndices(const Id& id, const void* data, int32 numBytes);
+    /// update a byte range of dynamic index data in place
+    static void UpdateIndices(const Id& id, int32 offset, const void* data, int32 numBytes);
+    /// map dynamic vertex data for writing up to maxNumBytes, replaces the vertex data like UpdateVertices()
+    static void* MapVertices(const Id& id, int32 maxNumBytes);
+    /// unmap vertex data mapped with MapVertices(), numBytes is the number of bytes written
+    static void UnmapVertices(const Id& id, int32 numBytes);
     /// read current framebuffer pixels into client memory, this means a PIPELINE STALL!!
     static void ReadPixels(void* ptr, int32 numBytes);
+    /// queue a non-stalling read of the current framebuffer pixels, returns ticket, or InvalidIndex if all readback buffers are busy
+    static int32 ReadPixelsAsync(ReadPixelsCallback callback=nullptr);
+    /// poll an async read queued without callback, copies the pixels and returns true once they have arrived
+    static bool PollReadPixels(int32 ticket, void* ptr, int32 numBytes);
     
     /// clear the currently assigned render target (default depth value is 1.0f, default stencil value is 0)
     static void Clear(ClearTarget::Mask clearMask, const glm::vec4& color, float32 depth=1.0f, uint8 stencil=0);
@@ -105,6 +123,15 @@ public:
     /// submit a draw call for instanced rendering with direct primitive group
     static void DrawInstanced(const PrimitiveGroup& primGroup, int32 numInstances);
 
+    /// execute the commands recorded in a command buffer
+    static void Submit(const GfxCommandBuffer& cmdBuffer);
+    /// get command buffer statistics of the last committed frame
+    static const GfxFrameStats& FrameStats();
+    /// enqueue a recorded draw list for execution in FlushDrawLists() (can be called from any thread)
+    static void Enqueue(const DrawList& drawList);
+    /// merge and execute enqueued draw lists (called from CommitFrame() for remaining lists)
+    static void FlushDrawLists();
+
     /// commit (and display) the current frame
     static void CommitFrame();
     /// reset internal state (must be called when directly rendering through GL; FIXME: better name?)
@@ -120,6 +147,8 @@ private:
         _priv::displayMgr displayManager;
         class _priv::renderer renderer;
         _priv::gfxResourceContainer resourceContainer;
+        _priv::gfxCmdReplay cmdReplay;
+        _priv::drawListQueue drawLists;
     };
     static _state* state;
 };
@@ -128,6 +157,7 @@ private:
 template<class T> inline void
 Gfx::ApplyUniformBlock(const T& value) {
     o_assert_dbg(IsValid());
+    state->cmdReplay.externalStateChanged();
     state->renderer.applyUniformBlock(T::_uniformBlockIndex, T::_layoutHash, (const uint8*) &value, sizeof(value));
 }
 
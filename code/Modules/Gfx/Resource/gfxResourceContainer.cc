@@ -14,7 +14,8 @@ namespace _priv {
 gfxResourceContainer::gfxResourceContainer() :
 renderer(nullptr),
 displayMgr(nullptr),
-runLoopId(RunLoop::InvalidId) {
+runLoopId(RunLoop::InvalidId),
+loaderTag(0) {
     // empty
 }
 
@@ -39,6 +40,7 @@ gfxResourceContainer::setup(const GfxSetup& setup, class renderer* rendr, class
     this->drawStateFactory.Setup(this->renderer, &this->meshPool, &this->programBundlePool);
     this->drawStatePool.Setup(GfxResourceType::DrawState, setup.PoolSize(GfxResourceType::DrawState));
     
+    this->loaderCompletions = CompletionList::Create();
     this->runLoopId = Core::PostRunLoop()->Add([this]() {
         this->update();
     });
@@ -56,6 +58,12 @@ gfxResourceContainer::discard() {
         loader->Cancel();
     }
     this->pendingLoaders.Clear();
+    for (const auto& kvp : this->notifyLoaders) {
+        kvp.Value()->Cancel();
+    }
+    this->notifyLoaders.Clear();
+    this->loaderCompletions = nullptr;
+    this->completedLoaders.Clear();
     
     resourceContainerBase::discard();
 
@@ -410,7 +418,15 @@ gfxResourceContainer::Load(const Ptr<ResourceLoader>& loader) {
         return resId;
     }
     else {
-        this->pendingLoaders.Add(loader);
+        // loaders which support it are only continued once their
+        // IO request has completed, all others are polled each frame
+        const uint64 tag = ++this->loaderTag;
+        if (loader->SetCompletionList(this->loaderCompletions, tag)) {
+            this->notifyLoaders.Add(tag, loader);
+        }
+        else {
+            this->pendingLoaders.Add(loader);
+        }
         resId = loader->Start();
         return resId;
     }
@@ -508,6 +524,7 @@ gfxResourceContainer::update() {
     this->drawStatePool.Update();
 
     // trigger loaders, and remove from pending array if finished
+    this->continueNotifiedLoaders();
     for (int32 i = this->pendingLoaders.Size() - 1; i >= 0; i--) {
         const auto& loader = this->pendingLoaders[i];
         ResourceState::Code state = loader->Continue();
@@ -520,6 +537,27 @@ gfxResourceContainer::update() {
     this->handlePendingDrawStates();
 }
 
+//------------------------------------------------------------------------------
+void
+gfxResourceContainer::continueNotifiedLoaders() {
+    if (0 == this->loaderCompletions->TakeAll(this->completedLoaders)) {
+        return;
+    }
+    for (uint64 tag : this->completedLoaders) {
+        Ptr<ResourceLoader>* loaderPtr = this->notifyLoaders.Find(tag);
+        if (nullptr == loaderPtr) {
+            continue;
+        }
+        Ptr<ResourceLoader> loader = *loaderPtr;
+        this->notifyLoaders.Erase(tag);
+        if (ResourceState::Pending == loader->Continue()) {
+            // the loader has more to do, fall back to polling
+            this->pendingLoaders.Add(loader);
+        }
+    }
+    this->completedLoaders.Clear();
+}
+
 //------------------------------------------------------------------------------
 ResourceInfo
 gfxResourceContainer::QueryResourceInfo(const Id& resId) const {
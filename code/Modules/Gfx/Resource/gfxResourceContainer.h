@@ -10,6 +10,8 @@
 #include "Core/Threading/RWLock.h"
 #include "Core/Containers/Array.h"
 #include "Core/Containers/KeyValuePair.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/Threading/CompletionList.h"
 #include "IO/IOProtocol.h"
 #include "Resource/Core/resourceContainerBase.h"
 #include "Resource/Core/SetupAndStream.h"
@@ -73,6 +75,8 @@ public:
 
     /// per-frame update (update resource pools and pending loaders)
     void update();
+    /// continue loaders which have been notified through the completion list
+    void continueNotifiedLoaders();
 
     /// query overall state of drawstate dependencies (state of input meshes)
     ResourceState::Code queryDrawStateDependenciesState(const drawState* ds);
@@ -92,7 +96,11 @@ public:
     class texturePool texturePool;
     class drawStatePool drawStatePool;
     RunLoop::Id runLoopId;
-    Array<Ptr<ResourceLoader>> pendingLoaders;
+    Array<Ptr<ResourceLoader>> pendingLoaders;          // polled each frame
+    HashMap<uint64, Ptr<ResourceLoader>> notifyLoaders; // continued when notified
+    Ptr<CompletionList> loaderCompletions;
+    Array<uint64> completedLoaders;
+    uint64 loaderTag;
     Array<Id> pendingDrawStates;
 };
 
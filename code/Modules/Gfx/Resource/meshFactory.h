@@ -18,6 +18,12 @@ namespace Oryol {
 namespace _priv {
 class meshFactory : public d3d11MeshFactory { };
 } }
+#elif ORYOL_NULL_GFX
+#include "Gfx/null/nullMeshFactory.h"
+namespace Oryol {
+namespace _priv {
+class meshFactory : public nullMeshFactory { };
+} }
 #else
 #error "Platform not yet supported!"
 #endif
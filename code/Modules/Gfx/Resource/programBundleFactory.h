@@ -17,6 +17,12 @@ namespace Oryol {
 namespace _priv {
 class programBundleFactory : public d3d11ProgramBundleFactory { };
 } }
+#elif ORYOL_NULL_GFX
+#include "Gfx/null/nullProgramBundleFactory.h"
+namespace Oryol {
+namespace _priv {
+class programBundleFactory : public nullProgramBundleFactory { };
+} }
 #else
 #error "Platform not yet supported!"
 #endif
@@ -17,6 +17,12 @@ namespace Oryol {
 namespace _priv {
 class shaderFactory : public d3d11ShaderFactory { };
 } }
+#elif ORYOL_NULL_GFX
+#include "Gfx/null/nullShaderFactory.h"
+namespace Oryol {
+namespace _priv {
+class shaderFactory : public nullShaderFactory { };
+} }
 #else
 #error "Platform not yet supported!"
 #endif
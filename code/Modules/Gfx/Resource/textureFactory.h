@@ -18,6 +18,12 @@ namespace Oryol {
 namespace _priv {
 class textureFactory : public d3d11TextureFactory { };
 }}
+#elif ORYOL_NULL_GFX
+#include "Gfx/null/nullTextureFactory.h"
+namespace Oryol {
+namespace _priv {
+class textureFactory : public nullTextureFactory { };
+} }
 #else
 #error "Platform not supported yet!"
 #endif
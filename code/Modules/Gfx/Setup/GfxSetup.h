@@ -59,6 +59,10 @@ public:
     int32 ResourceLabelStackCapacity = 256;
     /// initial resource registry capacity
     int32 ResourceRegistryCapacity = 256;
+    /// size of the uniform buffer ring for uniform blocks (only GL core profile)
+    int32 UniformBufferSize = 256 * 1024;
+    /// number of readback buffers for Gfx::ReadPixelsAsync() (max number of pending reads)
+    int32 NumReadbackBuffers = 3;
 
     /// get DisplayAttrs object initialized to setup values
     DisplayAttrs GetDisplayAttrs() const;
@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+//  DrawListTest.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Config.h"
+#include "Gfx/Core/DrawList.h"
+#if ORYOL_NULL_GFX
+#include "Gfx/Gfx.h"
+#endif
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+using namespace Oryol;
+
+namespace {
+struct params {
+    static const int32 _uniformBlockIndex = 0;
+    static const int64 _layoutHash = 1234;
+    float32 color[4];
+};
+
+void record(DrawList* drawList, const Id& drawState, int32 numDraws) {
+    drawList->ApplyDrawState(drawState);
+    params p = { { 0.0f, 0.0f, 0.0f, 1.0f } };
+    for (int32 i = 0; i < numDraws; i++) {
+        p.color[0] = float32(i);
+        drawList->ApplyUniformBlock(p);
+        drawList->Draw(0);
+    }
+}
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(DrawListRecordTest) {
+    DrawList drawList;
+    CHECK(drawList.Order() == 0);
+    CHECK(drawList.NumDraws() == 0);
+    CHECK(drawList.CommandBuffer().Empty());
+
+    drawList.Reset(5);
+    CHECK(drawList.Order() == 5);
+    record(&drawList, Id(1, 2, 3), 10);
+    CHECK(drawList.NumDraws() == 10);
+    CHECK(drawList.CommandBuffer().NumCommands() == 21);
+
+    drawList.Reset(-1);
+    CHECK(drawList.Order() == -1);
+    CHECK(drawList.NumDraws() == 0);
+    CHECK(drawList.CommandBuffer().Empty());
+
+    // record independent draw lists on several threads
+    const int32 numLists = 4;
+    DrawList lists[numLists];
+    #if ORYOL_HAS_THREADS
+    std::thread threads[numLists];
+    for (int32 i = 0; i < numLists; i++) {
+        threads[i] = std::thread(record, &lists[i], Id(1, i, 3), 1000 * (i + 1));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    #else
+    for (int32 i = 0; i < numLists; i++) {
+        record(&lists[i], Id(1, i, 3), 1000 * (i + 1));
+    }
+    #endif
+    for (int32 i = 0; i < numLists; i++) {
+        CHECK(lists[i].NumDraws() == 1000 * (i + 1));
+        CHECK(lists[i].CommandBuffer().NumCommands() == 1 + 2 * 1000 * (i + 1));
+    }
+}
+
+#if ORYOL_NULL_GFX
+//------------------------------------------------------------------------------
+TEST(DrawListSubmitTest) {
+    Gfx::Setup(GfxSetup::Window(400, 300, "Oryol Test"));
+
+    auto meshSetup = MeshSetup::Empty(4, Usage::Stream);
+    meshSetup.Layout.Add(VertexAttr::Position, VertexFormat::Float4);
+    meshSetup.AddPrimitiveGroup(PrimitiveGroup(PrimitiveType::TriangleStrip, 0, 4));
+    Id mesh = Gfx::CreateResource(meshSetup);
+    UniformLayout layout;
+    layout.TypeHash = params::_layoutHash;
+    layout.Add("color", UniformType::Vec4, 1);
+    ProgramBundleSetup progSetup("prog");
+    progSetup.AddUniformBlock("params", layout, ShaderType::VertexShader, 0);
+    Id prog = Gfx::CreateResource(progSetup);
+    Id ds0 = Gfx::CreateResource(DrawStateSetup::FromMeshAndProg(mesh, prog));
+    Id ds1 = Gfx::CreateResource(DrawStateSetup::FromMeshAndProg(mesh, prog));
+
+    // lists are recorded and enqueued from worker threads
+    const int32 numLists = 3;
+    DrawList lists[numLists];
+    const Id drawStates[numLists] = { ds0, ds1, ds0 };
+    const int32 orders[numLists] = { 0, 2, 1 };
+    auto recordAndEnqueue = [&](int32 i) {
+        lists[i].Reset(orders[i]);
+        record(&lists[i], drawStates[i], 100);
+        Gfx::Enqueue(lists[i]);
+    };
+    #if ORYOL_HAS_THREADS
+    std::thread threads[numLists];
+    for (int32 i = 0; i < numLists; i++) {
+        threads[i] = std::thread(recordAndEnqueue, i);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    #else
+    for (int32 i = 0; i < numLists; i++) {
+        recordAndEnqueue(i);
+    }
+    #endif
+
+    // CommitFrame() merges the lists by order: ds0, ds0, ds1, so the 2nd
+    // draw state apply is redundant no matter in which order the lists
+    // were enqueued (uniform blocks always change)
+    Gfx::ApplyDefaultRenderTarget();
+    Gfx::CommitFrame();
+    const GfxFrameStats& stats = Gfx::FrameStats();
+    CHECK(stats.NumCommandBuffers == 3);
+    CHECK(stats.NumDraws == 300);
+    CHECK(stats.NumRedundantBinds == 1);
+    CHECK(stats.NumStateChanges == 2 + 300);
+
+    // explicit flush, nothing left for CommitFrame()
+    Gfx::Enqueue(lists[0]);
+    Gfx::ApplyDefaultRenderTarget();
+    Gfx::FlushDrawLists();
+    Gfx::CommitFrame();
+    CHECK(stats.NumCommandBuffers == 1);
+    CHECK(stats.NumDraws == 100);
+
+    Gfx::Discard();
+}
+#endif
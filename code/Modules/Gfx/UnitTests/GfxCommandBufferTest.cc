@@ -0,0 +1,161 @@
+//------------------------------------------------------------------------------
+//  GfxCommandBufferTest.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Gfx/Core/GfxCommandBuffer.h"
+#if ORYOL_NULL_GFX
+#include "Gfx/Gfx.h"
+#endif
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(GfxCommandBufferRecordTest) {
+    typedef GfxCommandBuffer::Cmd Cmd;
+
+    GfxCommandBuffer cmdBuf;
+    CHECK(cmdBuf.Empty());
+    CHECK(cmdBuf.NumCommands() == 0);
+    CHECK(cmdBuf.Size() == 0);
+    CHECK(cmdBuf.Capacity() == 0);
+    CHECK(cmdBuf.Data() == nullptr);
+
+    cmdBuf.Reserve(100);
+    CHECK(cmdBuf.Capacity() >= 100);
+    CHECK(cmdBuf.Empty());
+
+    const Id ds(1, 2, 3);
+    const float32 params[4] = { 1.0f, 2.0f, 3.0f, 4.0f };
+    cmdBuf.ApplyDefaultRenderTarget();
+    cmdBuf.ApplyViewPort(0, 0, 640, 400);
+    cmdBuf.ApplyDrawState(ds);
+    cmdBuf.ApplyUniformBlock(0, 12345, params, sizeof(params));
+    cmdBuf.Draw(0);
+    cmdBuf.DrawInstanced(PrimitiveGroup(PrimitiveType::Triangles, 0, 6), 10);
+    CHECK(!cmdBuf.Empty());
+    CHECK(cmdBuf.NumCommands() == 6);
+    const int32 expectedSize =
+        (1 + 8) +                   // ApplyRenderTarget
+        (1 + 16) +                  // ApplyViewPort
+        (1 + 8) +                   // ApplyDrawState
+        (1 + 16 + sizeof(params)) + // ApplyUniformBlock
+        (1 + 4) +                   // Draw
+        (1 + sizeof(PrimitiveGroup) + 4);   // DrawInstancedPrimGroup
+    CHECK(cmdBuf.Size() == expectedSize);
+
+    // check the encoding of a few commands
+    const uint8* ptr = cmdBuf.Data();
+    CHECK(ptr[0] == Cmd::ApplyRenderTarget);
+    uint64 idValue = 0;
+    std::memcpy(&idValue, ptr + 1, sizeof(idValue));
+    CHECK(idValue == Id::InvalidId().Value);
+    ptr += 1 + 8;
+    CHECK(ptr[0] == Cmd::ApplyViewPort);
+    int32 rect[4];
+    std::memcpy(rect, ptr + 1, sizeof(rect));
+    CHECK((rect[0] == 0) && (rect[1] == 0) && (rect[2] == 640) && (rect[3] == 400));
+    ptr += 1 + 16;
+    CHECK(ptr[0] == Cmd::ApplyDrawState);
+    std::memcpy(&idValue, ptr + 1, sizeof(idValue));
+    CHECK(idValue == ds.Value);
+    ptr += 1 + 8;
+    CHECK(ptr[0] == Cmd::ApplyUniformBlock);
+    CHECK(0 == std::memcmp(ptr + 1 + 16, params, sizeof(params)));
+
+    // growing must preserve recorded commands
+    for (int32 i = 0; i < 10000; i++) {
+        cmdBuf.Draw(i);
+    }
+    CHECK(cmdBuf.NumCommands() == 10006);
+    CHECK(cmdBuf.Size() == expectedSize + 10000 * 5);
+    CHECK(cmdBuf.Data()[0] == Cmd::ApplyRenderTarget);
+
+    // move
+    const int32 capacity = cmdBuf.Capacity();
+    GfxCommandBuffer cmdBuf1(std::move(cmdBuf));
+    CHECK(cmdBuf.Empty());
+    CHECK(cmdBuf.Data() == nullptr);
+    CHECK(cmdBuf1.NumCommands() == 10006);
+    CHECK(cmdBuf1.Capacity() == capacity);
+
+    // reset keeps memory
+    cmdBuf1.Reset();
+    CHECK(cmdBuf1.Empty());
+    CHECK(cmdBuf1.Size() == 0);
+    CHECK(cmdBuf1.Capacity() == capacity);
+}
+
+#if ORYOL_NULL_GFX
+//------------------------------------------------------------------------------
+TEST(GfxCommandBufferSubmitTest) {
+    Gfx::Setup(GfxSetup::Window(400, 300, "Oryol Test"));
+
+    const int32 numVertices = 4;
+    auto meshSetup = MeshSetup::Empty(numVertices, Usage::Stream);
+    meshSetup.Layout.Add(VertexAttr::Position, VertexFormat::Float4);
+    meshSetup.AddPrimitiveGroup(PrimitiveGroup(PrimitiveType::TriangleStrip, 0, numVertices));
+    Id mesh = Gfx::CreateResource(meshSetup);
+
+    const int64 layoutHash = 1234;
+    UniformLayout layout;
+    layout.TypeHash = layoutHash;
+    layout.Add("color", UniformType::Vec4, 1);
+    ProgramBundleSetup progSetup("prog");
+    progSetup.AddUniformBlock("params", layout, ShaderType::VertexShader, 0);
+    Id prog = Gfx::CreateResource(progSetup);
+    Id ds0 = Gfx::CreateResource(DrawStateSetup::FromMeshAndProg(mesh, prog));
+    Id ds1 = Gfx::CreateResource(DrawStateSetup::FromMeshAndProg(mesh, prog));
+
+    const float32 red[4] = { 1.0f, 0.0f, 0.0f, 1.0f };
+    const float32 green[4] = { 0.0f, 1.0f, 0.0f, 1.0f };
+    const float32 verts[numVertices * 4] = { };
+    GfxCommandBuffer cmdBuf;
+    cmdBuf.ApplyDefaultRenderTarget();                  // change
+    cmdBuf.Clear(ClearTarget::All, glm::vec4(0.0f));
+    cmdBuf.UpdateVertices(mesh, verts, sizeof(verts));
+    cmdBuf.ApplyDrawState(ds0);                         // change
+    cmdBuf.ApplyUniformBlock(0, layoutHash, red, sizeof(red));      // change
+    cmdBuf.Draw(0);
+    cmdBuf.ApplyDrawState(ds0);                         // redundant
+    cmdBuf.ApplyUniformBlock(0, layoutHash, red, sizeof(red));      // redundant
+    cmdBuf.Draw(0);
+    cmdBuf.ApplyUniformBlock(0, layoutHash, green, sizeof(green));  // change
+    cmdBuf.Draw(0);
+    cmdBuf.ApplyDrawState(ds1);                         // change
+    cmdBuf.ApplyUniformBlock(0, layoutHash, green, sizeof(green));  // change (new draw state)
+    cmdBuf.DrawInstanced(0, 8);
+
+    Gfx::Submit(cmdBuf);
+    Gfx::CommitFrame();
+    const GfxFrameStats& stats = Gfx::FrameStats();
+    CHECK(stats.NumCommandBuffers == 1);
+    CHECK(stats.NumCommands == cmdBuf.NumCommands());
+    CHECK(stats.NumDraws == 4);
+    CHECK(stats.NumInstances == 11);
+    CHECK(stats.NumStateChanges == 6);
+    CHECK(stats.NumRedundantBinds == 2);
+    CHECK(stats.NumUniformBytes == 4 * int32(sizeof(red)));
+    CHECK(stats.NumVertexBytes == int32(sizeof(verts)));
+
+    // a new frame starts with untracked state, the 2nd submission
+    // within a frame sees the state left behind by the 1st
+    Gfx::Submit(cmdBuf);
+    Gfx::Submit(cmdBuf);
+    Gfx::CommitFrame();
+    CHECK(stats.NumCommandBuffers == 2);
+    CHECK(stats.NumDraws == 8);
+    CHECK(stats.NumStateChanges == 6 + 5);
+    CHECK(stats.NumRedundantBinds == 2 + 3);
+
+    // immediate-mode applies reset the tracked state
+    Gfx::Submit(cmdBuf);
+    Gfx::ApplyDrawState(ds0);
+    Gfx::Submit(cmdBuf);
+    Gfx::CommitFrame();
+    CHECK(stats.NumStateChanges == 2 * 6);
+    CHECK(stats.NumRedundantBinds == 2 * 2);
+
+    Gfx::Discard();
+}
+#endif
@@ -31,7 +31,7 @@ TEST(MeshFactoryTest) {
     meshPool meshPool;
     texturePool texPool;
     class renderer renderer;
-    renderer.setup(&displayManager, &meshPool, &texPool);
+    renderer.setup(gfxSetup, &displayManager, &meshPool, &texPool);
     meshFactory factory;
     factory.Setup(&renderer, &meshPool);
     
@@ -0,0 +1,49 @@
+//------------------------------------------------------------------------------
+//  MeshUpdateTest.cc
+//  Test full, partial and mapped updates of dynamic meshes.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#if ORYOL_NULL_GFX
+#include "Gfx/Gfx.h"
+#endif
+
+using namespace Oryol;
+
+#if ORYOL_NULL_GFX
+//------------------------------------------------------------------------------
+TEST(MeshUpdateTest) {
+    Gfx::Setup(GfxSetup::Window(400, 300, "Oryol Test"));
+
+    const int32 numVertices = 64;
+    const int32 numIndices = 96;
+    auto meshSetup = MeshSetup::Empty(numVertices, Usage::Stream, IndexType::Index16, numIndices, Usage::Dynamic);
+    meshSetup.Layout.Add(VertexAttr::Position, VertexFormat::Float4);
+    meshSetup.AddPrimitiveGroup(PrimitiveGroup(PrimitiveType::Triangles, 0, numIndices));
+    Id mesh = Gfx::CreateResource(meshSetup);
+    CHECK(Gfx::QueryResourceInfo(mesh).State == ResourceState::Valid);
+    const int32 vbSize = numVertices * meshSetup.Layout.ByteSize();
+
+    float32 vertices[numVertices * 4] = { };
+    uint16 indices[numIndices] = { };
+
+    // full and partial updates
+    Gfx::UpdateVertices(mesh, vertices, vbSize);
+    Gfx::UpdateVertices(mesh, vbSize / 2, vertices, vbSize / 2);
+    Gfx::UpdateIndices(mesh, indices, sizeof(indices));
+    Gfx::UpdateIndices(mesh, 32 * sizeof(uint16), indices, 16 * sizeof(uint16));
+
+    // map, write and unmap, less than the mapped size may be written
+    for (int32 i = 0; i < 3; i++) {
+        float32* ptr = (float32*) Gfx::MapVertices(mesh, vbSize);
+        CHECK(nullptr != ptr);
+        for (int32 j = 0; j < numVertices * 2; j++) {
+            ptr[j] = float32(j);
+        }
+        Gfx::UnmapVertices(mesh, vbSize / 2);
+        Gfx::CommitFrame();
+    }
+
+    Gfx::Discard();
+}
+#endif
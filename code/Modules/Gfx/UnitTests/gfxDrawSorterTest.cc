@@ -0,0 +1,156 @@
+//------------------------------------------------------------------------------
+//  gfxDrawSorterTest.cc
+//  Test draw sort keys, the radix sort, and sorted DrawLists.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/Array.h"
+#include "Gfx/Core/gfxDrawSorter.h"
+#include "Gfx/Core/DrawList.h"
+#if ORYOL_NULL_GFX
+#include "Gfx/Gfx.h"
+#endif
+
+using namespace Oryol;
+using namespace Oryol::_priv;
+
+namespace {
+struct params {
+    static const int32 _uniformBlockIndex = 0;
+    static const int64 _layoutHash = 4321;
+    float32 color[4];
+};
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(gfxDrawSorterKeyTest) {
+    // program is most significant, then draw state, texture, depth
+    CHECK(gfxDrawSorter::sortKey(1, 0, 0, 0.0f) > gfxDrawSorter::sortKey(0, 0xFFFF, 0xFFFF, 1000.0f));
+    CHECK(gfxDrawSorter::sortKey(0, 1, 0, 0.0f) > gfxDrawSorter::sortKey(0, 0, 0xFFFF, 1000.0f));
+    CHECK(gfxDrawSorter::sortKey(0, 0, 1, 0.0f) > gfxDrawSorter::sortKey(0, 0, 0, 1000.0f));
+
+    // front to back within the same state
+    CHECK(gfxDrawSorter::sortKey(0, 0, 0, 1.0f) > gfxDrawSorter::sortKey(0, 0, 0, 0.5f));
+    CHECK(gfxDrawSorter::sortKey(0, 0, 0, 100.0f) > gfxDrawSorter::sortKey(0, 0, 0, 10.0f));
+    CHECK(gfxDrawSorter::sortKey(0, 0, 0, 0.001f) > gfxDrawSorter::sortKey(0, 0, 0, 0.0f));
+
+    // negative depths are clamped to 0
+    CHECK(gfxDrawSorter::sortKey(0, 0, 0, -5.0f) == gfxDrawSorter::sortKey(0, 0, 0, 0.0f));
+}
+
+//------------------------------------------------------------------------------
+TEST(gfxDrawSorterRadixSortTest) {
+    const int32 num = 1000;
+    Array<gfxDrawSorter::sortItem> items;
+    Array<gfxDrawSorter::sortItem> tmp;
+    uint32 rnd = 12345;
+    for (int32 i = 0; i < num; i++) {
+        rnd = rnd * 1103515245 + 12345;
+        gfxDrawSorter::sortItem item;
+        // few distinct keys with bits in the lowest and highest bytes
+        item.key = (uint64((rnd >> 16) & 3) << 56) | uint64((rnd >> 20) & 7);
+        item.index = i;
+        items.Add(item);
+        tmp.Add(item);
+    }
+    gfxDrawSorter::radixSort(items.begin(), tmp.begin(), num);
+    bool sorted = true;
+    bool stable = true;
+    for (int32 i = 1; i < num; i++) {
+        sorted &= items[i - 1].key <= items[i].key;
+        if (items[i - 1].key == items[i].key) {
+            stable &= items[i - 1].index < items[i].index;
+        }
+    }
+    CHECK(sorted);
+    CHECK(stable);
+
+    // all keys equal keeps the original order
+    for (int32 i = 0; i < num; i++) {
+        items[i].key = 77;
+        items[i].index = i;
+    }
+    gfxDrawSorter::radixSort(items.begin(), tmp.begin(), num);
+    bool unchanged = true;
+    for (int32 i = 0; i < num; i++) {
+        unchanged &= items[i].index == i;
+    }
+    CHECK(unchanged);
+}
+
+#if ORYOL_NULL_GFX
+//------------------------------------------------------------------------------
+TEST(gfxDrawSorterSubmitTest) {
+    Gfx::Setup(GfxSetup::Window(400, 300, "Oryol Test"));
+
+    auto meshSetup = MeshSetup::Empty(4, Usage::Stream);
+    meshSetup.Layout.Add(VertexAttr::Position, VertexFormat::Float4);
+    meshSetup.AddPrimitiveGroup(PrimitiveGroup(PrimitiveType::TriangleStrip, 0, 4));
+    Id mesh = Gfx::CreateResource(meshSetup);
+    UniformLayout layout;
+    layout.TypeHash = params::_layoutHash;
+    layout.Add("color", UniformType::Vec4, 1);
+    ProgramBundleSetup progSetup0("prog0");
+    progSetup0.AddUniformBlock("params", layout, ShaderType::VertexShader, 0);
+    ProgramBundleSetup progSetup1("prog1");
+    progSetup1.AddUniformBlock("params", layout, ShaderType::VertexShader, 0);
+    Id prog0 = Gfx::CreateResource(progSetup0);
+    Id prog1 = Gfx::CreateResource(progSetup1);
+    Id ds0 = Gfx::CreateResource(DrawStateSetup::FromMeshAndProg(mesh, prog0));
+    Id ds1 = Gfx::CreateResource(DrawStateSetup::FromMeshAndProg(mesh, prog1));
+
+    // 2 sorted lists with interleaved draw states, every draw
+    // changes the draw state and uniform block in recording order
+    const int32 numDraws = 100;
+    DrawList lists[2];
+    for (auto& list : lists) {
+        list.Reset(0, true);
+        CHECK(list.SortDraws());
+        for (int32 i = 0; i < numDraws; i++) {
+            const int32 k = i & 1;
+            params p = { { float32(k), 0.0f, 0.0f, 1.0f } };
+            list.SetDepth(float32(numDraws - i));
+            list.ApplyDrawState(k ? ds1 : ds0);
+            list.ApplyUniformBlock(p);
+            list.Draw(0);
+            CHECK(list.DrawDepth(i) == float32(numDraws - i));
+        }
+        Gfx::Enqueue(list);
+    }
+
+    // ...after sorting only 2 draw states and 2 uniform blocks are applied
+    Gfx::ApplyDefaultRenderTarget();
+    Gfx::CommitFrame();
+    const GfxFrameStats& stats = Gfx::FrameStats();
+    CHECK(stats.NumCommandBuffers == 1);
+    CHECK(stats.NumDraws == 2 * numDraws);
+    CHECK(stats.NumSortedDraws == 2 * numDraws);
+    CHECK(stats.NumStateChanges == 4);
+    CHECK(stats.NumRedundantBinds == 0);
+    CHECK(stats.NumStateChangesAvoided == 2 * 2 * numDraws - 4);
+
+    // an unsorted list in between splits the sort batches
+    DrawList unsorted;
+    unsorted.Reset(0);
+    unsorted.ApplyDrawState(ds0);
+    unsorted.Draw(0);
+    Gfx::Enqueue(lists[0]);
+    Gfx::Enqueue(unsorted);
+    Gfx::Enqueue(lists[1]);
+    Gfx::ApplyDefaultRenderTarget();
+    Gfx::CommitFrame();
+    CHECK(stats.NumCommandBuffers == 3);
+    CHECK(stats.NumDraws == 2 * numDraws + 1);
+    CHECK(stats.NumSortedDraws == 2 * numDraws);
+    CHECK(stats.NumStateChangesAvoided == 2 * (2 * numDraws - 4));
+
+    // unsorted lists don't count
+    Gfx::Enqueue(unsorted);
+    Gfx::ApplyDefaultRenderTarget();
+    Gfx::CommitFrame();
+    CHECK(stats.NumSortedDraws == 0);
+    CHECK(stats.NumStateChangesAvoided == 0);
+
+    Gfx::Discard();
+}
+#endif
@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+//  gfxReadbackRingTest.cc
+//  Test async pixel readback bookkeeping, and the async readback API
+//  on the null backend.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Memory/Memory.h"
+#include "Gfx/Core/gfxReadbackRing.h"
+#if ORYOL_NULL_GFX
+#include "Gfx/Gfx.h"
+#endif
+
+using namespace Oryol;
+using namespace Oryol::_priv;
+
+//------------------------------------------------------------------------------
+TEST(gfxReadbackRingTest) {
+    gfxReadbackRing ring;
+    CHECK(!ring.isValid());
+    ring.setup(3);
+    CHECK(ring.isValid());
+    CHECK(ring.numSlots() == 3);
+    CHECK(ring.numPending() == 0);
+    CHECK(ring.oldest() == InvalidIndex);
+
+    // slots are handed out in ring order with increasing tickets
+    int32 numCalled = 0;
+    ReadPixelsCallback cb = [&numCalled](const ReadPixelsAttrs&, const void*) { numCalled++; };
+    const int32 s0 = ring.alloc(8, 4, PixelFormat::RGBA8, cb);
+    const int32 s1 = ring.alloc(16, 8, PixelFormat::RGB8, nullptr);
+    const int32 s2 = ring.alloc(4, 4, PixelFormat::RGBA8, nullptr);
+    CHECK((s0 == 0) && (s1 == 1) && (s2 == 2));
+    CHECK(ring.numPending() == 3);
+    CHECK(ring.oldest() == s0);
+    const int32 t0 = ring.attrs(s0).Ticket;
+    const int32 t1 = ring.attrs(s1).Ticket;
+    const int32 t2 = ring.attrs(s2).Ticket;
+    CHECK((t1 == t0 + 1) && (t2 == t1 + 1));
+    CHECK(ring.attrs(s1).Width == 16);
+    CHECK(ring.attrs(s1).Height == 8);
+    CHECK(ring.attrs(s1).ColorFormat == PixelFormat::RGB8);
+    CHECK(ring.attrs(s1).ByteSize() == 16 * 8 * 3);
+    CHECK(ring.callback(s0));
+    CHECK(!ring.callback(s1));
+    CHECK(ring.clientMemory(s1) != nullptr);
+    CHECK(ring.find(t1) == s1);
+    CHECK(ring.find(InvalidIndex) == InvalidIndex);
+
+    // all slots busy
+    CHECK(ring.alloc(4, 4, PixelFormat::RGBA8, nullptr) == InvalidIndex);
+
+    // freeing out of order keeps the oldest pending slot
+    ring.free(s1);
+    CHECK(ring.numPending() == 2);
+    CHECK(ring.find(t1) == InvalidIndex);
+    CHECK(ring.oldest() == s0);
+    ring.callback(s0)(ring.attrs(s0), nullptr);
+    CHECK(numCalled == 1);
+    ring.free(s0);
+    CHECK(ring.oldest() == s2);
+
+    // the next slot is free again after the ring wrapped around
+    const int32 s3 = ring.alloc(4, 4, PixelFormat::RGBA8, nullptr);
+    CHECK(s3 == 0);
+    CHECK(ring.attrs(s3).Ticket == t2 + 1);
+    CHECK(ring.oldest() == s2);
+    ring.free(s2);
+    CHECK(ring.oldest() == s3);
+    ring.free(s3);
+    CHECK(ring.numPending() == 0);
+    CHECK(ring.oldest() == InvalidIndex);
+
+    ring.discard();
+    CHECK(!ring.isValid());
+}
+
+#if ORYOL_NULL_GFX
+//------------------------------------------------------------------------------
+TEST(ReadPixelsAsyncTest) {
+    GfxSetup gfxSetup = GfxSetup::Window(400, 300, "Oryol Test");
+    gfxSetup.ColorFormat = PixelFormat::RGBA8;
+    gfxSetup.NumReadbackBuffers = 2;
+    Gfx::Setup(gfxSetup);
+    const int32 numBytes = 400 * 300 * 4;
+
+    // callbacks are invoked in CommitFrame()
+    int32 numCalled = 0;
+    int32 ticket = Gfx::ReadPixelsAsync([&numCalled, &ticket](const ReadPixelsAttrs& attrs, const void* pixels) {
+        CHECK(attrs.Ticket == ticket);
+        CHECK(attrs.Width == 400);
+        CHECK(attrs.Height == 300);
+        CHECK(attrs.ColorFormat == PixelFormat::RGBA8);
+        CHECK(nullptr != pixels);
+        numCalled++;
+    });
+    CHECK(ticket != InvalidIndex);
+    CHECK(numCalled == 0);
+    Gfx::CommitFrame();
+    CHECK(numCalled == 1);
+    Gfx::CommitFrame();
+    CHECK(numCalled == 1);
+
+    // polling, with all readback buffers busy
+    uint8* pixels = (uint8*) Memory::Alloc(numBytes);
+    Memory::Fill(pixels, numBytes, 0xFF);
+    const int32 t0 = Gfx::ReadPixelsAsync();
+    const int32 t1 = Gfx::ReadPixelsAsync();
+    CHECK((t0 != InvalidIndex) && (t1 != InvalidIndex) && (t0 != t1));
+    CHECK(Gfx::ReadPixelsAsync() == InvalidIndex);
+    Gfx::CommitFrame();
+    CHECK(Gfx::PollReadPixels(t1, pixels, numBytes));
+    CHECK((pixels[0] == 0) && (pixels[numBytes - 1] == 0));
+    CHECK(Gfx::PollReadPixels(t0, pixels, numBytes));
+    CHECK(Gfx::ReadPixelsAsync() != InvalidIndex);
+    Memory::Free(pixels);
+
+    // pending reads are dropped on discard
+    Gfx::Discard();
+}
+#endif
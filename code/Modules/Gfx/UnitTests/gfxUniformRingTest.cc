@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+//  gfxUniformRingTest.cc
+//  Test the uniform buffer ring allocator (doesn't need a GPU).
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Gfx/Core/gfxUniformRing.h"
+#include <cstring>
+
+using namespace Oryol;
+using namespace Oryol::_priv;
+
+//------------------------------------------------------------------------------
+TEST(gfxUniformRingTest) {
+    gfxUniformRing ring;
+    CHECK(!ring.isValid());
+    ring.setup(1024, 256);
+    CHECK(ring.isValid());
+    CHECK(ring.size() == 1024);
+    CHECK(ring.alignment() == 256);
+    CHECK(ring.frameBytes() == 0);
+    CHECK(ring.frameWraps() == 0);
+
+    // allocations are aligned, and the first one doesn't wrap
+    bool wrapped = true;
+    CHECK(ring.alloc(80, wrapped) == 0);
+    CHECK(!wrapped);
+    CHECK(ring.frameBytes() == 80);
+    CHECK(ring.alloc(64, wrapped) == 256);
+    CHECK(!wrapped);
+    CHECK(ring.frameBytes() == 256 + 64);
+    CHECK(ring.alloc(256, wrapped) == 512);
+    CHECK(!wrapped);
+    CHECK(ring.alloc(256, wrapped) == 768);
+    CHECK(!wrapped);
+    CHECK(ring.frameBytes() == 1024);
+    CHECK(ring.frameWraps() == 0);
+
+    // the ring is full, the next allocation wraps around
+    CHECK(ring.alloc(16, wrapped) == 0);
+    CHECK(wrapped);
+    CHECK(ring.frameWraps() == 1);
+    CHECK(ring.frameBytes() == 1024 + 16);
+
+    // a range which doesn't fit into the rest of the buffer wraps too,
+    // the skipped tail counts as consumed
+    CHECK(ring.alloc(512, wrapped) == 256);
+    CHECK(!wrapped);
+    CHECK(ring.alloc(512, wrapped) == 0);
+    CHECK(wrapped);
+    CHECK(ring.frameWraps() == 2);
+    CHECK(ring.frameBytes() == 2048 + 512);
+
+    // committing the frame resets the counters, but not the ring position
+    ring.commitFrame();
+    CHECK(ring.frameBytes() == 0);
+    CHECK(ring.frameWraps() == 0);
+    CHECK(ring.alloc(32, wrapped) == 512);
+    CHECK(!wrapped);
+    CHECK(ring.frameBytes() == 32);
+
+    // a range of the full buffer size always fits
+    CHECK(ring.alloc(1024, wrapped) == 0);
+    CHECK(wrapped);
+    CHECK(ring.alloc(1024, wrapped) == 0);
+    CHECK(wrapped);
+    CHECK(ring.frameWraps() == 2);
+
+    ring.discard();
+    CHECK(!ring.isValid());
+
+    // a ring with byte alignment packs ranges tightly
+    ring.setup(100, 1);
+    CHECK(ring.alloc(30, wrapped) == 0);
+    CHECK(ring.alloc(30, wrapped) == 30);
+    CHECK(ring.alloc(30, wrapped) == 60);
+    CHECK(ring.alloc(30, wrapped) == 0);
+    CHECK(wrapped);
+    CHECK(ring.frameBytes() == 130);
+    ring.discard();
+
+    // bound ranges keep a shadow copy of their data, a wrap while two
+    // blocks are bound moves the other block's range into the new storage
+    ring.setup(1024, 256);
+    const uint8 data0[16] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+    const uint8 data1[32] = { 0xAA, 0xBB, 0xCC };
+    CHECK(!ring.isBound(0));
+    CHECK(!ring.isBound(1));
+    CHECK(ring.allocBinding(0, 64, data0, sizeof(data0), wrapped) == 0);
+    CHECK(!wrapped);
+    CHECK(ring.allocBinding(1, 128, data1, sizeof(data1), wrapped) == 256);
+    CHECK(!wrapped);
+    CHECK(ring.isBound(0));
+    CHECK(ring.isBound(1));
+    CHECK(!ring.isBound(2));
+    CHECK(ring.bindingAt(1).numBytes == 128);
+    CHECK(ring.bindingAt(1).dataSize == sizeof(data1));
+    CHECK(0 == std::memcmp(ring.bindingAt(1).data, data1, sizeof(data1)));
+
+    // only block 0 is applied again until the ring wraps
+    CHECK(ring.allocBinding(0, 64, data0, sizeof(data0), wrapped) == 512);
+    CHECK(!wrapped);
+    CHECK(ring.allocBinding(0, 64, data0, sizeof(data0), wrapped) == 768);
+    CHECK(!wrapped);
+    CHECK(ring.bindingAt(1).offset == 256);
+    CHECK(ring.allocBinding(0, 64, data0, sizeof(data0), wrapped) == 0);
+    CHECK(wrapped);
+    CHECK(ring.bindingAt(0).offset == 0);
+    CHECK(ring.bindingAt(1).offset == 256);
+    CHECK(ring.bindingAt(1).numBytes == 128);
+    CHECK(0 == std::memcmp(ring.bindingAt(0).data, data0, sizeof(data0)));
+    CHECK(0 == std::memcmp(ring.bindingAt(1).data, data1, sizeof(data1)));
+
+    // the moved range is allocated in the new storage, the next range follows it
+    CHECK(ring.allocBinding(0, 64, data0, sizeof(data0), wrapped) == 512);
+    CHECK(!wrapped);
+    ring.discard();
+    CHECK(!ring.isBound(0));
+    CHECK(!ring.isBound(1));
+}
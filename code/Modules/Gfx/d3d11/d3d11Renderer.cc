@@ -28,7 +28,9 @@ curRenderTarget(nullptr),
 curDrawState(nullptr),
 curRenderTargetView(nullptr),
 curDepthStencilView(nullptr),
-curPrimitiveTopology(PrimitiveType::InvalidPrimitiveType) {
+curPrimitiveTopology(PrimitiveType::InvalidPrimitiveType),
+mappedMesh(nullptr),
+mappedMaxBytes(0) {
     // empty
 }
 
@@ -39,7 +41,7 @@ d3d11Renderer::~d3d11Renderer() {
 
 //------------------------------------------------------------------------------
 void
-d3d11Renderer::setup(displayMgr* dispMgr_, meshPool* mshPool_, texturePool* texPool_) {
+d3d11Renderer::setup(const GfxSetup& /*setup*/, displayMgr* dispMgr_, meshPool* mshPool_, texturePool* texPool_) {
     o_assert_dbg(!this->valid);
     o_assert_dbg(dispMgr_);
     o_assert_dbg(mshPool_);
@@ -63,6 +65,7 @@ d3d11Renderer::setup(displayMgr* dispMgr_, meshPool* mshPool_, texturePool* texP
 void
 d3d11Renderer::discard() {
     o_assert_dbg(this->valid);
+    o_assert_dbg(nullptr == this->mappedMesh);
 
     this->curRenderTargetView = nullptr;
     this->curDepthStencilView = nullptr;
@@ -113,6 +116,12 @@ d3d11Renderer::commitFrame() {
     this->rtValid = false;
 }
 
+//------------------------------------------------------------------------------
+void
+d3d11Renderer::addFrameStats(GfxFrameStats& /*stats*/) const {
+    // no renderer-side statistics
+}
+
 //------------------------------------------------------------------------------
 const DisplayAttrs&
 d3d11Renderer::renderTargetAttrs() const {
@@ -448,12 +457,122 @@ d3d11Renderer::updateVertices(mesh* msh, const void* data, int32 numBytes) {
     this->d3d11DeviceContext->Unmap(msh->d3d11VertexBuffer, 0);
 }
 
+//------------------------------------------------------------------------------
+void
+d3d11Renderer::updateBufferRange(ID3D11Buffer* buf, Usage::Code usage, int32 bufSize, int32 offset, const void* data, int32 numBytes) {
+    o_assert_dbg(this->d3d11DeviceContext);
+    o_assert_dbg(buf);
+
+    if (Usage::Static == usage) {
+        // default-usage buffers can't be mapped
+        D3D11_BOX box;
+        box.left = offset;
+        box.right = offset + numBytes;
+        box.top = 0;
+        box.bottom = 1;
+        box.front = 0;
+        box.back = 1;
+        this->d3d11DeviceContext->UpdateSubresource(buf, 0, &box, data, 0, 0);
+    }
+    else {
+        // replacing the whole buffer may discard it, a partial update must
+        // keep the rest of the buffer and promises not to overwrite
+        // data which is in use by the GPU
+        const bool whole = (0 == offset) && (bufSize == numBytes);
+        const D3D11_MAP mapType = whole ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        HRESULT hr = this->d3d11DeviceContext->Map(buf, 0, mapType, 0, &mapped);
+        o_assert_dbg(SUCCEEDED(hr));
+        std::memcpy(((uint8*)mapped.pData) + offset, data, numBytes);
+        this->d3d11DeviceContext->Unmap(buf, 0);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+d3d11Renderer::updateVertices(mesh* msh, int32 offset, const void* data, int32 numBytes) {
+    o_assert_dbg(this->d3d11DeviceContext);
+    o_assert_dbg(nullptr != msh);
+    o_assert_dbg(msh->d3d11VertexBuffer);
+    o_assert_dbg(msh != this->mappedMesh);
+
+    const VertexBufferAttrs& attrs = msh->vertexBufferAttrs;
+    const Usage::Code vbUsage = attrs.BufferUsage;
+    o_assert_dbg((offset >= 0) && (numBytes > 0) && ((offset + numBytes) <= attrs.ByteSize()));
+    o_assert_dbg((vbUsage == Usage::Stream) || (vbUsage == Usage::Dynamic) || (vbUsage == Usage::Static));
+
+    this->updateBufferRange(msh->d3d11VertexBuffer, vbUsage, attrs.ByteSize(), offset, data, numBytes);
+}
+
+//------------------------------------------------------------------------------
+void
+d3d11Renderer::updateIndices(mesh* msh, int32 offset, const void* data, int32 numBytes) {
+    o_assert_dbg(this->d3d11DeviceContext);
+    o_assert_dbg(nullptr != msh);
+    o_assert_dbg(msh->d3d11IndexBuffer);
+
+    const IndexBufferAttrs& attrs = msh->indexBufferAttrs;
+    const Usage::Code ibUsage = attrs.BufferUsage;
+    o_assert_dbg((offset >= 0) && (numBytes > 0) && ((offset + numBytes) <= attrs.ByteSize()));
+    o_assert_dbg((ibUsage == Usage::Stream) || (ibUsage == Usage::Dynamic) || (ibUsage == Usage::Static));
+
+    this->updateBufferRange(msh->d3d11IndexBuffer, ibUsage, attrs.ByteSize(), offset, data, numBytes);
+}
+
+//------------------------------------------------------------------------------
+void*
+d3d11Renderer::mapVertices(mesh* msh, int32 maxNumBytes) {
+    o_assert_dbg(this->d3d11DeviceContext);
+    o_assert_dbg(nullptr != msh);
+    o_assert_dbg(msh->d3d11VertexBuffer);
+    o_assert2_dbg(nullptr == this->mappedMesh, "mapVertices: another mesh is still mapped!\n");
+
+    const VertexBufferAttrs& attrs = msh->vertexBufferAttrs;
+    const Usage::Code vbUsage = attrs.BufferUsage;
+    o_assert_dbg((maxNumBytes > 0) && (maxNumBytes <= attrs.ByteSize()));
+    o_assert_dbg((vbUsage == Usage::Stream) || (vbUsage == Usage::Dynamic));
+
+    // discard lets the driver rename the buffer instead of waiting for the GPU
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    HRESULT hr = this->d3d11DeviceContext->Map(msh->d3d11VertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+    o_assert_dbg(SUCCEEDED(hr));
+    this->mappedMesh = msh;
+    this->mappedMaxBytes = maxNumBytes;
+    return mapped.pData;
+}
+
+//------------------------------------------------------------------------------
+void
+d3d11Renderer::unmapVertices(mesh* msh, int32 numBytes) {
+    o_assert_dbg(this->d3d11DeviceContext);
+    o_assert2_dbg(msh == this->mappedMesh, "unmapVertices: mesh is not mapped!\n");
+    o_assert_dbg((numBytes >= 0) && (numBytes <= this->mappedMaxBytes));
+
+    this->d3d11DeviceContext->Unmap(msh->d3d11VertexBuffer, 0);
+    this->mappedMesh = nullptr;
+    this->mappedMaxBytes = 0;
+}
+
 //------------------------------------------------------------------------------
 void 
 d3d11Renderer::readPixels(displayMgr* displayManager, void* buf, int32 bufNumBytes) {
     o_error("FIXME!\n");
 }
 
+//------------------------------------------------------------------------------
+int32
+d3d11Renderer::readPixelsAsync(displayMgr* displayManager, ReadPixelsCallback callback) {
+    o_error("FIXME!\n");
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+bool
+d3d11Renderer::pollReadPixels(int32 ticket, void* buf, int32 bufNumBytes) {
+    o_error("FIXME!\n");
+    return false;
+}
+
 //------------------------------------------------------------------------------
 void
 d3d11Renderer::invalidateMeshState() {
@@ -12,10 +12,15 @@
 #include "Gfx/Core/RasterizerState.h"
 #include "Gfx/Core/PrimitiveGroup.h"
 #include "Gfx/Attrs/DisplayAttrs.h"
+#include "Gfx/Attrs/ReadPixelsAttrs.h"
 #include <glm/vec4.hpp>
 #include "Gfx/d3d11/d3d11_decl.h"
 
 namespace Oryol {
+
+class GfxSetup;
+class GfxFrameStats;
+
 namespace _priv {
 
 class meshPool;
@@ -34,7 +39,7 @@ public:
     ~d3d11Renderer();
     
     /// setup the renderer
-    void setup(displayMgr* dispMgr, meshPool* mshPool, texturePool* texPool);
+    void setup(const GfxSetup& setup, displayMgr* dispMgr, meshPool* mshPool, texturePool* texPool);
     /// discard the renderer
     void discard();
     /// return true if renderer has been setup
@@ -46,6 +51,8 @@ public:
     bool supports(GfxFeature::Code feat) const;
     /// commit current frame
     void commitFrame();
+    /// add renderer statistics of the current frame
+    void addFrameStats(GfxFrameStats& stats) const;
     /// get the current render target attributes
     const DisplayAttrs& renderTargetAttrs() const;
 
@@ -71,8 +78,20 @@ public:
     void drawInstanced(const PrimitiveGroup& primGroup, int32 numInstances);
     /// update vertex data
     void updateVertices(mesh* msh, const void* data, int32 numBytes);
+    /// update a range of vertex data in place
+    void updateVertices(mesh* msh, int32 offset, const void* data, int32 numBytes);
+    /// update a range of index data in place
+    void updateIndices(mesh* msh, int32 offset, const void* data, int32 numBytes);
+    /// map vertex data for writing
+    void* mapVertices(mesh* msh, int32 maxNumBytes);
+    /// unmap vertex data, numBytes have been written
+    void unmapVertices(mesh* msh, int32 numBytes);
     /// read pixels back from framebuffer, causes a PIPELINE STALL!!!
     void readPixels(displayMgr* displayManager, void* buf, int32 bufNumBytes);
+    /// queue an asynchronous pixel readback, returns ticket or InvalidIndex
+    int32 readPixelsAsync(displayMgr* displayManager, ReadPixelsCallback callback);
+    /// poll an asynchronous pixel readback, returns true if pixels have been copied
+    bool pollReadPixels(int32 ticket, void* buf, int32 bufNumBytes);
 
     /// invalidate currently bound mesh state
     void invalidateMeshState();
@@ -89,6 +108,9 @@ public:
     ID3D11DeviceContext* d3d11DeviceContext;
 
 private:
+    /// write a range of a vertex or index buffer
+    void updateBufferRange(ID3D11Buffer* buf, Usage::Code usage, int32 bufSize, int32 offset, const void* data, int32 numBytes);
+
     bool valid;
     displayMgr* dispMgr;
     meshPool* mshPool;
@@ -106,6 +128,9 @@ private:
     ID3D11RenderTargetView* curRenderTargetView;
     ID3D11DepthStencilView* curDepthStencilView;
     PrimitiveType::Code curPrimitiveTopology;
+
+    mesh* mappedMesh;
+    int32 mappedMaxBytes;
 };
 
 } // namespace _priv
@@ -11,6 +11,11 @@ namespace _priv {
 void
 glDrawState::Clear() {
     this->glAttrs.Fill(glVertexAttr());
+    #if ORYOL_GL_USE_VAO_CACHE
+    this->vaos.Fill(vao());
+    this->numVAOs = 0;
+    this->nextVAO = 0;
+    #endif
     drawStateBase::Clear();
 }
 
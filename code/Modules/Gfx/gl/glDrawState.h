@@ -4,10 +4,20 @@
     @class Oryol::_priv::glDrawState
     @ingroup _priv
     @brief GL implementation of drawState
+
+    On GL3 and GLES3 the draw state caches Vertex Array Objects, one for
+    each combination of input meshes and their active vertex buffer slots
+    (stream meshes rotate between several vertex buffers). The VAOs are
+    created and specified lazily by glRenderer::applyDrawState(), and
+    deleted when the draw state is destroyed.
 */
 #include "Gfx/Resource/drawStateBase.h"
 #include "Gfx/gl/glVertexAttr.h"
 #include "Core/Containers/StaticArray.h"
+#include "Gfx/Setup/DrawStateSetup.h"
+
+/// cache Vertex Array Objects per draw state (GLES2 has no VAOs)
+#define ORYOL_GL_USE_VAO_CACHE (!ORYOL_OPENGLES2 && !ORYOL_GL_USE_GETATTRIBLOCATION)
 
 namespace Oryol {
 namespace _priv {
@@ -18,6 +28,24 @@ public:
     void Clear();
     /// GL vertex attributes
     StaticArray<glVertexAttr, VertexAttr::NumVertexAttrs> glAttrs;
+
+    #if ORYOL_GL_USE_VAO_CACHE
+    /// max number of cached VAOs, the oldest is re-specified when full
+    static const int32 MaxNumVAOs = 4;
+    /// a cached VAO and what it has been specified with
+    struct vao {
+        GLuint glVAO = 0;
+        uint32 generation = 0;
+        class Id meshIds[DrawStateSetup::MaxInputMeshes];
+        uint8 vbSlots[DrawStateSetup::MaxInputMeshes] = { };
+    };
+    /// cached VAOs
+    StaticArray<vao, MaxNumVAOs> vaos;
+    /// number of used VAO cache entries
+    int32 numVAOs = 0;
+    /// next cache entry to re-specify when all are used
+    int32 nextVAO = 0;
+    #endif
 };
 
 } // namespace _priv
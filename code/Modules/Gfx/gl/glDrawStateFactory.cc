@@ -45,7 +45,14 @@ void
 glDrawStateFactory::DestroyResource(drawState& ds) {
     o_assert_dbg(this->renderer);
 
+    // this also makes sure that none of the draw state's VAOs is bound
     this->renderer->invalidateMeshState();
+    #if ORYOL_GL_USE_VAO_CACHE
+    for (int32 i = 0; i < ds.numVAOs; i++) {
+        ::glDeleteVertexArrays(1, &ds.vaos[i].glVAO);
+    }
+    ORYOL_GL_CHECK_ERROR();
+    #endif
 
     ds.Clear();
 }
@@ -13,6 +13,9 @@ glIndexBuffer(0),
 numVertexBufferSlots(1),
 activeVertexBufferSlot(0) {
     this->glVertexBuffers.Fill(0);
+    #if ORYOL_OPENGL_CORE_PROFILE
+    this->glVertexBufferFences.Fill(nullptr);
+    #endif
 }
 
 //------------------------------------------------------------------------------
@@ -29,6 +32,9 @@ glMesh::Clear() {
     this->numVertexBufferSlots = 1;
     this->activeVertexBufferSlot = 0;
     this->glVertexBuffers.Fill(0);
+    #if ORYOL_OPENGL_CORE_PROFILE
+    this->glVertexBufferFences.Fill(nullptr);
+    #endif
     this->glIndexBuffer = 0;
     meshBase::Clear();
 }
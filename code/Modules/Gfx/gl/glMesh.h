@@ -33,6 +33,10 @@ public:
     uint8 activeVertexBufferSlot;
     /// GL vertex buffers
     StaticArray<GLuint, MaxNumSlots> glVertexBuffers;
+    #if ORYOL_OPENGL_CORE_PROFILE
+    /// fences set when switching away from a vertex buffer slot, to check if the GPU is done with it
+    StaticArray<GLsync, MaxNumSlots> glVertexBufferFences;
+    #endif
 };
 
 } // namespace _priv
@@ -88,6 +88,11 @@ glMeshFactory::DestroyResource(mesh& mesh) {
         if (0 != vb) {
             ::glDeleteBuffers(1, &vb);
         }
+        #if ORYOL_OPENGL_CORE_PROFILE
+        if (mesh.glVertexBufferFences[i]) {
+            ::glDeleteSync(mesh.glVertexBufferFences[i]);
+        }
+        #endif
     }
     if (0 != mesh.glIndexBuffer) {
         ::glDeleteBuffers(1, &mesh.glIndexBuffer);
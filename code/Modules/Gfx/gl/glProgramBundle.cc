@@ -32,6 +32,7 @@ glProgramBundle::Clear() {
         entry.mask = 0;
         entry.program = 0;
         for (int32 blockIndex = 0; blockIndex < MaxNumUniformBlocks; blockIndex++) {
+            entry.uniformBufferSize[blockIndex] = 0;
             for (int32 uniformIndex = 0; uniformIndex < MaxNumUniforms; uniformIndex++) {
                 entry.uniformMapping[blockIndex][uniformIndex] = -1;
                 entry.samplerMapping[blockIndex][uniformIndex] = -1;
@@ -80,6 +81,15 @@ glProgramBundle::bindSamplerUniform(int32 progIndex, int32 blockIndex, int32 slo
     this->programEntries[progIndex].samplerMapping[blockIndex][slotIndex] = samplerIndex;
 }
 
+//------------------------------------------------------------------------------
+void
+glProgramBundle::bindUniformBuffer(int32 progIndex, int32 blockIndex, int32 glBlockDataSize) {
+    o_assert_range_dbg(progIndex, this->numProgramEntries);
+    o_assert_range_dbg(blockIndex, MaxNumUniformBlocks);
+    o_assert_dbg(glBlockDataSize > 0);
+    this->programEntries[progIndex].uniformBufferSize[blockIndex] = glBlockDataSize;
+}
+
 //------------------------------------------------------------------------------
 #if ORYOL_GL_USE_GETATTRIBLOCATION
 void
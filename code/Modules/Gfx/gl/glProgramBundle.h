@@ -28,6 +28,8 @@ public:
     void bindUniform(int32 progIndex, int32 blockIndex, int32 slotIndex, GLint glUniformLocation);
     /// bind a sampler uniform location to a slot index
     void bindSamplerUniform(int32 progIndex, int32 blockIndex, int32 slotIndex, GLint glUniformLocation, int32 samplerIndex);
+    /// mark a uniform block as backed by a uniform buffer with the GL block data size
+    void bindUniformBuffer(int32 progIndex, int32 blockIndex, int32 glBlockDataSize);
     #if ORYOL_GL_USE_GETATTRIBLOCATION
     /// bind a vertex attribute location
     void bindAttribLocation(int32 progIndex, VertexAttr::Code attrib, GLint attribLocation);
@@ -43,6 +45,8 @@ public:
     GLint getUniformLocation(int32 blockIndex, int32 slotIndex) const;
     /// get sampler location by slot index in currently selected program (-1 if not exists)
     int32 getSamplerIndex(int32 blockIndex, int32 slotIndex) const;
+    /// get uniform buffer range size of a block in currently selected program (0 if not a uniform buffer)
+    int32 getUniformBufferSize(int32 blockIndex) const;
     #if ORYOL_GL_USE_GETATTRIBLOCATION
     /// get a vertex attribute location
     GLint getAttribLocation(VertexAttr::Code attrib) const;
@@ -63,6 +67,7 @@ private:
         GLuint program;
         GLint uniformMapping[MaxNumUniformBlocks][MaxNumUniforms];
         int32 samplerMapping[MaxNumUniformBlocks][MaxNumUniforms];
+        int32 uniformBufferSize[MaxNumUniformBlocks];
         #if ORYOL_GL_USE_GETATTRIBLOCATION
         GLint attribMapping[VertexAttr::NumVertexAttrs];
         #endif
@@ -117,6 +122,13 @@ glProgramBundle::getSamplerIndex(int32 blockIndex, int32 slotIndex) const {
     return this->programEntries[this->selIndex].samplerMapping[blockIndex][slotIndex];
 }
 
+//------------------------------------------------------------------------------
+inline int32
+glProgramBundle::getUniformBufferSize(int32 blockIndex) const {
+    o_assert_range_dbg(blockIndex, MaxNumUniformBlocks);
+    return this->programEntries[this->selIndex].uniformBufferSize[blockIndex];
+}
+
 //------------------------------------------------------------------------------
 #if ORYOL_GL_USE_GETATTRIBLOCATION
 inline GLint
@@ -170,6 +170,38 @@ glProgramBundleFactory::SetupResource(programBundle& progBundle) {
             int32 slotIndex = 0;
             const UniformLayout& layout = setup.UniformBlockLayout(uniformBlockIndex);
             const int32 numUniforms = layout.NumComponents();
+            #if ORYOL_OPENGL_CORE_PROFILE
+            // on GLSL 1.50 the shader generator writes std140 uniform blocks,
+            // bind them to the binding point of the same index
+            const GLuint glBlockIndex = ::glGetUniformBlockIndex(glProg, setup.UniformBlockName(uniformBlockIndex).AsCStr());
+            if (GL_INVALID_INDEX != glBlockIndex) {
+                GLint glBlockDataSize = 0;
+                ::glGetActiveUniformBlockiv(glProg, glBlockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &glBlockDataSize);
+                o_assert2(glBlockDataSize >= layout.ByteSizeWithoutTextures(), "uniform block is smaller than its uniform layout!\n");
+                ::glUniformBlockBinding(glProg, glBlockIndex, uniformBlockIndex);
+                progBundle.bindUniformBuffer(progIndex, uniformBlockIndex, glBlockDataSize);
+                #if ORYOL_DEBUG
+                // the uniform block struct must match the std140 layout, textures are
+                // at the start of the struct and not part of the uniform buffer
+                const int32 textureBytes = layout.ByteSize() - layout.ByteSizeWithoutTextures();
+                for (int uniformIndex = 0; uniformIndex < numUniforms; uniformIndex++) {
+                    const UniformLayout::Component& comp = layout.ComponentAt(uniformIndex);
+                    if (comp.Type != UniformType::Texture) {
+                        const GLchar* name = comp.Name.AsCStr();
+                        GLuint glUniformIndex = GL_INVALID_INDEX;
+                        ::glGetUniformIndices(glProg, 1, &name, &glUniformIndex);
+                        GLint glOffset = -1;
+                        if (GL_INVALID_INDEX != glUniformIndex) {
+                            ::glGetActiveUniformsiv(glProg, 1, &glUniformIndex, GL_UNIFORM_OFFSET, &glOffset);
+                        }
+                        o_assert2((GL_INVALID_INDEX == glUniformIndex) || (glOffset == layout.ComponentByteOffset(uniformIndex) - textureBytes),
+                            "uniform block member offset doesn't match std140 layout!\n");
+                    }
+                }
+                #endif
+            }
+            ORYOL_GL_CHECK_ERROR();
+            #endif
             for (int uniformIndex = 0; uniformIndex < numUniforms; uniformIndex++) {
                 const UniformLayout::Component& comp = layout.ComponentAt(uniformIndex);
                 const GLint glLocation = ::glGetUniformLocation(glProg, comp.Name.AsCStr());
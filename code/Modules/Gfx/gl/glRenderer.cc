@@ -9,6 +9,8 @@
 #include "Gfx/gl/glExt.h"
 #include "Gfx/gl/glTypes.h"
 #include "Gfx/Core/displayMgr.h"
+#include "Gfx/Core/GfxFrameStats.h"
+#include "Gfx/Setup/GfxSetup.h"
 #include "Gfx/Resource/resourcePools.h"
 #include "Gfx/Resource/texture.h"
 #include "Gfx/Resource/programBundle.h"
@@ -21,6 +23,7 @@
 #include "glm/mat3x3.hpp"
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/type_ptr.hpp"
+#include <cstring>
 
 namespace Oryol {
 namespace _priv {
@@ -85,6 +88,11 @@ mshPool(nullptr),
 texPool(nullptr),
 #if !ORYOL_OPENGLES2
 globalVAO(0),
+curVAO(0),
+vaoGeneration(1),
+#endif
+#if ORYOL_OPENGL_CORE_PROFILE
+uniformBuffer(0),
 #endif
 rtValid(false),
 curRenderTarget(nullptr),
@@ -100,7 +108,13 @@ viewPortWidth(0),
 viewPortHeight(0),
 vertexBuffer(0),
 indexBuffer(0),
-program(0) {
+program(0),
+mappedMesh(nullptr),
+mappedMaxBytes(0) {
+    #if !ORYOL_OPENGL_CORE_PROFILE
+    this->mapBuffer = nullptr;
+    this->mapBufferSize = 0;
+    #endif
     for (int32 i = 0; i < MaxTextureSamplers; i++) {
         this->samplers2D[i] = 0;
         this->samplersCube[i] = 0;
@@ -117,7 +131,7 @@ glRenderer::~glRenderer() {
 
 //------------------------------------------------------------------------------
 void
-glRenderer::setup(displayMgr* dispMgr_, meshPool* mshPool_, texturePool* texPool_) {
+glRenderer::setup(const GfxSetup& setup, displayMgr* dispMgr_, meshPool* mshPool_, texturePool* texPool_) {
     o_assert_dbg(!this->valid);
     o_assert_dbg(dispMgr_);
     o_assert_dbg(mshPool_);
@@ -132,10 +146,37 @@ glRenderer::setup(displayMgr* dispMgr_, meshPool* mshPool_, texturePool* texPool
     o_warn("glStateWrapper: ORYOL_GL_USE_GETATTRIBLOCATION is ON\n");
     #endif
 
-    // in case we are on a Core Profile, create a global Vertex Array Object
+    // in case we are on a Core Profile, create a global Vertex Array Object,
+    // this is bound whenever no draw state VAO is needed, so that mesh
+    // creation never modifies the index buffer binding of a cached VAO
     #if !ORYOL_OPENGLES2
     ::glGenVertexArrays(1, &this->globalVAO);
     ::glBindVertexArray(this->globalVAO);
+    this->curVAO = this->globalVAO;
+    #endif
+
+    // on the Core Profile, uniform blocks are written into a uniform buffer ring
+    #if ORYOL_OPENGL_CORE_PROFILE
+    GLint uniformBufferAlign = 0;
+    ::glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformBufferAlign);
+    this->uniformRing.setup(setup.UniformBufferSize, uniformBufferAlign);
+    ::glGenBuffers(1, &this->uniformBuffer);
+    ::glBindBuffer(GL_UNIFORM_BUFFER, this->uniformBuffer);
+    ::glBufferData(GL_UNIFORM_BUFFER, this->uniformRing.size(), nullptr, GL_STREAM_DRAW);
+    ORYOL_GL_CHECK_ERROR();
+    #endif
+
+    // async pixel readback goes through pixel pack buffers on the Core Profile,
+    // other GL flavours read synchronously into client memory
+    this->readbackRing.setup(setup.NumReadbackBuffers);
+    #if ORYOL_OPENGL_CORE_PROFILE
+    for (int32 i = 0; i < setup.NumReadbackBuffers; i++) {
+        GLuint pbo = 0;
+        ::glGenBuffers(1, &pbo);
+        this->readbackBuffers.Add(pbo);
+        this->readbackFences.Add(nullptr);
+    }
+    ORYOL_GL_CHECK_ERROR();
     #endif
     
     this->setupDepthStencilState();
@@ -148,6 +189,7 @@ glRenderer::setup(displayMgr* dispMgr_, meshPool* mshPool_, texturePool* texPool
 void
 glRenderer::discard() {
     o_assert_dbg(this->valid);
+    o_assert_dbg(nullptr == this->mappedMesh);
     
     this->invalidateMeshState();
     this->invalidateProgramState();
@@ -156,9 +198,33 @@ glRenderer::discard() {
     this->curDrawState = nullptr;
 
     #if !ORYOL_OPENGLES2
+    ::glBindVertexArray(0);
     ::glDeleteVertexArrays(1, &this->globalVAO);
     this->globalVAO = 0;
+    this->curVAO = 0;
+    #endif
+
+    #if ORYOL_OPENGL_CORE_PROFILE
+    ::glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    ::glDeleteBuffers(1, &this->uniformBuffer);
+    this->uniformBuffer = 0;
+    this->uniformRing.discard();
+    for (int32 i = 0; i < this->readbackBuffers.Size(); i++) {
+        if (this->readbackFences[i]) {
+            ::glDeleteSync(this->readbackFences[i]);
+        }
+        ::glDeleteBuffers(1, &this->readbackBuffers[i]);
+    }
+    this->readbackBuffers.Clear();
+    this->readbackFences.Clear();
+    #else
+    if (this->mapBuffer) {
+        Memory::Free(this->mapBuffer);
+        this->mapBuffer = nullptr;
+        this->mapBufferSize = 0;
+    }
     #endif
+    this->readbackRing.discard();
 
     this->texPool = nullptr;
     this->mshPool = nullptr;
@@ -180,9 +246,18 @@ glRenderer::resetStateCache() {
     this->setupDepthStencilState();
     this->setupBlendState();
     this->setupRasterizerState();
+    #if !ORYOL_OPENGLES2
+    // outside code may have bound another VAO, or modified the attributes
+    // of one of the cached VAOs, so they are re-specified on next use
+    this->curVAO = 0;
+    this->vaoGeneration++;
+    #endif
     this->invalidateMeshState();
     this->invalidateProgramState();
     this->invalidateTextureState();
+    #if ORYOL_OPENGL_CORE_PROFILE
+    ::glBindBuffer(GL_UNIFORM_BUFFER, this->uniformBuffer);
+    #endif
 }
 
 //------------------------------------------------------------------------------
@@ -220,6 +295,35 @@ glRenderer::commitFrame() {
     o_assert_dbg(this->valid);    
     this->rtValid = false;
     this->curRenderTarget = nullptr;
+    #if ORYOL_OPENGL_CORE_PROFILE
+    this->uniformRing.commitFrame();
+    #endif
+
+    // deliver arrived async readbacks with callback, oldest first, since
+    // fences signal in order the first one still in flight ends the search
+    const int32 numSlots = this->readbackRing.numSlots();
+    int32 slotIndex = this->readbackRing.oldest();
+    for (int32 i = 0; (i < numSlots) && (InvalidIndex != slotIndex); i++) {
+        if (InvalidIndex != this->readbackRing.attrs(slotIndex).Ticket) {
+            if (!this->readbackReady(slotIndex)) {
+                break;
+            }
+            if (this->readbackRing.callback(slotIndex)) {
+                this->finishReadback(slotIndex, nullptr);
+            }
+        }
+        slotIndex = (slotIndex + 1) % numSlots;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+glRenderer::addFrameStats(GfxFrameStats& stats) const {
+    o_assert_dbg(this->valid);
+    #if ORYOL_OPENGL_CORE_PROFILE
+    stats.NumUniformBufferBytes += this->uniformRing.frameBytes();
+    stats.NumUniformBufferWraps += this->uniformRing.frameWraps();
+    #endif
 }
 
 //------------------------------------------------------------------------------
@@ -320,16 +424,19 @@ glRenderer::applyProgramBundle(programBundle* progBundle, uint32 mask) {
 
 //------------------------------------------------------------------------------
 void
-glRenderer::applyMeshState(const drawState* ds) {
+glRenderer::applyMeshState(drawState* ds) {
     o_assert_dbg(this->valid);
     o_assert_dbg(nullptr != ds);
     o_assert_dbg(nullptr != ds->meshes[0]);
     o_assert_dbg(nullptr != ds->prog);
     ORYOL_GL_CHECK_ERROR();
 
-    #if !ORYOL_GL_USE_GETATTRIBLOCATION
-    // this is the default vertex attribute code path for most
-    // desktop and mobile platforms
+    #if ORYOL_GL_USE_VAO_CACHE
+    // GL3 and GLES3: the draw state's VAO holds the complete vertex
+    // attribute and index buffer state
+    this->bindVertexArray(this->lookupVertexArray(ds));
+    #elif !ORYOL_GL_USE_GETATTRIBLOCATION
+    // this is the default vertex attribute code path for GLES2
     this->bindIndexBuffer(ds->meshes[0]->glIndexBuffer);    // can be 0
     for (int attrIndex = 0; attrIndex < VertexAttr::NumVertexAttrs; attrIndex++) {
         const glVertexAttr& attr = ds->glAttrs[attrIndex];
@@ -400,6 +507,102 @@ glRenderer::applyMeshState(const drawState* ds) {
     ORYOL_GL_CHECK_ERROR();
 }
 
+#if !ORYOL_OPENGLES2
+//------------------------------------------------------------------------------
+void
+glRenderer::bindVertexArray(GLuint vao) {
+    o_assert_dbg(this->valid);
+
+    if (vao != this->curVAO) {
+        this->curVAO = vao;
+        ::glBindVertexArray(vao);
+        ORYOL_GL_CHECK_ERROR();
+    }
+}
+#endif
+
+#if ORYOL_GL_USE_VAO_CACHE
+//------------------------------------------------------------------------------
+GLuint
+glRenderer::lookupVertexArray(drawState* ds) {
+    o_assert_dbg(this->valid);
+
+    // the VAO cache key: input meshes and their active vertex buffer slots,
+    // a re-created mesh has a new Id, and stream meshes rotate their slots
+    Id meshIds[DrawStateSetup::MaxInputMeshes];
+    uint8 vbSlots[DrawStateSetup::MaxInputMeshes] = { };
+    for (int32 i = 0; i < DrawStateSetup::MaxInputMeshes; i++) {
+        const mesh* msh = ds->meshes[i];
+        if (msh) {
+            meshIds[i] = msh->Id;
+            vbSlots[i] = msh->activeVertexBufferSlot;
+        }
+    }
+
+    // find a matching VAO, or a VAO for the same slots of meshes which
+    // have been re-created since, or a free cache entry
+    glDrawState::vao* entry = nullptr;
+    glDrawState::vao* staleEntry = nullptr;
+    for (int32 i = 0; i < ds->numVAOs; i++) {
+        glDrawState::vao& cur = ds->vaos[i];
+        if (0 == std::memcmp(cur.vbSlots, vbSlots, sizeof(vbSlots))) {
+            bool sameMeshes = true;
+            for (int32 meshIndex = 0; meshIndex < DrawStateSetup::MaxInputMeshes; meshIndex++) {
+                sameMeshes &= cur.meshIds[meshIndex] == meshIds[meshIndex];
+            }
+            if (sameMeshes) {
+                entry = &cur;
+                break;
+            }
+            staleEntry = &cur;
+        }
+    }
+    if (entry && (entry->generation == this->vaoGeneration)) {
+        return entry->glVAO;
+    }
+    if (nullptr == entry) {
+        if (staleEntry) {
+            entry = staleEntry;
+        }
+        else if (ds->numVAOs < glDrawState::MaxNumVAOs) {
+            entry = &ds->vaos[ds->numVAOs++];
+            ::glGenVertexArrays(1, &entry->glVAO);
+            ORYOL_GL_CHECK_ERROR();
+        }
+        else {
+            entry = &ds->vaos[ds->nextVAO];
+            ds->nextVAO = (ds->nextVAO + 1) % glDrawState::MaxNumVAOs;
+        }
+        for (int32 i = 0; i < DrawStateSetup::MaxInputMeshes; i++) {
+            entry->meshIds[i] = meshIds[i];
+            entry->vbSlots[i] = vbSlots[i];
+        }
+    }
+
+    // (re-)specify the vertex attributes and index buffer, the
+    // GL_ARRAY_BUFFER binding isn't VAO state and goes through the cache
+    this->bindVertexArray(entry->glVAO);
+    ::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ds->meshes[0]->glIndexBuffer);   // can be 0
+    ORYOL_GL_CHECK_ERROR();
+    for (int attrIndex = 0; attrIndex < VertexAttr::NumVertexAttrs; attrIndex++) {
+        const glVertexAttr& attr = ds->glAttrs[attrIndex];
+        if (attr.enabled) {
+            const mesh* msh = ds->meshes[attr.vbIndex];
+            this->bindVertexBuffer(msh->glVertexBuffers[msh->activeVertexBufferSlot]);
+            ::glVertexAttribPointer(attr.index, attr.size, attr.type, attr.normalized, attr.stride, (const GLvoid*)(GLintptr)attr.offset);
+            ::glEnableVertexAttribArray(attr.index);
+            glExt::VertexAttribDivisor(attr.index, attr.divisor);
+        }
+        else {
+            ::glDisableVertexAttribArray(attr.index);
+        }
+        ORYOL_GL_CHECK_ERROR();
+    }
+    entry->generation = this->vaoGeneration;
+    return entry->glVAO;
+}
+#endif
+
 //------------------------------------------------------------------------------
 void
 glRenderer::applyDrawState(drawState* ds) {
@@ -565,35 +768,200 @@ glRenderer::drawInstanced(int32 primGroupIndex, int32 numInstances) {
 }
 
 //------------------------------------------------------------------------------
-void
-glRenderer::updateVertices(mesh* msh, const void* data, int32 numBytes) {
-    o_assert_dbg(this->valid);
-    o_assert_dbg(nullptr != msh);
-    o_assert_dbg(nullptr != data);
-    o_assert_dbg(numBytes > 0);
-    
-    const VertexBufferAttrs& attrs = msh->vertexBufferAttrs;
-    const Usage::Code vbUsage = attrs.BufferUsage;
-    o_assert_dbg((numBytes > 0) && (numBytes <= attrs.ByteSize()));
-    o_assert_dbg((vbUsage == Usage::Stream) || (vbUsage == Usage::Dynamic) || (vbUsage == Usage::Static));
-    
+GLuint
+glRenderer::nextVertexBuffer(mesh* msh, bool& outIdle) {
+    outIdle = false;
     uint8 slotIndex = msh->activeVertexBufferSlot;
-    if (Usage::Stream == vbUsage) {
+    if (Usage::Stream == msh->vertexBufferAttrs.BufferUsage) {
         // if usage is streaming, rotate slot index to next dynamic vertex buffer
         // to implement double/multi-buffering
+        #if ORYOL_OPENGL_CORE_PROFILE
+        const uint8 prevSlotIndex = slotIndex;
+        #endif
         slotIndex++;
         if (slotIndex >= msh->numVertexBufferSlots) {
             slotIndex = 0;
         }
         msh->activeVertexBufferSlot = slotIndex;
+
+        #if ORYOL_OPENGL_CORE_PROFILE
+        if (prevSlotIndex != slotIndex) {
+            // all draws from the previous vertex buffer have been issued, fence it
+            GLsync& prevFence = msh->glVertexBufferFences[prevSlotIndex];
+            if (prevFence) {
+                ::glDeleteSync(prevFence);
+            }
+            prevFence = ::glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+            // check without waiting whether the GPU is done with the new vertex buffer
+            GLsync& fence = msh->glVertexBufferFences[slotIndex];
+            if (fence) {
+                const GLenum result = ::glClientWaitSync(fence, 0, 0);
+                outIdle = (GL_ALREADY_SIGNALED == result) || (GL_CONDITION_SATISFIED == result);
+                ::glDeleteSync(fence);
+                fence = nullptr;
+            }
+            ORYOL_GL_CHECK_ERROR();
+        }
+        #endif
     }
+    return msh->glVertexBuffers[slotIndex];
+}
+
+//------------------------------------------------------------------------------
+void
+glRenderer::updateVertices(mesh* msh, const void* data, int32 numBytes) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(nullptr != msh);
+    o_assert_dbg(nullptr != data);
+    o_assert_dbg(numBytes > 0);
+    o_assert_dbg(msh != this->mappedMesh);
     
-    GLuint vb = msh->glVertexBuffers[slotIndex];
+    o_assert_dbg((numBytes > 0) && (numBytes <= msh->vertexBufferAttrs.ByteSize()));
+    o_assert_dbg((msh->vertexBufferAttrs.BufferUsage == Usage::Stream) ||
+                 (msh->vertexBufferAttrs.BufferUsage == Usage::Dynamic) ||
+                 (msh->vertexBufferAttrs.BufferUsage == Usage::Static));
+    
+    bool idle = false;
+    GLuint vb = this->nextVertexBuffer(msh, idle);
     this->bindVertexBuffer(vb);
     ::glBufferSubData(GL_ARRAY_BUFFER, 0, numBytes, data);
     ORYOL_GL_CHECK_ERROR();
 }
 
+//------------------------------------------------------------------------------
+void
+glRenderer::updateVertices(mesh* msh, int32 offset, const void* data, int32 numBytes) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(nullptr != msh);
+    o_assert_dbg(nullptr != data);
+    o_assert_dbg(msh != this->mappedMesh);
+
+    o_assert_dbg((offset >= 0) && (numBytes > 0) && ((offset + numBytes) <= msh->vertexBufferAttrs.ByteSize()));
+    o_assert_dbg((msh->vertexBufferAttrs.BufferUsage == Usage::Stream) ||
+                 (msh->vertexBufferAttrs.BufferUsage == Usage::Dynamic) ||
+                 (msh->vertexBufferAttrs.BufferUsage == Usage::Static));
+
+    // a range update doesn't switch to the next stream vertex buffer,
+    // the rest of the current vertex buffer must stay valid
+    GLuint vb = msh->glVertexBuffers[msh->activeVertexBufferSlot];
+    this->bindVertexBuffer(vb);
+    ::glBufferSubData(GL_ARRAY_BUFFER, offset, numBytes, data);
+    ORYOL_GL_CHECK_ERROR();
+}
+
+//------------------------------------------------------------------------------
+void
+glRenderer::updateIndices(mesh* msh, int32 offset, const void* data, int32 numBytes) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(nullptr != msh);
+    o_assert_dbg(nullptr != data);
+
+    o_assert_dbg(0 != msh->glIndexBuffer);
+    o_assert_dbg((offset >= 0) && (numBytes > 0) && ((offset + numBytes) <= msh->indexBufferAttrs.ByteSize()));
+    o_assert_dbg((msh->indexBufferAttrs.BufferUsage == Usage::Stream) ||
+                 (msh->indexBufferAttrs.BufferUsage == Usage::Dynamic) ||
+                 (msh->indexBufferAttrs.BufferUsage == Usage::Static));
+
+    // the index buffer binding is VAO state, update through the global
+    // VAO and restore the current VAO afterwards
+    #if !ORYOL_OPENGLES2
+    const GLuint vao = this->curVAO;
+    this->bindVertexArray(this->globalVAO);
+    #endif
+    this->bindIndexBuffer(msh->glIndexBuffer);
+    ::glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, numBytes, data);
+    ORYOL_GL_CHECK_ERROR();
+    #if !ORYOL_OPENGLES2
+    this->bindVertexArray(vao);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void*
+glRenderer::mapVertices(mesh* msh, int32 maxNumBytes) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(nullptr != msh);
+    o_assert2_dbg(nullptr == this->mappedMesh, "mapVertices: another mesh is still mapped!\n");
+
+    o_assert_dbg((maxNumBytes > 0) && (maxNumBytes <= msh->vertexBufferAttrs.ByteSize()));
+    o_assert_dbg((msh->vertexBufferAttrs.BufferUsage == Usage::Stream) ||
+                 (msh->vertexBufferAttrs.BufferUsage == Usage::Dynamic) ||
+                 (msh->vertexBufferAttrs.BufferUsage == Usage::Static));
+
+    bool idle = false;
+    GLuint vb = this->nextVertexBuffer(msh, idle);
+    this->bindVertexBuffer(vb);
+    #if ORYOL_OPENGL_CORE_PROFILE
+    // if the GPU is done with the vertex buffer it is written without
+    // synchronization, otherwise its storage is orphaned instead of waiting
+    GLbitfield access = GL_MAP_WRITE_BIT;
+    if (idle) {
+        access |= GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+    }
+    else {
+        access |= GL_MAP_INVALIDATE_BUFFER_BIT;
+    }
+    void* ptr = ::glMapBufferRange(GL_ARRAY_BUFFER, 0, maxNumBytes, access);
+    ORYOL_GL_CHECK_ERROR();
+    o_assert_dbg(nullptr != ptr);
+    #else
+    // no buffer mapping without the Core Profile, hand out client
+    // memory which is uploaded in unmapVertices()
+    if (maxNumBytes > this->mapBufferSize) {
+        if (this->mapBuffer) {
+            Memory::Free(this->mapBuffer);
+        }
+        this->mapBuffer = (uint8*) Memory::Alloc(maxNumBytes);
+        this->mapBufferSize = maxNumBytes;
+    }
+    void* ptr = this->mapBuffer;
+    #endif
+    this->mappedMesh = msh;
+    this->mappedMaxBytes = maxNumBytes;
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+void
+glRenderer::unmapVertices(mesh* msh, int32 numBytes) {
+    o_assert_dbg(this->valid);
+    o_assert2_dbg(msh == this->mappedMesh, "unmapVertices: mesh is not mapped!\n");
+    o_assert_dbg((numBytes >= 0) && (numBytes <= this->mappedMaxBytes));
+
+    this->bindVertexBuffer(msh->glVertexBuffers[msh->activeVertexBufferSlot]);
+    #if ORYOL_OPENGL_CORE_PROFILE
+    if (GL_FALSE == ::glUnmapBuffer(GL_ARRAY_BUFFER)) {
+        o_warn("glRenderer::unmapVertices(): vertex buffer contents have been lost!\n");
+    }
+    #else
+    if (numBytes > 0) {
+        ::glBufferSubData(GL_ARRAY_BUFFER, 0, numBytes, this->mapBuffer);
+    }
+    #endif
+    ORYOL_GL_CHECK_ERROR();
+    this->mappedMesh = nullptr;
+    this->mappedMaxBytes = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+glRenderer::readPixelsRect(displayMgr* displayManager, int32& outWidth, int32& outHeight, PixelFormat::Code& outFormat) const {
+    if (nullptr == this->curRenderTarget) {
+        const DisplayAttrs& attrs = displayManager->GetDisplayAttrs();
+        outWidth  = attrs.FramebufferWidth;
+        outHeight = attrs.FramebufferHeight;
+        outFormat = attrs.ColorPixelFormat;
+    }
+    else {
+        const TextureAttrs& attrs = this->curRenderTarget->textureAttrs;
+        outWidth  = attrs.Width;
+        outHeight = attrs.Height;
+        outFormat = attrs.ColorFormat;
+    }
+    o_assert((outWidth & 3) == 0);
+}
+
 //------------------------------------------------------------------------------
 void
 glRenderer::readPixels(displayMgr* displayManager, void* buf, int32 bufNumBytes) {
@@ -601,28 +969,108 @@ glRenderer::readPixels(displayMgr* displayManager, void* buf, int32 bufNumBytes)
     o_assert_dbg(displayManager);
     o_assert_dbg((nullptr != buf) && (bufNumBytes > 0));
     
-    GLsizei width, height;
-    GLenum format, type;
-    if (nullptr == this->curRenderTarget) {
-        const DisplayAttrs& attrs = displayManager->GetDisplayAttrs();
-        width  = attrs.FramebufferWidth;
-        height = attrs.FramebufferHeight;
-        format = glTypes::AsGLTexImageFormat(attrs.ColorPixelFormat);
-        type   = glTypes::AsGLTexImageType(attrs.ColorPixelFormat);
-        o_assert((width & 3) == 0);
-        o_assert(bufNumBytes >= (width * height * PixelFormat::ByteSize(attrs.ColorPixelFormat)));
+    int32 width, height;
+    PixelFormat::Code format;
+    this->readPixelsRect(displayManager, width, height, format);
+    o_assert(bufNumBytes >= (width * height * PixelFormat::ByteSize(format)));
+    ::glReadPixels(0, 0, width, height, glTypes::AsGLTexImageFormat(format), glTypes::AsGLTexImageType(format), buf);
+    ORYOL_GL_CHECK_ERROR();
+}
+
+//------------------------------------------------------------------------------
+int32
+glRenderer::readPixelsAsync(displayMgr* displayManager, ReadPixelsCallback callback) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(displayManager);
+
+    int32 width, height;
+    PixelFormat::Code format;
+    this->readPixelsRect(displayManager, width, height, format);
+    const int32 slotIndex = this->readbackRing.alloc(width, height, format, callback);
+    if (InvalidIndex == slotIndex) {
+        o_warn("glRenderer::readPixelsAsync(): all readback buffers busy (GfxSetup::NumReadbackBuffers)\n");
+        return InvalidIndex;
+    }
+    const ReadPixelsAttrs& attrs = this->readbackRing.attrs(slotIndex);
+    const GLenum glFormat = glTypes::AsGLTexImageFormat(format);
+    const GLenum glType = glTypes::AsGLTexImageType(format);
+
+    #if ORYOL_OPENGL_CORE_PROFILE
+    // read into the slot's pixel pack buffer, this only queues the copy
+    // on the GPU, a fence tells when the pixels have arrived
+    o_assert_dbg(nullptr == this->readbackFences[slotIndex]);
+    ::glBindBuffer(GL_PIXEL_PACK_BUFFER, this->readbackBuffers[slotIndex]);
+    ::glBufferData(GL_PIXEL_PACK_BUFFER, attrs.ByteSize(), nullptr, GL_STREAM_READ);
+    ::glReadPixels(0, 0, width, height, glFormat, glType, 0);
+    ::glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    this->readbackFences[slotIndex] = ::glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    #else
+    // no pixel pack buffers, read synchronously into client memory
+    ::glReadPixels(0, 0, width, height, glFormat, glType, this->readbackRing.clientMemory(slotIndex));
+    #endif
+    ORYOL_GL_CHECK_ERROR();
+    return attrs.Ticket;
+}
+
+//------------------------------------------------------------------------------
+bool
+glRenderer::pollReadPixels(int32 ticket, void* buf, int32 bufNumBytes) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg((nullptr != buf) && (bufNumBytes > 0));
+
+    const int32 slotIndex = this->readbackRing.find(ticket);
+    o_assert2_dbg(InvalidIndex != slotIndex, "pollReadPixels: ticket is not pending!\n");
+    o_assert2_dbg(!this->readbackRing.callback(slotIndex), "pollReadPixels: ticket has a callback!\n");
+    o_assert_dbg(bufNumBytes >= this->readbackRing.attrs(slotIndex).ByteSize());
+    if (this->readbackReady(slotIndex)) {
+        this->finishReadback(slotIndex, buf);
+        return true;
     }
     else {
-        const TextureAttrs& attrs = this->curRenderTarget->textureAttrs;
-        width  = attrs.Width;
-        height = attrs.Height;
-        format = glTypes::AsGLTexImageFormat(attrs.ColorFormat);
-        type   = glTypes::AsGLTexImageType(attrs.ColorFormat);
-        o_assert((width & 3) == 0);
-        o_assert(bufNumBytes >= (width * height * PixelFormat::ByteSize(attrs.ColorFormat)));
-    }
-    ::glReadPixels(0, 0, width, height, format, type, buf);
+        return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+glRenderer::readbackReady(int32 slotIndex) const {
+    #if ORYOL_OPENGL_CORE_PROFILE
+    GLsync fence = this->readbackFences[slotIndex];
+    o_assert_dbg(nullptr != fence);
+    const GLenum result = ::glClientWaitSync(fence, 0, 0);
+    return (GL_ALREADY_SIGNALED == result) || (GL_CONDITION_SATISFIED == result);
+    #else
+    return true;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+glRenderer::finishReadback(int32 slotIndex, void* buf) {
+    const ReadPixelsAttrs& attrs = this->readbackRing.attrs(slotIndex);
+    const int32 numBytes = attrs.ByteSize();
+    #if ORYOL_OPENGL_CORE_PROFILE
+    ::glDeleteSync(this->readbackFences[slotIndex]);
+    this->readbackFences[slotIndex] = nullptr;
+    ::glBindBuffer(GL_PIXEL_PACK_BUFFER, this->readbackBuffers[slotIndex]);
+    const void* pixels = ::glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, numBytes, GL_MAP_READ_BIT);
     ORYOL_GL_CHECK_ERROR();
+    o_assert_dbg(nullptr != pixels);
+    #else
+    const void* pixels = this->readbackRing.clientMemory(slotIndex);
+    #endif
+    if (buf) {
+        Memory::Copy(pixels, buf, numBytes);
+    }
+    else {
+        this->readbackRing.callback(slotIndex)(attrs, pixels);
+    }
+    #if ORYOL_OPENGL_CORE_PROFILE
+    ::glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    ::glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    ORYOL_GL_CHECK_ERROR();
+    #endif
+    this->readbackRing.free(slotIndex);
 }
 
 //------------------------------------------------------------------------------
@@ -630,6 +1078,12 @@ void
 glRenderer::invalidateMeshState() {
     o_assert_dbg(this->valid);
 
+    // the index buffer binding is VAO state, switch back to the
+    // global VAO so that the cached VAOs are never modified
+    #if !ORYOL_OPENGLES2
+    this->bindVertexArray(this->globalVAO);
+    #endif
+
     ::glBindBuffer(GL_ARRAY_BUFFER, 0);
     ::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     this->vertexBuffer = 0;
@@ -656,6 +1110,9 @@ glRenderer::bindVertexBuffer(GLuint vb) {
 void
 glRenderer::bindIndexBuffer(GLuint ib) {
     o_assert_dbg(this->valid);
+    #if !ORYOL_OPENGLES2
+    o_assert_dbg(this->globalVAO == this->curVAO);
+    #endif
 
     if (ib != this->indexBuffer) {
         this->indexBuffer = ib;
@@ -962,6 +1419,25 @@ glRenderer::applyRasterizerState(const RasterizerState& newState) {
     ORYOL_GL_CHECK_ERROR();
 }
 
+//------------------------------------------------------------------------------
+#if ORYOL_OPENGL_CORE_PROFILE
+/**
+    Copy the shadow data of a uniform ring binding into its range of
+    the uniform buffer, and bind the range to the binding point.
+*/
+void
+glRenderer::uploadUniformBinding(int32 bindIndex) {
+    const gfxUniformRing::binding& b = this->uniformRing.bindingAt(bindIndex);
+    void* dst = ::glMapBufferRange(GL_UNIFORM_BUFFER, b.offset, b.dataSize,
+        GL_MAP_WRITE_BIT|GL_MAP_INVALIDATE_RANGE_BIT|GL_MAP_UNSYNCHRONIZED_BIT);
+    o_assert_dbg(dst);
+    std::memcpy(dst, b.data, b.dataSize);
+    ::glUnmapBuffer(GL_UNIFORM_BUFFER);
+    ::glBindBufferRange(GL_UNIFORM_BUFFER, bindIndex, this->uniformBuffer, b.offset, b.numBytes);
+    ORYOL_GL_CHECK_ERROR();
+}
+#endif
+
 //------------------------------------------------------------------------------
 void
 glRenderer::applyUniformBlock(int32 blockIndex, int64 layoutHash, const uint8* ptr, int32 byteSize) {
@@ -983,10 +1459,44 @@ glRenderer::applyUniformBlock(int32 blockIndex, int64 layoutHash, const uint8* p
     o_assert2(layout.TypeHash == layoutHash, "incompatible uniform block!\n");
     o_assert_dbg(layout.ByteSize() == byteSize);
 
+    // if the uniform block is a std140 uniform block in the shader, copy
+    // the uniform data into the uniform buffer ring and bind the range
+    // to the block's binding point, only the textures (which are at
+    // the start of the struct) must then be applied one by one
+    bool texturesOnly = false;
+    #if ORYOL_OPENGL_CORE_PROFILE
+    const int32 uniformBufferSize = prog->getUniformBufferSize(blockIndex);
+    if (uniformBufferSize > 0) {
+        const int32 uniformBytes = layout.ByteSizeWithoutTextures();
+        bool wrapped = false;
+        this->uniformRing.allocBinding(blockIndex, uniformBufferSize, ptr + (byteSize - uniformBytes), uniformBytes, wrapped);
+        if (wrapped) {
+            // orphan the buffer storage, draws in flight keep the old storage,
+            // and ranges are never written twice until the next wrap, so
+            // the mapping doesn't need to synchronize; the ranges of the
+            // other bound blocks are gone with the old storage, the ring
+            // has moved them, so upload them again from their shadow copies
+            ::glBufferData(GL_UNIFORM_BUFFER, this->uniformRing.size(), nullptr, GL_STREAM_DRAW);
+            for (int32 bindIndex = 0; bindIndex < gfxUniformRing::MaxNumBindings; bindIndex++) {
+                if (this->uniformRing.isBound(bindIndex)) {
+                    this->uploadUniformBinding(bindIndex);
+                }
+            }
+        }
+        else {
+            this->uploadUniformBinding(blockIndex);
+        }
+        texturesOnly = true;
+    }
+    #endif
+
     // for each uniform in the uniform block:
     const int numComps = layout.NumComponents();
     for (int compIndex = 0; compIndex < numComps; compIndex++) {
         const auto& comp = layout.ComponentAt(compIndex);
+        if (texturesOnly && (comp.Type != UniformType::Texture)) {
+            continue;
+        }
         const uint8* valuePtr = ptr + layout.ComponentByteOffset(compIndex);
         GLint glLoc = prog->getUniformLocation(blockIndex, compIndex);
         switch (comp.Type) {
@@ -10,12 +10,19 @@
 #include "Gfx/Core/DepthStencilState.h"
 #include "Gfx/Core/RasterizerState.h"
 #include "Gfx/Core/PrimitiveGroup.h"
+#include "Gfx/Core/gfxUniformRing.h"
+#include "Core/Containers/Array.h"
+#include "Gfx/Core/gfxReadbackRing.h"
 #include "Gfx/Attrs/DisplayAttrs.h"
 #include "Gfx/gl/gl_decl.h"
 #include "Gfx/gl/glVertexAttr.h"
 #include "glm/vec4.hpp"
 
 namespace Oryol {
+
+class GfxSetup;
+class GfxFrameStats;
+
 namespace _priv {
 
 class meshPool;
@@ -34,7 +41,7 @@ public:
     ~glRenderer();
     
     /// setup the renderer
-    void setup(displayMgr* dispMgr, meshPool* mshPool, texturePool* texPool);
+    void setup(const GfxSetup& setup, displayMgr* dispMgr, meshPool* mshPool, texturePool* texPool);
     /// discard the renderer
     void discard();
     /// return true if renderer has been setup
@@ -46,6 +53,8 @@ public:
     bool supports(GfxFeature::Code feat) const;
     /// commit current frame
     void commitFrame();
+    /// add renderer statistics of the current frame
+    void addFrameStats(GfxFrameStats& stats) const;
     /// get the current render target attributes
     const DisplayAttrs& renderTargetAttrs() const;
 
@@ -71,8 +80,20 @@ public:
     void drawInstanced(const PrimitiveGroup& primGroup, int32 numInstances);
     /// update vertex data
     void updateVertices(mesh* msh, const void* data, int32 numBytes);
+    /// update a range of vertex data in place
+    void updateVertices(mesh* msh, int32 offset, const void* data, int32 numBytes);
+    /// update a range of index data in place
+    void updateIndices(mesh* msh, int32 offset, const void* data, int32 numBytes);
+    /// map vertex data for writing
+    void* mapVertices(mesh* msh, int32 maxNumBytes);
+    /// unmap vertex data, numBytes have been written
+    void unmapVertices(mesh* msh, int32 numBytes);
     /// read pixels back from framebuffer, causes a PIPELINE STALL!!!
     void readPixels(displayMgr* displayManager, void* buf, int32 bufNumBytes);
+    /// queue an asynchronous pixel readback, returns ticket or InvalidIndex
+    int32 readPixelsAsync(displayMgr* displayManager, ReadPixelsCallback callback);
+    /// poll an asynchronous pixel readback, returns true if pixels have been copied
+    bool pollReadPixels(int32 ticket, void* buf, int32 bufNumBytes);
     
     /// invalidate bound mesh state
     void invalidateMeshState();
@@ -109,7 +130,25 @@ private:
     /// apply program to use for rendering
     void applyProgramBundle(programBundle* progBundle, uint32 progSelMask);
     /// apply mesh state
-    void applyMeshState(const drawState* ds);
+    void applyMeshState(drawState* ds);
+    /// switch a stream mesh to its next vertex buffer, outIdle is true if the GPU is done with it
+    GLuint nextVertexBuffer(mesh* msh, bool& outIdle);
+    /// get size and pixel format of the current render target for reading pixels
+    void readPixelsRect(displayMgr* displayManager, int32& outWidth, int32& outHeight, PixelFormat::Code& outFormat) const;
+    /// return true if the pixels of an async readback have arrived (doesn't wait)
+    bool readbackReady(int32 slotIndex) const;
+    /// deliver the pixels of an async readback to buf, or to its callback if buf is null
+    void finishReadback(int32 slotIndex, void* buf);
+    #if ORYOL_OPENGL_CORE_PROFILE
+    /// upload a uniform ring binding from its shadow copy and bind its range
+    void uploadUniformBinding(int32 bindIndex);
+    #endif
+    #if !ORYOL_OPENGLES2
+    /// invoke glBindVertexArray (if changed)
+    void bindVertexArray(GLuint vao);
+    /// get the cached VAO of a draw state for its current vertex buffers, create or re-specify if needed
+    GLuint lookupVertexArray(drawState* ds);
+    #endif
 
     bool valid;
     displayMgr* dispMgr;
@@ -117,6 +156,12 @@ private:
     texturePool* texPool;
     #if !ORYOL_OPENGLES2
     GLuint globalVAO;
+    GLuint curVAO;
+    uint32 vaoGeneration;       // bumped by resetStateCache() to re-specify all cached VAOs
+    #endif
+    #if ORYOL_OPENGL_CORE_PROFILE
+    GLuint uniformBuffer;
+    gfxUniformRing uniformRing;
     #endif
 
     static GLenum mapCompareFunc[CompareFunc::NumCompareFuncs];
@@ -158,6 +203,19 @@ private:
     GLuint samplersCube[MaxTextureSamplers];
     glVertexAttr glAttrs[VertexAttr::NumVertexAttrs];
     GLuint glAttrVBs[VertexAttr::NumVertexAttrs];
+
+    gfxReadbackRing readbackRing;
+    #if ORYOL_OPENGL_CORE_PROFILE
+    Array<GLuint> readbackBuffers;      // one pixel pack buffer per readback slot
+    Array<GLsync> readbackFences;
+    #endif
+
+    mesh* mappedMesh;
+    int32 mappedMaxBytes;
+    #if !ORYOL_OPENGL_CORE_PROFILE
+    uint8* mapBuffer;           // client memory for mapVertices() without glMapBufferRange
+    int32 mapBufferSize;
+    #endif
 };
 
 //------------------------------------------------------------------------------
@@ -22,5 +22,6 @@ typedef float GLclampf;
 typedef double GLdouble;
 typedef double GLclampd;
 typedef void GLvoid;
+typedef struct __GLsync *GLsync;
 #endif
 
@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------
+//  nullMeshFactory.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "nullMeshFactory.h"
+#include "Gfx/Resource/resourcePools.h"
+#include "Gfx/Resource/mesh.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+nullMeshFactory::nullMeshFactory() :
+isValid(false) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+nullMeshFactory::~nullMeshFactory() {
+    o_assert_dbg(!this->isValid);
+}
+
+//------------------------------------------------------------------------------
+void
+nullMeshFactory::Setup(class renderer* rendr, class meshPool* mshPool) {
+    o_assert_dbg(!this->isValid);
+    o_assert_dbg(nullptr != rendr);
+    o_assert_dbg(nullptr != mshPool);
+    this->isValid = true;
+}
+
+//------------------------------------------------------------------------------
+void
+nullMeshFactory::Discard() {
+    o_assert_dbg(this->isValid);
+    this->isValid = false;
+}
+
+//------------------------------------------------------------------------------
+bool
+nullMeshFactory::IsValid() const {
+    return this->isValid;
+}
+
+//------------------------------------------------------------------------------
+ResourceState::Code
+nullMeshFactory::SetupResource(mesh& msh) {
+    o_assert_dbg(this->isValid);
+    if (msh.Setup.ShouldSetupEmpty()) {
+        o_assert_dbg(0 < msh.Setup.NumVertices);
+        this->setupAttrs(msh);
+        return ResourceState::Valid;
+    }
+    else if (msh.Setup.ShouldSetupFullScreenQuad()) {
+        this->setupFullscreenQuadAttrs(msh);
+        return ResourceState::Valid;
+    }
+    else {
+        o_error("nullMeshFactory::SetupResource(): don't know how to create mesh!");
+        return ResourceState::InvalidState;
+    }
+}
+
+//------------------------------------------------------------------------------
+ResourceState::Code
+nullMeshFactory::SetupResource(mesh& msh, const void* data, int32 size) {
+    o_assert_dbg(this->isValid);
+    o_assert_dbg(msh.Setup.ShouldSetupFromData());
+    o_assert_dbg(nullptr != data);
+    o_assert_dbg(size > 0);
+
+    #if ORYOL_DEBUG
+    const MeshSetup& setup = msh.Setup;
+    const int32 verticesByteSize = setup.NumVertices * setup.Layout.ByteSize();
+    o_assert_dbg(size >= (setup.DataVertexOffset + verticesByteSize));
+    if (setup.IndicesType != IndexType::None) {
+        o_assert_dbg(setup.DataIndexOffset != InvalidIndex);
+        o_assert_dbg(setup.DataIndexOffset >= verticesByteSize);
+        o_assert_dbg(size >= (setup.DataIndexOffset + setup.NumIndices * IndexType::ByteSize(setup.IndicesType)));
+    }
+    #endif
+    this->setupAttrs(msh);
+    return ResourceState::Valid;
+}
+
+//------------------------------------------------------------------------------
+void
+nullMeshFactory::DestroyResource(mesh& msh) {
+    o_assert_dbg(this->isValid);
+    msh.Clear();
+}
+
+//------------------------------------------------------------------------------
+void
+nullMeshFactory::setupAttrs(mesh& msh) {
+    const MeshSetup& setup = msh.Setup;
+
+    VertexBufferAttrs vbAttrs;
+    vbAttrs.NumVertices = setup.NumVertices;
+    vbAttrs.Layout = setup.Layout;
+    vbAttrs.BufferUsage = setup.VertexUsage;
+    vbAttrs.StepFunction = setup.StepFunction;
+    vbAttrs.StepRate = setup.StepRate;
+    msh.vertexBufferAttrs = vbAttrs;
+
+    IndexBufferAttrs ibAttrs;
+    ibAttrs.NumIndices = setup.NumIndices;
+    ibAttrs.Type = setup.IndicesType;
+    ibAttrs.BufferUsage = setup.IndexUsage;
+    msh.indexBufferAttrs = ibAttrs;
+
+    msh.numPrimGroups = setup.NumPrimitiveGroups();
+    o_assert_dbg(msh.numPrimGroups < mesh::MaxNumPrimGroups);
+    for (int32 i = 0; i < msh.numPrimGroups; i++) {
+        msh.primGroups[i] = setup.PrimitiveGroup(i);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+nullMeshFactory::setupFullscreenQuadAttrs(mesh& msh) {
+    VertexBufferAttrs vbAttrs;
+    vbAttrs.NumVertices = 4;
+    vbAttrs.BufferUsage = Usage::Immutable;
+    vbAttrs.Layout.Add(VertexAttr::Position, VertexFormat::Float3);
+    vbAttrs.Layout.Add(VertexAttr::TexCoord0, VertexFormat::Float2);
+    vbAttrs.StepFunction = VertexStepFunction::PerVertex;
+    vbAttrs.StepRate = 1;
+    msh.vertexBufferAttrs = vbAttrs;
+
+    IndexBufferAttrs ibAttrs;
+    ibAttrs.NumIndices = 6;
+    ibAttrs.Type = IndexType::Index16;
+    ibAttrs.BufferUsage = Usage::Immutable;
+    msh.indexBufferAttrs = ibAttrs;
+
+    msh.numPrimGroups = 1;
+    msh.primGroups[0] = PrimitiveGroup(PrimitiveType::Triangles, 0, 6);
+}
+
+} // namespace _priv
+} // namespace Oryol
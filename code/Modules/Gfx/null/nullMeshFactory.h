@@ -0,0 +1,52 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::nullMeshFactory
+    @ingroup _priv
+    @brief null-backend implementation of meshFactory
+
+    Sets up the mesh attributes and primitive groups like the real
+    mesh factories, but doesn't create any vertex or index buffers.
+*/
+#include "Resource/ResourceState.h"
+#include "Core/Types.h"
+
+namespace Oryol {
+namespace _priv {
+
+class renderer;
+class meshPool;
+class mesh;
+
+class nullMeshFactory {
+public:
+    /// constructor
+    nullMeshFactory();
+    /// destructor
+    ~nullMeshFactory();
+
+    /// setup with a pointer to the state wrapper object
+    void Setup(renderer* rendr, meshPool* mshPool);
+    /// discard the factory
+    void Discard();
+    /// return true if the object has been setup
+    bool IsValid() const;
+
+    /// setup resource
+    ResourceState::Code SetupResource(mesh& msh);
+    /// setup with 'raw' data
+    ResourceState::Code SetupResource(mesh& msh, const void* data, int32 size);
+    /// discard the resource
+    void DestroyResource(mesh& msh);
+
+private:
+    /// setup mesh attributes from the mesh setup object
+    void setupAttrs(mesh& msh);
+    /// setup mesh attributes for a fullscreen quad
+    void setupFullscreenQuadAttrs(mesh& msh);
+
+    bool isValid;
+};
+
+} // namespace _priv
+} // namespace Oryol
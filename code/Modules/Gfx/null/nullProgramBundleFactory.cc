@@ -0,0 +1,65 @@
+//------------------------------------------------------------------------------
+//  nullProgramBundleFactory.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "nullProgramBundleFactory.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+nullProgramBundleFactory::nullProgramBundleFactory() :
+isValid(false) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+nullProgramBundleFactory::~nullProgramBundleFactory() {
+    o_assert_dbg(!this->isValid);
+}
+
+//------------------------------------------------------------------------------
+void
+nullProgramBundleFactory::Setup(class renderer* rendr, shaderPool* shdPool, shaderFactory* shdFactory) {
+    o_assert_dbg(!this->isValid);
+    o_assert_dbg(nullptr != rendr);
+    o_assert_dbg(nullptr != shdPool);
+    o_assert_dbg(nullptr != shdFactory);
+    this->isValid = true;
+}
+
+//------------------------------------------------------------------------------
+void
+nullProgramBundleFactory::Discard() {
+    o_assert_dbg(this->isValid);
+    this->isValid = false;
+}
+
+//------------------------------------------------------------------------------
+bool
+nullProgramBundleFactory::IsValid() const {
+    return this->isValid;
+}
+
+//------------------------------------------------------------------------------
+/**
+ NOTE: generated shader libraries only contain GLSL sources or HLSL
+ byte code, so a program bundle may contain no programs at all when
+ compiled for the null backend. The uniform block layouts, which is
+ what the null renderer checks against, are always there.
+*/
+ResourceState::Code
+nullProgramBundleFactory::SetupResource(programBundle& progBundle) {
+    o_assert_dbg(this->isValid);
+    return ResourceState::Valid;
+}
+
+//------------------------------------------------------------------------------
+void
+nullProgramBundleFactory::DestroyResource(programBundle& progBundle) {
+    o_assert_dbg(this->isValid);
+    progBundle.Clear();
+}
+
+} // namespace _priv
+} // namespace Oryol
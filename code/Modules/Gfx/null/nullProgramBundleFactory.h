@@ -0,0 +1,42 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::nullProgramBundleFactory
+    @ingroup _priv
+    @brief private: null-backend implementation of programBundleFactory
+*/
+#include "Resource/ResourceState.h"
+#include "Gfx/Resource/programBundle.h"
+
+namespace Oryol {
+namespace _priv {
+
+class renderer;
+class shaderPool;
+class shaderFactory;
+
+class nullProgramBundleFactory {
+public:
+    /// constructor
+    nullProgramBundleFactory();
+    /// destructor
+    ~nullProgramBundleFactory();
+
+    /// setup with a pointer to the state wrapper object
+    void Setup(class renderer* rendr, shaderPool* shdPool, shaderFactory* shdFactory);
+    /// discard the factory
+    void Discard();
+    /// return true if the object has been setup
+    bool IsValid() const;
+
+    /// setup programBundle resource (nothing is compiled or linked)
+    ResourceState::Code SetupResource(programBundle& progBundle);
+    /// destroy the programBundle
+    void DestroyResource(programBundle& progBundle);
+
+private:
+    bool isValid;
+};
+
+} // namespace _priv
+} // namespace Oryol
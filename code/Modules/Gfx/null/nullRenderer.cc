@@ -0,0 +1,394 @@
+//------------------------------------------------------------------------------
+//  nullRenderer.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "nullRenderer.h"
+#include "Core/Memory/Memory.h"
+#include "Gfx/Core/displayMgr.h"
+#include "Gfx/Resource/resourcePools.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+nullRenderer::nullRenderer() :
+valid(false),
+dispMgr(nullptr),
+mshPool(nullptr),
+texPool(nullptr),
+rtValid(false),
+curRenderTarget(nullptr),
+curDrawState(nullptr),
+viewPortX(0),
+viewPortY(0),
+viewPortWidth(0),
+viewPortHeight(0),
+scissorX(0),
+scissorY(0),
+scissorWidth(0),
+scissorHeight(0),
+mappedMesh(nullptr),
+mappedMaxBytes(0),
+mapBuffer(nullptr),
+mapBufferSize(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+nullRenderer::~nullRenderer() {
+    o_assert_dbg(!this->valid);
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::setup(const GfxSetup& setup, displayMgr* dispMgr_, meshPool* mshPool_, texturePool* texPool_) {
+    o_assert_dbg(!this->valid);
+    o_assert_dbg(dispMgr_);
+    o_assert_dbg(mshPool_);
+    o_assert_dbg(texPool_);
+
+    this->valid = true;
+    this->dispMgr = dispMgr_;
+    this->mshPool = mshPool_;
+    this->texPool = texPool_;
+    this->readbackRing.setup(setup.NumReadbackBuffers);
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::discard() {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(nullptr == this->mappedMesh);
+
+    this->readbackRing.discard();
+    if (this->mapBuffer) {
+        Memory::Free(this->mapBuffer);
+        this->mapBuffer = nullptr;
+        this->mapBufferSize = 0;
+    }
+
+    this->curRenderTarget = nullptr;
+    this->curDrawState = nullptr;
+    this->texPool = nullptr;
+    this->mshPool = nullptr;
+    this->dispMgr = nullptr;
+    this->valid = false;
+}
+
+//------------------------------------------------------------------------------
+bool
+nullRenderer::isValid() const {
+    return this->valid;
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::resetStateCache() {
+    o_assert_dbg(this->valid);
+    this->curDrawState = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+nullRenderer::supports(GfxFeature::Code feat) const {
+    o_assert_dbg(this->valid);
+
+    switch (feat) {
+        case GfxFeature::TextureFloat:
+        case GfxFeature::TextureHalfFloat:
+        case GfxFeature::Instancing:
+            return true;
+        default:
+            return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::commitFrame() {
+    o_assert_dbg(this->valid);
+    this->rtValid = false;
+    this->curRenderTarget = nullptr;
+
+    // deliver pending async readbacks with callback, oldest first
+    const int32 numSlots = this->readbackRing.numSlots();
+    int32 slotIndex = this->readbackRing.oldest();
+    for (int32 i = 0; (i < numSlots) && (InvalidIndex != slotIndex); i++) {
+        const ReadPixelsAttrs& attrs = this->readbackRing.attrs(slotIndex);
+        if ((InvalidIndex != attrs.Ticket) && this->readbackRing.callback(slotIndex)) {
+            this->readbackRing.callback(slotIndex)(attrs, this->readbackRing.clientMemory(slotIndex));
+            this->readbackRing.free(slotIndex);
+        }
+        slotIndex = (slotIndex + 1) % numSlots;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::addFrameStats(GfxFrameStats& /*stats*/) const {
+    // no renderer-side statistics
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::applyRenderTarget(texture* rt) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(this->dispMgr);
+
+    if (nullptr == rt) {
+        this->rtAttrs = this->dispMgr->GetDisplayAttrs();
+    }
+    else {
+        const TextureAttrs& attrs = rt->textureAttrs;
+        o_assert_dbg(attrs.IsRenderTarget);
+        this->rtAttrs.WindowWidth = attrs.Width;
+        this->rtAttrs.WindowHeight = attrs.Height;
+        this->rtAttrs.WindowPosX = 0;
+        this->rtAttrs.WindowPosY = 0;
+        this->rtAttrs.FramebufferWidth = attrs.Width;
+        this->rtAttrs.FramebufferHeight = attrs.Height;
+        this->rtAttrs.ColorPixelFormat = attrs.ColorFormat;
+        this->rtAttrs.DepthPixelFormat = attrs.DepthFormat;
+        this->rtAttrs.Samples = 1;
+        this->rtAttrs.Windowed = false;
+        this->rtAttrs.SwapInterval = 1;
+    }
+    this->curRenderTarget = rt;
+    this->rtValid = true;
+    this->applyViewPort(0, 0, this->rtAttrs.FramebufferWidth, this->rtAttrs.FramebufferHeight);
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::applyViewPort(int32 x, int32 y, int32 width, int32 height) {
+    o_assert_dbg(this->valid);
+    this->viewPortX = x;
+    this->viewPortY = y;
+    this->viewPortWidth = width;
+    this->viewPortHeight = height;
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::applyScissorRect(int32 x, int32 y, int32 width, int32 height) {
+    o_assert_dbg(this->valid);
+    this->scissorX = x;
+    this->scissorY = y;
+    this->scissorWidth = width;
+    this->scissorHeight = height;
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::applyDrawState(drawState* ds) {
+    o_assert_dbg(this->valid);
+
+    // a nullptr means the draw state has not been loaded yet, invalidate rendering
+    if (ds) {
+        o_assert_dbg(ds->prog);
+        o_assert_dbg(ds->meshes[0]);
+    }
+    this->curDrawState = ds;
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::applyUniformBlock(int32 blockIndex, int64 layoutHash, const uint8* ptr, int32 byteSize) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(0 != layoutHash);
+    o_assert_dbg(nullptr != ptr);
+    if (!this->curDrawState) {
+        // currently no valid draw state set
+        return;
+    }
+
+    // same type-compatibility checks as the real renderers
+    const programBundle* prog = this->curDrawState->prog;
+    o_assert_dbg(prog);
+    const UniformLayout& layout = prog->Setup.UniformBlockLayout(blockIndex);
+    o_assert2(layout.TypeHash == layoutHash, "incompatible uniform block!\n");
+    o_assert_dbg(layout.ByteSize() == byteSize);
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::clear(ClearTarget::Mask clearMask, const glm::vec4& /*color*/, float32 /*depth*/, uint8 /*stencil*/) {
+    o_assert_dbg(this->valid);
+    o_assert2_dbg(this->rtValid, "No render target set!\n");
+    o_assert2_dbg((clearMask & ClearTarget::All) != 0, "No clear flags set (note that this has changed from PixelChannel)\n");
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::draw(const PrimitiveGroup& primGroup) {
+    o_assert_dbg(this->valid);
+    o_assert2_dbg(this->rtValid, "No render target set!");
+    if (nullptr == this->curDrawState) {
+        return;
+    }
+    o_assert_dbg(this->curDrawState->meshes[0]);
+    o_assert_dbg(primGroup.NumElements >= 0);
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::draw(int32 primGroupIndex) {
+    o_assert_dbg(this->valid);
+    o_assert2_dbg(this->rtValid, "No render target set!");
+    if (nullptr == this->curDrawState) {
+        return;
+    }
+    o_assert_dbg(this->curDrawState->meshes[0]);
+    if (primGroupIndex >= this->curDrawState->meshes[0]->numPrimGroups) {
+        // same as the real renderers, rendering a placeholder is not an error
+        return;
+    }
+    this->draw(this->curDrawState->meshes[0]->primGroups[primGroupIndex]);
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::drawInstanced(const PrimitiveGroup& primGroup, int32 numInstances) {
+    o_assert_dbg(numInstances >= 0);
+    this->draw(primGroup);
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::drawInstanced(int32 primGroupIndex, int32 numInstances) {
+    o_assert_dbg(numInstances >= 0);
+    this->draw(primGroupIndex);
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::updateVertices(mesh* msh, const void* data, int32 numBytes) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(nullptr != msh);
+    o_assert_dbg(nullptr != data);
+
+    o_assert_dbg((numBytes > 0) && (numBytes <= msh->vertexBufferAttrs.ByteSize()));
+    o_assert_dbg((msh->vertexBufferAttrs.BufferUsage == Usage::Stream) ||
+                 (msh->vertexBufferAttrs.BufferUsage == Usage::Dynamic) ||
+                 (msh->vertexBufferAttrs.BufferUsage == Usage::Static));
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::updateVertices(mesh* msh, int32 offset, const void* data, int32 numBytes) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(nullptr != msh);
+    o_assert_dbg(nullptr != data);
+    o_assert_dbg(msh != this->mappedMesh);
+
+    o_assert_dbg((offset >= 0) && (numBytes > 0) && ((offset + numBytes) <= msh->vertexBufferAttrs.ByteSize()));
+    o_assert_dbg((msh->vertexBufferAttrs.BufferUsage == Usage::Stream) ||
+                 (msh->vertexBufferAttrs.BufferUsage == Usage::Dynamic) ||
+                 (msh->vertexBufferAttrs.BufferUsage == Usage::Static));
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::updateIndices(mesh* msh, int32 offset, const void* data, int32 numBytes) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(nullptr != msh);
+    o_assert_dbg(nullptr != data);
+
+    o_assert_dbg(IndexType::None != msh->indexBufferAttrs.Type);
+    o_assert_dbg((offset >= 0) && (numBytes > 0) && ((offset + numBytes) <= msh->indexBufferAttrs.ByteSize()));
+    o_assert_dbg((msh->indexBufferAttrs.BufferUsage == Usage::Stream) ||
+                 (msh->indexBufferAttrs.BufferUsage == Usage::Dynamic) ||
+                 (msh->indexBufferAttrs.BufferUsage == Usage::Static));
+}
+
+//------------------------------------------------------------------------------
+void*
+nullRenderer::mapVertices(mesh* msh, int32 maxNumBytes) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(nullptr != msh);
+    o_assert2_dbg(nullptr == this->mappedMesh, "mapVertices: another mesh is still mapped!\n");
+
+    o_assert_dbg((maxNumBytes > 0) && (maxNumBytes <= msh->vertexBufferAttrs.ByteSize()));
+    o_assert_dbg((msh->vertexBufferAttrs.BufferUsage == Usage::Stream) ||
+                 (msh->vertexBufferAttrs.BufferUsage == Usage::Dynamic) ||
+                 (msh->vertexBufferAttrs.BufferUsage == Usage::Static));
+
+    if (maxNumBytes > this->mapBufferSize) {
+        if (this->mapBuffer) {
+            Memory::Free(this->mapBuffer);
+        }
+        this->mapBuffer = (uint8*) Memory::Alloc(maxNumBytes);
+        this->mapBufferSize = maxNumBytes;
+    }
+    this->mappedMesh = msh;
+    this->mappedMaxBytes = maxNumBytes;
+    return this->mapBuffer;
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::unmapVertices(mesh* msh, int32 numBytes) {
+    o_assert_dbg(this->valid);
+    o_assert2_dbg(msh == this->mappedMesh, "unmapVertices: mesh is not mapped!\n");
+    o_assert_dbg((numBytes >= 0) && (numBytes <= this->mappedMaxBytes));
+    this->mappedMesh = nullptr;
+    this->mappedMaxBytes = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+nullRenderer::readPixels(displayMgr* displayManager, void* buf, int32 bufNumBytes) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(displayManager);
+    o_assert_dbg((nullptr != buf) && (bufNumBytes > 0));
+    Memory::Clear(buf, bufNumBytes);
+}
+
+//------------------------------------------------------------------------------
+int32
+nullRenderer::readPixelsAsync(displayMgr* displayManager, ReadPixelsCallback callback) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(displayManager);
+
+    int32 width, height;
+    PixelFormat::Code format;
+    if (nullptr == this->curRenderTarget) {
+        const DisplayAttrs& attrs = displayManager->GetDisplayAttrs();
+        width  = attrs.FramebufferWidth;
+        height = attrs.FramebufferHeight;
+        format = attrs.ColorPixelFormat;
+    }
+    else {
+        const TextureAttrs& attrs = this->curRenderTarget->textureAttrs;
+        width  = attrs.Width;
+        height = attrs.Height;
+        format = attrs.ColorFormat;
+    }
+    const int32 slotIndex = this->readbackRing.alloc(width, height, format, callback);
+    if (InvalidIndex == slotIndex) {
+        o_warn("nullRenderer::readPixelsAsync(): all readback buffers busy (GfxSetup::NumReadbackBuffers)\n");
+        return InvalidIndex;
+    }
+    const ReadPixelsAttrs& attrs = this->readbackRing.attrs(slotIndex);
+    Memory::Clear(this->readbackRing.clientMemory(slotIndex), attrs.ByteSize());
+    return attrs.Ticket;
+}
+
+//------------------------------------------------------------------------------
+bool
+nullRenderer::pollReadPixels(int32 ticket, void* buf, int32 bufNumBytes) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg((nullptr != buf) && (bufNumBytes > 0));
+
+    const int32 slotIndex = this->readbackRing.find(ticket);
+    o_assert2_dbg(InvalidIndex != slotIndex, "pollReadPixels: ticket is not pending!\n");
+    o_assert2_dbg(!this->readbackRing.callback(slotIndex), "pollReadPixels: ticket has a callback!\n");
+    const ReadPixelsAttrs& attrs = this->readbackRing.attrs(slotIndex);
+    o_assert_dbg(bufNumBytes >= attrs.ByteSize());
+    Memory::Copy(this->readbackRing.clientMemory(slotIndex), buf, attrs.ByteSize());
+    this->readbackRing.free(slotIndex);
+    return true;
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,134 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::nullRenderer
+    @ingroup _priv
+    @brief renderer which doesn't need a GPU
+
+    The null renderer validates and tracks state like a real renderer
+    (current render target, draw state, view port, uniform block
+    layouts, ...) but doesn't render anything. It is used for headless
+    testing and to profile draw submission overhead on machines
+    without a GPU (e.g. CI boxes).
+*/
+#include "Core/Types.h"
+#include "Gfx/Core/Enums.h"
+#include "Gfx/Core/PrimitiveGroup.h"
+#include "Gfx/Attrs/DisplayAttrs.h"
+#include "Gfx/Core/gfxReadbackRing.h"
+#include "glm/vec4.hpp"
+
+namespace Oryol {
+
+class GfxSetup;
+class GfxFrameStats;
+
+namespace _priv {
+
+class meshPool;
+class texturePool;
+class displayMgr;
+class texture;
+class drawState;
+class mesh;
+
+class nullRenderer {
+public:
+    /// constructor
+    nullRenderer();
+    /// destructor
+    ~nullRenderer();
+
+    /// setup the renderer
+    void setup(const GfxSetup& setup, displayMgr* dispMgr, meshPool* mshPool, texturePool* texPool);
+    /// discard the renderer
+    void discard();
+    /// return true if renderer has been setup
+    bool isValid() const;
+
+    /// reset the internal state cache
+    void resetStateCache();
+    /// test if a feature is supported
+    bool supports(GfxFeature::Code feat) const;
+    /// commit current frame
+    void commitFrame();
+    /// add renderer statistics of the current frame
+    void addFrameStats(GfxFrameStats& stats) const;
+    /// get the current render target attributes
+    const DisplayAttrs& renderTargetAttrs() const;
+
+    /// apply a render target (default or offscreen)
+    void applyRenderTarget(texture* rt);
+    /// apply viewport
+    void applyViewPort(int32 x, int32 y, int32 width, int32 height);
+    /// apply scissor rect
+    void applyScissorRect(int32 x, int32 y, int32 width, int32 height);
+    /// apply draw state
+    void applyDrawState(drawState* ds);
+    /// apply a shader uniform block
+    void applyUniformBlock(int32 blockIndex, int64 layoutHash, const uint8* ptr, int32 byteSize);
+    /// clear currently assigned render target
+    void clear(ClearTarget::Mask clearMask, const glm::vec4& color, float32 depth, uint8 stencil);
+    /// submit a draw call with primitive group index in current mesh
+    void draw(int32 primGroupIndex);
+    /// submit a draw call with direct primitive group
+    void draw(const PrimitiveGroup& primGroup);
+    /// submit a draw call for instanced rendering with primitive group index in current mesh
+    void drawInstanced(int32 primGroupIndex, int32 numInstances);
+    /// submit a draw call for instanced rendering with direct primitive group
+    void drawInstanced(const PrimitiveGroup& primGroup, int32 numInstances);
+    /// update vertex data
+    void updateVertices(mesh* msh, const void* data, int32 numBytes);
+    /// update a range of vertex data in place
+    void updateVertices(mesh* msh, int32 offset, const void* data, int32 numBytes);
+    /// update a range of index data in place
+    void updateIndices(mesh* msh, int32 offset, const void* data, int32 numBytes);
+    /// map vertex data for writing
+    void* mapVertices(mesh* msh, int32 maxNumBytes);
+    /// unmap vertex data, numBytes have been written
+    void unmapVertices(mesh* msh, int32 numBytes);
+    /// read pixels back from framebuffer (always returns black pixels)
+    void readPixels(displayMgr* displayManager, void* buf, int32 bufNumBytes);
+    /// queue an asynchronous pixel readback (always returns black pixels)
+    int32 readPixelsAsync(displayMgr* displayManager, ReadPixelsCallback callback);
+    /// poll an asynchronous pixel readback, returns true if pixels have been copied
+    bool pollReadPixels(int32 ticket, void* buf, int32 bufNumBytes);
+
+private:
+    bool valid;
+    displayMgr* dispMgr;
+    meshPool* mshPool;
+    texturePool* texPool;
+
+    bool rtValid;
+    DisplayAttrs rtAttrs;
+    texture* curRenderTarget;
+    drawState* curDrawState;
+
+    int32 viewPortX;
+    int32 viewPortY;
+    int32 viewPortWidth;
+    int32 viewPortHeight;
+    int32 scissorX;
+    int32 scissorY;
+    int32 scissorWidth;
+    int32 scissorHeight;
+
+    // mapVertices() hands out a client memory buffer
+    mesh* mappedMesh;
+    int32 mappedMaxBytes;
+    uint8* mapBuffer;
+    int32 mapBufferSize;
+
+    // async readback pixels are available immediately in client memory
+    gfxReadbackRing readbackRing;
+};
+
+//------------------------------------------------------------------------------
+inline const DisplayAttrs&
+nullRenderer::renderTargetAttrs() const {
+    return this->rtAttrs;
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,59 @@
+//------------------------------------------------------------------------------
+//  nullShaderFactory.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "nullShaderFactory.h"
+#include "Gfx/Resource/shader.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+nullShaderFactory::nullShaderFactory() :
+isValid(false) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+nullShaderFactory::~nullShaderFactory() {
+    o_assert_dbg(!this->isValid);
+}
+
+//------------------------------------------------------------------------------
+void
+nullShaderFactory::Setup(class renderer* rendr) {
+    o_assert_dbg(!this->isValid);
+    o_assert_dbg(nullptr != rendr);
+    this->isValid = true;
+}
+
+//------------------------------------------------------------------------------
+void
+nullShaderFactory::Discard() {
+    o_assert_dbg(this->isValid);
+    this->isValid = false;
+}
+
+//------------------------------------------------------------------------------
+bool
+nullShaderFactory::IsValid() const {
+    return this->isValid;
+}
+
+//------------------------------------------------------------------------------
+ResourceState::Code
+nullShaderFactory::SetupResource(shader& shd) {
+    o_assert_dbg(this->isValid);
+    shd.shaderType = shd.Setup.Type;
+    return ResourceState::Valid;
+}
+
+//------------------------------------------------------------------------------
+void
+nullShaderFactory::DestroyResource(shader& shd) {
+    o_assert_dbg(this->isValid);
+    shd.Clear();
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,40 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::nullShaderFactory
+    @ingroup _priv
+    @brief private: null-backend implementation of shaderFactory
+*/
+#include "Resource/ResourceState.h"
+
+namespace Oryol {
+namespace _priv {
+
+class shader;
+class renderer;
+
+class nullShaderFactory {
+public:
+    /// constructor
+    nullShaderFactory();
+    /// destructor
+    ~nullShaderFactory();
+
+    /// setup the factory
+    void Setup(renderer* rendr);
+    /// discard the factory
+    void Discard();
+    /// return true if the object has been setup
+    bool IsValid() const;
+
+    /// setup shader resource (nothing is compiled)
+    ResourceState::Code SetupResource(shader& shd);
+    /// destroy the shader
+    void DestroyResource(shader& shd);
+
+private:
+    bool isValid;
+};
+
+} // namespace _priv
+} // namespace Oryol
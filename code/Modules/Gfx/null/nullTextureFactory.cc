@@ -0,0 +1,166 @@
+//------------------------------------------------------------------------------
+//  nullTextureFactory.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "nullTextureFactory.h"
+#include "Gfx/Resource/resourcePools.h"
+#include "Gfx/Core/displayMgr.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+nullTextureFactory::nullTextureFactory() :
+displayManager(nullptr),
+texPool(nullptr),
+isValid(false) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+nullTextureFactory::~nullTextureFactory() {
+    o_assert_dbg(!this->isValid);
+}
+
+//------------------------------------------------------------------------------
+void
+nullTextureFactory::Setup(class renderer* rendr, displayMgr* displayMgr, texturePool* texPool_) {
+    o_assert_dbg(!this->isValid);
+    o_assert_dbg(nullptr != rendr);
+    o_assert_dbg(nullptr != displayMgr);
+    o_assert_dbg(nullptr != texPool_);
+
+    this->isValid = true;
+    this->displayManager = displayMgr;
+    this->texPool = texPool_;
+}
+
+//------------------------------------------------------------------------------
+void
+nullTextureFactory::Discard() {
+    o_assert_dbg(this->isValid);
+
+    this->isValid = false;
+    this->displayManager = nullptr;
+    this->texPool = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+nullTextureFactory::IsValid() const {
+    return this->isValid;
+}
+
+//------------------------------------------------------------------------------
+ResourceState::Code
+nullTextureFactory::SetupResource(texture& tex) {
+    o_assert_dbg(this->isValid);
+    o_assert_dbg(!tex.Setup.ShouldSetupFromPixelData());
+    o_assert_dbg(!tex.Setup.ShouldSetupFromFile());
+
+    if (tex.Setup.ShouldSetupAsRenderTarget()) {
+        return this->createRenderTarget(tex);
+    }
+    else {
+        return ResourceState::InvalidState;
+    }
+}
+
+//------------------------------------------------------------------------------
+ResourceState::Code
+nullTextureFactory::SetupResource(texture& tex, const void* data, int32 size) {
+    o_assert_dbg(this->isValid);
+    o_assert_dbg(!tex.Setup.ShouldSetupAsRenderTarget());
+    o_assert_dbg(!tex.Setup.ShouldSetupFromFile());
+
+    if (tex.Setup.ShouldSetupFromPixelData()) {
+        return this->createFromPixelData(tex, data, size);
+    }
+    else {
+        return ResourceState::InvalidState;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+nullTextureFactory::DestroyResource(texture& tex) {
+    o_assert_dbg(this->isValid);
+    tex.Clear();
+}
+
+//------------------------------------------------------------------------------
+ResourceState::Code
+nullTextureFactory::createRenderTarget(texture& tex) {
+    const TextureSetup& setup = tex.Setup;
+    o_assert_dbg(setup.NumMipMaps == 1);
+    o_assert_dbg(setup.Type == TextureType::Texture2D);
+    o_assert_dbg(PixelFormat::IsValidRenderTargetColorFormat(setup.ColorFormat));
+
+    // get size of new render target
+    int32 width, height;
+    if (setup.IsRelSizeRenderTarget()) {
+        const DisplayAttrs& dispAttrs = this->displayManager->GetDisplayAttrs();
+        width = int32(dispAttrs.FramebufferWidth * setup.RelWidth);
+        height = int32(dispAttrs.FramebufferHeight * setup.RelHeight);
+    }
+    else if (setup.HasSharedDepth()) {
+        const texture* sharedDepthProvider = this->texPool->Lookup(setup.DepthRenderTarget);
+        o_assert_dbg(nullptr != sharedDepthProvider);
+        width = sharedDepthProvider->textureAttrs.Width;
+        height = sharedDepthProvider->textureAttrs.Height;
+    }
+    else {
+        width = setup.Width;
+        height = setup.Height;
+    }
+    o_assert_dbg((width > 0) && (height > 0));
+
+    TextureAttrs attrs;
+    attrs.Locator = setup.Locator;
+    attrs.Type = TextureType::Texture2D;
+    attrs.ColorFormat = setup.ColorFormat;
+    attrs.DepthFormat = setup.DepthFormat;
+    attrs.TextureUsage = Usage::Immutable;
+    attrs.Width = width;
+    attrs.Height = height;
+    attrs.NumMipMaps = 1;
+    attrs.IsRenderTarget = true;
+    attrs.HasDepthBuffer = setup.HasDepth();
+    attrs.HasSharedDepthBuffer = setup.HasSharedDepth();
+    tex.textureAttrs = attrs;
+
+    return ResourceState::Valid;
+}
+
+//------------------------------------------------------------------------------
+ResourceState::Code
+nullTextureFactory::createFromPixelData(texture& tex, const void* data, int32 size) {
+    o_assert_dbg(nullptr != data);
+    o_assert_dbg(size > 0);
+
+    const TextureSetup& setup = tex.Setup;
+    #if ORYOL_DEBUG
+    const int32 numFaces = setup.Type == TextureType::TextureCube ? 6 : 1;
+    for (int32 faceIndex = 0; faceIndex < numFaces; faceIndex++) {
+        for (int32 mipIndex = 0; mipIndex < setup.NumMipMaps; mipIndex++) {
+            o_assert_dbg(setup.ImageSizes[faceIndex][mipIndex] > 0);
+            o_assert_dbg((setup.ImageOffsets[faceIndex][mipIndex] + setup.ImageSizes[faceIndex][mipIndex]) <= size);
+        }
+    }
+    #endif
+
+    TextureAttrs attrs;
+    attrs.Locator = setup.Locator;
+    attrs.Type = setup.Type;
+    attrs.ColorFormat = setup.ColorFormat;
+    attrs.TextureUsage = Usage::Immutable;
+    attrs.Width = setup.Width;
+    attrs.Height = setup.Height;
+    attrs.NumMipMaps = setup.NumMipMaps;
+    tex.textureAttrs = attrs;
+
+    return ResourceState::Valid;
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,54 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::nullTextureFactory
+    @ingroup _priv
+    @brief private: null-backend implementation of textureFactory
+
+    Sets up the texture attributes like the real texture factories,
+    but doesn't create any texture objects.
+*/
+#include "Resource/ResourceState.h"
+#include "Gfx/Resource/texture.h"
+
+namespace Oryol {
+namespace _priv {
+
+class renderer;
+class displayMgr;
+class texturePool;
+
+class nullTextureFactory {
+public:
+    /// constructor
+    nullTextureFactory();
+    /// destructor
+    ~nullTextureFactory();
+
+    /// setup with a pointer to the state wrapper object
+    void Setup(class renderer* rendr, displayMgr* displayMgr, texturePool* texPool);
+    /// discard the factory
+    void Discard();
+    /// return true if the object has been setup
+    bool IsValid() const;
+
+    /// setup resource
+    ResourceState::Code SetupResource(texture& tex);
+    /// setup with input data
+    ResourceState::Code SetupResource(texture& tex, const void* data, int32 size);
+    /// discard the resource
+    void DestroyResource(texture& tex);
+
+private:
+    /// setup a render target
+    ResourceState::Code createRenderTarget(texture& tex);
+    /// setup texture from raw pixel data
+    ResourceState::Code createFromPixelData(texture& tex, const void* data, int32 size);
+
+    displayMgr* displayManager;
+    texturePool* texPool;
+    bool isValid;
+};
+
+} // namespace _priv
+} // namespace Oryol
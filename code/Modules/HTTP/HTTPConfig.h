@@ -0,0 +1,17 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file HTTPConfig.h
+    @ingroup HTTP
+    @brief Configuration defines for the Oryol HTTP module.
+*/
+#include "IO/Core/IOConfig.h"
+
+/// max number of transfers in flight per HTTPClient (only curl_multi loader)
+#define ORYOL_HTTP_MAX_TRANSFERS (64)
+/// max number of parallel connections to the same host (only curl_multi loader)
+#define ORYOL_HTTP_MAX_HOST_CONNECTIONS (6)
+/// max number of idle keep-alive connections kept in the pool (only curl_multi loader)
+#define ORYOL_HTTP_CONNECTION_POOL_SIZE (16)
+/// max time in milliseconds DoWork() waits for network activity while transfers are in flight
+#define ORYOL_HTTP_WAIT_TIMEOUT (5)
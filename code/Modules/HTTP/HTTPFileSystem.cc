@@ -38,11 +38,27 @@ HTTPFileSystem::onRequest(const Ptr<IOProtocol::Request>& msg) {
         httpReq->SetMethod(HTTPMethod::Get);
         httpReq->SetURL(msg->GetURL());
         httpReq->SetIoRequest(msg);
-        if (msg->GetEndOffset() != 0) {
+        const bool isRanged = (0 != msg->GetStartOffset()) || (0 != msg->GetEndOffset());
+        const bool isConditional = msg->GetIfNoneMatch().IsValid() || msg->GetIfModifiedSince().IsValid();
+        if (isRanged || isConditional) {
             Map<String,String> reqHeaders = this->requestHeaders;
-            // need to add a Range header
-            this->stringBuilder.Format(64, "bytes=%d-%d", msg->GetStartOffset(), msg->GetEndOffset());
-            reqHeaders.Add("Range", this->stringBuilder.GetString());
+            if (isRanged) {
+                // need to add a Range header, EndOffset is the last byte, or 0 for 'until end'
+                if (0 != msg->GetEndOffset()) {
+                    this->stringBuilder.Format(64, "bytes=%d-%d", msg->GetStartOffset(), msg->GetEndOffset());
+                }
+                else {
+                    this->stringBuilder.Format(64, "bytes=%d-", msg->GetStartOffset());
+                }
+                reqHeaders.Add("Range", this->stringBuilder.GetString());
+            }
+            // conditional request from IOCache revalidation, answered with 304 if unchanged
+            if (msg->GetIfNoneMatch().IsValid()) {
+                reqHeaders.Add("If-None-Match", msg->GetIfNoneMatch());
+            }
+            if (msg->GetIfModifiedSince().IsValid()) {
+                reqHeaders.Add("If-Modified-Since", msg->GetIfModifiedSince());
+            }
             httpReq->SetRequestHeaders(reqHeaders);
         }
         else {
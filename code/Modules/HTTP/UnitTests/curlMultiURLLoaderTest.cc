@@ -0,0 +1,315 @@
+//------------------------------------------------------------------------------
+//  curlMultiURLLoaderTest.cc
+//  Test the curl_multi HTTP loader against a local HTTP server.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/String/StringBuilder.h"
+#include "HTTP/HTTPClient.h"
+#include "HTTP/HTTPFileSystem.h"
+#include "HTTP/HTTPConfig.h"
+#include "IO/IO.h"
+#include "IO/Stream/ChunkedStream.h"
+
+#if ORYOL_USE_LIBCURL && ORYOL_USE_LIBCURL_MULTI
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cstring>
+#include <cstdio>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <string>
+
+using namespace Oryol;
+
+namespace {
+
+const int32 dataSize = 100000;
+
+uint8
+dataByte(int32 i) {
+    return uint8((i * 7) + (i >> 8));
+}
+
+// a minimal HTTP/1.1 server with keep-alive and Range support:
+//  /data       - dataSize bytes
+//  /norange    - the same bytes, but ignores the Range header
+//  everything else is 404
+class testServer {
+public:
+    std::atomic<int32> delayMilliSec{0};
+    std::atomic<int32> numConnections{0};
+    std::atomic<int32> numRequests{0};
+    std::atomic<int32> maxConcurrent{0};
+
+    /// start listening on a free port on the loopback interface
+    uint16 start() {
+        this->listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(this->listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        bind(this->listenFd, (sockaddr*)&addr, sizeof(addr));
+        listen(this->listenFd, 64);
+        socklen_t len = sizeof(addr);
+        getsockname(this->listenFd, (sockaddr*)&addr, &len);
+        this->acceptThread = std::thread([this] { this->acceptLoop(); });
+        return ntohs(addr.sin_port);
+    }
+    /// stop the server and close all connections
+    void stop() {
+        shutdown(this->listenFd, SHUT_RDWR);
+        close(this->listenFd);
+        this->acceptThread.join();
+        {
+            std::lock_guard<std::mutex> lock(this->connLock);
+            for (int fd : this->connFds) {
+                shutdown(fd, SHUT_RDWR);
+            }
+        }
+        for (auto& t : this->connThreads) {
+            t.join();
+        }
+        for (int fd : this->connFds) {
+            close(fd);
+        }
+    }
+
+private:
+    void acceptLoop() {
+        while (true) {
+            int fd = accept(this->listenFd, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+            this->numConnections++;
+            std::lock_guard<std::mutex> lock(this->connLock);
+            this->connFds.push_back(fd);
+            this->connThreads.push_back(std::thread([this, fd] { this->serve(fd); }));
+        }
+    }
+    void serve(int fd) {
+        std::string buf;
+        char recvBuf[4096];
+        while (true) {
+            size_t endOfHeader;
+            while (std::string::npos == (endOfHeader = buf.find("\r\n\r\n"))) {
+                ssize_t num = recv(fd, recvBuf, sizeof(recvBuf), 0);
+                if (num <= 0) {
+                    return;
+                }
+                buf.append(recvBuf, num);
+            }
+            const std::string header = buf.substr(0, endOfHeader);
+            buf.erase(0, endOfHeader + 4);
+            this->numRequests++;
+
+            const int32 cur = ++this->concurrent;
+            int32 max = this->maxConcurrent.load();
+            while ((cur > max) && !this->maxConcurrent.compare_exchange_weak(max, cur)) { }
+            if (this->delayMilliSec > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(this->delayMilliSec));
+            }
+            this->concurrent--;
+
+            std::string response = this->respond(header);
+            if (send(fd, response.data(), response.size(), MSG_NOSIGNAL) < 0) {
+                return;
+            }
+        }
+    }
+    std::string respond(const std::string& header) {
+        const size_t pathStart = header.find(' ') + 1;
+        const std::string path = header.substr(pathStart, header.find(' ', pathStart) - pathStart);
+        char line[256];
+        if ((path != "/data") && (path != "/norange")) {
+            const char* body = "not found";
+            std::snprintf(line, sizeof(line), "HTTP/1.1 404 Not Found\r\nContent-Length: %d\r\n\r\n", int(std::strlen(body)));
+            return std::string(line) + body;
+        }
+        int32 first = 0;
+        int32 last = dataSize - 1;
+        bool ranged = false;
+        const size_t rangePos = header.find("Range: bytes=");
+        if ((std::string::npos != rangePos) && (path == "/data")) {
+            ranged = true;
+            const char* range = header.c_str() + rangePos + 13;
+            first = std::atoi(range);
+            const char* dash = std::strchr(range, '-');
+            if (dash[1] >= '0' && dash[1] <= '9') {
+                last = std::atoi(dash + 1);
+            }
+        }
+        std::string response;
+        if (ranged) {
+            std::snprintf(line, sizeof(line), "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes %d-%d/%d\r\n", first, last, dataSize);
+        }
+        else {
+            std::snprintf(line, sizeof(line), "HTTP/1.1 200 OK\r\n");
+        }
+        response = line;
+        std::snprintf(line, sizeof(line), "Content-Type: application/octet-stream\r\nContent-Length: %d\r\n\r\n", last - first + 1);
+        response += line;
+        for (int32 i = first; i <= last; i++) {
+            response += char(dataByte(i));
+        }
+        return response;
+    }
+
+    int listenFd = -1;
+    std::atomic<int32> concurrent{0};
+    std::thread acceptThread;
+    std::mutex connLock;
+    std::vector<int> connFds;
+    std::vector<std::thread> connThreads;
+};
+
+// check that a stream contains the test data at an offset
+bool
+checkData(const Ptr<Stream>& stream, int32 offset, int32 size) {
+    if (!stream.isValid() || (stream->Size() != size)) {
+        return false;
+    }
+    std::vector<uint8> buf(size + 1);
+    stream->Open(OpenMode::ReadOnly);
+    bool valid = stream->Read(buf.data(), size + 1) == size;
+    stream->Close();
+    for (int32 i = 0; valid && (i < size); i++) {
+        valid = buf[i] == dataByte(offset + i);
+    }
+    return valid;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(curlMultiURLLoaderTest) {
+    testServer server;
+    server.delayMilliSec = 50;
+    const uint16 port = server.start();
+    StringBuilder strBuilder;
+
+    // many requests in flight at once
+    Ptr<HTTPClient> httpClient = HTTPClient::Create();
+    const int32 numRequests = 24;
+    Array<Ptr<HTTPProtocol::HTTPRequest>> requests;
+    strBuilder.Format(64, "http://127.0.0.1:%d/data", port);
+    for (int32 i = 0; i < numRequests; i++) {
+        Ptr<HTTPProtocol::HTTPRequest> req = HTTPProtocol::HTTPRequest::Create();
+        req->SetURL(strBuilder.GetString());
+        httpClient->Put(req);
+        requests.Add(req);
+    }
+    Ptr<HTTPProtocol::HTTPRequest> req404 = HTTPProtocol::HTTPRequest::Create();
+    strBuilder.Format(64, "http://127.0.0.1:%d/blargh", port);
+    req404->SetURL(strBuilder.GetString());
+    httpClient->Put(req404);
+
+    bool allHandled = false;
+    while (!allHandled) {
+        httpClient->DoWork();
+        allHandled = req404->Handled();
+        for (const auto& req : requests) {
+            allHandled &= req->Handled();
+        }
+    }
+    int32 numValid = 0;
+    for (const auto& req : requests) {
+        if (req->GetResponse().isValid() && (req->GetResponse()->GetStatus() == IOStatus::OK) &&
+            checkData(req->GetResponse()->GetBody(), 0, dataSize)) {
+            numValid++;
+        }
+    }
+    CHECK(numValid == numRequests);
+    CHECK(requests[0]->GetResponse()->GetResponseHeaders()["Content-Type"] == "application/octet-stream");
+    CHECK(requests[0]->GetResponse()->GetBody()->GetContentType().TypeAndSubType() == "application/octet-stream");
+    CHECK(req404->GetResponse()->GetStatus() == IOStatus::NotFound);
+
+    // transfers ran concurrently over a limited number of connections
+    CHECK(server.maxConcurrent > 1);
+    CHECK(server.numConnections <= ORYOL_HTTP_MAX_HOST_CONNECTIONS);
+    CHECK(server.numRequests == numRequests + 1);
+
+    // follow-up requests reuse the pooled keep-alive connections
+    const int32 numConnections = server.numConnections;
+    server.delayMilliSec = 0;
+    Ptr<HTTPProtocol::HTTPRequest> req = HTTPProtocol::HTTPRequest::Create();
+    strBuilder.Format(64, "http://127.0.0.1:%d/data", port);
+    req->SetURL(strBuilder.GetString());
+    httpClient->Put(req);
+    while (!req->Handled()) {
+        httpClient->DoWork();
+    }
+    CHECK(req->GetResponse()->GetStatus() == IOStatus::OK);
+    CHECK(server.numConnections == numConnections);
+
+    httpClient = nullptr;
+    server.stop();
+}
+
+//------------------------------------------------------------------------------
+TEST(curlMultiURLLoaderRangeTest) {
+    testServer server;
+    const uint16 port = server.start();
+    StringBuilder strBuilder;
+
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("http", HTTPFileSystem::Creator());
+    IO::Setup(ioSetup);
+
+    auto load = [&](const char* path, int32 startOffset, int32 endOffset, const Ptr<ChunkedStream>& progressive) {
+        Ptr<IOProtocol::Request> req = IOProtocol::Request::Create();
+        strBuilder.Format(64, "http://127.0.0.1:%d%s", port, path);
+        req->SetURL(strBuilder.GetString());
+        req->SetStartOffset(startOffset);
+        req->SetEndOffset(endOffset);
+        req->SetProgressiveStream(progressive);
+        IO::Put(req);
+        while (!req->Handled()) {
+            Core::PreRunLoop()->Run();
+        }
+        return req;
+    };
+
+    // EndOffset is the last byte of the range
+    Ptr<IOProtocol::Request> req = load("/data", 1000, 1999, nullptr);
+    CHECK(req->GetStatus() == IOStatus::OK);
+    CHECK(checkData(req->GetStream(), 1000, 1000));
+
+    // an EndOffset of 0 means 'until end'
+    req = load("/data", dataSize - 100, 0, nullptr);
+    CHECK(req->GetStatus() == IOStatus::OK);
+    CHECK(checkData(req->GetStream(), dataSize - 100, 100));
+
+    // a server which ignores the Range header
+    req = load("/norange", 5000, 5099, nullptr);
+    CHECK(req->GetStatus() == IOStatus::OK);
+    CHECK(checkData(req->GetStream(), 5000, 100));
+
+    // a progressive request is streamed into the ChunkedStream
+    Ptr<ChunkedStream> progressive = ChunkedStream::Create(4096);
+    req = load("/data", 0, 0, progressive);
+    CHECK(req->GetStatus() == IOStatus::OK);
+    CHECK(progressive->IsComplete() && !progressive->IsFailed());
+    CHECK(checkData(progressive, 0, dataSize));
+
+    // ...and fails without data on an error response
+    progressive = ChunkedStream::Create(4096);
+    req = load("/blargh", 0, 0, progressive);
+    CHECK(req->GetStatus() == IOStatus::NotFound);
+    CHECK(progressive->IsFailed());
+    CHECK(progressive->AvailableSize() == 0);
+
+    IO::Discard();
+    server.stop();
+}
+#endif
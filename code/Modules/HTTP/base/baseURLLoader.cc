@@ -3,6 +3,7 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "baseURLLoader.h"
+#include <cctype>
 
 namespace Oryol {
 namespace _priv {
@@ -28,18 +29,58 @@ baseURLLoader::handleCancelled(const Ptr<HTTPProtocol::HTTPRequest>& httpReq) {
     if (ioReq.isValid()) {
         if (ioReq->Cancelled()) {
             ioReq->SetStatus(IOStatus::Cancelled);
-            ioReq->Handled();
+            ioReq->SetHandled();
             httpReq->SetCancelled();
-            httpReq->Handled();
+            httpReq->SetHandled();
             return true;
         }
     }
     if (httpReq->Cancelled()) {
-        httpReq->Handled();
+        httpReq->SetHandled();
         return true;
     }
     return false;
 }
 
+//------------------------------------------------------------------------------
+void
+baseURLLoader::transferToIoRequest(const Ptr<HTTPProtocol::HTTPRequest>& httpReq) {
+    const auto& ioReq = httpReq->GetIoRequest();
+    if (ioReq.isValid()) {
+        const auto& httpResponse = httpReq->GetResponse();
+        const bool isRanged = (0 != ioReq->GetStartOffset()) || (0 != ioReq->GetEndOffset());
+        if (isRanged && (IOStatus::PartialContent == httpResponse->GetStatus())) {
+            // same status as a ranged request to a local filesystem
+            ioReq->SetStatus(IOStatus::OK);
+        }
+        else {
+            ioReq->SetStatus(httpResponse->GetStatus());
+        }
+        ioReq->SetStream(httpResponse->GetBody());
+        ioReq->SetErrorDesc(httpResponse->GetErrorDesc());
+        // cache validators for the IOCache
+        const Map<String, String>& headers = httpResponse->GetResponseHeaders();
+        ioReq->SetETag(findResponseHeader(headers, "ETag"));
+        ioReq->SetLastModified(findResponseHeader(headers, "Last-Modified"));
+        ioReq->SetHandled();
+    }
+}
+
+//------------------------------------------------------------------------------
+String
+baseURLLoader::findResponseHeader(const Map<String, String>& headers, const char* name) {
+    for (const auto& kvp : headers) {
+        const char* key = kvp.Key().AsCStr();
+        int32 i = 0;
+        while (name[i] && (std::tolower((unsigned char)key[i]) == std::tolower((unsigned char)name[i]))) {
+            i++;
+        }
+        if ((0 == name[i]) && (0 == key[i])) {
+            return kvp.Value();
+        }
+    }
+    return String();
+}
+
 } // namespace _priv
 } // namespace Oryol
\ No newline at end of file
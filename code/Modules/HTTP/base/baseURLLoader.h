@@ -22,6 +22,10 @@ public:
 protected:
     /// handle cancelled messages, return true if was handled
     bool handleCancelled(const Ptr<HTTPProtocol::HTTPRequest>& req);
+    /// transfer the response to the embedded IoRequest and set it to handled
+    static void transferToIoRequest(const Ptr<HTTPProtocol::HTTPRequest>& req);
+    /// lookup a response header with case-insensitive name, return empty string if not found
+    static String findResponseHeader(const Map<String, String>& headers, const char* name);
 
     Queue<Ptr<HTTPProtocol::HTTPRequest>> requestQueue;
 };
@@ -0,0 +1,403 @@
+//------------------------------------------------------------------------------
+//  curlMultiURLLoader.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "curlMultiURLLoader.h"
+#include "IO/Stream/MemoryStream.h"
+#include "Core/String/StringConverter.h"
+#include "curl/curl.h"
+#include <cstring>
+#include <cstdlib>
+
+#if LIBCURL_VERSION_NUM != 0x072400
+#error "Not using the right curl version, header search path fuckup?"
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+bool curlMultiURLLoader::curlInitCalled = false;
+std::mutex curlMultiURLLoader::curlInitMutex;
+
+//------------------------------------------------------------------------------
+curlMultiURLLoader::curlMultiURLLoader() :
+contentTypeString("Content-Type"),
+multiHandle(0) {
+
+    // one-time curl initialization, thread-protected because
+    // curl_global_init() is not thread-safe
+    curlInitMutex.lock();
+    if (!curlInitCalled) {
+        CURLcode curlInitRes = curl_global_init(CURL_GLOBAL_ALL);
+        o_assert(0 == curlInitRes);
+        curlInitCalled = true;
+    }
+    curlInitMutex.unlock();
+
+    // the multi handle owns the connection cache which is shared
+    // by all transfers
+    this->multiHandle = curl_multi_init();
+    o_assert(0 != this->multiHandle);
+    curl_multi_setopt(this->multiHandle, CURLMOPT_MAXCONNECTS, long(ORYOL_HTTP_CONNECTION_POOL_SIZE));
+    curl_multi_setopt(this->multiHandle, CURLMOPT_MAX_HOST_CONNECTIONS, long(ORYOL_HTTP_MAX_HOST_CONNECTIONS));
+}
+
+//------------------------------------------------------------------------------
+curlMultiURLLoader::~curlMultiURLLoader() {
+    while (!this->transfers.Empty()) {
+        this->discardTransfer(this->transfers.Back());
+    }
+    for (void* easyHandle : this->freeEasyHandles) {
+        curl_easy_cleanup(easyHandle);
+    }
+    this->freeEasyHandles.Clear();
+    curl_multi_cleanup(this->multiHandle);
+    this->multiHandle = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+curlMultiURLLoader::doWork() {
+    this->abortCancelledTransfers();
+
+    // start new transfers
+    while (!this->requestQueue.Empty() && (this->transfers.Size() < ORYOL_HTTP_MAX_TRANSFERS)) {
+        Ptr<HTTPProtocol::HTTPRequest> req = this->requestQueue.Dequeue();
+        if (!baseURLLoader::handleCancelled(req)) {
+            this->startTransfer(req);
+        }
+    }
+    if (this->transfers.Empty()) {
+        return;
+    }
+
+    // advance all transfers, if nothing finished, wait a little
+    // while for network activity and try again
+    for (int32 pass = 0; pass < 2; pass++) {
+        int numRunning = 0;
+        while (CURLM_CALL_MULTI_PERFORM == curl_multi_perform(this->multiHandle, &numRunning)) {
+            // curl wants to be called again right away
+        }
+        bool anyFinished = false;
+        int numMsgsLeft = 0;
+        CURLMsg* msg = nullptr;
+        while ((msg = curl_multi_info_read(this->multiHandle, &numMsgsLeft))) {
+            if (CURLMSG_DONE == msg->msg) {
+                transfer* t = nullptr;
+                curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &t);
+                o_assert_dbg(t);
+                this->finishTransfer(t, msg->data.result);
+                anyFinished = true;
+            }
+        }
+        if (anyFinished || this->transfers.Empty() || (1 == pass)) {
+            break;
+        }
+        int numFds = 0;
+        curl_multi_wait(this->multiHandle, nullptr, 0, ORYOL_HTTP_WAIT_TIMEOUT, &numFds);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+curlMultiURLLoader::startTransfer(const Ptr<HTTPProtocol::HTTPRequest>& req) {
+    transfer* t = Memory::New<transfer>();
+    t->loader = this;
+    t->req = req;
+
+    // reuse a previous easy handle if possible
+    if (this->freeEasyHandles.Empty()) {
+        t->easyHandle = curl_easy_init();
+        o_assert(0 != t->easyHandle);
+    }
+    else {
+        t->easyHandle = this->freeEasyHandles.Back();
+        this->freeEasyHandles.Erase(this->freeEasyHandles.Size() - 1);
+    }
+    CURL* curl = t->easyHandle;
+
+    // setup the error buffer
+    const int32 curlErrorBufferSize = CURL_ERROR_SIZE * 4;
+    t->error = (char*) Memory::Alloc(curlErrorBufferSize);
+    Memory::Clear(t->error, curlErrorBufferSize);
+
+    // set transfer options
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, t);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1L);
+    curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, t->error);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curlWriteDataCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, t);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curlHeaderCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEHEADER, t);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE, 10L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, 10L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 30L);
+    curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");   // all encodings supported by curl
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+
+    // set URL in curl
+    const URL& url = req->GetURL();
+    o_assert(url.Scheme() == "http");
+    curl_easy_setopt(curl, CURLOPT_URL, url.AsCStr());
+    if (url.HasPort()) {
+        uint16 port = StringConverter::FromString<uint16>(url.Port());
+        curl_easy_setopt(curl, CURLOPT_PORT, long(port));
+    } else {
+        curl_easy_setopt(curl, CURLOPT_PORT, 80L);
+    }
+
+    // set the HTTP method
+    /// @todo: only HTTP GET and POST supported for now
+    switch (req->GetMethod()) {
+        case HTTPMethod::Get:  curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L); break;
+        case HTTPMethod::Post: curl_easy_setopt(curl, CURLOPT_POST, 1L); break;
+        default: o_error("curlMultiURLLoader: unsupported HTTP method '%s'\n", HTTPMethod::ToString(req->GetMethod())); break;
+    }
+
+    // setup request header fields, a ranged IO request already comes
+    // with a Range header from the HTTPFileSystem
+    struct curl_slist* requestHeaders = 0;
+    for (const auto& kvp : req->GetRequestHeaders()) {
+        this->stringBuilder.Set(kvp.Key());
+        this->stringBuilder.Append(": ");
+        this->stringBuilder.Append(kvp.Value());
+        requestHeaders = curl_slist_append(requestHeaders, this->stringBuilder.AsCStr());
+    }
+
+    // if this is a POST, set the data to post, the post stream
+    // stays open until the transfer is finished
+    const Ptr<Stream>& postStream = req->GetBody();
+    if (req->GetMethod() == HTTPMethod::Post) {
+        o_assert(postStream.isValid());
+        postStream->Open(OpenMode::ReadOnly);
+        const uint8* endPtr = nullptr;
+        const uint8* postData = postStream->MapRead(&endPtr);
+        const int32 postDataSize = postStream->Size();
+        o_assert((endPtr - postData) == postDataSize);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, postData);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, long(postDataSize));
+
+        // add a Content-Type request header if the post-stream has a content-type set
+        if (postStream->GetContentType().IsValid()) {
+            this->stringBuilder.Set("Content-Type: ");
+            this->stringBuilder.Append(postStream->GetContentType().AsCStr());
+            requestHeaders = curl_slist_append(requestHeaders, this->stringBuilder.AsCStr());
+        }
+    }
+    if (0 != requestHeaders) {
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, requestHeaders);
+    }
+    t->requestHeaders = requestHeaders;
+
+    // prepare the response-body stream, if the IO request has a
+    // ProgressiveStream, the body is written into it while it is arriving
+    const Ptr<IOProtocol::Request>& ioReq = req->GetIoRequest();
+    if (ioReq.isValid()) {
+        if (ioReq->GetProgressiveStream().isValid()) {
+            t->progressiveStream = ioReq->GetProgressiveStream();
+            t->body = t->progressiveStream;
+        }
+        if ((0 != ioReq->GetStartOffset()) || (0 != ioReq->GetEndOffset())) {
+            t->rangeStart = ioReq->GetStartOffset();
+            t->rangeEnd = (0 != ioReq->GetEndOffset()) ? ioReq->GetEndOffset() : -1;
+        }
+    }
+    if (!t->body.isValid()) {
+        t->body = MemoryStream::Create();
+        t->body->SetURL(req->GetURL());
+        t->body->Open(OpenMode::WriteOnly);
+    }
+    else {
+        t->body->SetURL(req->GetURL());
+    }
+
+    this->transfers.Add(t);
+    curl_multi_add_handle(this->multiHandle, curl);
+}
+
+//------------------------------------------------------------------------------
+void
+curlMultiURLLoader::finishTransfer(transfer* t, int curlResult) {
+    const Ptr<HTTPProtocol::HTTPRequest>& req = t->req;
+
+    // query the http code
+    long curlHttpCode = 0;
+    curl_easy_getinfo(t->easyHandle, CURLINFO_RESPONSE_CODE, &curlHttpCode);
+    Ptr<HTTPProtocol::HTTPResponse> httpResponse = HTTPProtocol::HTTPResponse::Create();
+    httpResponse->SetStatus((IOStatus::Code) curlHttpCode);
+
+    // check for error codes
+    if (CURLE_PARTIAL_FILE == curlResult) {
+        Log::Warn("curlMultiURLLoader: CURLE_PARTIAL_FILE received for '%s', httpStatus='%ld'\n", req->GetURL().AsCStr(), curlHttpCode);
+        httpResponse->SetErrorDesc(t->error);
+    }
+    else if (0 != curlResult) {
+        Log::Warn("curlMultiURLLoader: transfer failed with '%s' for '%s', httpStatus='%ld'\n",
+            t->error, req->GetURL().AsCStr(), curlHttpCode);
+        httpResponse->SetErrorDesc(t->error);
+    }
+
+    // check if the responseHeaders contained a Content-Type, if yes, set it on the response body
+    if (t->responseHeaders.Contains(this->contentTypeString)) {
+        t->body->SetContentType(t->responseHeaders[this->contentTypeString]);
+    }
+
+    // close the response body, and set the result
+    if (t->progressiveStream.isValid()) {
+        const bool success = ((0 == curlResult) || (CURLE_PARTIAL_FILE == curlResult)) &&
+                             (curlHttpCode >= 200) && (curlHttpCode < 300);
+        if (success) {
+            t->progressiveStream->Finish();
+        }
+        else {
+            t->progressiveStream->Fail();
+        }
+    }
+    else {
+        t->body->Close();
+    }
+    httpResponse->SetResponseHeaders(t->responseHeaders);
+    httpResponse->SetBody(t->body);
+    req->SetResponse(httpResponse);
+
+    // close the optional post stream
+    const Ptr<Stream>& postStream = req->GetBody();
+    if (postStream.isValid() && postStream->IsOpen()) {
+        postStream->Close();
+    }
+
+    // transfer result to embedded IoRequest object
+    baseURLLoader::transferToIoRequest(req);
+    req->SetHandled();
+    this->discardTransfer(t);
+}
+
+//------------------------------------------------------------------------------
+void
+curlMultiURLLoader::abortCancelledTransfers() {
+    for (int32 i = this->transfers.Size() - 1; i >= 0; i--) {
+        transfer* t = this->transfers[i];
+        if (baseURLLoader::handleCancelled(t->req)) {
+            if (t->progressiveStream.isValid()) {
+                t->progressiveStream->Fail();
+            }
+            this->discardTransfer(t);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+curlMultiURLLoader::discardTransfer(transfer* t) {
+    // removing the easy handle from the multi handle keeps the
+    // connection in the connection cache
+    curl_multi_remove_handle(this->multiHandle, t->easyHandle);
+    curl_easy_reset(t->easyHandle);
+    this->freeEasyHandles.Add(t->easyHandle);
+    if (t->requestHeaders) {
+        curl_slist_free_all((curl_slist*) t->requestHeaders);
+    }
+    Memory::Free(t->error);
+    this->transfers.Erase(this->transfers.FindIndexLinear(t));
+    Memory::Delete(t);
+}
+
+//------------------------------------------------------------------------------
+void
+curlMultiURLLoader::beginBody(transfer* t) {
+    t->bodyStarted = true;
+    long curlHttpCode = 0;
+    curl_easy_getinfo(t->easyHandle, CURLINFO_RESPONSE_CODE, &curlHttpCode);
+    const bool isSuccess = (curlHttpCode >= 200) && (curlHttpCode < 300);
+
+    // the progressive stream only receives the body of successful responses
+    t->bodyAccepted = isSuccess || !t->progressiveStream.isValid();
+
+    // a 200 response to a ranged request contains the whole resource
+    const bool isRanged = (0 != t->rangeStart) || (-1 != t->rangeEnd);
+    t->trimRange = isRanged && (IOStatus::OK == curlHttpCode);
+
+    // pre-allocate the response body
+    if (isSuccess && !t->trimRange && !t->progressiveStream.isValid()) {
+        const String contentLength = findResponseHeader(t->responseHeaders, "Content-Length");
+        if (contentLength.IsValid()) {
+            const int64 size = std::strtoll(contentLength.AsCStr(), nullptr, 10);
+            if ((size > 0) && (size < (1<<30))) {
+                static_cast<MemoryStream*>(t->body.get())->Reserve(int32(size));
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+size_t
+curlMultiURLLoader::curlWriteDataCallback(char* ptr, size_t size, size_t nmemb, void* userData) {
+    // userData is expected to point to the transfer object
+    transfer* t = (transfer*) userData;
+    const int32 numBytes = (int32) (size * nmemb);
+    if (numBytes > 0) {
+        if (!t->bodyStarted) {
+            beginBody(t);
+        }
+        if (t->bodyAccepted) {
+            if (t->trimRange) {
+                // only keep the requested range of the full response
+                const int64 begin = t->rangeStart > t->bodyOffset ? t->rangeStart - t->bodyOffset : 0;
+                int64 end = numBytes;
+                if ((-1 != t->rangeEnd) && ((t->rangeEnd + 1 - t->bodyOffset) < end)) {
+                    end = t->rangeEnd + 1 - t->bodyOffset;
+                }
+                if (end > begin) {
+                    t->body->Write(ptr + begin, int32(end - begin));
+                }
+            }
+            else {
+                t->body->Write(ptr, numBytes);
+            }
+        }
+        t->bodyOffset += numBytes;
+        return numBytes;
+    }
+    else {
+        return 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+size_t
+curlMultiURLLoader::curlHeaderCallback(char* ptr, size_t size, size_t nmemb, void* userData) {
+    // userData is expected to point to the transfer object
+    transfer* t = (transfer*) userData;
+    StringBuilder& strBuilder = t->loader->stringBuilder;
+    int32 receivedBytes = (int32) (size * nmemb);
+    if (receivedBytes > 0) {
+        strBuilder.Set(ptr, 0, receivedBytes);
+        if (0 == std::strncmp(ptr, "HTTP/", 5)) {
+            // status line, headers of a previous response (redirect,
+            // 100 Continue) don't belong to the final response
+            t->responseHeaders.Clear();
+        }
+        int32 colonIndex = strBuilder.FindFirstOf(0, receivedBytes, ":");
+        if (InvalidIndex != colonIndex) {
+            String key = strBuilder.GetSubString(0, colonIndex);
+            int32 endOfValueIndex = strBuilder.FindFirstOf(colonIndex, EndOfString, "\r\n");
+            String value = strBuilder.GetSubString(colonIndex + 2, endOfValueIndex);
+            if (t->responseHeaders.Contains(key)) {
+                t->responseHeaders[key] = value;
+            }
+            else {
+                t->responseHeaders.Add(key, value);
+            }
+        }
+        return receivedBytes;
+    }
+    else {
+        return 0;
+    }
+}
+
+} // namespace _priv
+} // namespace Oryol
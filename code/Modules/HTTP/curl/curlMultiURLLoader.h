@@ -0,0 +1,97 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::curlMultiURLLoader
+    @ingroup _priv
+    @brief urlLoader implementation on top of the curl multi interface
+    @see urlLoader
+
+    Runs up to ORYOL_HTTP_MAX_TRANSFERS transfers concurrently on the
+    thread which calls doWork(), instead of performing one request
+    after another. All transfers share the connection cache of one
+    curl multi handle, so that idle keep-alive connections are reused
+    by following requests (at most ORYOL_HTTP_MAX_HOST_CONNECTIONS
+    parallel connections per host, additional transfers are queued
+    by curl until a connection becomes free).
+
+    doWork() never blocks longer than ORYOL_HTTP_WAIT_TIMEOUT, so it
+    must be called repeatedly until all requests are handled (the IO
+    lanes do this once per frame).
+
+    Response bodies are written straight into the response stream
+    (or the ProgressiveStream of the IO request) as they arrive. If the
+    server ignores the Range header of a ranged request, the
+    requested range is cut out of the full response.
+*/
+#include "HTTP/base/baseURLLoader.h"
+#include "HTTP/HTTPConfig.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Map.h"
+#include "IO/Stream/ChunkedStream.h"
+#include <mutex>
+
+namespace Oryol {
+namespace _priv {
+
+class curlMultiURLLoader : public baseURLLoader {
+public:
+    /// constructor
+    curlMultiURLLoader();
+    /// destructor
+    ~curlMultiURLLoader();
+    /// start enqueued requests and advance transfers in flight
+    void doWork();
+    /// get number of transfers in flight
+    int32 numTransfers() const;
+
+private:
+    struct transfer {
+        curlMultiURLLoader* loader = nullptr;
+        Ptr<HTTPProtocol::HTTPRequest> req;
+        Ptr<Stream> body;
+        Ptr<ChunkedStream> progressiveStream;
+        Map<String,String> responseHeaders;
+        void* easyHandle = nullptr;
+        void* requestHeaders = nullptr;     // curl_slist
+        char* error = nullptr;
+        int64 rangeStart = 0;               // start of the requested range
+        int64 rangeEnd = -1;                // last byte of the requested range, -1 if open
+        int64 bodyOffset = 0;               // offset of the next received byte in the response
+        bool bodyStarted = false;
+        bool bodyAccepted = false;          // false for error responses to progressive requests
+        bool trimRange = false;             // true if the server ignored the Range header
+    };
+
+    /// create a transfer for a request and add it to the multi handle
+    void startTransfer(const Ptr<HTTPProtocol::HTTPRequest>& req);
+    /// complete a finished transfer and hand the response to the request
+    void finishTransfer(transfer* t, int curlResult);
+    /// abort transfers whose request has been cancelled
+    void abortCancelledTransfers();
+    /// remove a transfer from the multi handle and free it
+    void discardTransfer(transfer* t);
+    /// called when the first bytes of a response body arrive
+    static void beginBody(transfer* t);
+    /// curl write-data callback
+    static size_t curlWriteDataCallback(char* ptr, size_t size, size_t nmemb, void* userData);
+    /// curl header-data callback
+    static size_t curlHeaderCallback(char* ptr, size_t size, size_t nmemb, void* userData);
+
+    static bool curlInitCalled;
+    static std::mutex curlInitMutex;
+    const String contentTypeString;
+    void* multiHandle;
+    Array<transfer*> transfers;
+    Array<void*> freeEasyHandles;
+    StringBuilder stringBuilder;
+};
+
+//------------------------------------------------------------------------------
+inline int32
+curlMultiURLLoader::numTransfers() const {
+    return this->transfers.Size();
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -100,6 +100,25 @@ curlURLLoader::curlWriteDataCallback(char* ptr, size_t size, size_t nmemb, void*
     }
 }
 
+//------------------------------------------------------------------------------
+size_t
+curlURLLoader::curlProgressiveWriteCallback(char* ptr, size_t size, size_t nmemb, void* userData) {
+    // userData is expected to point to the curlURLLoader object
+    curlURLLoader* self = (curlURLLoader*) userData;
+    int32 bytesToWrite = (int32) (size * nmemb);
+    if (bytesToWrite > 0) {
+        long curlHttpCode = 0;
+        curl_easy_getinfo(self->curlSession, CURLINFO_RESPONSE_CODE, &curlHttpCode);
+        if ((curlHttpCode >= 200) && (curlHttpCode < 300)) {
+            self->progressiveStream->Write(ptr, bytesToWrite);
+        }
+        return bytesToWrite;
+    }
+    else {
+        return 0;
+    }
+}
+
 //------------------------------------------------------------------------------
 size_t
 curlURLLoader::curlHeaderCallback(char* ptr, size_t size, size_t nmemb, void* userData) {
@@ -131,14 +150,7 @@ curlURLLoader::doWork() {
             this->doOneRequest(req);
 
             // transfer result to embedded IoRequest object
-            auto ioReq = req->GetIoRequest();
-            if (ioReq) {
-                auto httpResponse = req->GetResponse();
-                ioReq->SetStatus(httpResponse->GetStatus());
-                ioReq->SetStream(httpResponse->GetBody());
-                ioReq->SetErrorDesc(httpResponse->GetErrorDesc());
-                ioReq->SetHandled();
-            }
+            baseURLLoader::transferToIoRequest(req);
             req->SetHandled();
         }
     }
@@ -205,12 +217,27 @@ curlURLLoader::doOneRequest(const Ptr<HTTPProtocol::HTTPRequest>& req) {
         curl_easy_setopt(this->curlSession, CURLOPT_HTTPHEADER, requestHeaders);
     }
 
-    // prepare the HTTPResponse and the response-body stream
+    // prepare the HTTPResponse and the response-body stream, if the
+    // IO request has a ProgressiveStream, the body is written into it
+    // while it is arriving
     Ptr<HTTPProtocol::HTTPResponse> httpResponse = HTTPProtocol::HTTPResponse::Create();
-    Ptr<MemoryStream> responseBodyStream = MemoryStream::Create();
-    responseBodyStream->SetURL(req->GetURL());
-    responseBodyStream->Open(OpenMode::WriteOnly);
-    curl_easy_setopt(this->curlSession, CURLOPT_WRITEDATA, responseBodyStream.get());
+    Ptr<Stream> responseBodyStream;
+    if (req->GetIoRequest().isValid() && req->GetIoRequest()->GetProgressiveStream().isValid()) {
+        this->progressiveStream = req->GetIoRequest()->GetProgressiveStream();
+        responseBodyStream = this->progressiveStream;
+        curl_easy_setopt(this->curlSession, CURLOPT_WRITEFUNCTION, curlProgressiveWriteCallback);
+        curl_easy_setopt(this->curlSession, CURLOPT_WRITEDATA, this);
+    }
+    else {
+        responseBodyStream = MemoryStream::Create();
+        responseBodyStream->SetURL(req->GetURL());
+        responseBodyStream->Open(OpenMode::WriteOnly);
+        curl_easy_setopt(this->curlSession, CURLOPT_WRITEFUNCTION, curlWriteDataCallback);
+        curl_easy_setopt(this->curlSession, CURLOPT_WRITEDATA, responseBodyStream.get());
+    }
+    if (this->progressiveStream.isValid()) {
+        responseBodyStream->SetURL(req->GetURL());
+    }
 
     // perform the request
     CURLcode performResult = curl_easy_perform(this->curlSession);
@@ -240,7 +267,20 @@ curlURLLoader::doOneRequest(const Ptr<HTTPProtocol::HTTPRequest>& req) {
     }
 
     // close the responseBodyStream, and set the result
-    responseBodyStream->Close();
+    if (this->progressiveStream.isValid()) {
+        const bool success = ((0 == performResult) || (CURLE_PARTIAL_FILE == performResult)) &&
+                             (curlHttpCode >= 200) && (curlHttpCode < 300);
+        if (success) {
+            this->progressiveStream->Finish();
+        }
+        else {
+            this->progressiveStream->Fail();
+        }
+        this->progressiveStream = nullptr;
+    }
+    else {
+        responseBodyStream->Close();
+    }
     httpResponse->SetResponseHeaders(this->responseHeaders);
     httpResponse->SetBody(responseBodyStream);
     req->SetResponse(httpResponse);
@@ -9,6 +9,7 @@
 #include "HTTP/base/baseURLLoader.h"
 #include "Core/String/StringBuilder.h"
 #include "Core/Containers/Map.h"
+#include "IO/Stream/ChunkedStream.h"
 #include <mutex>
 
 namespace Oryol {
@@ -32,6 +33,8 @@ private:
     void doOneRequest(const Ptr<HTTPProtocol::HTTPRequest>& req);
     /// curl write-data callback
     static size_t curlWriteDataCallback(char* ptr, size_t size, size_t nmemb, void* userData);
+    /// curl write-data callback for progressive requests, drops the body of error responses
+    static size_t curlProgressiveWriteCallback(char* ptr, size_t size, size_t nmemb, void* userData);
     /// curl header-data callback
     static size_t curlHeaderCallback(char* ptr, size_t size, size_t nmenb, void* userData);
 
@@ -42,6 +45,7 @@ private:
     char* curlError;
     StringBuilder stringBuilder;
     Map<String,String> responseHeaders;
+    Ptr<ChunkedStream> progressiveStream;
 };
 
 } // namespace _priv
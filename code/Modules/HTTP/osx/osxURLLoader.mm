@@ -33,14 +33,7 @@ osxURLLoader::doWork() {
             this->doOneRequest(httpReq);
             
             // transfer result to embedded IoRequest and set to handled
-            auto ioReq = httpReq->GetIoRequest();
-            if (ioReq) {
-                auto httpResponse = httpReq->GetResponse();
-                ioReq->SetStatus(httpResponse->GetStatus());
-                ioReq->SetStream(httpResponse->GetBody());
-                ioReq->SetErrorDesc(httpResponse->GetErrorDesc());
-                ioReq->SetHandled();
-            }
+            baseURLLoader::transferToIoRequest(httpReq);
             httpReq->SetHandled();
         }
     }
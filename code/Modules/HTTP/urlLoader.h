@@ -6,7 +6,13 @@
     @brief private: processes a HTTP request and returns HTTP response    
     @see HTTPClient
 */
-#if ORYOL_USE_LIBCURL
+#if ORYOL_USE_LIBCURL && ORYOL_USE_LIBCURL_MULTI
+#include "HTTP/curl/curlMultiURLLoader.h"
+namespace Oryol {
+namespace _priv {
+class urlLoader : public curlMultiURLLoader {};
+} }
+#elif ORYOL_USE_LIBCURL
 #include "HTTP/curl/curlURLLoader.h"
 namespace Oryol {
 namespace _priv {
@@ -48,14 +48,7 @@ winURLLoader::doWork() {
             this->doOneRequest(req);
 
             // transfer result to embedded ioRequest and set to handled
-            auto ioReq = req->GetIoRequest();
-            if (ioReq) {
-                auto httpResponse = req->GetResponse();
-                ioReq->SetStatus(httpResponse->GetStatus());
-                ioReq->SetStream(httpResponse->GetBody());
-                ioReq->SetErrorDesc(httpResponse->GetErrorDesc());
-                ioReq->SetHandled();
-            }
+            baseURLLoader::transferToIoRequest(req);
             req->SetHandled();
         }
     }
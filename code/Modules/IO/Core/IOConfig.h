@@ -11,3 +11,5 @@
 #define ORYOL_STREAM_DEFAULT_MIN_GROW (256)
 /// maximum grow size for streams (in bytes)
 #define ORYOL_STREAM_DEFAULT_MAX_GROW (1<<18)   // 256 kByte
+/// default chunk size of ChunkedStream (in bytes)
+#define ORYOL_STREAM_DEFAULT_CHUNK_SIZE (1<<16)   // 64 kByte
@@ -0,0 +1,41 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IOLaneStats
+    @ingroup IO
+    @brief scheduling statistics of an IO lane
+
+    Returned by IO::LaneStats(). The queue depth counts requests which
+    have been put into the lane and haven't been handed off to a
+    filesystem yet (including the request which is currently being
+    dispatched). The wait time is measured from IO::Put() until the
+    lane hands the request to its filesystem.
+*/
+#include "Core/Types.h"
+#include "Time/Duration.h"
+
+namespace Oryol {
+
+class IOLaneStats {
+public:
+    /// current number of queued requests
+    int32 QueueDepth = 0;
+    /// max number of queued requests seen by the lane
+    int32 MaxQueueDepth = 0;
+    /// number of requests handed to a filesystem
+    int32 NumDispatched = 0;
+    /// number of cancelled requests dropped before dispatch
+    int32 NumCancelled = 0;
+    /// number of requests dispatched after their deadline
+    int32 NumMissedDeadlines = 0;
+    /// number of requests answered from the IOCache (including revalidated hits)
+    int32 NumCacheHits = 0;
+    /// number of cacheable requests which went to the filesystem
+    int32 NumCacheMisses = 0;
+    /// average wait time of dispatched requests
+    Duration AvgWaitTime;
+    /// max wait time of dispatched requests
+    Duration MaxWaitTime;
+};
+
+} // namespace Oryol
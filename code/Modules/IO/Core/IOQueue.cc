@@ -13,7 +13,8 @@ namespace Oryol {
 IOQueue::IOQueue() :
 isStarted(false),
 runLoopId(RunLoop::InvalidId),
-serial(0) {
+serial(0),
+completions(CompletionList::Create()) {
     // empty
 }
 
@@ -42,6 +43,10 @@ IOQueue::Stop() {
     Core::PreRunLoop()->Remove(this->runLoopId);
     this->items.Clear();
     this->groupItems.Clear();
+    this->groupRequests.Clear();
+    // requests which are still in flight push into the old list
+    this->completions = CompletionList::Create();
+    this->completedIds.Clear();
 }
 
 //------------------------------------------------------------------------------
@@ -65,20 +70,21 @@ IOQueue::Add(const URL& url, SuccessFunc onSuccess, FailFunc onFail) {
     Ptr<IOProtocol::Request> ioReq = IOProtocol::Request::Create();
     ioReq->SetURL(url);
     ioReq->SetSerialId(++this->serial);
-    IO::Put(ioReq);
+    ioReq->SetCompletionList(this->completions, this->serial);
     
-    // add to our queue if pending requests
-    this->items.Add(item{ ioReq, onSuccess, onFail });
+    // add to our queue of pending requests
+    this->items.Add(this->serial, item{ ioReq, onSuccess, onFail });
+    IO::Put(ioReq);
 
     return this->serial;
 }
 
+//------------------------------------------------------------------------------
 void
-IOQueue::Cancel(uint64 id){
-    for (int32 i = this->items.Size() - 1; i >= 0; --i){
-        const auto& cur = this->items[i];
-        if (cur.ioRequest->GetSerialId() == id)
-            cur.ioRequest->SetCancelled();
+IOQueue::Cancel(uint64 id) {
+    const item* curItem = this->items.Find(id);
+    if (curItem) {
+        curItem->ioRequest->SetCancelled();
     }
 }
 
@@ -87,89 +93,117 @@ void
 IOQueue::AddGroup(const Array<URL>& urls, GroupSuccessFunc onSuccess, FailFunc onFail) {
     o_assert_dbg(onSuccess);
     
+    const uint64 groupId = ++this->serial;
     groupItem item;
+    item.successFunc = onSuccess;
+    item.failFunc = onFail;
     item.ioRequests.Reserve(urls.Size());
     for (const URL& url : urls) {
         Ptr<IOProtocol::Request> ioReq = IOProtocol::Request::Create();
         ioReq->SetURL(url);
-        IO::Put(ioReq);
+        ioReq->SetSerialId(++this->serial);
+        ioReq->SetCompletionList(this->completions, this->serial);
+        this->groupRequests.Add(this->serial, groupId);
         item.ioRequests.Add(ioReq);
-        item.successFunc = onSuccess;
-        item.failFunc = onFail;
     }
-    this->groupItems.Add(item);
+    item.numPending = item.ioRequests.Size();
+    this->groupItems.Add(groupId, item);
+    for (const auto& ioReq : this->groupItems[groupId].ioRequests) {
+        IO::Put(ioReq);
+    }
 }
 
 //------------------------------------------------------------------------------
 /**
-    This is called per frame from the thread-local run-loop.
+    This is called per frame from the thread-local run-loop, and only
+    looks at requests which have been handled since the last call.
 */
 void
 IOQueue::update() {
+    if (0 == this->completions->TakeAll(this->completedIds)) {
+        return;
+    }
+    for (uint64 id : this->completedIds) {
+        const item* itemPtr = this->items.Find(id);
+        if (nullptr == itemPtr) {
+            this->onGroupRequestHandled(id);
+            continue;
+        }
 
-    // check single items
-    for (int i = this->items.Size() - 1; i >= 0; --i) {
-        const item& curItem = this->items[i];
+        // remove the handled io request from the queue before calling
+        // the callbacks, which may add new requests
+        const item curItem = *itemPtr;
+        this->items.Erase(id);
         const auto& ioReq = curItem.ioRequest;
-        if (ioReq->Handled()) {
-            // io request has been handled
-            if (IOStatus::OK == ioReq->GetStatus()) {
-                // io request was successful
-                curItem.successFunc(ioReq->GetStream());
+        if (IOStatus::OK == ioReq->GetStatus()) {
+            // io request was successful
+            curItem.successFunc(ioReq->GetStream());
+        }
+        else {
+            // io request failed
+            if (curItem.failFunc) {
+                curItem.failFunc(ioReq->GetURL(), ioReq->GetStatus());
             }
             else {
-                // io request failed
-                if (curItem.failFunc) {
-                    curItem.failFunc(ioReq->GetURL(), ioReq->GetStatus());
-                }
-                else {
-                    // no fail handler was set, error out
-                    o_error("IOQueue::update(): failed to load file '%s'\n", ioReq->GetURL().AsCStr());
-                }
+                // no fail handler was set, error out
+                o_error("IOQueue::update(): failed to load file '%s'\n", ioReq->GetURL().AsCStr());
             }
-            // remove the handled io request from the queue
-            this->items.Erase(i);
         }
     }
-    
-    // check group items
-    for (int i = this->groupItems.Size() - 1; i >= 0; --i) {
-        const groupItem& curItem = this->groupItems[i];
-        bool allHandled = true;
-        bool anyFailed = false;
-        for (const auto& ioReq : curItem.ioRequests) {
-            if (ioReq->Handled()) {
-                if (IOStatus::OK != ioReq->GetStatus()) {
-                    anyFailed = true;
-                    if (curItem.failFunc) {
-                        curItem.failFunc(ioReq->GetURL(), ioReq->GetStatus());
-                    }
-                    else {
-                        // no fail handler was set, throw fatal error
-                        o_error("IOQueue::update(): failed to load file '%s'\n", ioReq->GetURL().AsCStr());
-                    }
-                }
-            }
-            else {
-                allHandled = false;
-                break;
-            }
+    this->completedIds.Clear();
+}
+
+//------------------------------------------------------------------------------
+void
+IOQueue::onGroupRequestHandled(uint64 id) {
+    const uint64* groupIdPtr = this->groupRequests.Find(id);
+    if (nullptr == groupIdPtr) {
+        // request of a cancelled or stopped queue
+        return;
+    }
+    const uint64 groupId = *groupIdPtr;
+    this->groupRequests.Erase(id);
+    groupItem* group = this->groupItems.Find(groupId);
+    o_assert_dbg(group);
+
+    // find the request and call the fail func if it failed
+    Ptr<IOProtocol::Request> ioReq;
+    for (const auto& req : group->ioRequests) {
+        if (req->GetSerialId() == id) {
+            ioReq = req;
+            break;
         }
-        
-        // if all request in this group have been handled, remove item, and
-        // if all were successful, call the successFunc
-        if (allHandled) {
-            if (!anyFailed) {
-                Array<Ptr<Stream>> result;
-                result.Reserve(curItem.ioRequests.Size());
-                for (const auto& ioReq : curItem.ioRequests) {
-                    result.Add(ioReq->GetStream());
-                }
-                curItem.successFunc(result);
-            }
-            this->groupItems.Erase(i);
+    }
+    o_assert_dbg(ioReq);
+    group->numPending--;
+    const bool allHandled = 0 == group->numPending;
+    if (IOStatus::OK != ioReq->GetStatus()) {
+        group->anyFailed = true;
+    }
+
+    // if all request in this group have been handled, remove item, and
+    // if all were successful, call the successFunc
+    const groupItem curItem = allHandled ? *group : groupItem();
+    const FailFunc failFunc = group->failFunc;
+    if (allHandled) {
+        this->groupItems.Erase(groupId);
+    }
+    if (IOStatus::OK != ioReq->GetStatus()) {
+        if (failFunc) {
+            failFunc(ioReq->GetURL(), ioReq->GetStatus());
+        }
+        else {
+            // no fail handler was set, throw fatal error
+            o_error("IOQueue::update(): failed to load file '%s'\n", ioReq->GetURL().AsCStr());
+        }
+    }
+    if (allHandled && !curItem.anyFailed) {
+        Array<Ptr<Stream>> result;
+        result.Reserve(curItem.ioRequests.Size());
+        for (const auto& req : curItem.ioRequests) {
+            result.Add(req->GetStream());
         }
-        
+        curItem.successFunc(result);
     }
 }
 
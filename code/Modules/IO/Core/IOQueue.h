@@ -7,6 +7,10 @@
 
     IOQueues are used to load one or more files asynchronously, and associate
     a success (and optional failure) callback with an IO request.
+
+    The IO requests push their serial id into a CompletionList when
+    they are handled, so the per-frame update only touches requests
+    which actually completed, no matter how many are still in flight.
     
     See the IOQueue sample application to see how it works :)
 */
@@ -14,6 +18,8 @@
 #include "Core/String/StringAtom.h"
 #include "IO/IOProtocol.h"
 #include "Core/Containers/Array.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/Threading/CompletionList.h"
 #include <functional>
 
 namespace Oryol {
@@ -46,11 +52,14 @@ public:
     /// return true if queue is empty
     bool Empty() const;
 
+    /// cancel a request started with Add()
     void Cancel(uint64 id);
     
 private:
     /// update the queue, called per frame from runloop
     void update();
+    /// handle a completed request of a group
+    void onGroupRequestHandled(uint64 id);
     
     bool isStarted;
     int32 runLoopId;
@@ -59,14 +68,19 @@ private:
         SuccessFunc successFunc;
         FailFunc failFunc;
     };
-    Array<item> items;
-    int64 serial;
+    HashMap<uint64, item> items;        // by request serial id
+    uint64 serial;
     struct groupItem {
         Array<Ptr<IOProtocol::Request>> ioRequests;
         GroupSuccessFunc successFunc;
         FailFunc failFunc;
+        int32 numPending{0};
+        bool anyFailed{false};
     };
-    Array<groupItem> groupItems;
+    HashMap<uint64, groupItem> groupItems;      // by group id
+    HashMap<uint64, uint64> groupRequests;      // request serial id => group id
+    Ptr<CompletionList> completions;
+    Array<uint64> completedIds;
 };
     
 } // namespace Oryol
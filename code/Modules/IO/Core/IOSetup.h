@@ -9,6 +9,7 @@
 #include "Core/Containers/Map.h"
 #include "Core/Containers/KeyValuePair.h"
 #include "IO/FS/FileSystem.h"
+#include "IO/FS/IOCache.h"
 #include <functional>
 
 namespace Oryol {
@@ -21,6 +22,8 @@ public:
     Map<StringAtom, std::function<Ptr<FileSystem>()>> FileSystems;
     /// number of IOLanes
     int32 NumIOLanes = 4;
+    /// optional cache between the IO lanes and the filesystems (shared by all lanes)
+    Ptr<IOCache> Cache;
 };
     
 } // namespace Oryol
@@ -0,0 +1,47 @@
+//------------------------------------------------------------------------------
+//  IOCache.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "IOCache.h"
+
+namespace Oryol {
+
+OryolClassImpl(IOCache);
+
+//------------------------------------------------------------------------------
+IOCache::IOCache() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+IOCache::~IOCache() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+bool
+IOCache::IsCacheable(const URL& /*url*/) const {
+    // implement in subclass!
+    return false;
+}
+
+//------------------------------------------------------------------------------
+bool
+IOCache::RevalidateHits() const {
+    return false;
+}
+
+//------------------------------------------------------------------------------
+Ptr<Stream>
+IOCache::Lookup(const URL& /*url*/, String& /*outETag*/, String& /*outLastModified*/) {
+    // implement in subclass!
+    return Ptr<Stream>();
+}
+
+//------------------------------------------------------------------------------
+void
+IOCache::Store(const URL& /*url*/, const String& /*eTag*/, const String& /*lastModified*/, const Ptr<Stream>& /*data*/) {
+    // implement in subclass!
+}
+
+} // namespace Oryol
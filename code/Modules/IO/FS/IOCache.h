@@ -0,0 +1,51 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IOCache
+    @ingroup IO
+    @brief base-class for caches between the IO lanes and the filesystems
+
+    If an IOCache is set in IOSetup::Cache, the IO lanes ask it for
+    requests of cacheable URLs before the request goes to a filesystem:
+
+    - if CacheReadEnabled is set and the cache has an entry for the URL,
+      the request is answered from the cache without bothering the
+      filesystem, unless RevalidateHits() returns true, in that case
+      the filesystem gets a conditional request with IfNoneMatch and
+      IfModifiedSince set to the entry's ETag and Last-Modified, and
+      if it answers with IOStatus::NotModified the cached data is used
+    - if CacheWriteEnabled is set, the data of successful filesystem
+      responses is stored in the cache together with the ETag and
+      LastModified values the filesystem returned
+
+    Ranged requests (StartOffset or EndOffset not 0) bypass the cache.
+    The same cache object is used by all IO lanes, so subclasses must
+    be thread-safe. The default implementation doesn't cache anything.
+
+    @see LocalFileCache
+*/
+#include "Core/RefCounted.h"
+#include "IO/Core/URL.h"
+#include "IO/Stream/Stream.h"
+
+namespace Oryol {
+
+class IOCache : public RefCounted {
+    OryolClassDecl(IOCache);
+public:
+    /// default constructor
+    IOCache();
+    /// destructor
+    virtual ~IOCache();
+
+    /// return true if requests for the URL should go through the cache
+    virtual bool IsCacheable(const URL& url) const;
+    /// return true if cache hits must be revalidated by the filesystem
+    virtual bool RevalidateHits() const;
+    /// lookup cached data for URL, return invalid ptr if not cached
+    virtual Ptr<Stream> Lookup(const URL& url, String& outETag, String& outLastModified);
+    /// store the content of a stream for URL
+    virtual void Store(const URL& url, const String& eTag, const String& lastModified, const Ptr<Stream>& data);
+};
+
+} // namespace Oryol
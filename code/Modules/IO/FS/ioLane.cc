@@ -4,6 +4,9 @@
 #include "Pre.h"
 #include "ioLane.h"
 #include "Messaging/Dispatcher.h"
+#include "Time/Clock.h"
+#include <algorithm>
+#include <limits>
 
 // FIXME: access to IO.h from down here is a bit hacky :/
 #include "IO/IO.h"
@@ -14,7 +17,8 @@ namespace _priv {
 OryolClassImpl(ioLane);
 
 //------------------------------------------------------------------------------
-ioLane::ioLane() {
+ioLane::ioLane(const Ptr<IOCache>& cache_) :
+cache(cache_) {
     // let our thread wake up from time to time
     this->SetTickDuration(100);
 }
@@ -27,7 +31,7 @@ ioLane::~ioLane() {
 //------------------------------------------------------------------------------
 void
 ioLane::onThreadEnter() {
-    ThreadedQueue::onThreadEnter();
+    LockFreeQueue::onThreadEnter();
 
     // setup a Dispatcher to route messages to safely route messages
     // to this object's callback methods
@@ -43,20 +47,142 @@ ioLane::onThreadEnter() {
 //------------------------------------------------------------------------------
 void
 ioLane::onThreadLeave() {
+    // drop requests which haven't been dispatched
+    this->queueDepth.fetch_sub(this->pendingRequests.Size(), std::memory_order_relaxed);
+    this->pendingRequests.Clear();
+    for (const auto& item : this->cacheableRequests) {
+        item.proxy->SetCancelled();
+    }
+    this->cacheableRequests.Clear();
     this->forwardingPort = 0;
     this->fileSystems.Clear();
-    ThreadedQueue::onThreadLeave();
+    LockFreeQueue::onThreadLeave();
+}
+
+//------------------------------------------------------------------------------
+bool
+ioLane::Put(const Ptr<Message>& msg) {
+    Ptr<IOProtocol::Request> req = msg->DynamicCast<IOProtocol::Request>();
+    if (req.isValid()) {
+        req->SetEnqueueTime(Clock::Now());
+        this->queueDepth.fetch_add(1, std::memory_order_relaxed);
+    }
+    return LockFreeQueue::Put(msg);
+}
+
+//------------------------------------------------------------------------------
+IOLaneStats
+ioLane::Stats() const {
+    IOLaneStats stats;
+    stats.QueueDepth = this->queueDepth.load(std::memory_order_relaxed);
+    stats.MaxQueueDepth = this->maxQueueDepth.load(std::memory_order_relaxed);
+    stats.NumDispatched = this->numDispatched.load(std::memory_order_relaxed);
+    stats.NumCancelled = this->numCancelled.load(std::memory_order_relaxed);
+    stats.NumMissedDeadlines = this->numMissedDeadlines.load(std::memory_order_relaxed);
+    stats.NumCacheHits = this->numCacheHits.load(std::memory_order_relaxed);
+    stats.NumCacheMisses = this->numCacheMisses.load(std::memory_order_relaxed);
+    if (stats.NumDispatched > 0) {
+        stats.AvgWaitTime = Duration(this->totalWaitTicks.load(std::memory_order_relaxed) / stats.NumDispatched);
+    }
+    stats.MaxWaitTime = Duration(this->maxWaitTicks.load(std::memory_order_relaxed));
+    return stats;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Requests are moved into the priority queue, they are dispatched
+ in onTick(). Everything else is forwarded immediately, but
+ filesystem changes must not overtake requests which were put
+ before them.
+*/
+void
+ioLane::onMessage(const Ptr<Message>& msg) {
+    Ptr<IOProtocol::Request> req = msg->DynamicCast<IOProtocol::Request>();
+    if (req.isValid()) {
+        pendingRequest pending;
+        pending.req = req;
+        pending.priority = req->GetPriority();
+        const TimePoint& deadline = req->GetDeadline();
+        pending.deadline = (TimePoint() == deadline) ? std::numeric_limits<int64>::max() : deadline.getRaw();
+        pending.seq = this->pendingSeq++;
+        this->pendingRequests.Add(pending);
+        std::push_heap(this->pendingRequests.begin(), this->pendingRequests.end(), dispatchedAfter);
+
+        const int32 depth = this->queueDepth.load(std::memory_order_relaxed);
+        if (depth > this->maxQueueDepth.load(std::memory_order_relaxed)) {
+            this->maxQueueDepth.store(depth, std::memory_order_relaxed);
+        }
+    }
+    else {
+        if (msg->IsA<IOProtocol::notifyFileSystemRemoved>() || msg->IsA<IOProtocol::notifyFileSystemReplaced>()) {
+            this->dispatchRequests(false);
+        }
+        LockFreeQueue::onMessage(msg);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+ioLane::dispatchedAfter(const pendingRequest& a, const pendingRequest& b) {
+    if (a.priority != b.priority) {
+        return a.priority < b.priority;
+    }
+    else if (a.deadline != b.deadline) {
+        return a.deadline > b.deadline;
+    }
+    else {
+        return a.seq > b.seq;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioLane::dispatchRequests(bool pollNewRequests) {
+    while (!this->pendingRequests.Empty() && !this->threadStopRequested) {
+        std::pop_heap(this->pendingRequests.begin(), this->pendingRequests.end(), dispatchedAfter);
+        const pendingRequest pending = this->pendingRequests.Back();
+        this->pendingRequests.Erase(this->pendingRequests.Size() - 1);
+        const Ptr<IOProtocol::Request>& req = pending.req;
+
+        if (req->Cancelled()) {
+            // drop cancelled requests before they reach a filesystem
+            req->SetStatus(IOStatus::Cancelled);
+            req->SetHandled();
+            this->numCancelled.fetch_add(1, std::memory_order_relaxed);
+        }
+        else {
+            const TimePoint now = Clock::Now();
+            const int64 waitTicks = now.Since(req->GetEnqueueTime()).getRaw();
+            this->totalWaitTicks.fetch_add(waitTicks, std::memory_order_relaxed);
+            if (waitTicks > this->maxWaitTicks.load(std::memory_order_relaxed)) {
+                this->maxWaitTicks.store(waitTicks, std::memory_order_relaxed);
+            }
+            if (now.getRaw() > pending.deadline) {
+                this->numMissedDeadlines.fetch_add(1, std::memory_order_relaxed);
+            }
+            this->forwardingPort->Put(req);
+            this->numDispatched.fetch_add(1, std::memory_order_relaxed);
+        }
+        this->queueDepth.fetch_sub(1, std::memory_order_relaxed);
+
+        // pick up requests which have arrived in the meantime
+        if (pollNewRequests) {
+            this->processMessages();
+        }
+    }
 }
 
 //------------------------------------------------------------------------------
 void
 ioLane::onTick() {
-    ThreadedQueue::onTick();
+    this->dispatchRequests(true);
+    LockFreeQueue::onTick();
     
     // also tick our file systems
     for (const auto& kvp : this->fileSystems) {
         kvp.Value()->DoWork();
     }
+    this->updateCacheableRequests();
 }
 
 //------------------------------------------------------------------------------
@@ -83,9 +209,111 @@ ioLane::onRequest(const Ptr<IOProtocol::Request>& msg) {
     else {
         Ptr<FileSystem> fs = this->fileSystemForURL(msg->GetURL());
         if (fs) {
-            fs->onRequest(msg);
+            if (this->isCacheable(msg)) {
+                this->onCacheableRequest(msg, fs);
+            }
+            else {
+                fs->onRequest(msg);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+ioLane::isCacheable(const Ptr<IOProtocol::Request>& req) const {
+    return this->cache.isValid() &&
+           (req->GetCacheReadEnabled() || req->GetCacheWriteEnabled()) &&
+           (0 == req->GetStartOffset()) && (0 == req->GetEndOffset()) &&
+           !req->GetProgressiveStream().isValid() &&
+           this->cache->IsCacheable(req->GetURL());
+}
+
+//------------------------------------------------------------------------------
+void
+ioLane::onCacheableRequest(const Ptr<IOProtocol::Request>& req, const Ptr<FileSystem>& fs) {
+    cacheableRequest item;
+    item.req = req;
+    if (req->GetCacheReadEnabled()) {
+        item.cached = this->cache->Lookup(req->GetURL(), item.eTag, item.lastModified);
+        if (item.cached.isValid() && !this->cache->RevalidateHits()) {
+            req->SetStatus(IOStatus::OK);
+            req->SetStream(item.cached);
+            req->SetETag(item.eTag);
+            req->SetLastModified(item.lastModified);
+            req->SetHandled();
+            this->numCacheHits.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    // the filesystem gets a separate request, so that the response
+    // can be inspected before the original request is handled
+    item.proxy = IOProtocol::Request::Create();
+    item.proxy->SetURL(req->GetURL());
+    item.proxy->SetLane(req->GetLane());
+    item.proxy->SetActualLane(req->GetActualLane());
+    item.proxy->SetPriority(req->GetPriority());
+    item.proxy->SetDeadline(req->GetDeadline());
+    item.proxy->SetCacheReadEnabled(req->GetCacheReadEnabled());
+    item.proxy->SetCacheWriteEnabled(req->GetCacheWriteEnabled());
+    if (item.cached.isValid()) {
+        item.proxy->SetIfNoneMatch(item.eTag);
+        item.proxy->SetIfModifiedSince(item.lastModified);
+    }
+    fs->onRequest(item.proxy);
+    if (item.proxy->Handled()) {
+        // synchronous filesystem
+        this->completeCacheableRequest(item);
+    }
+    else {
+        this->cacheableRequests.Add(item);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioLane::updateCacheableRequests() {
+    for (int32 i = 0; i < this->cacheableRequests.Size();) {
+        const cacheableRequest& item = this->cacheableRequests[i];
+        if (item.req->Cancelled() && !item.proxy->Cancelled()) {
+            item.proxy->SetCancelled();
+        }
+        if (item.proxy->Handled()) {
+            this->completeCacheableRequest(item);
+            this->cacheableRequests.Erase(i);
+        }
+        else {
+            i++;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioLane::completeCacheableRequest(const cacheableRequest& item) {
+    const Ptr<IOProtocol::Request>& req = item.req;
+    const Ptr<IOProtocol::Request>& proxy = item.proxy;
+    if ((IOStatus::NotModified == proxy->GetStatus()) && item.cached.isValid()) {
+        // revalidated cache hit
+        req->SetStatus(IOStatus::OK);
+        req->SetStream(item.cached);
+        req->SetETag(item.eTag);
+        req->SetLastModified(item.lastModified);
+        this->numCacheHits.fetch_add(1, std::memory_order_relaxed);
+    }
+    else {
+        req->SetStatus(proxy->GetStatus());
+        req->SetStream(proxy->GetStream());
+        req->SetErrorDesc(proxy->GetErrorDesc());
+        req->SetETag(proxy->GetETag());
+        req->SetLastModified(proxy->GetLastModified());
+        if ((IOStatus::OK == proxy->GetStatus()) && proxy->GetStream().isValid() && req->GetCacheWriteEnabled()) {
+            this->cache->Store(req->GetURL(), proxy->GetETag(), proxy->GetLastModified(), proxy->GetStream());
         }
+        this->numCacheMisses.fetch_add(1, std::memory_order_relaxed);
     }
+    req->SetHandled();
 }
 
 //------------------------------------------------------------------------------
@@ -5,25 +5,47 @@
     @ingroup _priv
     @brief controls one IO lane thread
     
-    @todo: ioLane description
+    IO requests put into the lane are not dispatched in FIFO order,
+    instead the lane thread moves them into a priority queue and
+    hands them to the filesystems highest-priority first, then
+    earliest-deadline first, then in the order they were put.
+    Cancelled requests are dropped before they reach a filesystem.
+    New requests are picked up after each dispatched request, so an
+    urgent request never waits for the whole backlog.
+
+    If an IOCache is set, cacheable requests are first looked up in
+    the cache. Requests which go on to the filesystem are sent as a
+    separate proxy request, the lane watches the proxy requests in
+    onTick(), stores successful responses in the cache and completes
+    the original request.
 */
-#include "Messaging/ThreadedQueue.h"
+#include "Messaging/LockFreeQueue.h"
+#include "Core/Containers/Array.h"
 #include "Core/Containers/Map.h"
 #include "Core/String/StringAtom.h"
 #include "IO/IOProtocol.h"
+#include "IO/Core/IOLaneStats.h"
 #include "IO/FS/FileSystem.h"
+#include "IO/FS/IOCache.h"
 
 namespace Oryol {
 namespace _priv {
 
-class ioLane : public ThreadedQueue {
+class ioLane : public LockFreeQueue {
     OryolClassDecl(ioLane);
 public:
-    /// constructor
-    ioLane();
+    /// constructor with optional cache
+    ioLane(const Ptr<IOCache>& cache);
     /// destructor
     virtual ~ioLane();
     
+    /// put a message into the lane (may be called from any thread)
+    virtual bool Put(const Ptr<Message>& msg) override;
+    /// get number of requests which haven't been dispatched yet
+    int32 QueueDepth() const;
+    /// get scheduling statistics
+    IOLaneStats Stats() const;
+
 private:
     /// lookup filesystem for URL
     Ptr<FileSystem> fileSystemForURL(const URL& url);
@@ -31,6 +53,8 @@ private:
     virtual void onThreadEnter() override;
     /// called in thread before thread is left
     virtual void onThreadLeave() override ;
+    /// called for each message taken from the ring buffer
+    virtual void onMessage(const Ptr<Message>& msg) override;
     /// called after messages are processed, and on each tick (if a TickDuration is set)
     virtual void onTick() override;
     /// callback for IOProtocol::Request
@@ -41,9 +65,57 @@ private:
     void onNotifyFileSystemReplaced(const Ptr<IOProtocol::notifyFileSystemReplaced>& msg);
     /// callback for IOProtocol::notifyFileSystemRemoved
     void onNotifyFileSystemRemoved(const Ptr<IOProtocol::notifyFileSystemRemoved>& msg);
+    /// dispatch pending requests in priority order, optionally pick up new requests in between
+    void dispatchRequests(bool pollNewRequests);
+    /// return true if a request should go through the cache
+    bool isCacheable(const Ptr<IOProtocol::Request>& req) const;
+    /// handle a cacheable request, answer from cache or send proxy request to filesystem
+    void onCacheableRequest(const Ptr<IOProtocol::Request>& req, const Ptr<FileSystem>& fs);
+    /// complete cacheable requests whose proxy request has been handled
+    void updateCacheableRequests();
+
+    struct cacheableRequest {
+        Ptr<IOProtocol::Request> req;       // the original request
+        Ptr<IOProtocol::Request> proxy;     // the request sent to the filesystem
+        Ptr<Stream> cached;                 // cached data if hit is revalidated
+        String eTag;
+        String lastModified;
+    };
+    /// complete a cacheable request from its handled proxy request
+    void completeCacheableRequest(const cacheableRequest& item);
+
+    struct pendingRequest {
+        Ptr<IOProtocol::Request> req;
+        int32 priority;
+        int64 deadline;     // raw TimePoint, max int64 if no deadline
+        uint64 seq;
+    };
+    /// heap ordering, true if a is dispatched after b
+    static bool dispatchedAfter(const pendingRequest& a, const pendingRequest& b);
 
     Map<StringAtom, Ptr<FileSystem>> fileSystems;
+    Ptr<IOCache> cache;
+    Array<cacheableRequest> cacheableRequests;  // waiting for their proxy request
+    Array<pendingRequest> pendingRequests;  // binary heap, only accessed by lane thread
+    uint64 pendingSeq = 0;
+
+    // written by the lane thread (queueDepth also by producers), read by any thread
+    std::atomic<int32> queueDepth{0};
+    std::atomic<int32> maxQueueDepth{0};
+    std::atomic<int32> numDispatched{0};
+    std::atomic<int32> numCancelled{0};
+    std::atomic<int32> numMissedDeadlines{0};
+    std::atomic<int64> totalWaitTicks{0};
+    std::atomic<int64> maxWaitTicks{0};
+    std::atomic<int32> numCacheHits{0};
+    std::atomic<int32> numCacheMisses{0};
 };
+
+//------------------------------------------------------------------------------
+inline int32
+ioLane::QueueDepth() const {
+    return this->queueDepth.load(std::memory_order_relaxed);
+}
     
 } // namespace _priv
 } // namespace Oryol
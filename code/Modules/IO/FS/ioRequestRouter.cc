@@ -8,13 +8,13 @@ namespace Oryol {
 namespace _priv {
 
 //------------------------------------------------------------------------------
-ioRequestRouter::ioRequestRouter(int32 numLanes_) :
+ioRequestRouter::ioRequestRouter(int32 numLanes_, const Ptr<IOCache>& cache) :
 numLanes(numLanes_) {
 
     // create ioLanes
     this->ioLanes.Reserve(this->numLanes);
     for (int32 i = 0; i < this->numLanes; i++) {
-        Ptr<ioLane> newLane = ioLane::Create();
+        Ptr<ioLane> newLane = ioLane::Create(cache);
         newLane->StartThread();
         this->ioLanes.Add(newLane);
     }
@@ -42,7 +42,7 @@ ioRequestRouter::Put(const Ptr<Message>& msg) {
     else {
         Ptr<IOProtocol::Request> req = msg->DynamicCast<IOProtocol::Request>();
         if (req.isValid()) {
-            const int32 laneIndex = req->GetLane() % this->numLanes;
+            const int32 laneIndex = this->selectLane(req->GetLane() % this->numLanes);
             req->SetActualLane(laneIndex);
             this->ioLanes[laneIndex]->Put(msg);
             return true;
@@ -53,6 +53,33 @@ ioRequestRouter::Put(const Ptr<Message>& msg) {
     return false;
 }
 
+//------------------------------------------------------------------------------
+int32
+ioRequestRouter::selectLane(int32 preferredLane) const {
+    int32 bestLane = preferredLane;
+    int32 bestDepth = this->ioLanes[preferredLane]->QueueDepth();
+    for (int32 i = 0; (i < this->numLanes) && (bestDepth > 0); i++) {
+        const int32 depth = this->ioLanes[i]->QueueDepth();
+        if (depth < bestDepth) {
+            bestLane = i;
+            bestDepth = depth;
+        }
+    }
+    return bestLane;
+}
+
+//------------------------------------------------------------------------------
+int32
+ioRequestRouter::NumLanes() const {
+    return this->numLanes;
+}
+
+//------------------------------------------------------------------------------
+IOLaneStats
+ioRequestRouter::LaneStats(int32 laneIndex) const {
+    return this->ioLanes[laneIndex]->Stats();
+}
+
 //------------------------------------------------------------------------------
 void
 ioRequestRouter::DoWork() {
@@ -5,7 +5,10 @@
     @ingroup _priv
     @brief front end router port of the IO system
     
-    @todo: ioRequestRouter description
+    Distributes IO requests to the ioLanes. A request goes to the lane
+    with the fewest queued requests, the request's Lane attribute is
+    only used as tie-breaker. Filesystem notifications are sent to all
+    lanes.
 */
 #include "IO/Core/IOConfig.h"
 #include "Messaging/Port.h"
@@ -17,8 +20,8 @@ namespace _priv {
 class ioRequestRouter : public Port {
     OryolClassDecl(ioRequestRouter);
 public:
-    /// constructor
-    ioRequestRouter(int32 numLanes);
+    /// constructor with number of lanes and optional cache
+    ioRequestRouter(int32 numLanes, const Ptr<IOCache>& cache);
     /// destructor
     virtual ~ioRequestRouter();
     
@@ -27,7 +30,15 @@ public:
     /// perform work, this will be invoked on downstream ports
     virtual void DoWork() override;
     
+    /// get number of lanes
+    int32 NumLanes() const;
+    /// get scheduling statistics of a lane
+    IOLaneStats LaneStats(int32 laneIndex) const;
+
 private:
+    /// select the least busy lane
+    int32 selectLane(int32 preferredLane) const;
+
     int32 numLanes;
     Array<Ptr<ioLane>> ioLanes;
 };
@@ -19,7 +19,7 @@ IO::Setup(const IOSetup& setup) {
     o_assert(!IsValid());
     
     state = Memory::New<_state>();
-    state->requestRouter = ioRequestRouter::Create(setup.NumIOLanes);
+    state->requestRouter = ioRequestRouter::Create(setup.NumIOLanes, setup.Cache);
     
     // setup initial assigns
     for (const auto& assign : setup.Assigns) {
@@ -140,6 +140,21 @@ IO::Put(const Ptr<IOProtocol::Request>& ioReq) {
     state->requestRouter->Put(ioReq);
 }
 
+//------------------------------------------------------------------------------
+int32
+IO::NumLanes() {
+    o_assert_dbg(IsValid());
+    return state->requestRouter->NumLanes();
+}
+
+//------------------------------------------------------------------------------
+IOLaneStats
+IO::LaneStats(int32 laneIndex) {
+    o_assert_dbg(IsValid());
+    o_assert_range_dbg(laneIndex, state->requestRouter->NumLanes());
+    return state->requestRouter->LaneStats(laneIndex);
+}
+
 //------------------------------------------------------------------------------
 schemeRegistry*
 IO::getSchemeRegistry() {
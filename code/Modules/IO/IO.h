@@ -49,6 +49,11 @@ public:
     static Ptr<IOProtocol::Request> LoadFile(const URL& url, int32 ioLane=0);
     /// push a generic asynchronous IO request
     static void Put(const Ptr<IOProtocol::Request>& ioReq);
+
+    /// get number of IO lanes
+    static int32 NumLanes();
+    /// get scheduling statistics of an IO lane
+    static IOLaneStats LaneStats(int32 laneIndex);
     
 private:
     friend class _priv::ioLane;
@@ -11,6 +11,8 @@
 #include "IO/Core/URL.h"
 #include "IO/Core/IOStatus.h"
 #include "IO/Stream/MemoryStream.h"
+#include "IO/Stream/ChunkedStream.h"
+#include "Time/TimePoint.h"
 
 namespace Oryol {
 class IOProtocol {
@@ -65,6 +67,7 @@ public:
             this->cachewriteenabled = true;
             this->startoffset = 0;
             this->endoffset = 0;
+            this->priority = 0;
             this->status = IOStatus::InvalidIOStatus;
             this->actuallane = 0;
         };
@@ -120,6 +123,36 @@ public:
         int32 GetEndOffset() const {
             return this->endoffset;
         };
+        void SetPriority(int32 val) {
+            this->priority = val;
+        };
+        int32 GetPriority() const {
+            return this->priority;
+        };
+        void SetDeadline(const TimePoint& val) {
+            this->deadline = val;
+        };
+        const TimePoint& GetDeadline() const {
+            return this->deadline;
+        };
+        void SetIfNoneMatch(const String& val) {
+            this->ifnonematch = val;
+        };
+        const String& GetIfNoneMatch() const {
+            return this->ifnonematch;
+        };
+        void SetIfModifiedSince(const String& val) {
+            this->ifmodifiedsince = val;
+        };
+        const String& GetIfModifiedSince() const {
+            return this->ifmodifiedsince;
+        };
+        void SetProgressiveStream(const Ptr<ChunkedStream>& val) {
+            this->progressivestream = val;
+        };
+        const Ptr<ChunkedStream>& GetProgressiveStream() const {
+            return this->progressivestream;
+        };
         void SetStatus(const IOStatus::Code& val) {
             this->status = val;
         };
@@ -144,6 +177,24 @@ public:
         int32 GetActualLane() const {
             return this->actuallane;
         };
+        void SetEnqueueTime(const TimePoint& val) {
+            this->enqueuetime = val;
+        };
+        const TimePoint& GetEnqueueTime() const {
+            return this->enqueuetime;
+        };
+        void SetETag(const String& val) {
+            this->etag = val;
+        };
+        const String& GetETag() const {
+            return this->etag;
+        };
+        void SetLastModified(const String& val) {
+            this->lastmodified = val;
+        };
+        const String& GetLastModified() const {
+            return this->lastmodified;
+        };
 private:
         uint64 serialid;
         URL url;
@@ -152,10 +203,18 @@ private:
         bool cachewriteenabled;
         int32 startoffset;
         int32 endoffset;
+        int32 priority;
+        TimePoint deadline;
+        String ifnonematch;
+        String ifmodifiedsince;
+        Ptr<ChunkedStream> progressivestream;
         IOStatus::Code status;
         String errordesc;
         Ptr<Stream> stream;
         int32 actuallane;
+        TimePoint enqueuetime;
+        String etag;
+        String lastmodified;
     };
     class notifyLanes : public Message {
         OryolClassDecl(notifyLanes);
@@ -0,0 +1,263 @@
+//------------------------------------------------------------------------------
+//  ChunkedStream.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "ChunkedStream.h"
+#include "Core/Memory/Memory.h"
+#include <algorithm>
+
+namespace Oryol {
+
+OryolClassImpl(ChunkedStream);
+
+//------------------------------------------------------------------------------
+ChunkedStream::ChunkedStream() :
+ChunkedStream(ORYOL_STREAM_DEFAULT_CHUNK_SIZE) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+ChunkedStream::ChunkedStream(int32 chunkSize_) :
+chunkSize(chunkSize_),
+available(0),
+expectedSize(-1),
+complete(false),
+failed(false),
+appendOffset(0),
+readOffset(0) {
+    o_assert(chunkSize_ > 0);
+}
+
+//------------------------------------------------------------------------------
+ChunkedStream::~ChunkedStream() {
+    if (this->IsOpen()) {
+        this->Close();
+    }
+    this->DiscardContent();
+}
+
+//------------------------------------------------------------------------------
+int32
+ChunkedStream::ChunkSize() const {
+    return this->chunkSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+ The data is copied into the chunks without holding the lock, the
+ consumer only looks at bytes below the published available size.
+*/
+int32
+ChunkedStream::Write(const void* ptr, int32 numBytes) {
+    o_assert((nullptr != ptr) || (0 == numBytes));
+    o_assert(numBytes >= 0);
+    const uint8* src = (const uint8*) ptr;
+    int32 bytesLeft = numBytes;
+    while (bytesLeft > 0) {
+        const int32 chunkIndex = int32(this->appendOffset / this->chunkSize);
+        const int32 chunkOffset = int32(this->appendOffset % this->chunkSize);
+        uint8* chunk = nullptr;
+        if (0 == chunkOffset) {
+            chunk = (uint8*) Memory::Alloc(this->chunkSize);
+            std::lock_guard<std::mutex> guard(this->lock);
+            o_assert(!this->complete);
+            this->chunks.Add(chunk);
+        }
+        else {
+            std::lock_guard<std::mutex> guard(this->lock);
+            chunk = this->chunks[chunkIndex];
+        }
+        const int32 num = std::min(bytesLeft, this->chunkSize - chunkOffset);
+        Memory::Copy(src, chunk + chunkOffset, num);
+        src += num;
+        bytesLeft -= num;
+        this->appendOffset += num;
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->available = this->appendOffset;
+        }
+        this->arrived.notify_all();
+    }
+    return numBytes;
+}
+
+//------------------------------------------------------------------------------
+void
+ChunkedStream::SetExpectedSize(int64 numBytes) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->expectedSize = numBytes;
+}
+
+//------------------------------------------------------------------------------
+void
+ChunkedStream::Finish() {
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        o_assert(!this->complete);
+        this->complete = true;
+        this->size = this->available > 0x7FFFFFFF ? 0x7FFFFFFF : int32(this->available);
+    }
+    this->arrived.notify_all();
+}
+
+//------------------------------------------------------------------------------
+void
+ChunkedStream::Fail() {
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        o_assert(!this->complete);
+        this->complete = true;
+        this->failed = true;
+    }
+    this->arrived.notify_all();
+}
+
+//------------------------------------------------------------------------------
+int64
+ChunkedStream::AvailableSize() const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->available;
+}
+
+//------------------------------------------------------------------------------
+int64
+ChunkedStream::ExpectedSize() const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->expectedSize;
+}
+
+//------------------------------------------------------------------------------
+bool
+ChunkedStream::IsComplete() const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->complete;
+}
+
+//------------------------------------------------------------------------------
+bool
+ChunkedStream::IsFailed() const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->failed;
+}
+
+//------------------------------------------------------------------------------
+bool
+ChunkedStream::WaitAvailable(int64 numBytes) const {
+    std::unique_lock<std::mutex> guard(this->lock);
+    this->arrived.wait(guard, [this, numBytes] {
+        return this->complete || (this->available >= numBytes);
+    });
+    return this->available >= numBytes;
+}
+
+//------------------------------------------------------------------------------
+int32
+ChunkedStream::ReadAt(int64 offset, void* ptr, int32 numBytes) const {
+    o_assert((offset >= 0) && (numBytes >= 0));
+    uint8* dst = (uint8*) ptr;
+    int32 bytesRead = 0;
+    while (bytesRead < numBytes) {
+        const int32 chunkIndex = int32(offset / this->chunkSize);
+        const int32 chunkOffset = int32(offset % this->chunkSize);
+        const uint8* chunk = nullptr;
+        int64 avail = 0;
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            avail = this->available;
+            if (offset < avail) {
+                chunk = this->chunks[chunkIndex];
+            }
+        }
+        if (nullptr == chunk) {
+            break;
+        }
+        int64 num = std::min(int64(numBytes - bytesRead), avail - offset);
+        num = std::min(num, int64(this->chunkSize - chunkOffset));
+        Memory::Copy(chunk + chunkOffset, dst + bytesRead, int32(num));
+        bytesRead += int32(num);
+        offset += num;
+    }
+    return bytesRead;
+}
+
+//------------------------------------------------------------------------------
+bool
+ChunkedStream::Open(OpenMode::Enum mode) {
+    o_assert2(OpenMode::ReadOnly == mode, "ChunkedStream can only be opened as ReadOnly!\n");
+    this->readOffset = 0;
+    return Stream::Open(mode);
+}
+
+//------------------------------------------------------------------------------
+void
+ChunkedStream::DiscardContent() {
+    o_assert(!this->isOpen);
+    std::lock_guard<std::mutex> guard(this->lock);
+    for (uint8* chunk : this->chunks) {
+        Memory::Free(chunk);
+    }
+    this->chunks.Clear();
+    this->available = 0;
+    this->expectedSize = -1;
+    this->complete = false;
+    this->failed = false;
+    this->appendOffset = 0;
+    this->readOffset = 0;
+    this->size = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+ChunkedStream::SetReadOffset(int64 offset) {
+    o_assert(offset >= 0);
+    this->readOffset = offset;
+}
+
+//------------------------------------------------------------------------------
+int64
+ChunkedStream::GetReadOffset() const {
+    return this->readOffset;
+}
+
+//------------------------------------------------------------------------------
+int32
+ChunkedStream::Read(void* ptr, int32 numBytes) {
+    o_assert(this->isOpen);
+    o_assert(this->IsReadable());
+    if (EndOfStream == numBytes) {
+        const int64 avail = this->AvailableSize() - this->readOffset;
+        numBytes = avail > 0x7FFFFFFF ? 0x7FFFFFFF : int32(avail);
+    }
+    const int32 bytesRead = this->ReadAt(this->readOffset, ptr, numBytes);
+    this->readOffset += bytesRead;
+    return bytesRead;
+}
+
+//------------------------------------------------------------------------------
+const uint8*
+ChunkedStream::MapRead(const uint8** outMaxValidPtr) {
+    o_assert(this->isOpen);
+    o_assert(!this->isReadMapped);
+    o_assert(this->IsReadable());
+
+    this->isReadMapped = true;
+    const int32 chunkIndex = int32(this->readOffset / this->chunkSize);
+    const int32 chunkOffset = int32(this->readOffset % this->chunkSize);
+    const uint8* ptr = nullptr;
+    const uint8* maxValidPtr = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        if (this->readOffset < this->available) {
+            const int64 chunkEnd = int64(chunkIndex + 1) * this->chunkSize;
+            const int64 end = std::min(chunkEnd, this->available);
+            ptr = this->chunks[chunkIndex] + chunkOffset;
+            maxValidPtr = ptr + (end - this->readOffset);
+        }
+    }
+    if (nullptr != outMaxValidPtr) {
+        *outMaxValidPtr = maxValidPtr;
+    }
+    return ptr;
+}
+
+} // namespace Oryol
@@ -0,0 +1,110 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::ChunkedStream
+    @ingroup IO
+    @brief a growable stream for progressive loading
+
+    A ChunkedStream stores its content in fixed-size chunks which are
+    never moved or reallocated, and has 64-bit sizes and read offsets.
+    One producer thread (usually an IO lane) appends data with Write()
+    and finally calls Finish() or Fail(), while one consumer thread
+    reads the data which has arrived so far. The producer doesn't need
+    to open the stream, the consumer opens it as ReadOnly:
+
+        Ptr<ChunkedStream> stream = ChunkedStream::Create();
+        Ptr<IOProtocol::Request> req = IOProtocol::Request::Create();
+        req->SetURL("file:///home/bla/big.dds");
+        req->SetProgressiveStream(stream);
+        IO::Put(req);
+        ...
+        stream->Open(OpenMode::ReadOnly);
+        while (stream->AvailableSize() > stream->GetReadOffset()) {
+            const uint8* end = nullptr;
+            const uint8* ptr = stream->MapRead(&end);
+            ...consume (end - ptr) bytes...
+            stream->UnmapRead();
+            stream->SetReadOffset(stream->GetReadOffset() + (end - ptr));
+        }
+        stream->Close();
+
+    Read() and MapRead() never block and only return data which has
+    already arrived, MapRead() maps at most up to the end of a chunk.
+    The inherited 32-bit Size() is only valid after IsComplete()
+    returned true, use AvailableSize() and ExpectedSize() instead.
+
+    File systems which don't support progressive loading ignore the
+    ProgressiveStream of a request and return a complete Stream as
+    usual, so the consumer should also check whether the request has
+    been handled.
+*/
+#include "IO/Core/IOConfig.h"
+#include "IO/Stream/Stream.h"
+#include "Core/Containers/Array.h"
+#include <mutex>
+#include <condition_variable>
+
+namespace Oryol {
+
+class ChunkedStream : public Stream {
+    OryolClassDecl(ChunkedStream);
+public:
+    /// constructor
+    ChunkedStream();
+    /// construct with chunk size
+    ChunkedStream(int32 chunkSize);
+    /// destructor
+    virtual ~ChunkedStream();
+
+    /// get the chunk size
+    int32 ChunkSize() const;
+
+    /// append data (producer side, doesn't need the stream to be open)
+    virtual int32 Write(const void* ptr, int32 numBytes) override;
+    /// optionally announce the final size (producer side)
+    void SetExpectedSize(int64 numBytes);
+    /// mark the stream as complete (producer side)
+    void Finish();
+    /// mark the stream as complete but failed (producer side)
+    void Fail();
+
+    /// get number of bytes which have arrived so far
+    int64 AvailableSize() const;
+    /// get the announced final size, or -1 if unknown
+    int64 ExpectedSize() const;
+    /// return true if the producer has called Finish() or Fail()
+    bool IsComplete() const;
+    /// return true if the producer has called Fail()
+    bool IsFailed() const;
+    /// block until numBytes have arrived, returns false if the stream completed with less
+    bool WaitAvailable(int64 numBytes) const;
+    /// copy arrived bytes at an offset, returns number of bytes copied (doesn't need the stream to be open)
+    int32 ReadAt(int64 offset, void* ptr, int32 numBytes) const;
+
+    /// open the stream for reading (only OpenMode::ReadOnly is allowed)
+    virtual bool Open(OpenMode::Enum mode) override;
+    /// discard the content of the stream (the producer must be done)
+    virtual void DiscardContent() override;
+    /// set the 64-bit read offset
+    void SetReadOffset(int64 offset);
+    /// get the 64-bit read offset
+    int64 GetReadOffset() const;
+    /// read arrived bytes at the read offset and advance the read offset
+    virtual int32 Read(void* ptr, int32 numBytes) override;
+    /// map the arrived bytes of the chunk at the read offset, DOES NOT ADVANCE READ-OFFSET!
+    virtual const uint8* MapRead(const uint8** outMaxValidPtr) override;
+
+private:
+    const int32 chunkSize;
+    mutable std::mutex lock;
+    mutable std::condition_variable arrived;
+    Array<uint8*> chunks;       // guarded by lock
+    int64 available;            // guarded by lock
+    int64 expectedSize;         // guarded by lock
+    bool complete;              // guarded by lock
+    bool failed;                // guarded by lock
+    int64 appendOffset;         // producer side only
+    int64 readOffset;           // consumer side only
+};
+
+} // namespace Oryol
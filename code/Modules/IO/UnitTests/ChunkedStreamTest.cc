@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+//  ChunkedStreamTest.cc
+//  Test ChunkedStream functionality.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/Stream/ChunkedStream.h"
+#include <thread>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(ChunkedStreamTest) {
+    Ptr<ChunkedStream> stream = ChunkedStream::Create(16);
+    CHECK(stream->ChunkSize() == 16);
+    CHECK(stream->AvailableSize() == 0);
+    CHECK(stream->ExpectedSize() == -1);
+    CHECK(!stream->IsComplete());
+
+    // append across chunk boundaries
+    uint8 data[100];
+    for (int32 i = 0; i < 100; i++) {
+        data[i] = uint8(i);
+    }
+    stream->SetExpectedSize(100);
+    CHECK(stream->Write(data, 10) == 10);
+    CHECK(stream->Write(data + 10, 30) == 30);
+    CHECK(stream->AvailableSize() == 40);
+    CHECK(stream->ExpectedSize() == 100);
+
+    // MapRead maps up to the end of a chunk
+    CHECK(stream->Open(OpenMode::ReadOnly));
+    const uint8* end = nullptr;
+    const uint8* ptr = stream->MapRead(&end);
+    CHECK((end - ptr) == 16);
+    CHECK(ptr[0] == 0);
+    stream->UnmapRead();
+    stream->SetReadOffset(36);
+    ptr = stream->MapRead(&end);
+    CHECK((end - ptr) == 4);
+    CHECK(ptr[0] == 36);
+    stream->UnmapRead();
+
+    // Read only returns bytes which have arrived
+    uint8 buf[100] = { 0 };
+    stream->SetReadOffset(5);
+    CHECK(stream->Read(buf, 50) == 35);
+    CHECK(stream->GetReadOffset() == 40);
+    CHECK(buf[0] == 5 && buf[34] == 39);
+    CHECK(stream->Read(buf, 10) == 0);
+    ptr = stream->MapRead(&end);
+    CHECK(nullptr == ptr);
+    stream->UnmapRead();
+
+    // finish the stream
+    stream->Write(data + 40, 60);
+    stream->Finish();
+    CHECK(stream->IsComplete());
+    CHECK(!stream->IsFailed());
+    CHECK(stream->Size() == 100);
+    CHECK(stream->Read(buf, EndOfStream) == 60);
+    CHECK(buf[0] == 40 && buf[59] == 99);
+    CHECK(stream->ReadAt(90, buf, 20) == 10);
+    CHECK(buf[0] == 90);
+    CHECK(stream->WaitAvailable(100));
+    CHECK(!stream->WaitAvailable(101));
+    stream->Close();
+
+    stream->DiscardContent();
+    CHECK(stream->AvailableSize() == 0);
+    CHECK(!stream->IsComplete());
+    stream->Fail();
+    CHECK(stream->IsComplete());
+    CHECK(stream->IsFailed());
+}
+
+//------------------------------------------------------------------------------
+TEST(ChunkedStreamThreadTest) {
+    // a producer thread appends while the consumer reads
+    const int32 numBytes = 1000000;
+    Ptr<ChunkedStream> stream = ChunkedStream::Create(4096);
+    std::thread producer([stream, numBytes] {
+        uint8 buf[1000];
+        for (int32 pos = 0; pos < numBytes; pos += 1000) {
+            for (int32 i = 0; i < 1000; i++) {
+                buf[i] = uint8((pos + i) * 7);
+            }
+            stream->Write(buf, 1000);
+        }
+        stream->Finish();
+    });
+
+    bool valid = true;
+    int64 pos = 0;
+    stream->Open(OpenMode::ReadOnly);
+    while (stream->WaitAvailable(pos + 1)) {
+        const uint8* end = nullptr;
+        const uint8* ptr = stream->MapRead(&end);
+        for (const uint8* p = ptr; p < end; p++, pos++) {
+            valid &= (*p == uint8(pos * 7));
+        }
+        stream->UnmapRead();
+        stream->SetReadOffset(pos);
+    }
+    stream->Close();
+    producer.join();
+    CHECK(valid);
+    CHECK(pos == numBytes);
+    CHECK(stream->IsComplete());
+}
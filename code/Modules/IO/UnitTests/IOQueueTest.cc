@@ -0,0 +1,179 @@
+//------------------------------------------------------------------------------
+//  IOQueueTest.cc
+//  Test IOQueue completion handling, and benchmark it with many
+//  requests in flight.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/IO.h"
+#include "IO/Core/IOQueue.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Log.h"
+#include "Core/String/StringBuilder.h"
+#include <chrono>
+#include <cstring>
+#include <mutex>
+
+using namespace Oryol;
+using namespace std::chrono;
+
+namespace {
+
+std::mutex heldLock;
+Array<Ptr<IOProtocol::Request>> heldRequests;
+
+// a filesystem which holds on to requests until they are released
+class HoldFileSystem : public FileSystem {
+    OryolClassDecl(HoldFileSystem);
+    OryolClassCreator(HoldFileSystem);
+public:
+    virtual void onRequest(const Ptr<IOProtocol::Request>& msg) override {
+        std::lock_guard<std::mutex> lock(heldLock);
+        heldRequests.Add(msg);
+    };
+};
+OryolClassImpl(HoldFileSystem);
+
+int32
+numHeld() {
+    std::lock_guard<std::mutex> lock(heldLock);
+    return heldRequests.Size();
+}
+
+void
+waitHeld(int32 num) {
+    while (numHeld() < num) {
+        Core::PreRunLoop()->Run();
+    }
+}
+
+// handle all held requests, requests with 'fail' in the URL fail
+void
+releaseHeld() {
+    std::lock_guard<std::mutex> lock(heldLock);
+    for (const auto& req : heldRequests) {
+        const bool fail = nullptr != std::strstr(req->GetURL().AsCStr(), "fail");
+        req->SetStatus(fail ? IOStatus::NotFound : IOStatus::OK);
+        if (!fail) {
+            req->SetStream(MemoryStream::Create());
+        }
+        req->SetHandled();
+    }
+    heldRequests.Clear();
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(IOQueueTest) {
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("hold", HoldFileSystem::Creator());
+    IO::Setup(ioSetup);
+
+    int32 numSuccess = 0;
+    int32 numFailed = 0;
+    int32 numGroupSuccess = 0;
+    IOQueue queue;
+    queue.Start();
+    auto onSuccess = [&numSuccess](const Ptr<Stream>& stream) { numSuccess++; };
+    auto onFail = [&numFailed](const URL& url, IOStatus::Code status) { numFailed++; };
+    queue.Add("hold://a", onSuccess, onFail);
+    queue.Add("hold://fail", onSuccess, onFail);
+    queue.Add("hold://c", onSuccess, onFail);
+    queue.AddGroup({ "hold://g0", "hold://g1" }, [&numGroupSuccess](const Array<Ptr<Stream>>& streams) {
+        numGroupSuccess += streams.Size();
+    }, onFail);
+    queue.AddGroup({ "hold://g2", "hold://fail_g" }, [&numGroupSuccess](const Array<Ptr<Stream>>& streams) {
+        numGroupSuccess += streams.Size();
+    }, onFail);
+    CHECK(!queue.Empty());
+
+    // nothing happens until the requests are handled
+    waitHeld(7);
+    Core::PreRunLoop()->Run();
+    CHECK((0 == numSuccess) && (0 == numFailed) && (0 == numGroupSuccess));
+    releaseHeld();
+    Core::PreRunLoop()->Run();
+    CHECK(numSuccess == 2);
+    CHECK(numFailed == 2);
+    CHECK(numGroupSuccess == 2);
+    CHECK(queue.Empty());
+
+    // the callbacks may add new requests
+    queue.Add("hold://b", [&queue, &numSuccess, onFail](const Ptr<Stream>& stream) {
+        numSuccess++;
+        queue.Add("hold://bb", [&numSuccess](const Ptr<Stream>& stream) { numSuccess += 10; }, onFail);
+    }, onFail);
+    waitHeld(1);
+    releaseHeld();
+    Core::PreRunLoop()->Run();
+    CHECK(numSuccess == 3);
+    waitHeld(1);
+    releaseHeld();
+    Core::PreRunLoop()->Run();
+    CHECK(numSuccess == 13);
+    CHECK(queue.Empty());
+
+    queue.Stop();
+    IO::Discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(IOQueueBenchmark) {
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("hold", HoldFileSystem::Creator());
+    IO::Setup(ioSetup);
+
+    const int32 numRequests = 10000;
+    int32 numSuccess = 0;
+    IOQueue queue;
+    queue.Start();
+    StringBuilder strBuilder;
+    for (int32 i = 0; i < numRequests; i++) {
+        strBuilder.Format(32, "hold://%d", i);
+        queue.Add(strBuilder.GetString(), [&numSuccess](const Ptr<Stream>& stream) {
+            numSuccess++;
+        });
+    }
+    waitHeld(numRequests);
+
+    // per-frame cost with all requests in flight, and none completed
+    const int32 numFrames = 1000;
+    auto start = steady_clock::now();
+    for (int32 i = 0; i < numFrames; i++) {
+        Core::PreRunLoop()->Run();
+    }
+    duration<double> idleDur = steady_clock::now() - start;
+    CHECK(0 == numSuccess);
+
+    // for comparison: polling Handled() on each request every frame
+    Array<Ptr<IOProtocol::Request>> requests;
+    {
+        std::lock_guard<std::mutex> lock(heldLock);
+        requests = heldRequests;
+    }
+    int32 numHandled = 0;
+    start = steady_clock::now();
+    for (int32 i = 0; i < numFrames; i++) {
+        for (const auto& req : requests) {
+            numHandled += req->Handled() ? 1 : 0;
+        }
+    }
+    duration<double> pollDur = steady_clock::now() - start;
+    CHECK(0 == numHandled);
+
+    // complete all requests, and drain the queue in one frame
+    releaseHeld();
+    start = steady_clock::now();
+    Core::PreRunLoop()->Run();
+    duration<double> drainDur = steady_clock::now() - start;
+    CHECK(numSuccess == numRequests);
+    CHECK(queue.Empty());
+
+    Log::Info("IOQueue: %d requests in flight: %.3f usec/frame idle (polling: %.3f usec/frame), %.3f msec to complete all\n",
+        numRequests, idleDur.count() * 1e6 / numFrames, pollDur.count() * 1e6 / numFrames, drainDur.count() * 1e3);
+
+    queue.Stop();
+    IO::Discard();
+}
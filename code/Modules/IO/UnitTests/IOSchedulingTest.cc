@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+//  IOSchedulingTest.cc
+//  Test priority and deadline scheduling of IO requests.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/IO.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Time/Clock.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+using namespace Oryol;
+
+namespace {
+
+std::atomic<bool> gateOpen{false};
+std::atomic<bool> gateEntered{false};
+std::mutex handledLock;
+Array<String> handledPaths;
+
+// a filesystem which blocks on the 'gate' file until the gate is opened
+class GateFileSystem : public FileSystem {
+    OryolClassDecl(GateFileSystem);
+    OryolClassCreator(GateFileSystem);
+public:
+    virtual void onRequest(const Ptr<IOProtocol::Request>& msg) override {
+        const String path = msg->GetURL().Path();
+        if (path == "gate") {
+            gateEntered = true;
+            while (!gateOpen) {
+                std::this_thread::yield();
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(handledLock);
+            handledPaths.Add(path);
+        }
+        msg->SetStatus(IOStatus::OK);
+        msg->SetHandled();
+    };
+};
+OryolClassImpl(GateFileSystem);
+
+Ptr<IOProtocol::Request>
+makeRequest(const char* url, int32 priority) {
+    Ptr<IOProtocol::Request> req = IOProtocol::Request::Create();
+    req->SetURL(url);
+    req->SetPriority(priority);
+    return req;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(IOSchedulingTest) {
+    IOSetup ioSetup;
+    ioSetup.NumIOLanes = 1;
+    IO::Setup(ioSetup);
+    IO::RegisterFileSystem("gate", GateFileSystem::Creator());
+    CHECK(IO::NumLanes() == 1);
+
+    // block the lane, and queue requests behind the blocking request
+    gateOpen = false;
+    gateEntered = false;
+    auto gate = makeRequest("gate://host/gate", 0);
+    IO::Put(gate);
+    while (!gateEntered) {
+        std::this_thread::yield();
+    }
+    auto low0 = makeRequest("gate://host/low0", 0);
+    auto low1 = makeRequest("gate://host/low1", 0);
+    auto high = makeRequest("gate://host/high", 10);
+    auto deadline = makeRequest("gate://host/deadline", 0);
+    deadline->SetDeadline(Clock::Now() + Duration::FromSeconds(10.0));
+    auto cancelled = makeRequest("gate://host/cancelled", 5);
+    IO::Put(low0);
+    IO::Put(low1);
+    IO::Put(high);
+    IO::Put(deadline);
+    IO::Put(cancelled);
+    cancelled->SetCancelled();
+    CHECK(IO::LaneStats(0).QueueDepth == 6);
+
+    // release the lane and wait until everything is handled
+    gateOpen = true;
+    while (IO::LaneStats(0).QueueDepth > 0) {
+        Core::PreRunLoop()->Run();
+        std::this_thread::yield();
+    }
+    CHECK(low0->Handled() && low1->Handled() && high->Handled() && deadline->Handled());
+    CHECK(cancelled->Handled());
+    CHECK(cancelled->GetStatus() == IOStatus::Cancelled);
+    {
+        std::lock_guard<std::mutex> lock(handledLock);
+        CHECK(handledPaths.Size() == 5);
+        if (handledPaths.Size() == 5) {
+            CHECK(handledPaths[0] == "gate");
+            CHECK(handledPaths[1] == "high");
+            CHECK(handledPaths[2] == "deadline");
+            CHECK(handledPaths[3] == "low0");
+            CHECK(handledPaths[4] == "low1");
+        }
+        handledPaths.Clear();
+    }
+    IOLaneStats stats = IO::LaneStats(0);
+    CHECK(stats.QueueDepth == 0);
+    CHECK(stats.MaxQueueDepth >= 5);
+    CHECK(stats.NumDispatched == 5);
+    CHECK(stats.NumCancelled == 1);
+    CHECK(stats.NumMissedDeadlines == 0);
+    CHECK(stats.MaxWaitTime >= stats.AvgWaitTime);
+    CHECK(stats.MaxWaitTime > Duration());
+    IO::Discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(IOLaneBalancingTest) {
+    IOSetup ioSetup;
+    ioSetup.NumIOLanes = 2;
+    IO::Setup(ioSetup);
+    IO::RegisterFileSystem("gate", GateFileSystem::Creator());
+
+    // block lane 0, requests for lane 0 must go to lane 1 instead
+    gateOpen = false;
+    gateEntered = false;
+    auto gate = makeRequest("gate://host/gate", 0);
+    IO::Put(gate);
+    CHECK(gate->GetActualLane() == 0);
+    while (!gateEntered) {
+        std::this_thread::yield();
+    }
+    auto req = makeRequest("gate://host/req", 0);
+    IO::Put(req);
+    CHECK(req->GetActualLane() == 1);
+    while (!req->Handled()) {
+        Core::PreRunLoop()->Run();
+        std::this_thread::yield();
+    }
+    CHECK(!gate->Handled());
+    gateOpen = true;
+    while (!gate->Handled()) {
+        Core::PreRunLoop()->Run();
+        std::this_thread::yield();
+    }
+    {
+        std::lock_guard<std::mutex> lock(handledLock);
+        handledPaths.Clear();
+    }
+    IO::Discard();
+}
@@ -5,7 +5,13 @@
     @ingroup _priv
     @brief frontend inputMgr class
 */
-#if ORYOL_D3D11
+#if ORYOL_NULL_GFX
+#include "Input/base/inputMgrBase.h"
+namespace Oryol {
+namespace _priv {
+class inputMgr : public inputMgrBase { };
+} }
+#elif ORYOL_D3D11
 #include "Input/d3d11/d3d11InputMgr.h"
 namespace Oryol {
 namespace _priv {
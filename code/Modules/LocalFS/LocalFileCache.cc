@@ -0,0 +1,547 @@
+//------------------------------------------------------------------------------
+//  LocalFileCache.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "LocalFileCache.h"
+#include "LocalFS/MappedStream.h"
+#include "LocalFS/fileMapping.h"
+#include "Messaging/Serializer.h"
+#include "Core/Memory/Memory.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/Containers/Array.h"
+#include "Core/Log.h"
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#if ORYOL_POSIX
+#include <sys/stat.h>
+#endif
+
+namespace Oryol {
+
+OryolClassImpl(LocalFileCache);
+
+namespace {
+
+const uint32 IndexMagic = 0x4943524f;   // 'ORCI'
+const uint32 IndexVersion = 1;
+
+//------------------------------------------------------------------------------
+uint64
+contentHash(const uint8* data, int32 size) {
+    // 64-bit FNV-1a
+    uint64 hash = 0xcbf29ce484222325ULL;
+    for (int32 i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+LocalFileCache::LocalFileCache(const LocalFileCacheSetup& setup_) :
+setup(setup_) {
+    o_assert(this->setup.Path.IsValid());
+    o_assert((this->setup.MaxSize > 0) && (this->setup.MaxSize <= 512 * 1024 * 1024));
+    #if ORYOL_POSIX
+    if ((0 != ::mkdir(this->setup.Path.AsCStr(), 0755)) && (EEXIST != errno)) {
+        o_warn("LocalFileCache: failed to create cache directory '%s'\n", this->setup.Path.AsCStr());
+    }
+    #endif
+    this->load();
+}
+
+//------------------------------------------------------------------------------
+LocalFileCache::~LocalFileCache() {
+    this->Flush();
+    if (this->packFile) {
+        std::fclose(this->packFile);
+        this->packFile = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+String
+LocalFileCache::indexPath() const {
+    StringBuilder strBuilder(this->setup.Path);
+    strBuilder.Append("/cache.idx");
+    return strBuilder.GetString();
+}
+
+//------------------------------------------------------------------------------
+String
+LocalFileCache::packPath(uint32 gen) const {
+    StringBuilder strBuilder(this->setup.Path);
+    strBuilder.AppendFormat(32, "/cache.%u.pak", gen);
+    return strBuilder.GetString();
+}
+
+//------------------------------------------------------------------------------
+bool
+LocalFileCache::IsCacheable(const URL& url) const {
+    StringAtom scheme = url.Scheme();
+    return InvalidIndex != this->setup.Schemes.FindIndexLinear(scheme);
+}
+
+//------------------------------------------------------------------------------
+bool
+LocalFileCache::RevalidateHits() const {
+    return this->setup.Revalidate;
+}
+
+//------------------------------------------------------------------------------
+int32
+LocalFileCache::NumEntries() const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->entries.Size();
+}
+
+//------------------------------------------------------------------------------
+int64
+LocalFileCache::Size() const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->liveSize;
+}
+
+//------------------------------------------------------------------------------
+int64
+LocalFileCache::PackSize() const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->packSize;
+}
+
+//------------------------------------------------------------------------------
+void
+LocalFileCache::Flush() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (this->indexDirty) {
+        this->writeIndex();
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+LocalFileCache::openPack(const char* mode) {
+    o_assert(nullptr == this->packFile);
+    this->packFile = std::fopen(this->packPath(this->generation).AsCStr(), mode);
+    if (nullptr == this->packFile) {
+        o_warn("LocalFileCache: failed to open pack file in '%s'\n", this->setup.Path.AsCStr());
+        return false;
+    }
+    std::fseek(this->packFile, 0, SEEK_END);
+    this->packSize = std::ftell(this->packFile);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Index file layout (host byte order, strings are int32 length + chars):
+
+    uint32 magic, uint32 version, uint32 generation, uint64 accessCounter
+    int32 numBlobs, numBlobs * { uint64 hash, int64 offset, int32 size }
+    int32 numEntries, numEntries * { String url, uint64 hash, uint64 lastAccess,
+                                     String eTag, String lastModified, String contentType }
+
+ If the index is missing or broken, the cache starts empty.
+*/
+void
+LocalFileCache::load() {
+    uint8* buf = nullptr;
+    int32 bufSize = 0;
+    FILE* fp = std::fopen(this->indexPath().AsCStr(), "rb");
+    if (fp) {
+        std::fseek(fp, 0, SEEK_END);
+        bufSize = int32(std::ftell(fp));
+        std::fseek(fp, 0, SEEK_SET);
+        if (bufSize > 0) {
+            buf = (uint8*) Memory::Alloc(bufSize);
+            if (std::fread(buf, 1, bufSize, fp) != size_t(bufSize)) {
+                bufSize = 0;
+            }
+        }
+        std::fclose(fp);
+    }
+
+    bool valid = false;
+    if (buf && (bufSize > 0)) {
+        const uint8* ptr = buf;
+        const uint8* maxPtr = buf + bufSize;
+        uint32 magic = 0, version = 0, gen = 0;
+        uint64 counter = 0;
+        int32 num = 0;
+        ptr = Serializer::Decode(ptr, maxPtr, magic);
+        ptr = Serializer::Decode(ptr, maxPtr, version);
+        ptr = Serializer::Decode(ptr, maxPtr, gen);
+        ptr = Serializer::Decode(ptr, maxPtr, counter);
+        ptr = Serializer::Decode(ptr, maxPtr, num);
+        if (ptr && (IndexMagic == magic) && (IndexVersion == version)) {
+            this->generation = gen;
+            this->accessCounter = counter;
+            for (int32 i = 0; ptr && (i < num); i++) {
+                uint64 hash = 0;
+                blob b;
+                ptr = Serializer::Decode(ptr, maxPtr, hash);
+                ptr = Serializer::Decode(ptr, maxPtr, b.offset);
+                ptr = Serializer::Decode(ptr, maxPtr, b.size);
+                if (ptr) {
+                    this->blobs.Add(hash, b);
+                }
+            }
+            ptr = Serializer::Decode(ptr, maxPtr, num);
+            for (int32 i = 0; ptr && (i < num); i++) {
+                String url;
+                entry e;
+                ptr = Serializer::Decode(ptr, maxPtr, url);
+                ptr = Serializer::Decode(ptr, maxPtr, e.hash);
+                ptr = Serializer::Decode(ptr, maxPtr, e.lastAccess);
+                ptr = Serializer::Decode(ptr, maxPtr, e.eTag);
+                ptr = Serializer::Decode(ptr, maxPtr, e.lastModified);
+                ptr = Serializer::Decode(ptr, maxPtr, e.contentType);
+                if (ptr) {
+                    this->entries.Add(url, e);
+                }
+            }
+            valid = (nullptr != ptr);
+        }
+    }
+    if (buf) {
+        Memory::Free(buf);
+    }
+
+    if (valid && this->openPack("ab")) {
+        // drop blobs which are not in the pack file, and count blob users
+        for (int32 i = this->blobs.Size() - 1; i >= 0; i--) {
+            const blob& b = this->blobs.ValueAtIndex(i);
+            if ((b.offset < 0) || (b.size <= 0) || ((b.offset + b.size) > this->packSize)) {
+                this->blobs.EraseIndex(i);
+            }
+        }
+        for (int32 i = this->entries.Size() - 1; i >= 0; i--) {
+            const uint64 hash = this->entries.ValueAtIndex(i).hash;
+            if (this->blobs.Contains(hash)) {
+                this->blobs[hash].useCount++;
+            }
+            else {
+                this->entries.EraseIndex(i);
+            }
+        }
+        for (int32 i = this->blobs.Size() - 1; i >= 0; i--) {
+            const blob& b = this->blobs.ValueAtIndex(i);
+            if (0 == b.useCount) {
+                this->blobs.EraseIndex(i);
+            }
+            else {
+                this->liveSize += b.size;
+            }
+        }
+    }
+    else {
+        if (this->packFile) {
+            std::fclose(this->packFile);
+            this->packFile = nullptr;
+        }
+        this->entries.Clear();
+        this->blobs.Clear();
+        this->generation = 0;
+        this->accessCounter = 0;
+        this->liveSize = 0;
+        this->openPack("wb");
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+LocalFileCache::writeIndex() {
+    int32 size = 3 * sizeof(uint32) + sizeof(uint64) + 2 * sizeof(int32);
+    size += this->blobs.Size() * (sizeof(uint64) + sizeof(int64) + sizeof(int32));
+    for (const auto& kvp : this->entries) {
+        const entry& e = kvp.Value();
+        size += Serializer::EncodedSize(kvp.Key()) + 2 * sizeof(uint64);
+        size += Serializer::EncodedSize(e.eTag);
+        size += Serializer::EncodedSize(e.lastModified);
+        size += Serializer::EncodedSize(e.contentType);
+    }
+    uint8* buf = (uint8*) Memory::Alloc(size);
+    uint8* ptr = buf;
+    const uint8* maxPtr = buf + size;
+    ptr = Serializer::Encode(IndexMagic, ptr, maxPtr);
+    ptr = Serializer::Encode(IndexVersion, ptr, maxPtr);
+    ptr = Serializer::Encode(this->generation, ptr, maxPtr);
+    ptr = Serializer::Encode(this->accessCounter, ptr, maxPtr);
+    ptr = Serializer::Encode(this->blobs.Size(), ptr, maxPtr);
+    for (const auto& kvp : this->blobs) {
+        ptr = Serializer::Encode(kvp.Key(), ptr, maxPtr);
+        ptr = Serializer::Encode(kvp.Value().offset, ptr, maxPtr);
+        ptr = Serializer::Encode(kvp.Value().size, ptr, maxPtr);
+    }
+    ptr = Serializer::Encode(this->entries.Size(), ptr, maxPtr);
+    for (const auto& kvp : this->entries) {
+        const entry& e = kvp.Value();
+        ptr = Serializer::Encode(kvp.Key(), ptr, maxPtr);
+        ptr = Serializer::Encode(e.hash, ptr, maxPtr);
+        ptr = Serializer::Encode(e.lastAccess, ptr, maxPtr);
+        ptr = Serializer::Encode(e.eTag, ptr, maxPtr);
+        ptr = Serializer::Encode(e.lastModified, ptr, maxPtr);
+        ptr = Serializer::Encode(e.contentType, ptr, maxPtr);
+    }
+    o_assert(ptr == maxPtr);
+
+    // write to a temp file and rename, so that a valid index always exists
+    StringBuilder tmpPath(this->indexPath());
+    tmpPath.Append(".tmp");
+    bool success = false;
+    FILE* fp = std::fopen(tmpPath.AsCStr(), "wb");
+    if (fp) {
+        success = std::fwrite(buf, 1, size, fp) == size_t(size);
+        success &= 0 == std::fclose(fp);
+        success = success && (0 == std::rename(tmpPath.AsCStr(), this->indexPath().AsCStr()));
+    }
+    Memory::Free(buf);
+    if (success) {
+        this->indexDirty = false;
+    }
+    else {
+        o_warn("LocalFileCache: failed to write index file in '%s'\n", this->setup.Path.AsCStr());
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+LocalFileCache::appendBlob(const uint8* data, int32 size, int64& outOffset) {
+    if (nullptr == this->packFile) {
+        return false;
+    }
+    if ((std::fwrite(data, 1, size, this->packFile) != size_t(size)) || (0 != std::fflush(this->packFile))) {
+        // the partially written data is dead space
+        o_warn("LocalFileCache: failed to write pack file in '%s'\n", this->setup.Path.AsCStr());
+        this->packSize = std::ftell(this->packFile);
+        return false;
+    }
+    outOffset = this->packSize;
+    this->packSize += size;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+LocalFileCache::blobEquals(int64 offset, int32 size, const uint8* data) const {
+    _priv::fileMapping mapping;
+    if (IOStatus::OK != mapping.Map(this->packPath(this->generation), int32(offset), int32(offset + size - 1))) {
+        return false;
+    }
+    return (mapping.Size() == size) && (0 == std::memcmp(mapping.Data(), data, size));
+}
+
+//------------------------------------------------------------------------------
+void
+LocalFileCache::removeEntry(int32 entryIndex) {
+    const uint64 hash = this->entries.ValueAtIndex(entryIndex).hash;
+    this->entries.EraseIndex(entryIndex);
+    blob& b = this->blobs[hash];
+    if (0 == --b.useCount) {
+        // the data becomes dead space in the pack file
+        this->liveSize -= b.size;
+        this->blobs.Erase(hash);
+    }
+    this->indexDirty = true;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Entries are sorted by last access once, evicted entries are marked
+ with a lastAccess of 0 (the access counter starts at 1), and the
+ entry and blob maps are rebuilt without them at the end.
+*/
+void
+LocalFileCache::evict() {
+    if (this->liveSize <= this->setup.MaxSize) {
+        return;
+    }
+    Array<int32> order;
+    order.Reserve(this->entries.Size());
+    for (int32 i = 0; i < this->entries.Size(); i++) {
+        order.Add(i);
+    }
+    std::sort(order.begin(), order.end(), [this](int32 a, int32 b) {
+        return this->entries.ValueAtIndex(a).lastAccess < this->entries.ValueAtIndex(b).lastAccess;
+    });
+    int32 numEvicted = 0;
+    for (int32 i = 0; (i < order.Size()) && (this->liveSize > this->setup.MaxSize); i++) {
+        entry& e = this->entries.ValueAtIndex(order[i]);
+        blob& b = this->blobs[e.hash];
+        if (0 == --b.useCount) {
+            // the data becomes dead space in the pack file
+            this->liveSize -= b.size;
+        }
+        e.lastAccess = 0;
+        numEvicted++;
+    }
+
+    Map<String, entry> liveEntries;
+    liveEntries.Reserve(this->entries.Size() - numEvicted);
+    for (const auto& kvp : this->entries) {
+        if (0 != kvp.Value().lastAccess) {
+            liveEntries.Add(kvp.Key(), kvp.Value());
+        }
+    }
+    this->entries = std::move(liveEntries);
+    Map<uint64, blob> liveBlobs;
+    liveBlobs.Reserve(this->blobs.Size());
+    for (const auto& kvp : this->blobs) {
+        if (0 != kvp.Value().useCount) {
+            liveBlobs.Add(kvp.Key(), kvp.Value());
+        }
+    }
+    this->blobs = std::move(liveBlobs);
+    this->indexDirty = true;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Streams returned by Lookup() keep mapping the old pack file,
+ which stays valid after the file has been removed.
+*/
+void
+LocalFileCache::compact() {
+    const String oldPath = this->packPath(this->generation);
+    const String newPath = this->packPath(this->generation + 1);
+    FILE* fp = std::fopen(newPath.AsCStr(), "wb");
+    if (nullptr == fp) {
+        return;
+    }
+    Map<uint64, blob> newBlobs;
+    newBlobs.Reserve(this->blobs.Size());
+    int64 offset = 0;
+    bool success = true;
+    for (const auto& kvp : this->blobs) {
+        const blob& b = kvp.Value();
+        _priv::fileMapping mapping;
+        success = (IOStatus::OK == mapping.Map(oldPath, int32(b.offset), int32(b.offset + b.size - 1)));
+        success = success && (mapping.Size() == b.size);
+        success = success && (std::fwrite(mapping.Data(), 1, b.size, fp) == size_t(b.size));
+        if (!success) {
+            break;
+        }
+        blob newBlob = b;
+        newBlob.offset = offset;
+        newBlobs.Add(kvp.Key(), newBlob);
+        offset += b.size;
+    }
+    success &= 0 == std::fclose(fp);
+    if (!success) {
+        o_warn("LocalFileCache: failed to compact pack file in '%s'\n", this->setup.Path.AsCStr());
+        std::remove(newPath.AsCStr());
+        return;
+    }
+
+    // switch to the new pack file, the index must be written before the old file goes away
+    std::fclose(this->packFile);
+    this->packFile = nullptr;
+    this->generation++;
+    this->blobs = newBlobs;
+    this->openPack("ab");
+    this->writeIndex();
+    std::remove(oldPath.AsCStr());
+}
+
+//------------------------------------------------------------------------------
+Ptr<Stream>
+LocalFileCache::Lookup(const URL& url, String& outETag, String& outLastModified) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    const String key(url.AsCStr());
+    const int32 entryIndex = this->entries.FindIndex(key);
+    if (InvalidIndex == entryIndex) {
+        return Ptr<Stream>();
+    }
+    entry& e = this->entries.ValueAtIndex(entryIndex);
+    const blob& b = this->blobs[e.hash];
+    Ptr<MappedStream> stream = MappedStream::Create();
+    if (IOStatus::OK != stream->Map(this->packPath(this->generation), int32(b.offset), int32(b.offset + b.size - 1))) {
+        o_warn("LocalFileCache: failed to map cached data for '%s'\n", url.AsCStr());
+        this->removeEntry(entryIndex);
+        return Ptr<Stream>();
+    }
+    stream->SetURL(url);
+    if (e.contentType.IsValid()) {
+        stream->SetContentType(ContentType(e.contentType));
+    }
+    e.lastAccess = ++this->accessCounter;
+    this->indexDirty = true;
+    outETag = e.eTag;
+    outLastModified = e.lastModified;
+    return stream;
+}
+
+//------------------------------------------------------------------------------
+void
+LocalFileCache::Store(const URL& url, const String& eTag, const String& lastModified, const Ptr<Stream>& data) {
+    if (!data.isValid() || data->IsOpen()) {
+        return;
+    }
+    data->Open(OpenMode::ReadOnly);
+    const int32 size = data->Size();
+    const uint8* ptr = (size > 0) ? data->MapRead(nullptr) : nullptr;
+    if (ptr && (size <= this->setup.MaxSize)) {
+        const uint64 hash = contentHash(ptr, size);
+        const String key(url.AsCStr());
+
+        std::lock_guard<std::mutex> guard(this->lock);
+        entry newEntry;
+        newEntry.eTag = eTag;
+        newEntry.lastModified = lastModified;
+        if (data->GetContentType().IsValid()) {
+            newEntry.contentType = data->GetContentType().AsCStr();
+        }
+        newEntry.hash = hash;
+        newEntry.lastAccess = ++this->accessCounter;
+
+        // replace an existing entry, the data may have changed
+        const int32 entryIndex = this->entries.FindIndex(key);
+        if (InvalidIndex != entryIndex) {
+            if (this->entries.ValueAtIndex(entryIndex).hash == hash) {
+                this->entries.ValueAtIndex(entryIndex) = newEntry;
+                this->indexDirty = true;
+                data->UnmapRead();
+                data->Close();
+                return;
+            }
+            this->removeEntry(entryIndex);
+        }
+
+        // identical data is only stored once
+        bool stored = false;
+        if (this->blobs.Contains(hash)) {
+            blob& b = this->blobs[hash];
+            if ((b.size == size) && this->blobEquals(b.offset, b.size, ptr)) {
+                b.useCount++;
+                stored = true;
+            }
+        }
+        else {
+            blob b;
+            if (this->appendBlob(ptr, size, b.offset)) {
+                b.size = size;
+                b.useCount = 1;
+                this->blobs.Add(hash, b);
+                this->liveSize += size;
+                stored = true;
+            }
+        }
+        if (stored) {
+            this->entries.Add(key, newEntry);
+            this->indexDirty = true;
+            this->evict();
+            if ((this->packSize - this->liveSize) > (this->setup.MaxSize / 2)) {
+                this->compact();
+            }
+        }
+    }
+    if (ptr) {
+        data->UnmapRead();
+    }
+    data->Close();
+}
+
+} // namespace Oryol
@@ -0,0 +1,119 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::LocalFileCache
+    @ingroup LocalFS
+    @brief size-bounded IOCache on the local disk
+    @see IOCache, LocalFileCacheSetup, MappedStream
+
+    The LocalFileCache keeps the data of cached URLs in a single packed,
+    append-only file in the cache directory, and an index file which
+    maps URLs (with their ETag, Last-Modified and content-type) to
+    ranges in the pack file. The data is content-addressed: identical
+    responses for different URLs are stored only once. Cache hits are
+    returned as MappedStreams which point directly into the pack file.
+
+    If the cached data grows beyond LocalFileCacheSetup::MaxSize, the
+    least recently used entries are evicted. Their data becomes dead
+    space in the pack file, once the dead space exceeds half of MaxSize,
+    the live data is copied into a new pack file. Because the index is
+    written after the data, and compaction writes a new pack file
+    instead of modifying the old one, an interrupted write never leaves
+    the index pointing to wrong data.
+
+    The index is not written for each stored URL, but only in Flush(),
+    after compaction and in the destructor. Entries stored after the
+    last index write are lost if the app is killed, their data is
+    dead space in the pack file.
+
+    Setup the IO module with a LocalFileCache like this:
+
+        LocalFileCacheSetup cacheSetup;
+        cacheSetup.Path = "/home/bla/.cache/myapp";
+        IOSetup ioSetup;
+        ioSetup.FileSystems.Add("http", HTTPFileSystem::Creator());
+        ioSetup.Cache = LocalFileCache::Create(cacheSetup);
+        IO::Setup(ioSetup);
+*/
+#include "IO/FS/IOCache.h"
+#include "Core/Containers/Map.h"
+#include "LocalFS/LocalFileCacheSetup.h"
+#include <cstdio>
+#include <mutex>
+
+namespace Oryol {
+
+class LocalFileCache : public IOCache {
+    OryolClassDecl(LocalFileCache);
+public:
+    /// constructor, loads the index from the cache directory
+    LocalFileCache(const LocalFileCacheSetup& setup);
+    /// destructor, writes the index
+    virtual ~LocalFileCache();
+
+    /// return true if the URL scheme is in LocalFileCacheSetup::Schemes
+    virtual bool IsCacheable(const URL& url) const override;
+    /// return LocalFileCacheSetup::Revalidate
+    virtual bool RevalidateHits() const override;
+    /// lookup cached data for URL, returns a MappedStream
+    virtual Ptr<Stream> Lookup(const URL& url, String& outETag, String& outLastModified) override;
+    /// store the content of a stream for URL
+    virtual void Store(const URL& url, const String& eTag, const String& lastModified, const Ptr<Stream>& data) override;
+
+    /// write the index file if it has changed (also happens in destructor)
+    void Flush();
+    /// get number of cached URLs
+    int32 NumEntries() const;
+    /// get number of bytes of cached data (identical data counts once)
+    int64 Size() const;
+    /// get size of the pack file in bytes, including dead space
+    int64 PackSize() const;
+
+private:
+    /// get path of the index file
+    String indexPath() const;
+    /// get path of a pack file generation
+    String packPath(uint32 generation) const;
+    /// load the index, or start with an empty cache
+    void load();
+    /// open the current pack file for appending
+    bool openPack(const char* mode);
+    /// write the index file, must be called with lock held
+    void writeIndex();
+    /// append data to the pack file
+    bool appendBlob(const uint8* data, int32 size, int64& outOffset);
+    /// test if a blob in the pack file contains the given data
+    bool blobEquals(int64 offset, int32 size, const uint8* data) const;
+    /// drop an entry, and its blob if no other entry uses it
+    void removeEntry(int32 entryIndex);
+    /// evict least recently used entries until the cached data fits
+    void evict();
+    /// copy live data into a new pack file generation
+    void compact();
+
+    struct entry {
+        String eTag;
+        String lastModified;
+        String contentType;
+        uint64 hash = 0;
+        uint64 lastAccess = 0;
+    };
+    struct blob {
+        int64 offset = 0;
+        int32 size = 0;
+        int32 useCount = 0;
+    };
+
+    LocalFileCacheSetup setup;
+    mutable std::mutex lock;
+    Map<String, entry> entries;     // URL => entry
+    Map<uint64, blob> blobs;        // content hash => data in pack file
+    uint32 generation = 0;
+    FILE* packFile = nullptr;
+    int64 packSize = 0;
+    int64 liveSize = 0;
+    uint64 accessCounter = 0;
+    bool indexDirty = false;
+};
+
+} // namespace Oryol
@@ -0,0 +1,27 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::LocalFileCacheSetup
+    @ingroup LocalFS
+    @brief configure a LocalFileCache
+    @see LocalFileCache
+*/
+#include "Core/String/String.h"
+#include "Core/String/StringAtom.h"
+#include "Core/Containers/Array.h"
+
+namespace Oryol {
+
+class LocalFileCacheSetup {
+public:
+    /// native path of the cache directory (created if it doesn't exist)
+    String Path;
+    /// max number of bytes of cached data (at most 512 MByte)
+    int64 MaxSize = 64 * 1024 * 1024;
+    /// URL schemes which go through the cache
+    Array<StringAtom> Schemes{ "http" };
+    /// if true, hits are revalidated with a conditional request before use
+    bool Revalidate = false;
+};
+
+} // namespace Oryol
@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+//  LocalFileSystem.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "LocalFileSystem.h"
+#include "LocalFS/MappedStream.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/Log.h"
+#include "Core/Memory/Memory.h"
+#include <cstdio>
+#include <cerrno>
+
+namespace Oryol {
+
+OryolClassImpl(LocalFileSystem);
+
+//------------------------------------------------------------------------------
+LocalFileSystem::LocalFileSystem() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+LocalFileSystem::~LocalFileSystem() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+String
+LocalFileSystem::NativePath(const URL& url) {
+    // the URL parser strips the leading slash from the path
+    StringBuilder strBuilder;
+    #if !ORYOL_WINDOWS
+    strBuilder.Append('/');
+    #endif
+    strBuilder.Append(url.Path());
+    return strBuilder.GetString();
+}
+
+//------------------------------------------------------------------------------
+void
+LocalFileSystem::onRequest(const Ptr<IOProtocol::Request>& msg) {
+    if (msg->Cancelled()) {
+        if (msg->GetProgressiveStream().isValid()) {
+            msg->GetProgressiveStream()->Fail();
+        }
+        msg->SetStatus(IOStatus::Cancelled);
+        msg->SetHandled();
+        return;
+    }
+
+    const URL& url = msg->GetURL();
+    if (url.HasHost() && (url.Host() != "localhost")) {
+        o_warn("LocalFileSystem: only local file URLs supported ('%s')\n", url.AsCStr());
+        msg->SetStatus(IOStatus::BadRequest);
+        msg->SetErrorDesc("non-local file URL");
+        msg->SetHandled();
+        return;
+    }
+
+    if (msg->GetProgressiveStream().isValid()) {
+        IOStatus::Code status = this->readProgressive(msg);
+        if (IOStatus::OK != status) {
+            msg->SetErrorDesc(IOStatus::ToString(status));
+        }
+        else if ((0 != msg->GetStartOffset()) || (0 != msg->GetEndOffset())) {
+            status = IOStatus::PartialContent;
+        }
+        msg->SetStatus(status);
+        msg->SetHandled();
+        return;
+    }
+
+    // map the requested range, this happens on the IO lane thread,
+    // and the page-faults will happen wherever the data is read
+    Ptr<MappedStream> stream = MappedStream::Create();
+    stream->SetURL(url);
+    IOStatus::Code status = stream->Map(NativePath(url), msg->GetStartOffset(), msg->GetEndOffset());
+    if (IOStatus::OK == status) {
+        if ((0 != msg->GetStartOffset()) || (0 != msg->GetEndOffset())) {
+            status = IOStatus::PartialContent;
+        }
+        msg->SetStream(stream);
+    }
+    else {
+        msg->SetErrorDesc(IOStatus::ToString(status));
+    }
+    msg->SetStatus(status);
+    msg->SetHandled();
+}
+
+//------------------------------------------------------------------------------
+/**
+ Reads the file in chunk-sized blocks with plain stdio, each block
+ becomes visible to the consumer as soon as it has been read.
+*/
+IOStatus::Code
+LocalFileSystem::readProgressive(const Ptr<IOProtocol::Request>& msg) {
+    const Ptr<ChunkedStream>& stream = msg->GetProgressiveStream();
+    stream->SetURL(msg->GetURL());
+    msg->SetStream(stream);
+
+    FILE* fp = std::fopen(NativePath(msg->GetURL()).AsCStr(), "rb");
+    if (nullptr == fp) {
+        stream->Fail();
+        switch (errno) {
+            case ENOENT:
+            case ENOTDIR:
+                return IOStatus::NotFound;
+            case EACCES:
+            case EPERM:
+                return IOStatus::Forbidden;
+            default:
+                return IOStatus::InternalServerError;
+        }
+    }
+
+    // figure out the requested range, same rules as for mapped files
+    std::fseek(fp, 0, SEEK_END);
+    const int64 fileSize = int64(std::ftell(fp));
+    const int64 startOffset = msg->GetStartOffset();
+    int64 endOffset = (0 != msg->GetEndOffset()) ? int64(msg->GetEndOffset()) + 1 : fileSize;
+    if (endOffset > fileSize) {
+        endOffset = fileSize;
+    }
+    if ((startOffset > endOffset) || ((startOffset == fileSize) && (0 != startOffset)) ||
+        (0 != std::fseek(fp, long(startOffset), SEEK_SET))) {
+        std::fclose(fp);
+        stream->Fail();
+        return IOStatus::RequestedRangeNotSatisfiable;
+    }
+    stream->SetExpectedSize(endOffset - startOffset);
+
+    const int32 bufSize = stream->ChunkSize();
+    uint8* buf = (uint8*) Memory::Alloc(bufSize);
+    int64 bytesLeft = endOffset - startOffset;
+    while (bytesLeft > 0) {
+        if (msg->Cancelled()) {
+            break;
+        }
+        const int32 num = int32(bytesLeft < bufSize ? bytesLeft : bufSize);
+        const size_t bytesRead = std::fread(buf, 1, num, fp);
+        if (bytesRead > 0) {
+            stream->Write(buf, int32(bytesRead));
+        }
+        if (bytesRead != size_t(num)) {
+            break;
+        }
+        bytesLeft -= num;
+    }
+    Memory::Free(buf);
+    std::fclose(fp);
+    if (msg->Cancelled()) {
+        stream->Fail();
+        return IOStatus::Cancelled;
+    }
+    else if (bytesLeft > 0) {
+        stream->Fail();
+        return IOStatus::InternalServerError;
+    }
+    stream->Finish();
+    return IOStatus::OK;
+}
+
+} // namespace Oryol
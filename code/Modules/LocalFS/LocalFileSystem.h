@@ -0,0 +1,53 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @defgroup LocalFS LocalFS
+    @brief filesystem for the local disk, using memory-mapped streams
+
+    @class Oryol::LocalFileSystem
+    @ingroup LocalFS
+    @brief implements a filesystem for file: URLs on the local disk
+    @see FileSystem, MappedStream
+
+    The LocalFileSystem serves IOProtocol::Request messages for
+    file: URLs (e.g. file:///home/bla/textures/bla.dds) on the IO lane
+    threads. The loaded data is returned as a MappedStream which points
+    directly into the mapped file pages, no data is copied.
+    
+    StartOffset and EndOffset of the request are honored with the same
+    semantics as the HTTPFileSystem (EndOffset is the last byte of
+    the range, an EndOffset of 0 means 'until end of file'), a
+    ranged request returns IOStatus::PartialContent.
+    
+    Register the filesystem with the IO module like this:
+
+        IOSetup ioSetup;
+        ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+        IO::Setup(ioSetup);
+*/
+#include "IO/FS/FileSystem.h"
+#include "Core/Creator.h"
+
+namespace Oryol {
+
+class LocalFileSystem : public FileSystem {
+    OryolClassDecl(LocalFileSystem);
+    OryolClassCreator(LocalFileSystem);
+public:
+    /// default constructor
+    LocalFileSystem();
+    /// destructor
+    virtual ~LocalFileSystem();
+
+    /// called when the IOProtocol::Request message is received
+    virtual void onRequest(const Ptr<IOProtocol::Request>& msg) override;
+
+    /// convert a file: URL into a native filesystem path
+    static String NativePath(const URL& url);
+
+private:
+    /// read the requested range into the request's ProgressiveStream
+    IOStatus::Code readProgressive(const Ptr<IOProtocol::Request>& msg);
+};
+
+} // namespace Oryol
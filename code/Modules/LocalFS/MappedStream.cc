@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------
+//  MappedStream.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "MappedStream.h"
+#include "Core/Assertion.h"
+
+namespace Oryol {
+
+OryolClassImpl(MappedStream);
+
+//------------------------------------------------------------------------------
+MappedStream::MappedStream() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+MappedStream::~MappedStream() {
+    if (this->IsOpen()) {
+        this->Close();
+    }
+    this->DiscardContent();
+}
+
+//------------------------------------------------------------------------------
+IOStatus::Code
+MappedStream::Map(const String& path, int32 startOffset, int32 endOffset) {
+    o_assert(!this->isOpen);
+    o_assert(!this->mapping.IsMapped());
+    IOStatus::Code status = this->mapping.Map(path, startOffset, endOffset);
+    this->size = this->mapping.Size();
+    this->readPosition = 0;
+    this->writePosition = 0;
+    return status;
+}
+
+//------------------------------------------------------------------------------
+bool
+MappedStream::Open(OpenMode::Enum mode) {
+    o_assert2(OpenMode::ReadOnly == mode, "MappedStream can only be opened as ReadOnly!\n");
+    return Stream::Open(mode);
+}
+
+//------------------------------------------------------------------------------
+void
+MappedStream::DiscardContent() {
+    o_assert(!this->isOpen);
+    if (this->mapping.IsMapped()) {
+        this->mapping.Unmap();
+    }
+    this->size = 0;
+    this->readPosition = 0;
+    this->writePosition = 0;
+}
+
+//------------------------------------------------------------------------------
+int32
+MappedStream::Read(void* ptr, int32 numBytes) {
+    o_assert(this->isOpen);
+    o_assert(this->IsReadable());
+    o_assert((this->readPosition >= 0) && (this->readPosition <= this->size));
+
+    // cap numBytes if EndOfStream or trying to read past stream
+    if ((EndOfStream == numBytes) || ((this->readPosition + numBytes) > this->size)) {
+        numBytes = this->size - this->readPosition;
+    }
+    if (numBytes > 0) {
+        Memory::Copy(this->mapping.Data() + this->readPosition, ptr, numBytes);
+        this->readPosition += numBytes;
+    }
+    return numBytes;
+}
+
+//------------------------------------------------------------------------------
+/**
+ See Stream::MapRead() for details! The returned pointer points
+ into the mapped file pages.
+*/
+const uint8*
+MappedStream::MapRead(const uint8** outMaxValidPtr) {
+    o_assert(this->isOpen);
+    o_assert(!this->isReadMapped);
+    o_assert(this->IsReadable());
+    o_assert((this->readPosition >= 0) && (this->readPosition <= this->size));
+
+    this->isReadMapped = true;
+    if (this->readPosition == this->size) {
+        if (nullptr != outMaxValidPtr) {
+            *outMaxValidPtr = nullptr;
+        }
+        return nullptr;
+    }
+    else {
+        if (nullptr != outMaxValidPtr) {
+            *outMaxValidPtr = this->mapping.Data() + this->size;
+        }
+        return this->mapping.Data() + this->readPosition;
+    }
+}
+
+} // namespace Oryol
@@ -0,0 +1,45 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::MappedStream
+    @ingroup LocalFS
+    @brief a read-only Stream on top of a memory-mapped file range
+
+    A MappedStream exposes a memory-mapped range of a local file through
+    the Stream interface. MapRead() returns pointers directly into
+    the mapped pages, no data is copied into a separate buffer.
+    The mapping stays valid until the stream is destroyed or
+    DiscardContent() is called, so (like with MemoryStream) a 
+    pointer obtained through MapRead() can still be used after Close().
+*/
+#include "IO/Stream/Stream.h"
+#include "IO/Core/IOStatus.h"
+#include "LocalFS/fileMapping.h"
+
+namespace Oryol {
+
+class MappedStream : public Stream {
+    OryolClassDecl(MappedStream);
+public:
+    /// constructor
+    MappedStream();
+    /// destructor
+    virtual ~MappedStream();
+
+    /// map a file range (endOffset is inclusive, 0 means until end of file)
+    IOStatus::Code Map(const String& path, int32 startOffset=0, int32 endOffset=0);
+
+    /// open the stream, only OpenMode::ReadOnly is supported
+    virtual bool Open(OpenMode::Enum mode) override;
+    /// unmap the file
+    virtual void DiscardContent() override;
+    /// read a number of bytes from the stream (returns bytes read), numBytes can be EndOfStream
+    virtual int32 Read(void* ptr, int32 numBytes) override;
+    /// map a memory area at the current read-position, DOES NOT ADVANCE READ-POS!
+    virtual const uint8* MapRead(const uint8** outMaxValidPtr) override;
+
+private:
+    _priv::fileMapping mapping;
+};
+
+} // namespace Oryol
@@ -0,0 +1,154 @@
+//------------------------------------------------------------------------------
+//  PakArchive.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "PakArchive.h"
+#include "LocalFS/lz4Codec.h"
+#include "Core/Assertion.h"
+#include "Core/Log.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Oryol {
+
+OryolClassImpl(PakArchive);
+
+//------------------------------------------------------------------------------
+PakArchive::PakArchive() :
+header(nullptr),
+entries(nullptr),
+names(nullptr) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+PakArchive::~PakArchive() {
+    // empty, the mapping is released by its destructor
+}
+
+//------------------------------------------------------------------------------
+bool
+PakArchive::IsOpen() const {
+    return nullptr != this->header;
+}
+
+//------------------------------------------------------------------------------
+IOStatus::Code
+PakArchive::Open(const String& nativePath) {
+    o_assert(!this->IsOpen());
+    IOStatus::Code status = this->mapping.Map(nativePath, 0, 0);
+    if (IOStatus::OK != status) {
+        return status;
+    }
+
+    // validate the header and table of contents, so that lookups
+    // and reads don't need to check for broken data anymore, each
+    // value is checked against the remaining size, so that broken
+    // 64-bit offsets can't wrap around
+    const uint8* base = this->mapping.Data();
+    const uint64 fileSize = uint64(this->mapping.Size());
+    const PakFormat::Header* hdr = (const PakFormat::Header*) base;
+    bool valid = (fileSize >= sizeof(PakFormat::Header)) &&
+                 (PakFormat::Magic == hdr->Magic) &&
+                 (PakFormat::Version == hdr->Version) &&
+                 (hdr->TocOffset >= sizeof(PakFormat::Header)) &&
+                 (hdr->TocOffset <= fileSize) &&
+                 (0 == (hdr->TocOffset % alignof(PakFormat::Entry))) &&
+                 (uint64(hdr->NumEntries) * sizeof(PakFormat::Entry) <= fileSize - hdr->TocOffset) &&
+                 (hdr->NamesSize == fileSize - hdr->TocOffset - uint64(hdr->NumEntries) * sizeof(PakFormat::Entry));
+    if (valid) {
+        const PakFormat::Entry* toc = (const PakFormat::Entry*) (base + hdr->TocOffset);
+        for (uint32 i = 0; valid && (i < hdr->NumEntries); i++) {
+            const PakFormat::Entry& e = toc[i];
+            valid = (uint64(e.NameOffset) + e.NameLength <= hdr->NamesSize) &&
+                    (e.Offset <= hdr->TocOffset) &&
+                    (e.Size <= hdr->TocOffset - e.Offset) &&
+                    (e.UncompressedSize <= 0x7FFFFFFF) &&
+                    (e.Codec < PakFormat::Compression::NumCompressions) &&
+                    ((PakFormat::Compression::None != e.Codec) || (e.Size == e.UncompressedSize)) &&
+                    ((0 == i) || (toc[i-1].NameHash <= e.NameHash));
+        }
+        if (valid) {
+            this->entries = toc;
+            this->names = (const char*) (toc + hdr->NumEntries);
+            this->header = hdr;
+        }
+    }
+    if (!valid) {
+        o_warn("PakArchive: '%s' is not a valid pak archive\n", nativePath.AsCStr());
+        this->mapping.Unmap();
+        return IOStatus::UnsupportedMediaType;
+    }
+    return IOStatus::OK;
+}
+
+//------------------------------------------------------------------------------
+int32
+PakArchive::NumEntries() const {
+    o_assert_dbg(this->IsOpen());
+    return int32(this->header->NumEntries);
+}
+
+//------------------------------------------------------------------------------
+const PakFormat::Entry&
+PakArchive::EntryAt(int32 index) const {
+    o_assert_dbg(this->IsOpen());
+    o_assert_range_dbg(index, int32(this->header->NumEntries));
+    return this->entries[index];
+}
+
+//------------------------------------------------------------------------------
+String
+PakArchive::NameAt(int32 index) const {
+    const PakFormat::Entry& e = this->EntryAt(index);
+    if (e.NameLength > 0) {
+        return String(this->names + e.NameOffset, 0, e.NameLength);
+    }
+    else {
+        return String();
+    }
+}
+
+//------------------------------------------------------------------------------
+const PakFormat::Entry*
+PakArchive::Find(const char* name, int32 len) const {
+    o_assert_dbg(this->IsOpen());
+    o_assert_dbg(name && (len >= 0));
+    const uint32 hash = PakFormat::HashName(name, len);
+    const PakFormat::Entry* first = this->entries;
+    const PakFormat::Entry* last = this->entries + this->header->NumEntries;
+    const PakFormat::Entry* e = std::lower_bound(first, last, hash,
+        [](const PakFormat::Entry& entry, uint32 h) { return entry.NameHash < h; });
+    for (; (e != last) && (e->NameHash == hash); e++) {
+        if ((e->NameLength == uint32(len)) && (0 == std::memcmp(this->names + e->NameOffset, name, len))) {
+            return e;
+        }
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+const uint8*
+PakArchive::Data(const PakFormat::Entry& entry) const {
+    o_assert_dbg(this->IsOpen());
+    return this->mapping.Data() + entry.Offset;
+}
+
+//------------------------------------------------------------------------------
+bool
+PakArchive::Decompress(const PakFormat::Entry& entry, uint8* dst, int32 dstSize) const {
+    o_assert_dbg(this->IsOpen());
+    o_assert(dstSize == int32(entry.UncompressedSize));
+    const uint8* src = this->Data(entry);
+    switch (entry.Codec) {
+        case PakFormat::Compression::None:
+            std::memcpy(dst, src, dstSize);
+            return true;
+        case PakFormat::Compression::LZ4:
+            return _priv::lz4Codec::decompress(src, int32(entry.Size), dst, dstSize) == dstSize;
+        default:
+            return false;
+    }
+}
+
+} // namespace Oryol
@@ -0,0 +1,58 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::PakArchive
+    @ingroup LocalFS
+    @brief a memory-mapped pak archive
+    @see PakFormat, PakWriter, PakFileSystem
+
+    Open() maps the whole archive file once and validates the table of
+    contents, after that the archive is read-only and can be used from
+    any thread. Entries are looked up by name with a binary search on
+    the sorted name hashes, the data of uncompressed entries is read
+    directly from the mapped pages.
+
+    Archives are limited to 2 GByte.
+*/
+#include "Core/RefCounted.h"
+#include "Core/String/String.h"
+#include "IO/Core/IOStatus.h"
+#include "LocalFS/PakFormat.h"
+#include "LocalFS/fileMapping.h"
+
+namespace Oryol {
+
+class PakArchive : public RefCounted {
+    OryolClassDecl(PakArchive);
+public:
+    /// constructor
+    PakArchive();
+    /// destructor
+    virtual ~PakArchive();
+
+    /// map and validate an archive file
+    IOStatus::Code Open(const String& nativePath);
+    /// return true if the archive has been opened
+    bool IsOpen() const;
+
+    /// get number of entries
+    int32 NumEntries() const;
+    /// get entry by index
+    const PakFormat::Entry& EntryAt(int32 index) const;
+    /// get name of entry by index
+    String NameAt(int32 index) const;
+    /// find an entry by name, return nullptr if not found
+    const PakFormat::Entry* Find(const char* name, int32 len) const;
+    /// get pointer to the stored (possibly compressed) data of an entry
+    const uint8* Data(const PakFormat::Entry& entry) const;
+    /// decompress an entry into dst (dstSize must be UncompressedSize), return false on broken data
+    bool Decompress(const PakFormat::Entry& entry, uint8* dst, int32 dstSize) const;
+
+private:
+    _priv::fileMapping mapping;
+    const PakFormat::Header* header;
+    const PakFormat::Entry* entries;
+    const char* names;
+};
+
+} // namespace Oryol
@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------
+//  PakFileSystem.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "PakFileSystem.h"
+#include "LocalFS/pakStream.h"
+#include "IO/Stream/MemoryStream.h"
+#include "Core/Containers/Map.h"
+#include "Core/Log.h"
+#include <mutex>
+
+namespace Oryol {
+
+OryolClassImpl(PakFileSystem);
+
+namespace {
+    std::mutex mountLock;
+    Map<StringAtom, Ptr<PakArchive>> mountedArchives;
+}
+
+//------------------------------------------------------------------------------
+PakFileSystem::PakFileSystem() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+PakFileSystem::~PakFileSystem() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+IOStatus::Code
+PakFileSystem::Mount(const StringAtom& name, const String& nativePath) {
+    o_assert(name.IsValid());
+    Ptr<PakArchive> archive = PakArchive::Create();
+    IOStatus::Code status = archive->Open(nativePath);
+    if (IOStatus::OK == status) {
+        std::lock_guard<std::mutex> guard(mountLock);
+        mountedArchives.Erase(name);
+        mountedArchives.Add(name, archive);
+    }
+    return status;
+}
+
+//------------------------------------------------------------------------------
+void
+PakFileSystem::Unmount(const StringAtom& name) {
+    std::lock_guard<std::mutex> guard(mountLock);
+    mountedArchives.Erase(name);
+}
+
+//------------------------------------------------------------------------------
+bool
+PakFileSystem::IsMounted(const StringAtom& name) {
+    std::lock_guard<std::mutex> guard(mountLock);
+    return mountedArchives.Contains(name);
+}
+
+//------------------------------------------------------------------------------
+Ptr<PakArchive>
+PakFileSystem::Archive(const StringAtom& name) {
+    std::lock_guard<std::mutex> guard(mountLock);
+    const int32 index = mountedArchives.FindIndex(name);
+    if (InvalidIndex != index) {
+        return mountedArchives.ValueAtIndex(index);
+    }
+    return Ptr<PakArchive>();
+}
+
+//------------------------------------------------------------------------------
+void
+PakFileSystem::onRequest(const Ptr<IOProtocol::Request>& msg) {
+    if (msg->Cancelled()) {
+        msg->SetStatus(IOStatus::Cancelled);
+        msg->SetHandled();
+        return;
+    }
+
+    // lookup archive and entry
+    const URL& url = msg->GetURL();
+    Ptr<PakArchive> archive = Archive(url.Host());
+    const PakFormat::Entry* entry = nullptr;
+    if (archive.isValid()) {
+        const String path = url.Path();
+        entry = archive->Find(path.AsCStr(), path.Length());
+    }
+    if (nullptr == entry) {
+        msg->SetStatus(IOStatus::NotFound);
+        msg->SetErrorDesc(IOStatus::ToString(IOStatus::NotFound));
+        msg->SetHandled();
+        return;
+    }
+
+    // figure out the requested range, same rules as for local files
+    const int32 entrySize = int32(entry->UncompressedSize);
+    const int32 startOffset = msg->GetStartOffset();
+    int32 endOffset = (0 != msg->GetEndOffset()) ? msg->GetEndOffset() + 1 : entrySize;
+    if (endOffset > entrySize) {
+        endOffset = entrySize;
+    }
+    if ((startOffset < 0) || (startOffset > endOffset) || ((startOffset == entrySize) && (0 != startOffset))) {
+        msg->SetStatus(IOStatus::RequestedRangeNotSatisfiable);
+        msg->SetErrorDesc(IOStatus::ToString(IOStatus::RequestedRangeNotSatisfiable));
+        msg->SetHandled();
+        return;
+    }
+    const int32 rangeSize = endOffset - startOffset;
+
+    Ptr<Stream> stream;
+    if ((PakFormat::Compression::None == entry->Codec) || (0 == entrySize)) {
+        stream = _priv::pakStream::Create(archive, archive->Data(*entry) + startOffset, rangeSize);
+    }
+    else {
+        // decompress on the IO lane thread
+        Ptr<MemoryStream> memStream = MemoryStream::Create();
+        memStream->Reserve(entrySize);
+        memStream->Open(OpenMode::WriteOnly);
+        uint8* dst = memStream->MapWrite(entrySize);
+        const bool success = archive->Decompress(*entry, dst, entrySize);
+        memStream->UnmapWrite();
+        memStream->Close();
+        if (!success) {
+            o_warn("PakFileSystem: failed to decompress '%s'\n", url.AsCStr());
+            msg->SetStatus(IOStatus::InternalServerError);
+            msg->SetErrorDesc("broken compressed data");
+            msg->SetHandled();
+            return;
+        }
+        if (rangeSize != entrySize) {
+            Ptr<MemoryStream> rangeStream = MemoryStream::Create();
+            rangeStream->Open(OpenMode::WriteOnly);
+            memStream->Open(OpenMode::ReadOnly);
+            rangeStream->Write(memStream->MapRead(nullptr) + startOffset, rangeSize);
+            memStream->UnmapRead();
+            memStream->Close();
+            rangeStream->Close();
+            memStream = rangeStream;
+        }
+        stream = memStream;
+    }
+    stream->SetURL(url);
+    msg->SetStream(stream);
+    if ((0 != msg->GetStartOffset()) || (0 != msg->GetEndOffset())) {
+        msg->SetStatus(IOStatus::PartialContent);
+    }
+    else {
+        msg->SetStatus(IOStatus::OK);
+    }
+    msg->SetHandled();
+}
+
+} // namespace Oryol
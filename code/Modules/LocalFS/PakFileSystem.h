@@ -0,0 +1,56 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::PakFileSystem
+    @ingroup LocalFS
+    @brief serves pak: URLs from mounted pak archives
+    @see PakArchive, PakWriter, PakFormat
+
+    Instead of opening thousands of small files, the PakFileSystem
+    serves them from a few memory-mapped pak archives. An archive is
+    mounted once under a name, and its entries are addressed with
+    the archive name as host, and the entry name as path:
+
+        PakFileSystem::Mount("data", "/home/bla/game/data.pak");
+        IOSetup ioSetup;
+        ioSetup.FileSystems.Add("pak", PakFileSystem::Creator());
+        IO::Setup(ioSetup);
+        ...
+        IO::LoadFile("pak://data/textures/lok_dxt1.dds");
+
+    Mounted archives are shared by all IO lanes. Uncompressed entries
+    are returned as streams which point directly into the mapped
+    archive, compressed entries are decompressed into a MemoryStream
+    on the IO lane thread. StartOffset and EndOffset select a range
+    of the (uncompressed) entry data with the same semantics as the
+    LocalFileSystem, a ranged request returns IOStatus::PartialContent.
+*/
+#include "IO/FS/FileSystem.h"
+#include "Core/Creator.h"
+#include "LocalFS/PakArchive.h"
+
+namespace Oryol {
+
+class PakFileSystem : public FileSystem {
+    OryolClassDecl(PakFileSystem);
+    OryolClassCreator(PakFileSystem);
+public:
+    /// default constructor
+    PakFileSystem();
+    /// destructor
+    virtual ~PakFileSystem();
+
+    /// called when the IOProtocol::Request message is received
+    virtual void onRequest(const Ptr<IOProtocol::Request>& msg) override;
+
+    /// open a pak archive and mount it under a name (replaces an archive with the same name)
+    static IOStatus::Code Mount(const StringAtom& name, const String& nativePath);
+    /// unmount an archive, streams which are still alive keep the archive open
+    static void Unmount(const StringAtom& name);
+    /// test if an archive is mounted
+    static bool IsMounted(const StringAtom& name);
+    /// get a mounted archive, or invalid ptr if not mounted
+    static Ptr<PakArchive> Archive(const StringAtom& name);
+};
+
+} // namespace Oryol
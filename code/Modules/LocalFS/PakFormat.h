@@ -0,0 +1,94 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::PakFormat
+    @ingroup LocalFS
+    @brief file format of pak archives
+    @see PakArchive, PakWriter, PakFileSystem
+
+    A pak archive bundles many small files into one file which is
+    memory-mapped as a whole. The layout is:
+
+        Header                          // at offset 0
+        entry data                      // each entry starts at a DataAlignment boundary
+        Entry entries[numEntries]       // at Header::TocOffset, sorted by (NameHash, name)
+        char names[NamesSize]           // entry names, not 0-terminated
+
+    Entry data is either stored as is, or compressed as a single LZ4
+    block (see Compression). All values are in the byte order of the
+    machine which wrote the archive (little-endian on all current
+    platforms), archives from a machine with different byte order are
+    rejected because the magic number doesn't match.
+
+    Entry names are relative paths with forward slashes (e.g.
+    "textures/lok_dxt1.dds"), they are looked up by binary search on
+    the name hash.
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+
+class PakFormat {
+public:
+    /// the 'OPAK' magic number
+    static const uint32 Magic = 0x4b41504f;
+    /// current version
+    static const uint32 Version = 1;
+    /// alignment of entry data in the archive
+    static const int32 DataAlignment = 16;
+
+    /// entry compression methods
+    class Compression {
+    public:
+        enum Code : uint32 {
+            None = 0,   ///< data is stored as is
+            LZ4,        ///< data is a single LZ4 block
+
+            NumCompressions,
+            InvalidCompression,
+        };
+        /// convert to string
+        static const char* ToString(Code c) {
+            switch (c) {
+                case None:  return "None";
+                case LZ4:   return "LZ4";
+                default:    return "InvalidCompression";
+            }
+        }
+    };
+
+    /// archive header
+    struct Header {
+        uint32 Magic;
+        uint32 Version;
+        uint32 NumEntries;
+        uint32 NamesSize;
+        uint64 TocOffset;
+        uint64 Reserved;
+    };
+
+    /// table of contents entry
+    struct Entry {
+        uint32 NameHash;
+        uint32 NameOffset;          ///< offset of the name in the names table
+        uint32 NameLength;
+        Compression::Code Codec;    ///< how the entry data is compressed
+        uint64 Offset;              ///< offset of the (compressed) data in the archive
+        uint32 Size;                ///< size of the (compressed) data in the archive
+        uint32 UncompressedSize;    ///< size of the data after decompression
+    };
+
+    /// compute the name hash of an entry name (32-bit FNV-1a)
+    static uint32 HashName(const char* name, int32 len) {
+        uint32 hash = 2166136261U;
+        for (int32 i = 0; i < len; i++) {
+            hash ^= uint8(name[i]);
+            hash *= 16777619U;
+        }
+        return hash;
+    }
+};
+static_assert(sizeof(PakFormat::Header) == 32, "PakFormat::Header size mismatch");
+static_assert(sizeof(PakFormat::Entry) == 32, "PakFormat::Entry size mismatch");
+
+} // namespace Oryol
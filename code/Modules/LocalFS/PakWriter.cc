@@ -0,0 +1,184 @@
+//------------------------------------------------------------------------------
+//  PakWriter.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "PakWriter.h"
+#include "LocalFS/lz4Codec.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Log.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+PakWriter::PakWriter() :
+file(nullptr),
+failed(false),
+pos(0),
+dataSize(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+PakWriter::~PakWriter() {
+    if (this->IsWriting()) {
+        this->End();
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+PakWriter::IsWriting() const {
+    return nullptr != this->file;
+}
+
+//------------------------------------------------------------------------------
+int32
+PakWriter::NumEntries() const {
+    return this->entries.Size();
+}
+
+//------------------------------------------------------------------------------
+int64
+PakWriter::DataSize() const {
+    return this->dataSize;
+}
+
+//------------------------------------------------------------------------------
+void
+PakWriter::write(const void* ptr, int32 size) {
+    if (!this->failed && (size > 0)) {
+        this->failed = std::fwrite(ptr, 1, size, this->file) != size_t(size);
+        this->pos += size;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+PakWriter::Begin(const String& nativePath) {
+    o_assert(!this->IsWriting());
+    this->file = std::fopen(nativePath.AsCStr(), "wb");
+    if (nullptr == this->file) {
+        o_warn("PakWriter: failed to create '%s'\n", nativePath.AsCStr());
+        return false;
+    }
+    this->failed = false;
+    this->pos = 0;
+    this->dataSize = 0;
+    this->entries.Clear();
+    this->names.Clear();
+    this->nameSet.Clear();
+
+    // the header is written again in End()
+    PakFormat::Header header;
+    std::memset(&header, 0, sizeof(header));
+    this->write(&header, sizeof(header));
+    return !this->failed;
+}
+
+//------------------------------------------------------------------------------
+bool
+PakWriter::Add(const String& name, const uint8* data, int32 size, PakFormat::Compression::Code compression) {
+    o_assert(this->IsWriting());
+    o_assert((nullptr != data) || (0 == size));
+    if (this->nameSet.Contains(name)) {
+        o_warn("PakWriter: duplicate entry '%s'\n", name.AsCStr());
+        return false;
+    }
+
+    // align the entry data
+    static const uint8 padding[PakFormat::DataAlignment] = { 0 };
+    const int32 padSize = int32((PakFormat::DataAlignment - (this->pos % PakFormat::DataAlignment)) % PakFormat::DataAlignment);
+    this->write(padding, padSize);
+
+    PakFormat::Entry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.NameHash = PakFormat::HashName(name.AsCStr(), name.Length());
+    entry.NameLength = name.Length();
+    entry.Offset = uint64(this->pos);
+    entry.UncompressedSize = uint32(size);
+    entry.Codec = PakFormat::Compression::None;
+    entry.Size = uint32(size);
+    bool written = false;
+    if ((PakFormat::Compression::LZ4 == compression) && (size > 0)) {
+        const int32 maxSize = size - size / 8;
+        uint8* buf = (uint8*) Memory::Alloc(_priv::lz4Codec::compressBound(size));
+        const int32 compressedSize = _priv::lz4Codec::compress(data, size, buf, maxSize);
+        if (compressedSize > 0) {
+            entry.Codec = PakFormat::Compression::LZ4;
+            entry.Size = uint32(compressedSize);
+            this->write(buf, compressedSize);
+            written = true;
+        }
+        Memory::Free(buf);
+    }
+    if (!written) {
+        this->write(data, size);
+    }
+    if (this->failed) {
+        return false;
+    }
+    this->dataSize += entry.Size;
+    this->entries.Add(entry);
+    this->names.Add(name);
+    this->nameSet.Add(name);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+PakWriter::End() {
+    o_assert(this->IsWriting());
+
+    // sort the entries by name hash, then by name
+    Array<int32> order;
+    order.Reserve(this->entries.Size());
+    for (int32 i = 0; i < this->entries.Size(); i++) {
+        order.Add(i);
+    }
+    std::sort(order.begin(), order.end(), [this](int32 a, int32 b) {
+        const uint32 ha = this->entries[a].NameHash;
+        const uint32 hb = this->entries[b].NameHash;
+        return (ha != hb) ? (ha < hb) : (this->names[a] < this->names[b]);
+    });
+
+    // the table of contents follows the data, then the names
+    static const uint8 padding[PakFormat::DataAlignment] = { 0 };
+    const int32 padSize = int32((PakFormat::DataAlignment - (this->pos % PakFormat::DataAlignment)) % PakFormat::DataAlignment);
+    this->write(padding, padSize);
+    PakFormat::Header header;
+    std::memset(&header, 0, sizeof(header));
+    header.Magic = PakFormat::Magic;
+    header.Version = PakFormat::Version;
+    header.NumEntries = uint32(this->entries.Size());
+    header.TocOffset = uint64(this->pos);
+    uint32 nameOffset = 0;
+    for (int32 i : order) {
+        PakFormat::Entry entry = this->entries[i];
+        entry.NameOffset = nameOffset;
+        nameOffset += entry.NameLength;
+        this->write(&entry, sizeof(entry));
+    }
+    for (int32 i : order) {
+        this->write(this->names[i].AsCStr(), this->names[i].Length());
+    }
+    header.NamesSize = nameOffset;
+    if (!this->failed) {
+        this->failed = (0 != std::fseek(this->file, 0, SEEK_SET));
+        this->write(&header, sizeof(header));
+    }
+    this->failed |= (0 != std::fclose(this->file));
+    this->file = nullptr;
+    if (this->failed) {
+        o_warn("PakWriter: failed to write archive\n");
+    }
+    if (this->pos > 0x7FFFFFFF) {
+        o_warn("PakWriter: archive is larger than 2 GByte, can't be mapped\n");
+        this->failed = true;
+    }
+    return !this->failed;
+}
+
+} // namespace Oryol
@@ -0,0 +1,62 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::PakWriter
+    @ingroup LocalFS
+    @brief write pak archives
+    @see PakFormat, PakArchive, PakFileSystem
+
+    Entry data is written to the archive file right away, the table of
+    contents is collected in memory and written in End(). Compressed
+    entries are only stored compressed if this saves at least 1/8 of
+    their size, otherwise they are stored as is.
+
+        PakWriter writer;
+        writer.Begin("/home/bla/game/data.pak");
+        writer.Add("textures/lok_dxt1.dds", data, size, PakFormat::Compression::LZ4);
+        ...
+        writer.End();
+*/
+#include "Core/String/String.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Set.h"
+#include "LocalFS/PakFormat.h"
+#include <cstdio>
+
+namespace Oryol {
+
+class PakWriter {
+public:
+    /// constructor
+    PakWriter();
+    /// destructor, calls End() if still writing
+    ~PakWriter();
+
+    /// create the archive file
+    bool Begin(const String& nativePath);
+    /// add an entry, fails on duplicate names or write errors
+    bool Add(const String& name, const uint8* data, int32 size, PakFormat::Compression::Code compression=PakFormat::Compression::LZ4);
+    /// write the table of contents and close the file
+    bool End();
+    /// return true if between Begin() and End()
+    bool IsWriting() const;
+
+    /// get number of entries added so far
+    int32 NumEntries() const;
+    /// get number of bytes of entry data written so far (after compression)
+    int64 DataSize() const;
+
+private:
+    /// write bytes at the current position, track write errors
+    void write(const void* ptr, int32 size);
+
+    FILE* file;
+    bool failed;
+    int64 pos;
+    Array<PakFormat::Entry> entries;
+    Array<String> names;
+    Set<String> nameSet;
+    int64 dataSize;
+};
+
+} // namespace Oryol
@@ -0,0 +1,27 @@
+#pragma once
+//------------------------------------------------------------------------------
+//  LocalFSTest.h
+//  Helper functions shared by the LocalFS unit tests.
+//------------------------------------------------------------------------------
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "IO/IO.h"
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+/// load a byte range of an URL through the IO module and wait until handled
+inline Ptr<IOProtocol::Request>
+loadAndWait(const URL& url, int32 startOffset, int32 endOffset) {
+    Ptr<IOProtocol::Request> req = IOProtocol::Request::Create();
+    req->SetURL(url);
+    req->SetStartOffset(startOffset);
+    req->SetEndOffset(endOffset);
+    IO::Put(req);
+    while (!req->Handled()) {
+        Core::PreRunLoop()->Run();
+    }
+    return req;
+}
+
+} // namespace Oryol
@@ -0,0 +1,275 @@
+//------------------------------------------------------------------------------
+//  LocalFileCacheTest.cc
+//  Test the on-disk IO cache.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/String/StringBuilder.h"
+#include "LocalFS/LocalFileCache.h"
+#include "IO/IO.h"
+#include "IO/Stream/MemoryStream.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unistd.h>
+
+using namespace Oryol;
+
+#if ORYOL_POSIX && !ORYOL_EMSCRIPTEN
+namespace {
+
+// stand-in for a HTTP server: serves strings with an ETag, answers
+// conditional requests with 304, responses are sent in DoWork()
+std::mutex serverLock;
+Map<String, String> serverContent;
+Map<String, String> serverETags;
+std::atomic<int32> numServerRequests{0};
+std::atomic<int32> numNotModified{0};
+
+class standInFileSystem : public FileSystem {
+    OryolClassDecl(standInFileSystem);
+    OryolClassCreator(standInFileSystem);
+public:
+    virtual void onRequest(const Ptr<IOProtocol::Request>& msg) override {
+        this->requests.Add(msg);
+    }
+    virtual void DoWork() override {
+        for (const auto& req : this->requests) {
+            numServerRequests++;
+            std::lock_guard<std::mutex> guard(serverLock);
+            const String path = req->GetURL().Path();
+            if (!serverContent.Contains(path)) {
+                req->SetStatus(IOStatus::NotFound);
+            }
+            else if (req->GetIfNoneMatch().IsValid() && (req->GetIfNoneMatch() == serverETags[path])) {
+                numNotModified++;
+                req->SetStatus(IOStatus::NotModified);
+            }
+            else {
+                const String& content = serverContent[path];
+                Ptr<MemoryStream> stream = MemoryStream::Create();
+                stream->SetURL(req->GetURL());
+                stream->SetContentType("text/plain");
+                stream->Open(OpenMode::WriteOnly);
+                stream->Write(content.AsCStr(), content.Length());
+                stream->Close();
+                req->SetStream(stream);
+                req->SetETag(serverETags[path]);
+                req->SetStatus(IOStatus::OK);
+            }
+            req->SetHandled();
+        }
+        this->requests.Clear();
+    }
+    Array<Ptr<IOProtocol::Request>> requests;
+};
+OryolClassImpl(standInFileSystem);
+
+void
+serve(const char* path, const char* content, const char* eTag) {
+    std::lock_guard<std::mutex> guard(serverLock);
+    serverContent.Erase(path);
+    serverContent.Add(path, content);
+    serverETags.Erase(path);
+    serverETags.Add(path, eTag);
+}
+
+Ptr<IOProtocol::Request>
+loadAndWait(const URL& url, bool cacheRead=true, bool cacheWrite=true) {
+    Ptr<IOProtocol::Request> req = IOProtocol::Request::Create();
+    req->SetURL(url);
+    req->SetCacheReadEnabled(cacheRead);
+    req->SetCacheWriteEnabled(cacheWrite);
+    IO::Put(req);
+    while (!req->Handled()) {
+        Core::PreRunLoop()->Run();
+    }
+    return req;
+}
+
+String
+readString(const Ptr<Stream>& stream) {
+    String str;
+    if (stream.isValid() && (stream->Size() > 0)) {
+        stream->Open(OpenMode::ReadOnly);
+        const uint8* data = stream->MapRead(nullptr);
+        str.Assign((const char*)data, 0, stream->Size());
+        stream->UnmapRead();
+        stream->Close();
+    }
+    return str;
+}
+
+Ptr<Stream>
+makeStream(const char* content) {
+    Ptr<MemoryStream> stream = MemoryStream::Create();
+    stream->Open(OpenMode::WriteOnly);
+    stream->Write(content, int32(std::strlen(content)));
+    stream->Close();
+    return stream;
+}
+
+void
+removeCacheDir(const char* dir) {
+    StringBuilder strBuilder;
+    strBuilder.Format(256, "%s/cache.idx", dir);
+    std::remove(strBuilder.AsCStr());
+    for (int i = 0; i < 16; i++) {
+        strBuilder.Format(256, "%s/cache.%d.pak", dir, i);
+        std::remove(strBuilder.AsCStr());
+    }
+    rmdir(dir);
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(LocalFileCacheTest) {
+    char dir[] = "/tmp/oryol_cache_XXXXXX";
+    CHECK(nullptr != mkdtemp(dir));
+    LocalFileCacheSetup setup;
+    setup.Path = dir;
+    setup.MaxSize = 64;
+    String eTag, lastModified;
+    {
+        Ptr<LocalFileCache> cache = LocalFileCache::Create(setup);
+        CHECK(cache->IsCacheable("http://host/bla.txt"));
+        CHECK(!cache->IsCacheable("file:///bla.txt"));
+        CHECK(!cache->Lookup("http://host/a.txt", eTag, lastModified).isValid());
+
+        // store and lookup, identical data is only stored once
+        cache->Store("http://host/a.txt", "\"a1\"", "Tue, 15 Nov 1994 12:45:26 GMT", makeStream("0123456789abcdef"));
+        cache->Store("http://host/b.txt", "\"b1\"", "", makeStream("0123456789abcdef"));
+        cache->Store("http://host/c.txt", "\"c1\"", "", makeStream("ABCDEFGHIJKLMNOP"));
+        CHECK(cache->NumEntries() == 3);
+        CHECK(cache->Size() == 32);
+        CHECK(cache->PackSize() == 32);
+        Ptr<Stream> stream = cache->Lookup("http://host/a.txt", eTag, lastModified);
+        CHECK(stream.isValid());
+        CHECK(readString(stream) == "0123456789abcdef");
+        CHECK(eTag == "\"a1\"");
+        CHECK(lastModified == "Tue, 15 Nov 1994 12:45:26 GMT");
+        CHECK(readString(cache->Lookup("http://host/c.txt", eTag, lastModified)) == "ABCDEFGHIJKLMNOP");
+        CHECK(eTag == "\"c1\"");
+
+        // a new version of an URL replaces the old one
+        cache->Store("http://host/b.txt", "\"b2\"", "", makeStream("bbbbbbbbbbbbbbbb"));
+        CHECK(cache->NumEntries() == 3);
+        CHECK(cache->Size() == 48);
+        CHECK(readString(cache->Lookup("http://host/b.txt", eTag, lastModified)) == "bbbbbbbbbbbbbbbb");
+        CHECK(eTag == "\"b2\"");
+    }
+    {
+        // the index survives, and the least recently used entries are evicted
+        Ptr<LocalFileCache> cache = LocalFileCache::Create(setup);
+        CHECK(cache->NumEntries() == 3);
+        CHECK(cache->Size() == 48);
+        Ptr<Stream> held = cache->Lookup("http://host/a.txt", eTag, lastModified);
+        cache->Store("http://host/d.txt", "", "", makeStream("dddddddddddddddddddddddddddddddddddddddddddddddd"));
+        CHECK(cache->NumEntries() == 2);
+        CHECK(cache->Size() == 64);
+        CHECK(!cache->Lookup("http://host/c.txt", eTag, lastModified).isValid());
+        CHECK(!cache->Lookup("http://host/b.txt", eTag, lastModified).isValid());
+
+        // dead space is compacted away, existing streams stay valid
+        cache->Store("http://host/e.txt", "", "", makeStream("eeeeeeeeeeeeeeee"));
+        CHECK(cache->NumEntries() == 2);
+        CHECK(cache->Size() == 64);
+        CHECK(cache->PackSize() == 64);
+        CHECK(readString(held) == "0123456789abcdef");
+        CHECK(readString(cache->Lookup("http://host/e.txt", eTag, lastModified)) == "eeeeeeeeeeeeeeee");
+
+        // data larger than the cache is not stored
+        cache->Store("http://host/big.txt", "", "", makeStream("0123456789012345678901234567890123456789012345678901234567890123456789"));
+        CHECK(!cache->Lookup("http://host/big.txt", eTag, lastModified).isValid());
+    }
+    removeCacheDir(dir);
+}
+
+//------------------------------------------------------------------------------
+TEST(LocalFileCacheIOTest) {
+    char dir[] = "/tmp/oryol_cache_XXXXXX";
+    CHECK(nullptr != mkdtemp(dir));
+    serve("a.txt", "content of a", "\"a1\"");
+    serve("b.txt", "content of b", "\"b1\"");
+    LocalFileCacheSetup setup;
+    setup.Path = dir;
+    setup.Schemes.Add("standin");
+
+    IOSetup ioSetup;
+    ioSetup.NumIOLanes = 2;
+    ioSetup.FileSystems.Add("standin", standInFileSystem::Creator());
+    ioSetup.Cache = LocalFileCache::Create(setup);
+    IO::Setup(ioSetup);
+
+    // first load goes to the server and is stored in the cache
+    numServerRequests = 0;
+    Ptr<IOProtocol::Request> req = loadAndWait("standin://host/a.txt");
+    CHECK(req->GetStatus() == IOStatus::OK);
+    CHECK(readString(req->GetStream()) == "content of a");
+    CHECK(req->GetETag() == "\"a1\"");
+    CHECK(numServerRequests == 1);
+
+    // second load is served from the cache
+    req = loadAndWait("standin://host/a.txt");
+    CHECK(req->GetStatus() == IOStatus::OK);
+    CHECK(req->GetStream()->GetContentType() == "text/plain");
+    CHECK(readString(req->GetStream()) == "content of a");
+    CHECK(req->GetETag() == "\"a1\"");
+    CHECK(numServerRequests == 1);
+
+    // bypass reading the cache, without writing the new data
+    serve("a.txt", "new content of a", "\"a2\"");
+    req = loadAndWait("standin://host/a.txt", false, false);
+    CHECK(readString(req->GetStream()) == "new content of a");
+    CHECK(numServerRequests == 2);
+    req = loadAndWait("standin://host/a.txt");
+    CHECK(readString(req->GetStream()) == "content of a");
+    CHECK(numServerRequests == 2);
+
+    // errors are not cached
+    req = loadAndWait("standin://host/missing.txt");
+    CHECK(req->GetStatus() == IOStatus::NotFound);
+    req = loadAndWait("standin://host/missing.txt");
+    CHECK(req->GetStatus() == IOStatus::NotFound);
+    CHECK(numServerRequests == 4);
+
+    int32 numHits = 0;
+    int32 numMisses = 0;
+    for (int32 i = 0; i < IO::NumLanes(); i++) {
+        numHits += IO::LaneStats(i).NumCacheHits;
+        numMisses += IO::LaneStats(i).NumCacheMisses;
+    }
+    CHECK(numHits == 2);
+    CHECK(numMisses == 3);
+    IO::Discard();
+
+    // with revalidation, unchanged data comes from the cache, changed data is updated
+    setup.Revalidate = true;
+    ioSetup.Cache = nullptr;
+    ioSetup.Cache = LocalFileCache::Create(setup);
+    IO::Setup(ioSetup);
+    numServerRequests = 0;
+    numNotModified = 0;
+    req = loadAndWait("standin://host/b.txt");
+    CHECK(readString(req->GetStream()) == "content of b");
+    req = loadAndWait("standin://host/b.txt");
+    CHECK(req->GetStatus() == IOStatus::OK);
+    CHECK(readString(req->GetStream()) == "content of b");
+    CHECK(numServerRequests == 2);
+    CHECK(numNotModified == 1);
+    req = loadAndWait("standin://host/a.txt");
+    CHECK(req->GetStatus() == IOStatus::OK);
+    CHECK(readString(req->GetStream()) == "new content of a");
+    CHECK(req->GetETag() == "\"a2\"");
+    CHECK(numNotModified == 1);
+    IO::Discard();
+
+    ioSetup.Cache = nullptr;
+    removeCacheDir(dir);
+}
+#endif
@@ -0,0 +1,114 @@
+//------------------------------------------------------------------------------
+//  LocalFileSystemTest.cc
+//  Test local file system functionality.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/String/StringBuilder.h"
+#include "LocalFS/LocalFileSystem.h"
+#include "LocalFS/MappedStream.h"
+#include "IO/IO.h"
+#include "LocalFS/UnitTests/LocalFSTest.h"
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+using namespace Oryol;
+
+#if ORYOL_POSIX && !ORYOL_EMSCRIPTEN
+TEST(LocalFileSystemTest) {
+
+    // write a test file
+    char path[] = "/tmp/oryol_localfs_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(-1 != fd);
+    const char* content = "0123456789ABCDEF";
+    const int32 contentSize = int32(std::strlen(content));
+    CHECK(contentSize == write(fd, content, contentSize));
+    close(fd);
+
+    StringBuilder strBuilder;
+    strBuilder.Format(256, "file://%s", path);
+    const URL url = strBuilder.GetString();
+    CHECK(LocalFileSystem::NativePath(url) == path);
+
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+    IO::Setup(ioSetup);
+
+    // load the whole file
+    Ptr<IOProtocol::Request> req = loadAndWait(url, 0, 0);
+    CHECK(req->GetStatus() == IOStatus::OK);
+    const Ptr<Stream>& stream = req->GetStream();
+    CHECK(stream.isValid());
+    CHECK(stream->Size() == contentSize);
+    stream->Open(OpenMode::ReadOnly);
+    const uint8* maxPtr = nullptr;
+    const uint8* data = stream->MapRead(&maxPtr);
+    CHECK((maxPtr - data) == contentSize);
+    CHECK(0 == std::memcmp(data, content, contentSize));
+    stream->UnmapRead();
+    char buf[4] = { 0 };
+    stream->SetReadPosition(10);
+    CHECK(stream->Read(buf, 4) == 4);
+    CHECK(0 == std::memcmp(buf, "ABCD", 4));
+    stream->Close();
+
+    // a ranged request (EndOffset is inclusive)
+    req = loadAndWait(url, 5, 9);
+    CHECK(req->GetStatus() == IOStatus::PartialContent);
+    CHECK(req->GetStream()->Size() == 5);
+    req->GetStream()->Open(OpenMode::ReadOnly);
+    CHECK(0 == std::memcmp(req->GetStream()->MapRead(nullptr), "56789", 5));
+    req->GetStream()->Close();
+
+    // start offset only, crossing no page boundary
+    req = loadAndWait(url, 12, 0);
+    CHECK(req->GetStatus() == IOStatus::PartialContent);
+    CHECK(req->GetStream()->Size() == 4);
+
+    // invalid range
+    req = loadAndWait(url, 100, 0);
+    CHECK(req->GetStatus() == IOStatus::RequestedRangeNotSatisfiable);
+    CHECK(!req->GetStream().isValid());
+
+    // progressive loading into a ChunkedStream
+    Ptr<ChunkedStream> chunked = ChunkedStream::Create(4);
+    req = IOProtocol::Request::Create();
+    req->SetURL(url);
+    req->SetStartOffset(2);
+    req->SetProgressiveStream(chunked);
+    IO::Put(req);
+    CHECK(chunked->WaitAvailable(contentSize - 2));
+    CHECK(chunked->ReadAt(0, buf, 4) == 4);
+    CHECK(0 == std::memcmp(buf, "2345", 4));
+    while (!req->Handled()) {
+        Core::PreRunLoop()->Run();
+    }
+    CHECK(req->GetStatus() == IOStatus::PartialContent);
+    CHECK(req->GetStream() == chunked);
+    CHECK(chunked->IsComplete() && !chunked->IsFailed());
+    CHECK(chunked->AvailableSize() == contentSize - 2);
+
+    // file doesn't exist
+    req = loadAndWait("file:///tmp/oryol_localfs_does_not_exist", 0, 0);
+    CHECK(req->GetStatus() == IOStatus::NotFound);
+    chunked = ChunkedStream::Create();
+    req = IOProtocol::Request::Create();
+    req->SetURL("file:///tmp/oryol_localfs_does_not_exist");
+    req->SetProgressiveStream(chunked);
+    IO::Put(req);
+    CHECK(!chunked->WaitAvailable(1));
+    CHECK(chunked->IsFailed());
+    while (!req->Handled()) {
+        Core::PreRunLoop()->Run();
+    }
+    CHECK(req->GetStatus() == IOStatus::NotFound);
+    req = 0;
+
+    IO::Discard();
+    unlink(path);
+}
+#endif
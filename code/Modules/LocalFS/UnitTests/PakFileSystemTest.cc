@@ -0,0 +1,209 @@
+//------------------------------------------------------------------------------
+//  PakFileSystemTest.cc
+//  Test pak archives, the LZ4 codec and the pak file system.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/String/StringBuilder.h"
+#include "LocalFS/PakFileSystem.h"
+#include "LocalFS/PakWriter.h"
+#include "LocalFS/lz4Codec.h"
+#include "IO/IO.h"
+#include "LocalFS/UnitTests/LocalFSTest.h"
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+using namespace Oryol;
+using namespace Oryol::_priv;
+
+//------------------------------------------------------------------------------
+TEST(LZ4CodecTest) {
+    // repetitive data must compress well and roundtrip
+    const int32 size = 10000;
+    Array<uint8> src;
+    for (int32 i = 0; i < size; i++) {
+        src.Add(uint8("Oryol pak archive "[i % 18]));
+    }
+    Array<uint8> comp;
+    comp.Reserve(lz4Codec::compressBound(size));
+    for (int32 i = 0; i < lz4Codec::compressBound(size); i++) {
+        comp.Add(0);
+    }
+    const int32 compSize = lz4Codec::compress(&src[0], size, &comp[0], comp.Size());
+    CHECK(compSize > 0);
+    CHECK(compSize < size / 10);
+    Array<uint8> dst;
+    for (int32 i = 0; i < size; i++) {
+        dst.Add(0);
+    }
+    CHECK(lz4Codec::decompress(&comp[0], compSize, &dst[0], size) == size);
+    CHECK(0 == std::memcmp(&src[0], &dst[0], size));
+
+    // not enough room in the destination buffer
+    CHECK(lz4Codec::compress(&src[0], size, &comp[0], 8) == 0);
+    CHECK(lz4Codec::decompress(&comp[0], compSize, &dst[0], size - 1) == -1);
+
+    // truncated or garbage input must fail gracefully
+    CHECK(lz4Codec::decompress(&comp[0], compSize - 1, &dst[0], size) != size);
+    const uint8 garbage[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0xFF, 0xFF };
+    CHECK(lz4Codec::decompress(garbage, sizeof(garbage), &dst[0], size) == -1);
+
+    // random data, and very small inputs
+    uint32 seed = 12345;
+    for (int32 i = 0; i < size; i++) {
+        seed = seed * 1103515245 + 12345;
+        src[i] = uint8(seed >> 16);
+    }
+    for (int32 n : { 1, 5, 13, 100, size }) {
+        const int32 s = lz4Codec::compress(&src[0], n, &comp[0], comp.Size());
+        CHECK(s > 0);
+        CHECK(lz4Codec::decompress(&comp[0], s, &dst[0], n) == n);
+        CHECK(0 == std::memcmp(&src[0], &dst[0], n));
+    }
+}
+
+#if ORYOL_POSIX && !ORYOL_EMSCRIPTEN
+//------------------------------------------------------------------------------
+static bool
+checkContent(const Ptr<IOProtocol::Request>& req, const void* content, int32 size) {
+    const Ptr<Stream>& stream = req->GetStream();
+    if (!stream.isValid() || (stream->Size() != size)) {
+        return false;
+    }
+    stream->Open(OpenMode::ReadOnly);
+    const uint8* data = stream->MapRead(nullptr);
+    bool equal = (0 == size) || (0 == std::memcmp(data, content, size));
+    stream->UnmapRead();
+    stream->Close();
+    return equal;
+}
+
+//------------------------------------------------------------------------------
+TEST(PakFileSystemTest) {
+
+    char path[] = "/tmp/oryol_pak_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(-1 != fd);
+    close(fd);
+
+    // build test content, one compressible and one incompressible entry
+    const int32 textSize = 5000;
+    Array<uint8> text;
+    for (int32 i = 0; i < textSize; i++) {
+        text.Add(uint8('a' + (i % 7)));
+    }
+    const char* small = "0123456789ABCDEF";
+
+    PakWriter writer;
+    CHECK(writer.Begin(path));
+    CHECK(writer.Add("data/text.txt", &text[0], textSize));
+    CHECK(writer.Add("data/small.bin", (const uint8*) small, 16));
+    CHECK(writer.Add("empty", nullptr, 0));
+    CHECK(!writer.Add("empty", nullptr, 0));
+    CHECK(writer.NumEntries() == 3);
+    CHECK(writer.DataSize() < textSize);
+    CHECK(writer.End());
+
+    // open the archive directly
+    Ptr<PakArchive> archive = PakArchive::Create();
+    CHECK(archive->Open(path) == IOStatus::OK);
+    CHECK(archive->NumEntries() == 3);
+    const PakFormat::Entry* e = archive->Find("data/text.txt", 13);
+    CHECK(nullptr != e);
+    if (e) {
+        CHECK(e->Codec == PakFormat::Compression::LZ4);
+        CHECK(e->UncompressedSize == uint32(textSize));
+        CHECK(0 == (e->Offset % PakFormat::DataAlignment));
+        CHECK(archive->NameAt(int32(e - &archive->EntryAt(0))) == "data/text.txt");
+    }
+    e = archive->Find("data/small.bin", 14);
+    CHECK(nullptr != e);
+    if (e) {
+        CHECK(e->Codec == PakFormat::Compression::None);
+        CHECK(0 == std::memcmp(archive->Data(*e), small, 16));
+    }
+    CHECK(nullptr == archive->Find("data/bla.txt", 12));
+    CHECK(nullptr == archive->Find("data", 4));
+    archive = nullptr;
+
+    // not a pak archive
+    Ptr<PakArchive> broken = PakArchive::Create();
+    CHECK(broken->Open("/dev/null") != IOStatus::OK);
+    CHECK(!broken->IsOpen());
+
+    // entry offsets where offset + size wraps around must be rejected
+    char brokenPath[] = "/tmp/oryol_pak_broken_XXXXXX";
+    fd = mkstemp(brokenPath);
+    CHECK(-1 != fd);
+    close(fd);
+    FILE* fp = std::fopen(path, "rb");
+    std::fseek(fp, 0, SEEK_END);
+    Array<uint8> bytes;
+    bytes.Reserve(int32(std::ftell(fp)));
+    for (int32 i = 0; i < bytes.Capacity(); i++) {
+        bytes.Add(0);
+    }
+    std::fseek(fp, 0, SEEK_SET);
+    CHECK(std::fread(&bytes[0], 1, bytes.Size(), fp) == size_t(bytes.Size()));
+    std::fclose(fp);
+    const PakFormat::Header* hdr = (const PakFormat::Header*) &bytes[0];
+    PakFormat::Entry* toc = (PakFormat::Entry*) &bytes[int32(hdr->TocOffset)];
+    for (uint32 i = 0; i < hdr->NumEntries; i++) {
+        if (toc[i].Size > 0) {
+            toc[i].Offset = ~uint64(0);
+        }
+    }
+    fp = std::fopen(brokenPath, "wb");
+    CHECK(std::fwrite(&bytes[0], 1, bytes.Size(), fp) == size_t(bytes.Size()));
+    std::fclose(fp);
+    CHECK(broken->Open(brokenPath) == IOStatus::UnsupportedMediaType);
+    CHECK(!broken->IsOpen());
+    std::remove(brokenPath);
+
+    // load entries through the IO module
+    CHECK(PakFileSystem::Mount("test", path) == IOStatus::OK);
+    CHECK(PakFileSystem::IsMounted("test"));
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("pak", PakFileSystem::Creator());
+    IO::Setup(ioSetup);
+
+    Ptr<IOProtocol::Request> req = loadAndWait("pak://test/data/text.txt", 0, 0);
+    CHECK(req->GetStatus() == IOStatus::OK);
+    CHECK(checkContent(req, &text[0], textSize));
+    req = loadAndWait("pak://test/data/small.bin", 0, 0);
+    CHECK(req->GetStatus() == IOStatus::OK);
+    CHECK(checkContent(req, small, 16));
+    req = loadAndWait("pak://test/empty", 0, 0);
+    CHECK(req->GetStatus() == IOStatus::OK);
+    CHECK(checkContent(req, nullptr, 0));
+
+    // ranged requests on compressed and uncompressed entries
+    req = loadAndWait("pak://test/data/small.bin", 5, 9);
+    CHECK(req->GetStatus() == IOStatus::PartialContent);
+    CHECK(checkContent(req, "56789", 5));
+    req = loadAndWait("pak://test/data/text.txt", 1000, 1999);
+    CHECK(req->GetStatus() == IOStatus::PartialContent);
+    CHECK(checkContent(req, &text[1000], 1000));
+    req = loadAndWait("pak://test/data/text.txt", 4990, 0);
+    CHECK(req->GetStatus() == IOStatus::PartialContent);
+    CHECK(checkContent(req, &text[4990], 10));
+    req = loadAndWait("pak://test/data/small.bin", 100, 0);
+    CHECK(req->GetStatus() == IOStatus::RequestedRangeNotSatisfiable);
+    CHECK(!req->GetStream().isValid());
+
+    // missing entries and archives
+    req = loadAndWait("pak://test/data/bla.txt", 0, 0);
+    CHECK(req->GetStatus() == IOStatus::NotFound);
+    PakFileSystem::Unmount("test");
+    CHECK(!PakFileSystem::IsMounted("test"));
+    req = loadAndWait("pak://test/data/small.bin", 0, 0);
+    CHECK(req->GetStatus() == IOStatus::NotFound);
+    req = 0;
+
+    IO::Discard();
+    unlink(path);
+}
+#endif
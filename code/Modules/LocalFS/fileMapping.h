@@ -0,0 +1,17 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::fileMapping
+    @ingroup _priv
+    @brief private: platform-specific read-only file mapping
+    @see MappedStream
+*/
+#if ORYOL_POSIX
+#include "LocalFS/posix/posixFileMapping.h"
+namespace Oryol {
+namespace _priv {
+class fileMapping : public posixFileMapping {};
+} }
+#else
+#error "LocalFS: file mapping not implemented on this platform!"
+#endif
@@ -0,0 +1,227 @@
+//------------------------------------------------------------------------------
+//  lz4Codec.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "lz4Codec.h"
+#include "Core/Assertion.h"
+#include <cstring>
+
+namespace Oryol {
+namespace _priv {
+
+namespace {
+
+const int32 MinMatch = 4;
+const int32 LastLiterals = 5;       // the last 5 bytes are always literals
+const int32 MFLimit = 12;           // the last match must start 12 bytes before the end
+const int32 MaxOffset = 65535;
+const int32 HashLog = 12;
+
+//------------------------------------------------------------------------------
+inline uint32
+read32(const uint8* ptr) {
+    uint32 val;
+    std::memcpy(&val, ptr, sizeof(val));
+    return val;
+}
+
+//------------------------------------------------------------------------------
+inline uint32
+hash32(uint32 seq) {
+    return (seq * 2654435761U) >> (32 - HashLog);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Write a length which didn't fit into the token nibble.
+*/
+inline uint8*
+writeLength(int32 len, uint8* op, const uint8* opEnd) {
+    while (len >= 255) {
+        if (op >= opEnd) {
+            return nullptr;
+        }
+        *op++ = 255;
+        len -= 255;
+    }
+    if (op >= opEnd) {
+        return nullptr;
+    }
+    *op++ = uint8(len);
+    return op;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Write one sequence (literals followed by an optional match), matchLen
+    is 0 for the last sequence.
+*/
+uint8*
+writeSequence(const uint8* literals, int32 litLen, int32 offset, int32 matchLen, uint8* op, const uint8* opEnd) {
+    if (op >= opEnd) {
+        return nullptr;
+    }
+    uint8* token = op++;
+    *token = uint8((litLen >= 15 ? 15 : litLen) << 4);
+    if (litLen >= 15) {
+        op = writeLength(litLen - 15, op, opEnd);
+        if (nullptr == op) {
+            return nullptr;
+        }
+    }
+    if ((op + litLen) > opEnd) {
+        return nullptr;
+    }
+    std::memcpy(op, literals, litLen);
+    op += litLen;
+    if (matchLen > 0) {
+        if ((op + 2) > opEnd) {
+            return nullptr;
+        }
+        *op++ = uint8(offset & 0xFF);
+        *op++ = uint8(offset >> 8);
+        const int32 len = matchLen - MinMatch;
+        *token |= uint8(len >= 15 ? 15 : len);
+        if (len >= 15) {
+            op = writeLength(len - 15, op, opEnd);
+        }
+    }
+    return op;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+int32
+lz4Codec::compressBound(int32 srcSize) {
+    o_assert_dbg(srcSize >= 0);
+    return srcSize + (srcSize / 255) + 16;
+}
+
+//------------------------------------------------------------------------------
+int32
+lz4Codec::compress(const uint8* src, int32 srcSize, uint8* dst, int32 dstCapacity) {
+    o_assert_dbg(src && dst && (srcSize >= 0));
+    uint8* op = dst;
+    const uint8* opEnd = dst + dstCapacity;
+    int32 anchor = 0;
+    if (srcSize > MFLimit) {
+        // hash table of the last positions of 4-byte sequences
+        int32 table[1 << HashLog];
+        for (int32& pos : table) {
+            pos = -1;
+        }
+        const int32 limit = srcSize - MFLimit;
+        const int32 matchLimit = srcSize - LastLiterals;
+        int32 ip = 0;
+        while (ip < limit) {
+            const uint32 seq = read32(src + ip);
+            const uint32 h = hash32(seq);
+            const int32 ref = table[h];
+            table[h] = ip;
+            if ((ref >= 0) && ((ip - ref) <= MaxOffset) && (read32(src + ref) == seq)) {
+                int32 len = MinMatch;
+                while (((ip + len) < matchLimit) && (src[ref + len] == src[ip + len])) {
+                    len++;
+                }
+                op = writeSequence(src + anchor, ip - anchor, ip - ref, len, op, opEnd);
+                if (nullptr == op) {
+                    return 0;
+                }
+                ip += len;
+                anchor = ip;
+            }
+            else {
+                ip++;
+            }
+        }
+    }
+    op = writeSequence(src + anchor, srcSize - anchor, 0, 0, op, opEnd);
+    if (nullptr == op) {
+        return 0;
+    }
+    return int32(op - dst);
+}
+
+//------------------------------------------------------------------------------
+int32
+lz4Codec::decompress(const uint8* src, int32 srcSize, uint8* dst, int32 dstCapacity) {
+    o_assert_dbg(src && dst && (srcSize >= 0));
+    const uint8* ip = src;
+    const uint8* ipEnd = src + srcSize;
+    uint8* op = dst;
+    const uint8* opEnd = dst + dstCapacity;
+    while (ip < ipEnd) {
+        const uint8 token = *ip++;
+
+        // literals
+        int32 litLen = token >> 4;
+        if (15 == litLen) {
+            uint8 b;
+            do {
+                if (ip >= ipEnd) {
+                    return -1;
+                }
+                b = *ip++;
+                litLen += b;
+                if (litLen > dstCapacity) {
+                    return -1;
+                }
+            }
+            while (255 == b);
+        }
+        if ((litLen > (ipEnd - ip)) || (litLen > (opEnd - op))) {
+            return -1;
+        }
+        std::memcpy(op, ip, litLen);
+        ip += litLen;
+        op += litLen;
+        if (ip == ipEnd) {
+            // the last sequence has no match
+            break;
+        }
+
+        // match
+        if ((ipEnd - ip) < 2) {
+            return -1;
+        }
+        const int32 offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if ((0 == offset) || (offset > (op - dst))) {
+            return -1;
+        }
+        int32 matchLen = (token & 15) + MinMatch;
+        if ((15 + MinMatch) == matchLen) {
+            uint8 b;
+            do {
+                if (ip >= ipEnd) {
+                    return -1;
+                }
+                b = *ip++;
+                matchLen += b;
+                if (matchLen > dstCapacity) {
+                    return -1;
+                }
+            }
+            while (255 == b);
+        }
+        if (matchLen > (opEnd - op)) {
+            return -1;
+        }
+        const uint8* match = op - offset;
+        if (offset >= matchLen) {
+            std::memcpy(op, match, matchLen);
+            op += matchLen;
+        }
+        else {
+            // overlapping copy repeats the last offset bytes
+            for (int32 i = 0; i < matchLen; i++) {
+                *op++ = *match++;
+            }
+        }
+    }
+    return int32(op - dst);
+}
+
+} // namespace _priv
+} // namespace Oryol
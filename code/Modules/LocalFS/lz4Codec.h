@@ -0,0 +1,32 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::lz4Codec
+    @ingroup _priv
+    @brief private: LZ4 block format compressor and decompressor
+
+    Produces and consumes raw LZ4 blocks (no frame header, the
+    uncompressed size must be known by the caller), the output is
+    compatible with LZ4_compress_default() / LZ4_decompress_safe().
+    The compressor is a simple greedy single-pass matcher, which
+    favours a small implementation over compression ratio.
+    Decompression validates all offsets and lengths, so broken
+    data never reads or writes out of bounds.
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+namespace _priv {
+
+class lz4Codec {
+public:
+    /// max size of compressed data for a given input size
+    static int32 compressBound(int32 srcSize);
+    /// compress data, return compressed size, or 0 if it doesn't fit into dst
+    static int32 compress(const uint8* src, int32 srcSize, uint8* dst, int32 dstCapacity);
+    /// decompress data, return decompressed size, or -1 if the data is broken or doesn't fit
+    static int32 decompress(const uint8* src, int32 srcSize, uint8* dst, int32 dstCapacity);
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+//  pakStream.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "pakStream.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+namespace _priv {
+
+OryolClassImpl(pakStream);
+
+//------------------------------------------------------------------------------
+pakStream::pakStream(const Ptr<PakArchive>& archive_, const uint8* data_, int32 size_) :
+archive(archive_),
+data(data_) {
+    o_assert(archive_.isValid() && (size_ >= 0));
+    this->size = size_;
+}
+
+//------------------------------------------------------------------------------
+pakStream::~pakStream() {
+    if (this->IsOpen()) {
+        this->Close();
+    }
+    this->DiscardContent();
+}
+
+//------------------------------------------------------------------------------
+bool
+pakStream::Open(OpenMode::Enum mode) {
+    o_assert2(OpenMode::ReadOnly == mode, "pakStream can only be opened as ReadOnly!\n");
+    return Stream::Open(mode);
+}
+
+//------------------------------------------------------------------------------
+void
+pakStream::DiscardContent() {
+    o_assert(!this->isOpen);
+    this->archive = nullptr;
+    this->data = nullptr;
+    this->size = 0;
+    this->readPosition = 0;
+    this->writePosition = 0;
+}
+
+//------------------------------------------------------------------------------
+int32
+pakStream::Read(void* ptr, int32 numBytes) {
+    o_assert(this->isOpen);
+    o_assert(this->IsReadable());
+    o_assert((this->readPosition >= 0) && (this->readPosition <= this->size));
+
+    // cap numBytes if EndOfStream or trying to read past stream
+    if ((EndOfStream == numBytes) || ((this->readPosition + numBytes) > this->size)) {
+        numBytes = this->size - this->readPosition;
+    }
+    if (numBytes > 0) {
+        Memory::Copy(this->data + this->readPosition, ptr, numBytes);
+        this->readPosition += numBytes;
+    }
+    return numBytes;
+}
+
+//------------------------------------------------------------------------------
+/**
+ See Stream::MapRead() for details! The returned pointer points
+ into the mapped archive.
+*/
+const uint8*
+pakStream::MapRead(const uint8** outMaxValidPtr) {
+    o_assert(this->isOpen);
+    o_assert(!this->isReadMapped);
+    o_assert(this->IsReadable());
+    o_assert((this->readPosition >= 0) && (this->readPosition <= this->size));
+
+    this->isReadMapped = true;
+    if (this->readPosition == this->size) {
+        if (nullptr != outMaxValidPtr) {
+            *outMaxValidPtr = nullptr;
+        }
+        return nullptr;
+    }
+    else {
+        if (nullptr != outMaxValidPtr) {
+            *outMaxValidPtr = this->data + this->size;
+        }
+        return this->data + this->readPosition;
+    }
+}
+
+} // namespace _priv
+} // namespace Oryol
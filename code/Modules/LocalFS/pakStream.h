@@ -0,0 +1,41 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::pakStream
+    @ingroup _priv
+    @brief private: read-only stream on an uncompressed range of a pak archive
+
+    The stream points directly into the memory-mapped archive and keeps
+    the archive alive, no data is copied and no file is opened.
+    @see PakFileSystem
+*/
+#include "IO/Stream/Stream.h"
+#include "LocalFS/PakArchive.h"
+
+namespace Oryol {
+namespace _priv {
+
+class pakStream : public Stream {
+    OryolClassDecl(pakStream);
+public:
+    /// constructor with archive, and data range inside the archive
+    pakStream(const Ptr<PakArchive>& archive, const uint8* data, int32 size);
+    /// destructor
+    virtual ~pakStream();
+
+    /// open the stream, only OpenMode::ReadOnly is supported
+    virtual bool Open(OpenMode::Enum mode) override;
+    /// release the archive
+    virtual void DiscardContent() override;
+    /// read a number of bytes from the stream (returns bytes read), numBytes can be EndOfStream
+    virtual int32 Read(void* ptr, int32 numBytes) override;
+    /// map a memory area at the current read-position, DOES NOT ADVANCE READ-POS!
+    virtual const uint8* MapRead(const uint8** outMaxValidPtr) override;
+
+private:
+    Ptr<PakArchive> archive;
+    const uint8* data;
+};
+
+} // namespace _priv
+} // namespace Oryol
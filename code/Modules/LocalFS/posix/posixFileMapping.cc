@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------
+//  posixFileMapping.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "posixFileMapping.h"
+#include "Core/Assertion.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <limits>
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+posixFileMapping::posixFileMapping() :
+mapAddr(nullptr),
+mapSize(0),
+data(nullptr),
+size(0),
+mapped(false) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+posixFileMapping::~posixFileMapping() {
+    if (this->mapped) {
+        this->Unmap();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ NOTE: the mapping is private and read-only, the returned data pointer
+ points directly into the page cache. The mapping stays valid even
+ after the file descriptor has been closed, so the descriptor is
+ closed right away.
+*/
+IOStatus::Code
+posixFileMapping::Map(const String& path, int32 startOffset, int32 endOffset) {
+    o_assert(!this->mapped);
+    o_assert((startOffset >= 0) && (endOffset >= 0));
+
+    int fd = ::open(path.AsCStr(), O_RDONLY);
+    if (-1 == fd) {
+        switch (errno) {
+            case ENOENT:
+            case ENOTDIR:
+                return IOStatus::NotFound;
+            case EACCES:
+            case EPERM:
+                return IOStatus::Forbidden;
+            default:
+                return IOStatus::InternalServerError;
+        }
+    }
+    struct stat st;
+    if ((-1 == ::fstat(fd, &st)) || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return IOStatus::NotFound;
+    }
+    const int64 fileSize = st.st_size;
+
+    // figure out the requested byte range
+    int64 rangeStart = startOffset;
+    int64 rangeEnd = (0 != endOffset) ? int64(endOffset) + 1 : fileSize;
+    if (rangeEnd > fileSize) {
+        rangeEnd = fileSize;
+    }
+    if ((rangeStart > rangeEnd) || ((rangeStart == fileSize) && (0 != rangeStart))) {
+        ::close(fd);
+        return IOStatus::RequestedRangeNotSatisfiable;
+    }
+    const int64 rangeSize = rangeEnd - rangeStart;
+    if (rangeSize > std::numeric_limits<int32>::max()) {
+        ::close(fd);
+        return IOStatus::RequestEntityTooLarge;
+    }
+    this->mapped = true;
+    this->size = int32(rangeSize);
+    if (0 == rangeSize) {
+        // can't mmap an empty range, return a valid but empty mapping
+        ::close(fd);
+        return IOStatus::OK;
+    }
+
+    // mmap offsets must be page-aligned
+    const int64 pageSize = ::sysconf(_SC_PAGESIZE);
+    const int64 mapStart = rangeStart & ~(pageSize - 1);
+    this->mapSize = size_t(rangeEnd - mapStart);
+    this->mapAddr = ::mmap(nullptr, this->mapSize, PROT_READ, MAP_PRIVATE, fd, off_t(mapStart));
+    ::close(fd);
+    if (MAP_FAILED == this->mapAddr) {
+        this->mapAddr = nullptr;
+        this->mapSize = 0;
+        this->size = 0;
+        this->mapped = false;
+        return IOStatus::InternalServerError;
+    }
+    // the data is usually consumed front-to-back right away
+    ::madvise(this->mapAddr, this->mapSize, MADV_WILLNEED);
+    this->data = ((const uint8*)this->mapAddr) + (rangeStart - mapStart);
+    return IOStatus::OK;
+}
+
+//------------------------------------------------------------------------------
+void
+posixFileMapping::Unmap() {
+    o_assert(this->mapped);
+    if (nullptr != this->mapAddr) {
+        ::munmap(this->mapAddr, this->mapSize);
+    }
+    this->mapAddr = nullptr;
+    this->mapSize = 0;
+    this->data = nullptr;
+    this->size = 0;
+    this->mapped = false;
+}
+
+//------------------------------------------------------------------------------
+bool
+posixFileMapping::IsMapped() const {
+    return this->mapped;
+}
+
+//------------------------------------------------------------------------------
+const uint8*
+posixFileMapping::Data() const {
+    return this->data;
+}
+
+//------------------------------------------------------------------------------
+int32
+posixFileMapping::Size() const {
+    return this->size;
+}
+
+} // namespace _priv
+} // namespace Oryol
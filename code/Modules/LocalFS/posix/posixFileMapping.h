@@ -0,0 +1,43 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::posixFileMapping
+    @ingroup _priv
+    @brief private: read-only memory mapping of a local file range via mmap
+    @see fileMapping, MappedStream
+*/
+#include "Core/Types.h"
+#include "Core/String/String.h"
+#include "IO/Core/IOStatus.h"
+
+namespace Oryol {
+namespace _priv {
+
+class posixFileMapping {
+public:
+    /// constructor
+    posixFileMapping();
+    /// destructor, unmaps the file
+    ~posixFileMapping();
+
+    /// map a file range (endOffset is inclusive, 0 means until end of file)
+    IOStatus::Code Map(const String& path, int32 startOffset, int32 endOffset);
+    /// unmap the file
+    void Unmap();
+    /// return true if a file range is currently mapped
+    bool IsMapped() const;
+    /// get pointer to start of the requested range
+    const uint8* Data() const;
+    /// get size of the requested range in bytes
+    int32 Size() const;
+
+private:
+    void* mapAddr;
+    size_t mapSize;
+    const uint8* data;
+    int32 size;
+    bool mapped;
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,313 @@
+//------------------------------------------------------------------------------
+//  LockFreeQueue.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "LockFreeQueue.h"
+#include "Core/Core.h"
+
+namespace Oryol {
+
+OryolClassPoolAllocImpl(LockFreeQueue);
+
+//------------------------------------------------------------------------------
+/**
+ NOTE: if the default constructor is used, a forwarding port must be
+ provided by the subclass in the onThreadEnter() method, or in the
+ subclasses constructor!
+*/
+LockFreeQueue::LockFreeQueue(int32 capacity) :
+tickDuration(0),
+spinCount(64),
+ringBuffer(capacity),
+workerSleeping(false),
+tickRequested(false),
+threadStopRequested(false),
+threadStarted(false),
+threadStopped(false) {
+    #if ORYOL_HAS_THREADS
+        this->createThreadId = std::this_thread::get_id();
+        this->workThreadIdValid = false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+LockFreeQueue::LockFreeQueue(const Ptr<Port>& port_, int32 capacity) :
+tickDuration(0),
+spinCount(64),
+ringBuffer(capacity),
+forwardingPort(port_),
+workerSleeping(false),
+tickRequested(false),
+threadStopRequested(false),
+threadStarted(false),
+threadStopped(false) {
+    #if ORYOL_HAS_THREADS
+        this->createThreadId = std::this_thread::get_id();
+        this->workThreadIdValid = false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+LockFreeQueue::~LockFreeQueue() {
+    o_assert(this->isCreateThread());
+    o_assert(this->threadStopped);
+}
+
+//------------------------------------------------------------------------------
+/**
+ See ThreadedQueue::SetTickDuration() for details.
+*/
+void
+LockFreeQueue::SetTickDuration(uint32 milliSec) {
+    o_assert(!this->threadStarted);
+    this->tickDuration = milliSec;
+}
+
+//------------------------------------------------------------------------------
+uint32
+LockFreeQueue::GetTickDuration() const {
+    return this->tickDuration;
+}
+
+//------------------------------------------------------------------------------
+/**
+ The worker thread polls the ring buffer this many times (yielding
+ in between) before it goes to sleep. Higher values reduce wakeup
+ latency for bursty traffic at the cost of burning CPU cycles.
+*/
+void
+LockFreeQueue::SetSpinCount(int32 numSpins) {
+    o_assert(!this->threadStarted);
+    o_assert(numSpins >= 0);
+    this->spinCount = numSpins;
+}
+
+//------------------------------------------------------------------------------
+int32
+LockFreeQueue::GetSpinCount() const {
+    return this->spinCount;
+}
+
+//------------------------------------------------------------------------------
+int32
+LockFreeQueue::GetNumQueuedMessages() const {
+    return this->ringBuffer.Size();
+}
+
+//------------------------------------------------------------------------------
+void
+LockFreeQueue::StartThread() {
+    o_assert(this->isCreateThread());
+    o_assert(!this->threadStarted);
+    #if ORYOL_HAS_THREADS
+        // the worker thread id is only known after the thread has
+        // started, publish it to the worker which waits for it
+        this->thread = std::thread(threadFunc, this);
+        this->workThreadId = this->thread.get_id();
+        this->workThreadIdValid.store(true, std::memory_order_release);
+    #else
+        this->onThreadEnter();
+    #endif
+    this->threadStarted = true;
+}
+
+//------------------------------------------------------------------------------
+void
+LockFreeQueue::StopThread() {
+    o_assert(this->threadStarted);
+    this->threadStopRequested = true;
+    #if ORYOL_HAS_THREADS
+        {
+            std::lock_guard<std::mutex> lock(this->wakeupMutex);
+            this->wakeup.notify_one();
+        }
+        this->thread.join();
+    #else
+        this->onThreadLeave();
+    #endif
+    this->threadStopped = true;
+}
+
+//------------------------------------------------------------------------------
+/**
+ NOTE: the memory fence between publishing the message and checking
+ the workerSleeping flag pairs with the fence in threadFunc(), this
+ guarantees that either the worker sees the new message, or we see
+ that the worker has gone to sleep.
+*/
+void
+LockFreeQueue::wakeupWorker() {
+    #if ORYOL_HAS_THREADS
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (this->workerSleeping.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(this->wakeupMutex);
+        this->wakeup.notify_one();
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+bool
+LockFreeQueue::Put(const Ptr<Message>& msg) {
+    o_assert_dbg(this->threadStarted);
+    o_assert_dbg(!this->threadStopped);
+    while (!this->ringBuffer.Enqueue(msg)) {
+        // ring buffer is full, give the worker thread a chance to catch up
+        #if ORYOL_HAS_THREADS
+            o_assert2(!this->isWorkerThread(), "LockFreeQueue::Put(): ring buffer full on worker thread!\n");
+            this->wakeupWorker();
+            std::this_thread::yield();
+        #else
+            this->processMessages();
+        #endif
+    }
+    this->wakeupWorker();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+LockFreeQueue::DoWork() {
+    o_assert(this->isCreateThread());
+    o_assert(this->threadStarted);
+    o_assert(!this->threadStopped);
+    #if ORYOL_HAS_THREADS
+        // messages are already visible to the worker thread, only
+        // make sure that it ticks at least once per DoWork
+        this->tickRequested = true;
+        this->wakeupWorker();
+    #else
+        // if no threads are available, pump the messages right here
+        this->processMessages();
+        this->onTick();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int32
+LockFreeQueue::processMessages() {
+    int32 numMessages = 0;
+    Ptr<Message> msg;
+    while (this->ringBuffer.Dequeue(msg)) {
+        this->onMessage(msg);
+        msg = nullptr;
+        numMessages++;
+    }
+    return numMessages;
+}
+
+//------------------------------------------------------------------------------
+bool
+LockFreeQueue::isCreateThread() {
+    #if ORYOL_HAS_THREADS
+        return std::this_thread::get_id() == this->createThreadId;
+    #else
+        return true;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+bool
+LockFreeQueue::isWorkerThread() {
+    #if ORYOL_HAS_THREADS
+    return std::this_thread::get_id() == this->workThreadId;
+    #else
+    return true;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+#if ORYOL_HAS_THREADS
+void
+LockFreeQueue::threadFunc(LockFreeQueue* self) {
+
+    // wait until StartThread() has set workThreadId
+    while (!self->workThreadIdValid.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    // notify subclass that thread has been entered
+    self->onThreadEnter();
+
+    int32 numEmptyPolls = 0;
+    while (!self->threadStopRequested) {
+        if ((self->processMessages() > 0) || self->tickRequested.exchange(false)) {
+            self->onTick();
+            numEmptyPolls = 0;
+        }
+        else if (numEmptyPolls++ < self->spinCount) {
+            std::this_thread::yield();
+        }
+        else {
+            // nothing to do, go to sleep until a producer wakes us up,
+            // or the tick duration has passed
+            numEmptyPolls = 0;
+            std::unique_lock<std::mutex> lock(self->wakeupMutex);
+            self->workerSleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (self->ringBuffer.Empty() && !self->tickRequested && !self->threadStopRequested) {
+                if (0 != self->tickDuration) {
+                    self->wakeup.wait_for(lock, std::chrono::milliseconds(self->tickDuration));
+                }
+                else {
+                    self->wakeup.wait(lock);
+                }
+            }
+            self->workerSleeping.store(false, std::memory_order_relaxed);
+            lock.unlock();
+
+            // always tick after waking up
+            self->tickRequested = false;
+            self->processMessages();
+            self->onTick();
+        }
+    }
+
+    // notify subclass that we're about to leave the thread
+    self->onThreadLeave();
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+ The default implementation of onThreadEnter() will call
+ Core::EnterThread() to setup any thread-locale data.
+*/
+void
+LockFreeQueue::onThreadEnter() {
+    Core::EnterThread();
+}
+
+//------------------------------------------------------------------------------
+/**
+ The default implementation of onMessage will invoke the Put() method
+ on the forwarding port with the message as argument.
+*/
+void
+LockFreeQueue::onMessage(const Ptr<Message>& msg) {
+    o_assert(this->forwardingPort.isValid());
+    this->forwardingPort->Put(msg);
+}
+
+//------------------------------------------------------------------------------
+/**
+ The default implementation of onTick() will invoke the DoWork() method
+ on the forwarding port.
+*/
+void
+LockFreeQueue::onTick() {
+    o_assert(this->forwardingPort.isValid());
+    this->forwardingPort->DoWork();
+}
+
+//------------------------------------------------------------------------------
+/**
+ The default implementation of onThreadLeave() will call
+ Core::LeaveThread() to discard any thread-locale data.
+*/
+void
+LockFreeQueue::onThreadLeave() {
+    Core::LeaveThread();
+}
+
+} // namespace Oryol
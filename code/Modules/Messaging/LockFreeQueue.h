@@ -0,0 +1,116 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::LockFreeQueue
+    @ingroup Messaging
+    @brief a threaded message queue port on top of a lock-free ring buffer
+
+    A message Port which forwards messages to a worker thread,
+    the forwarding port is running on the thread (same as ThreadedQueue).
+
+    Unlike ThreadedQueue, messages are not shuffled through a write-,
+    transfer- and read-queue. Put() moves the message straight into a
+    bounded multi-producer/multi-consumer ring buffer, where the worker
+    thread picks it up immediately. Put() may be called from any thread.
+
+    The worker thread spins for a short while when the ring buffer runs
+    empty, and then goes to sleep. Producers only touch the wakeup
+    mutex and condition variable when the worker is actually sleeping
+    (similar to a futex), so the common case doesn't involve any
+    system calls or locking.
+
+    If the ring buffer is full, Put() will yield until the worker
+    thread has made room.
+
+    DoWork() only wakes up the worker thread so that onTick() is called
+    at least once per frame (this is the same behaviour as in
+    ThreadedQueue, which allows to switch subclasses like ioLane between
+    the two).
+*/
+#include "Core/Config.h"
+#include "Messaging/Port.h"
+#include "Core/Threading/mpmcQueue.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+#include <atomic>
+
+namespace Oryol {
+
+class LockFreeQueue : public Port {
+    OryolClassPoolAllocDecl(LockFreeQueue);
+public:
+    /// default capacity of the ring buffer
+    static const int32 DefaultCapacity = 4096;
+
+    /// default constructor (must setup forwardingPort in subclass!)
+    LockFreeQueue(int32 capacity=DefaultCapacity);
+    /// constructor with forwarding port
+    LockFreeQueue(const Ptr<Port>& forwardingPort, int32 capacity=DefaultCapacity);
+    /// destructor
+    virtual ~LockFreeQueue();
+
+    /// set optional tick-duration in millsecs, thread will wake up even if no messages pending
+    void SetTickDuration(uint32 milliSecs);
+    /// get optional tick-rate in millisecs
+    uint32 GetTickDuration() const;
+    /// set number of empty polls before the worker thread goes to sleep
+    void SetSpinCount(int32 numSpins);
+    /// get number of empty polls before the worker thread goes to sleep
+    int32 GetSpinCount() const;
+    /// start the handler thread, this cannot happen in the constructor
+    virtual void StartThread();
+    /// stop the handler thread, this cannot happen in the destructor
+    virtual void StopThread();
+    /// put a message into the port (may be called from any thread)
+    virtual bool Put(const Ptr<Message>& msg) override;
+    /// perform work, this will be invoked on downstream ports
+    virtual void DoWork() override;
+    /// get the number of messages currently in the ring buffer (approximate)
+    int32 GetNumQueuedMessages() const;
+
+protected:
+    /// the thread entry function
+    #if ORYOL_HAS_THREADS
+    static void threadFunc(LockFreeQueue* self);
+    #endif
+    /// test if we are on the creation-thread
+    bool isCreateThread();
+    /// test if we are on the worker-thread
+    bool isWorkerThread();
+    /// called in thread on thread-entry
+    virtual void onThreadEnter();
+    /// called to forward one message
+    virtual void onMessage(const Ptr<Message>& msg);
+    /// called after messages are processed, and on each tick (if a TickDuration is set)
+    virtual void onTick();
+    /// called in thread before thread is left
+    virtual void onThreadLeave();
+    /// pop and forward all messages in the ring buffer, return number of messages
+    int32 processMessages();
+    /// wake up the worker thread if it is sleeping
+    void wakeupWorker();
+
+    uint32 tickDuration;
+    int32 spinCount;
+    _priv::mpmcQueue<Ptr<Message>> ringBuffer;
+    Ptr<Port> forwardingPort;                 // runs in thread!
+    std::atomic<bool> workerSleeping;
+    std::atomic<bool> tickRequested;
+
+    #if ORYOL_HAS_THREADS
+    std::thread::id createThreadId;
+    std::thread::id workThreadId;
+    std::atomic<bool> workThreadIdValid;    // published by StartThread(), worker waits for it
+    std::thread thread;
+    std::mutex wakeupMutex;
+    std::condition_variable wakeup;
+    #endif
+    std::atomic<bool> threadStopRequested;
+    bool threadStarted;
+    bool threadStopped;
+};
+
+} // namespace Oryol
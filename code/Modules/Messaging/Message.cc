@@ -3,6 +3,7 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "Message.h"
+#include "Messaging/Serializer.h"
 
 namespace Oryol {
     
@@ -22,7 +23,28 @@ Message::IsMemberOf(ProtocolIdType protId) const {
 //------------------------------------------------------------------------------
 void
 Message::SetHandled() {
+    // only the first SetHandled() pushes to the completion list
+    #if ORYOL_HAS_ATOMIC
+    const bool wasHandled = this->handled.exchange(true);
+    #else
+    const bool wasHandled = this->handled;
     this->handled = true;
+    #endif
+    if (!wasHandled && this->completionList) {
+        this->completionList->Push(this->completionTag);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Must be called before the message is sent off, and not changed
+ while the message is in flight.
+*/
+void
+Message::SetCompletionList(const Ptr<CompletionList>& list, uint64 tag) {
+    o_assert_dbg(!this->handled);
+    this->completionList = list;
+    this->completionTag = tag;
 }
 
 //------------------------------------------------------------------------------
@@ -52,21 +74,25 @@ Message::Cancelled() const {
 //------------------------------------------------------------------------------
 int32
 Message::EncodedSize() const {
-    /// @todo: this should include some sort of header information
-    return 0;
+    // the message id header
+    return sizeof(MessageIdType);
 }
 
 //------------------------------------------------------------------------------
 uint8*
 Message::Encode(uint8* dstPtr, const uint8* maxValidPtr) const {
-    // @todo: this should write a header with the MessageId
-    return dstPtr;
+    return Serializer::Encode<MessageIdType>(this->msgId, dstPtr, maxValidPtr);
 }
 
 //------------------------------------------------------------------------------
 const uint8*
 Message::Decode(const uint8* srcPtr, const uint8* maxValidPtr) {
-    /// @todo: this should decode the header
+    // the message id header must match the message object
+    MessageIdType id = InvalidMessageId;
+    srcPtr = Serializer::Decode<MessageIdType>(srcPtr, maxValidPtr, id);
+    if (id != this->msgId) {
+        return nullptr;
+    }
     return srcPtr;
 }
     
@@ -7,6 +7,7 @@
 */
 #include "Core/Config.h"
 #include "Core/RefCounted.h"
+#include "Core/Threading/CompletionList.h"
 #include "Messaging/Types.h"
 
 namespace Oryol {
@@ -26,8 +27,10 @@ public:
     static MessageIdType ClassMessageId();
     /// get the object message id
     MessageIdType MessageId() const;
-    /// set message to Handled state
+    /// set message to Handled state (pushes the completion tag if a CompletionList is set)
     void SetHandled();
+    /// set a CompletionList which receives the tag when the message is handled
+    void SetCompletionList(const Ptr<CompletionList>& list, uint64 tag);
     /// cancel the message
     void SetCancelled();
     /// return true if the message is in Pending state
@@ -37,11 +40,11 @@ public:
     /// return true if the message is in cancelled state
     bool Cancelled() const;
     
-    /// get the encoded size of the message
+    /// get the encoded size of the message (including the message id header)
     virtual int32 EncodedSize() const;
     /// encode the message to raw memory, maxBytes must be at least EncodedSize()
     virtual uint8* Encode(uint8* dstPtr, const uint8* maxValidPtr) const;
-    /// decode the message from raw memory
+    /// decode the message from raw memory, returns nullptr on error
     virtual const uint8* Decode(const uint8* srcPtr, const uint8* maxValidPtr);
 
 protected:
@@ -53,13 +56,16 @@ protected:
     bool handled;
     bool cancelled;
     #endif
+    Ptr<CompletionList> completionList;
+    uint64 completionTag;
 };
 
 //------------------------------------------------------------------------------
 inline Message::Message() :
 msgId(InvalidMessageId),
 handled(false),
-cancelled(false) {
+cancelled(false),
+completionTag(0) {
     // empty
 }
 
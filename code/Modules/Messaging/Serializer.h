@@ -8,9 +8,31 @@
     This is a simple template class which knows how to 
     encode/decode a specific data type (the template arg) to and from
     a plain-old-data memory region.
+
+    Arrays of POD values are encoded and decoded with a single memcpy.
+    Aligned arrays (EncodeAlignedArray) additionally place the elements
+    at their natural alignment in the destination buffer:
+
+        int32 numElements
+        uint8 padding
+        uint8 pad[padding]
+        TYPE elements[numElements]
+        uint8 tail[alignof(TYPE) - 1 - padding]
+
+    The encoded size doesn't depend on the buffer address. If the
+    encoded data ends up at the same alignment on the receiving side
+    (e.g. a whole buffer received into or loaded to an aligned buffer),
+    DecodeArrayView() returns the elements as a view into the source
+    buffer without copying. DecodeStringView() does the same for
+    String and StringAtom data. Views are only valid as long as the
+    source buffer.
 */
 #include <string.h>
+#include <type_traits>
 #include "Core/Types.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Containers/Array.h"
 #include "Core/String/String.h"
 #include "Core/String/StringAtom.h"
 
@@ -18,6 +40,27 @@ namespace Oryol {
     
 class Serializer {
 public:
+    /// a read-only view of encoded elements in a source buffer
+    template<typename TYPE> struct ArrayView {
+        /// pointer to first element
+        const TYPE* Data = nullptr;
+        /// number of elements
+        int32 Size = 0;
+        /// read-only access single element
+        const TYPE& operator[](int32 index) const {
+            o_assert_dbg((index >= 0) && (index < this->Size));
+            return this->Data[index];
+        };
+        /// C++ conform begin
+        const TYPE* begin() const {
+            return this->Data;
+        };
+        /// C++ conform end
+        const TYPE* end() const {
+            return this->Data + this->Size;
+        };
+    };
+
     /// return the encoded size of the provided value
     template<typename TYPE> static int32 EncodedSize(const TYPE& val);
     /// encode to plain-old-data representation, return pointer to next pos, or nullptr if not enough space
@@ -30,6 +73,30 @@ public:
     template<typename TYPE> static uint8* EncodeArray(const Array<TYPE>& vals, uint8* dstPtr, const uint8* maxPtr);
     /// decode an array of values
     template<typename TYPE> static const uint8* DecodeArray(const uint8* srcPtr, const uint8* maxPtr, Array<TYPE>& outVals);
+
+    /// decode an encoded String or StringAtom as view (not null-terminated)
+    static const uint8* DecodeStringView(const uint8* srcPtr, const uint8* maxPtr, ArrayView<char>& outView);
+    /// return the encoded size for an aligned array of POD values
+    template<typename TYPE> static int32 EncodedAlignedArraySize(const Array<TYPE>& vals);
+    /// encode an array of POD values with the elements at their natural alignment
+    template<typename TYPE> static uint8* EncodeAlignedArray(const Array<TYPE>& vals, uint8* dstPtr, const uint8* maxPtr);
+    /// decode an aligned array of POD values into an array
+    template<typename TYPE> static const uint8* DecodeAlignedArray(const uint8* srcPtr, const uint8* maxPtr, Array<TYPE>& outVals);
+    /// decode an aligned array of POD values as view, returns nullptr if the elements are misaligned in the source buffer
+    template<typename TYPE> static const uint8* DecodeArrayView(const uint8* srcPtr, const uint8* maxPtr, ArrayView<TYPE>& outView);
+
+private:
+    /// encoded array size, bulk or element-wise
+    template<typename TYPE> static int32 encodedArraySize(const Array<TYPE>& vals, std::true_type isPod);
+    template<typename TYPE> static int32 encodedArraySize(const Array<TYPE>& vals, std::false_type isPod);
+    /// encode array elements, bulk or element-wise
+    template<typename TYPE> static uint8* encodeElements(const Array<TYPE>& vals, uint8* dstPtr, const uint8* maxPtr, std::true_type isPod);
+    template<typename TYPE> static uint8* encodeElements(const Array<TYPE>& vals, uint8* dstPtr, const uint8* maxPtr, std::false_type isPod);
+    /// decode array elements, bulk or element-wise
+    template<typename TYPE> static const uint8* decodeElements(const uint8* srcPtr, const uint8* maxPtr, int32 num, Array<TYPE>& outVals, std::true_type isPod);
+    template<typename TYPE> static const uint8* decodeElements(const uint8* srcPtr, const uint8* maxPtr, int32 num, Array<TYPE>& outVals, std::false_type isPod);
+    /// decode the header of an aligned array, returns end of encoded array, or nullptr
+    static const uint8* decodeAlignedHeader(const uint8* srcPtr, const uint8* maxPtr, int32 elmSize, int32 elmAlign, int32& outNum, const uint8*& outElmPtr);
 };
 
 //------------------------------------------------------------------------------
@@ -43,7 +110,7 @@ Serializer::EncodedSize(const TYPE& val) {
 template<typename TYPE> inline uint8*
 Serializer::Encode(const TYPE& val, uint8* dstPtr, const uint8* maxPtr) {
     static_assert(std::is_pod<TYPE>::value, "Serializer::Encode(): Type not POD, must provide specialization!");
-    if ((dstPtr + sizeof(TYPE)) <= maxPtr) {
+    if ((nullptr != dstPtr) && ((dstPtr + sizeof(TYPE)) <= maxPtr)) {
         // must copy byte-wise because of alignment restrictions
         // hopefully this will be an intrinsic
         memcpy(dstPtr, &val, sizeof(TYPE));
@@ -59,7 +126,7 @@ Serializer::Encode(const TYPE& val, uint8* dstPtr, const uint8* maxPtr) {
 template<typename TYPE> inline const uint8*
 Serializer::Decode(const uint8* srcPtr, const uint8* maxPtr, TYPE& outVal) {
     static_assert(std::is_pod<TYPE>::value, "Serializer::Encode(): Type not POD, must provide specialization!");
-    if ((srcPtr + sizeof(TYPE)) <= maxPtr) {
+    if ((nullptr != srcPtr) && ((srcPtr + sizeof(TYPE)) <= maxPtr)) {
         // must copy byte-wise because of alignment restrictions
         // hopefully this will be an intrinsic
         memcpy(&outVal, srcPtr, sizeof(TYPE));
@@ -80,7 +147,7 @@ Serializer::EncodedSize(const String& val) {
 //------------------------------------------------------------------------------
 template<> inline uint8*
 Serializer::Encode(const String& val, uint8* dstPtr, const uint8* maxPtr) {
-    if ((dstPtr + EncodedSize(val)) <= maxPtr) {
+    if ((nullptr != dstPtr) && ((dstPtr + EncodedSize(val)) <= maxPtr)) {
         const int32 len = val.Length();
         dstPtr = Serializer::Encode<int32>(len, dstPtr, maxPtr);
         o_assert(nullptr != dstPtr);
@@ -96,14 +163,19 @@ Serializer::Encode(const String& val, uint8* dstPtr, const uint8* maxPtr) {
 //------------------------------------------------------------------------------
 template<> inline const uint8*
 Serializer::Decode(const uint8* srcPtr, const uint8* maxPtr, String& outVal) {
-    if ((srcPtr + sizeof(int32)) <= maxPtr) {
+    if ((nullptr != srcPtr) && ((srcPtr + sizeof(int32)) <= maxPtr)) {
         // read length
         int32 len = 0;
         srcPtr = Serializer::Decode<int32>(srcPtr, maxPtr, len);
         o_assert(nullptr != srcPtr);
-        if ((srcPtr + len) <= maxPtr) {
+        if ((len >= 0) && ((srcPtr + len) <= maxPtr)) {
             // read and assign string data
-            outVal.Assign((const char*)srcPtr, 0, len);
+            if (len > 0) {
+                outVal.Assign((const char*)srcPtr, 0, len);
+            }
+            else {
+                outVal.Clear();
+            }
             return srcPtr + len;
         }
     }
@@ -120,7 +192,7 @@ Serializer::EncodedSize(const StringAtom& val) {
 //------------------------------------------------------------------------------
 template<> inline uint8*
 Serializer::Encode(const StringAtom& val, uint8* dstPtr, const uint8* maxPtr) {
-    if ((dstPtr + EncodedSize(val)) <= maxPtr) {
+    if ((nullptr != dstPtr) && ((dstPtr + EncodedSize(val)) <= maxPtr)) {
         const int32 len = val.Length();
         dstPtr = Serializer::Encode<int32>(len, dstPtr, maxPtr);
         o_assert(nullptr != dstPtr);
@@ -136,15 +208,13 @@ Serializer::Encode(const StringAtom& val, uint8* dstPtr, const uint8* maxPtr) {
 //------------------------------------------------------------------------------
 template<> inline const uint8*
 Serializer::Decode(const uint8* srcPtr, const uint8* maxPtr, StringAtom& outVal) {
-    if ((srcPtr + sizeof(int32)) <= maxPtr) {
+    if ((nullptr != srcPtr) && ((srcPtr + sizeof(int32)) <= maxPtr)) {
         // read length
         int32 len = 0;
         srcPtr = Serializer::Decode<int32>(srcPtr, maxPtr, len);
         o_assert(nullptr != srcPtr);
-        if ((srcPtr + len) <= maxPtr) {
-            /// @todo: meh, must create temp string
-            String str((const char*) srcPtr, 0, len);
-            outVal = str;
+        if ((len >= 0) && ((srcPtr + len) <= maxPtr)) {
+            outVal = StringAtom((const char*) srcPtr, len);
             return srcPtr + len;
         }
     }
@@ -155,31 +225,36 @@ Serializer::Decode(const uint8* srcPtr, const uint8* maxPtr, StringAtom& outVal)
 //------------------------------------------------------------------------------
 template<typename TYPE> inline int32
 Serializer::EncodedArraySize(const Array<TYPE>& vals) {
-    if (vals.Size() > 0) {
-        int32 size = sizeof(int32);
-        for (const TYPE& val : vals) {
-            size += Serializer::EncodedSize<TYPE>(val);
-        }
-        return size;
-    }
-    else {
-        // if the array is empty, we still need to write the number of elements
-        // (which is 0)
-        return sizeof(int32);
+    return encodedArraySize(vals, std::integral_constant<bool, std::is_pod<TYPE>::value>());
+}
+
+//------------------------------------------------------------------------------
+template<typename TYPE> inline int32
+Serializer::encodedArraySize(const Array<TYPE>& vals, std::true_type /*isPod*/) {
+    // number of elements followed by the elements
+    return sizeof(int32) + vals.Size() * sizeof(TYPE);
+}
+
+//------------------------------------------------------------------------------
+template<typename TYPE> inline int32
+Serializer::encodedArraySize(const Array<TYPE>& vals, std::false_type /*isPod*/) {
+    // if the array is empty, we still need to write the number of elements
+    // (which is 0)
+    int32 size = sizeof(int32);
+    for (const TYPE& val : vals) {
+        size += Serializer::EncodedSize<TYPE>(val);
     }
+    return size;
 }
     
 //------------------------------------------------------------------------------
 template<typename TYPE> inline uint8*
 Serializer::EncodeArray(const Array<TYPE>& vals, uint8* dstPtr, const uint8* maxPtr) {
-    if ((dstPtr + EncodedArraySize<TYPE>(vals)) <= maxPtr) {
+    if ((nullptr != dstPtr) && ((dstPtr + EncodedArraySize<TYPE>(vals)) <= maxPtr)) {
         const int32 numElements = vals.Size();
         dstPtr = Serializer::Encode<int32>(numElements, dstPtr, maxPtr);
         if (numElements > 0) {
-            for (const TYPE& val : vals) {
-                dstPtr = Serializer::Encode<TYPE>(val, dstPtr, maxPtr);
-                o_assert(nullptr != dstPtr);
-            }
+            dstPtr = encodeElements(vals, dstPtr, maxPtr, std::integral_constant<bool, std::is_pod<TYPE>::value>());
         }
         // success
         return dstPtr;
@@ -187,33 +262,175 @@ Serializer::EncodeArray(const Array<TYPE>& vals, uint8* dstPtr, const uint8* max
     // fallthrough: not enough space
     return nullptr;
 }
+
+//------------------------------------------------------------------------------
+template<typename TYPE> inline uint8*
+Serializer::encodeElements(const Array<TYPE>& vals, uint8* dstPtr, const uint8* maxPtr, std::true_type /*isPod*/) {
+    const int32 numBytes = vals.Size() * sizeof(TYPE);
+    memcpy(dstPtr, &vals.Front(), numBytes);
+    return dstPtr + numBytes;
+}
+
+//------------------------------------------------------------------------------
+template<typename TYPE> inline uint8*
+Serializer::encodeElements(const Array<TYPE>& vals, uint8* dstPtr, const uint8* maxPtr, std::false_type /*isPod*/) {
+    for (const TYPE& val : vals) {
+        dstPtr = Serializer::Encode<TYPE>(val, dstPtr, maxPtr);
+        o_assert(nullptr != dstPtr);
+    }
+    return dstPtr;
+}
     
 //------------------------------------------------------------------------------
 template<typename TYPE> inline const uint8*
 Serializer::DecodeArray(const uint8* srcPtr, const uint8* maxPtr, Array<TYPE>& outVals) {
     o_assert(outVals.Size() == 0);
-    if ((srcPtr + sizeof(int32)) < maxPtr) {
+    if ((nullptr != srcPtr) && ((srcPtr + sizeof(int32)) <= maxPtr)) {
         // read number of elements
         int32 numElements = 0;
         srcPtr = Serializer::Decode<int32>(srcPtr, maxPtr, numElements);
+        if ((numElements < 0) || (numElements > (maxPtr - srcPtr))) {
+            // each element takes at least one byte
+            return nullptr;
+        }
         if (numElements > 0) {
-            outVals.Reserve(numElements);
-            for (int32 i = 0; i < numElements; i++) {
-                TYPE val;
-                srcPtr = Serializer::Decode<TYPE>(srcPtr, maxPtr, val);
-                if (nullptr == srcPtr) {
-                    // not enough data
-                    outVals.Clear();
-                    return nullptr;
-                }
-                outVals.Add(val);
-            }
+            srcPtr = decodeElements(srcPtr, maxPtr, numElements, outVals, std::integral_constant<bool, std::is_pod<TYPE>::value>());
         }
-        // success
         return srcPtr;
     }
     // fallthrough not enough data
     return nullptr;
 }
 
+//------------------------------------------------------------------------------
+template<typename TYPE> inline const uint8*
+Serializer::decodeElements(const uint8* srcPtr, const uint8* maxPtr, int32 num, Array<TYPE>& outVals, std::true_type /*isPod*/) {
+    const size_t numBytes = size_t(num) * sizeof(TYPE);
+    if (numBytes > size_t(maxPtr - srcPtr)) {
+        // not enough data
+        return nullptr;
+    }
+    outVals.AddRange((const TYPE*) srcPtr, num);
+    return srcPtr + numBytes;
+}
+
+//------------------------------------------------------------------------------
+template<typename TYPE> inline const uint8*
+Serializer::decodeElements(const uint8* srcPtr, const uint8* maxPtr, int32 num, Array<TYPE>& outVals, std::false_type /*isPod*/) {
+    outVals.Reserve(num);
+    for (int32 i = 0; i < num; i++) {
+        TYPE val;
+        srcPtr = Serializer::Decode<TYPE>(srcPtr, maxPtr, val);
+        if (nullptr == srcPtr) {
+            // not enough data
+            outVals.Clear();
+            return nullptr;
+        }
+        outVals.Add(val);
+    }
+    return srcPtr;
+}
+
+//------------------------------------------------------------------------------
+inline const uint8*
+Serializer::DecodeStringView(const uint8* srcPtr, const uint8* maxPtr, ArrayView<char>& outView) {
+    if ((nullptr != srcPtr) && ((srcPtr + sizeof(int32)) <= maxPtr)) {
+        int32 len = 0;
+        srcPtr = Serializer::Decode<int32>(srcPtr, maxPtr, len);
+        if ((len >= 0) && ((srcPtr + len) <= maxPtr)) {
+            outView.Data = (const char*) srcPtr;
+            outView.Size = len;
+            return srcPtr + len;
+        }
+    }
+    // fallthrough: not enough data
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<typename TYPE> inline int32
+Serializer::EncodedAlignedArraySize(const Array<TYPE>& vals) {
+    static_assert(std::is_pod<TYPE>::value, "Serializer::EncodedAlignedArraySize(): Type not POD!");
+    // number of elements, padding byte, worst-case padding, elements
+    return sizeof(int32) + 1 + (std::alignment_of<TYPE>::value - 1) + vals.Size() * sizeof(TYPE);
+}
+
+//------------------------------------------------------------------------------
+template<typename TYPE> inline uint8*
+Serializer::EncodeAlignedArray(const Array<TYPE>& vals, uint8* dstPtr, const uint8* maxPtr) {
+    static_assert(std::is_pod<TYPE>::value, "Serializer::EncodeAlignedArray(): Type not POD!");
+    static_assert(std::alignment_of<TYPE>::value <= 128, "Serializer::EncodeAlignedArray(): alignment too big!");
+    if ((nullptr != dstPtr) && ((dstPtr + EncodedAlignedArraySize<TYPE>(vals)) <= maxPtr)) {
+        const int32 align = std::alignment_of<TYPE>::value;
+        const int32 numElements = vals.Size();
+        dstPtr = Serializer::Encode<int32>(numElements, dstPtr, maxPtr);
+        uint8* elmPtr = (uint8*) Memory::Align(dstPtr + 1, align);
+        const int32 padding = int32(elmPtr - (dstPtr + 1));
+        // padding bytes are cleared so that the encoded data is deterministic
+        *dstPtr = uint8(padding);
+        memset(dstPtr + 1, 0, padding);
+        const int32 numBytes = numElements * sizeof(TYPE);
+        if (numElements > 0) {
+            memcpy(elmPtr, &vals.Front(), numBytes);
+        }
+        uint8* tailPtr = elmPtr + numBytes;
+        const int32 tail = (align - 1) - padding;
+        memset(tailPtr, 0, tail);
+        return tailPtr + tail;
+    }
+    // fallthrough: not enough space
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+inline const uint8*
+Serializer::decodeAlignedHeader(const uint8* srcPtr, const uint8* maxPtr, int32 elmSize, int32 elmAlign, int32& outNum, const uint8*& outElmPtr) {
+    if ((nullptr != srcPtr) && ((srcPtr + sizeof(int32) + elmAlign) <= maxPtr)) {
+        int32 numElements = 0;
+        srcPtr = Serializer::Decode<int32>(srcPtr, maxPtr, numElements);
+        const int32 padding = *srcPtr;
+        if ((numElements >= 0) && (padding < elmAlign)) {
+            // srcPtr + elmAlign is the start of the elements in the worst case
+            const size_t numBytes = size_t(numElements) * elmSize;
+            if (numBytes <= size_t(maxPtr - (srcPtr + elmAlign))) {
+                outNum = numElements;
+                outElmPtr = srcPtr + 1 + padding;
+                return srcPtr + elmAlign + numBytes;
+            }
+        }
+    }
+    // fallthrough: not enough data, or invalid header
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<typename TYPE> inline const uint8*
+Serializer::DecodeAlignedArray(const uint8* srcPtr, const uint8* maxPtr, Array<TYPE>& outVals) {
+    static_assert(std::is_pod<TYPE>::value, "Serializer::DecodeAlignedArray(): Type not POD!");
+    o_assert(outVals.Size() == 0);
+    int32 numElements = 0;
+    const uint8* elmPtr = nullptr;
+    const uint8* endPtr = decodeAlignedHeader(srcPtr, maxPtr, sizeof(TYPE), std::alignment_of<TYPE>::value, numElements, elmPtr);
+    if (nullptr != endPtr) {
+        outVals.AddRange((const TYPE*) elmPtr, numElements);
+    }
+    return endPtr;
+}
+
+//------------------------------------------------------------------------------
+template<typename TYPE> inline const uint8*
+Serializer::DecodeArrayView(const uint8* srcPtr, const uint8* maxPtr, ArrayView<TYPE>& outView) {
+    static_assert(std::is_pod<TYPE>::value, "Serializer::DecodeArrayView(): Type not POD!");
+    int32 numElements = 0;
+    const uint8* elmPtr = nullptr;
+    const uint8* endPtr = decodeAlignedHeader(srcPtr, maxPtr, sizeof(TYPE), std::alignment_of<TYPE>::value, numElements, elmPtr);
+    if ((nullptr != endPtr) && (elmPtr == Memory::Align((void*)elmPtr, std::alignment_of<TYPE>::value))) {
+        outView.Data = (const TYPE*) elmPtr;
+        outView.Size = numElements;
+        return endPtr;
+    }
+    // not enough data, or the elements are misaligned in this buffer
+    return nullptr;
+}
+
 } // namespace Oryol
\ No newline at end of file
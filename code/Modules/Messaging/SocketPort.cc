@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+//  SocketPort.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "SocketPort.h"
+#include "Core/Assertion.h"
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#if !defined(MSG_NOSIGNAL)
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace Oryol {
+
+OryolClassImpl(SocketPort);
+
+//------------------------------------------------------------------------------
+SocketPort::SocketPort(int socketFd, CreateFunc createFunc, const Ptr<Port>& forwardingPort) :
+StreamPort(socketFd, socketFd, createFunc, forwardingPort) {
+    #if defined(SO_NOSIGPIPE)
+    int noSigPipe = 1;
+    ::setsockopt(socketFd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+SocketPort::CreatePair(CreateFunc createFunc,
+                       const Ptr<Port>& forwardingPortA,
+                       const Ptr<Port>& forwardingPortB,
+                       Ptr<SocketPort>& outPortA,
+                       Ptr<SocketPort>& outPortB) {
+    int fds[2] = { -1, -1 };
+    const int res = ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+    o_assert2(0 == res, "socketpair() failed\n");
+    outPortA = SocketPort::Create(fds[0], createFunc, forwardingPortA);
+    outPortB = SocketPort::Create(fds[1], createFunc, forwardingPortB);
+}
+
+//------------------------------------------------------------------------------
+int32
+SocketPort::writeBytes(const uint8* ptr, int32 numBytes) {
+    ssize_t res;
+    do {
+        res = ::send(this->writeFd, ptr, numBytes, MSG_NOSIGNAL);
+    }
+    while ((res < 0) && (EINTR == errno));
+    if (res >= 0) {
+        return int32(res);
+    }
+    return ((EAGAIN == errno) || (EWOULDBLOCK == errno)) ? 0 : -1;
+}
+
+//------------------------------------------------------------------------------
+int32
+SocketPort::readBytes(uint8* ptr, int32 numBytes) {
+    ssize_t res;
+    do {
+        res = ::recv(this->readFd, ptr, numBytes, 0);
+    }
+    while ((res < 0) && (EINTR == errno));
+    if (res > 0) {
+        return int32(res);
+    }
+    else if (0 == res) {
+        // other side has closed the connection
+        return -1;
+    }
+    return ((EAGAIN == errno) || (EWOULDBLOCK == errno)) ? 0 : -1;
+}
+
+} // namespace Oryol
@@ -0,0 +1,41 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::SocketPort
+    @ingroup Messaging
+    @brief a StreamPort over a connected stream socket
+
+    Sends and receives messages through a connected SOCK_STREAM socket
+    (TCP or Unix domain). Writing to a socket whose other side has been
+    closed doesn't raise SIGPIPE, the SocketPort simply becomes
+    disconnected.
+
+    CreatePair() creates two SocketPorts connected to each other
+    through socketpair(), this is useful to communicate with a forked
+    child process, and for testing.
+*/
+#include "Messaging/StreamPort.h"
+
+namespace Oryol {
+
+class SocketPort : public StreamPort {
+    OryolClassDecl(SocketPort);
+public:
+    /// constructor with connected socket, takes ownership of the socket
+    SocketPort(int socketFd, CreateFunc createFunc, const Ptr<Port>& forwardingPort);
+
+    /// create 2 connected socket ports through socketpair()
+    static void CreatePair(CreateFunc createFunc,
+                           const Ptr<Port>& forwardingPortA,
+                           const Ptr<Port>& forwardingPortB,
+                           Ptr<SocketPort>& outPortA,
+                           Ptr<SocketPort>& outPortB);
+
+protected:
+    /// send without raising SIGPIPE
+    virtual int32 writeBytes(const uint8* ptr, int32 numBytes) override;
+    /// receive available bytes
+    virtual int32 readBytes(uint8* ptr, int32 numBytes) override;
+};
+
+} // namespace Oryol
@@ -0,0 +1,275 @@
+//------------------------------------------------------------------------------
+//  StreamPort.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "StreamPort.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Log.h"
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace Oryol {
+
+OryolClassImpl(StreamPort);
+
+//------------------------------------------------------------------------------
+void
+StreamPort::buffer::reserve(int32 numBytes) {
+    if ((this->end + numBytes) <= this->capacity) {
+        return;
+    }
+    // first move the unconsumed data to the front
+    if (this->start > 0) {
+        const int32 size = this->end - this->start;
+        if (size > 0) {
+            std::memmove(this->data, this->data + this->start, size);
+        }
+        this->start = 0;
+        this->end = size;
+    }
+    if ((this->end + numBytes) > this->capacity) {
+        int32 newCapacity = this->capacity > 0 ? this->capacity * 2 : 64 * 1024;
+        while (newCapacity < (this->end + numBytes)) {
+            newCapacity *= 2;
+        }
+        this->data = (uint8*) Memory::ReAlloc(this->data, newCapacity);
+        this->capacity = newCapacity;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+StreamPort::buffer::free() {
+    if (this->data) {
+        Memory::Free(this->data);
+    }
+    this->data = nullptr;
+    this->start = this->end = this->capacity = 0;
+}
+
+//------------------------------------------------------------------------------
+StreamPort::StreamPort(int readFd_, int writeFd_, CreateFunc createFunc_, const Ptr<Port>& forwardingPort_) :
+readFd(readFd_),
+writeFd(writeFd_),
+createFunc(createFunc_),
+forwardingPort(forwardingPort_) {
+    o_assert(readFd_ >= 0);
+    o_assert(writeFd_ >= 0);
+    o_assert(nullptr != createFunc_);
+    o_assert(forwardingPort_);
+    ::fcntl(this->readFd, F_SETFL, ::fcntl(this->readFd, F_GETFL) | O_NONBLOCK);
+    if (this->writeFd != this->readFd) {
+        ::fcntl(this->writeFd, F_SETFL, ::fcntl(this->writeFd, F_GETFL) | O_NONBLOCK);
+    }
+}
+
+//------------------------------------------------------------------------------
+StreamPort::~StreamPort() {
+    this->Close();
+    this->sendBuffer.free();
+    this->recvBuffer.free();
+}
+
+//------------------------------------------------------------------------------
+void
+StreamPort::Close() {
+    if (this->readFd >= 0) {
+        ::close(this->readFd);
+        if (this->writeFd != this->readFd) {
+            ::close(this->writeFd);
+        }
+        this->readFd = -1;
+        this->writeFd = -1;
+    }
+    this->sendQueue.Clear();
+    this->sendBuffer.start = this->sendBuffer.end = 0;
+    this->recvBuffer.start = this->recvBuffer.end = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+StreamPort::onError(const char* what) {
+    o_warn("StreamPort: %s, closing stream\n", what);
+    this->Close();
+}
+
+//------------------------------------------------------------------------------
+bool
+StreamPort::Put(const Ptr<Message>& msg) {
+    if (!this->IsConnected()) {
+        return false;
+    }
+    this->sendQueue.Enqueue(msg);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+StreamPort::DoWork() {
+    if (this->IsConnected()) {
+        this->encodeMessages();
+        this->send();
+    }
+    if (this->IsConnected()) {
+        this->receive();
+        this->decodeFrames();
+    }
+    this->forwardingPort->DoWork();
+}
+
+//------------------------------------------------------------------------------
+int32
+StreamPort::GetNumQueuedMessages() const {
+    return this->sendQueue.Size();
+}
+
+//------------------------------------------------------------------------------
+int32
+StreamPort::GetNumPendingSendBytes() const {
+    return this->sendBuffer.end - this->sendBuffer.start;
+}
+
+//------------------------------------------------------------------------------
+void
+StreamPort::encodeMessages() {
+    while (!this->sendQueue.Empty()) {
+        Ptr<Message> msg = this->sendQueue.Dequeue();
+        const int32 msgSize = msg->EncodedSize();
+        if (msgSize > MaxFrameSize) {
+            // the receiver would treat the frame as a protocol error
+            o_warn("StreamPort: message '%d' too big (%d bytes), dropped\n", msg->MessageId(), msgSize);
+            continue;
+        }
+        this->sendBuffer.reserve(sizeof(uint32) + msgSize);
+        uint8* framePtr = this->sendBuffer.data + this->sendBuffer.end;
+        const uint32 frameSize = msgSize;
+        std::memcpy(framePtr, &frameSize, sizeof(frameSize));
+        uint8* msgPtr = framePtr + sizeof(frameSize);
+        const uint8* endPtr = msg->Encode(msgPtr, msgPtr + msgSize);
+        if (endPtr != (msgPtr + msgSize)) {
+            o_warn("StreamPort: failed to encode message '%d', dropped\n", msg->MessageId());
+            continue;
+        }
+        this->sendBuffer.end += sizeof(frameSize) + msgSize;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+StreamPort::send() {
+    buffer& buf = this->sendBuffer;
+    while (buf.start < buf.end) {
+        const int32 written = this->writeBytes(buf.data + buf.start, buf.end - buf.start);
+        if (written > 0) {
+            buf.start += written;
+        }
+        else if (0 == written) {
+            // stream is full, continue in next DoWork()
+            return;
+        }
+        else {
+            this->onError("write failed");
+            return;
+        }
+    }
+    buf.start = buf.end = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+StreamPort::receive() {
+    const int32 chunkSize = 64 * 1024;
+    for (;;) {
+        this->recvBuffer.reserve(chunkSize);
+        uint8* dst = this->recvBuffer.data + this->recvBuffer.end;
+        const int32 numRead = this->readBytes(dst, this->recvBuffer.capacity - this->recvBuffer.end);
+        if (numRead > 0) {
+            this->recvBuffer.end += numRead;
+        }
+        else if (0 == numRead) {
+            return;
+        }
+        else {
+            // the other side has closed the stream, decode what we've got
+            this->decodeFrames();
+            this->Close();
+            return;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+StreamPort::decodeFrames() {
+    buffer& buf = this->recvBuffer;
+    while ((buf.end - buf.start) >= int32(sizeof(uint32))) {
+        const uint8* framePtr = buf.data + buf.start;
+        uint32 frameSize = 0;
+        std::memcpy(&frameSize, framePtr, sizeof(frameSize));
+        if ((frameSize < sizeof(MessageIdType)) || (frameSize > uint32(MaxFrameSize))) {
+            // the stream can't be resynchronized, onError() closes
+            // the stream and drops the received data
+            this->onError("invalid frame size");
+            return;
+        }
+        if ((buf.end - buf.start) < int32(sizeof(frameSize) + frameSize)) {
+            // incomplete frame, wait for more data
+            break;
+        }
+        const uint8* msgPtr = framePtr + sizeof(frameSize);
+        const uint8* msgEnd = msgPtr + frameSize;
+        buf.start += sizeof(frameSize) + frameSize;
+
+        MessageIdType msgId = InvalidMessageId;
+        std::memcpy(&msgId, msgPtr, sizeof(msgId));
+        Ptr<Message> msg = this->createFunc(msgId);
+        if (!msg || (msg->MessageId() != msgId)) {
+            o_warn("StreamPort: received unknown message id '%d', dropped\n", msgId);
+            continue;
+        }
+        if (msg->Decode(msgPtr, msgEnd) != msgEnd) {
+            o_warn("StreamPort: failed to decode message '%d', dropped\n", msgId);
+            continue;
+        }
+        this->forwardingPort->Put(msg);
+    }
+    if (buf.start == buf.end) {
+        buf.start = buf.end = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+int32
+StreamPort::writeBytes(const uint8* ptr, int32 numBytes) {
+    ssize_t res;
+    do {
+        res = ::write(this->writeFd, ptr, numBytes);
+    }
+    while ((res < 0) && (EINTR == errno));
+    if (res >= 0) {
+        return int32(res);
+    }
+    return ((EAGAIN == errno) || (EWOULDBLOCK == errno)) ? 0 : -1;
+}
+
+//------------------------------------------------------------------------------
+int32
+StreamPort::readBytes(uint8* ptr, int32 numBytes) {
+    ssize_t res;
+    do {
+        res = ::read(this->readFd, ptr, numBytes);
+    }
+    while ((res < 0) && (EINTR == errno));
+    if (res > 0) {
+        return int32(res);
+    }
+    else if (0 == res) {
+        // end of stream
+        return -1;
+    }
+    return ((EAGAIN == errno) || (EWOULDBLOCK == errno)) ? 0 : -1;
+}
+
+} // namespace Oryol
@@ -0,0 +1,106 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::StreamPort
+    @ingroup Messaging
+    @brief send and receive encoded messages over a byte stream
+
+    A StreamPort moves messages across a process boundary over a pair
+    of POSIX file descriptors (for instance pipes, or the same socket
+    for reading and writing). Messages put into the port are queued,
+    and encoded in DoWork() into a contiguous send buffer as
+    length-prefixed frames:
+
+        uint32 numBytes     // size of the encoded message
+        uint8 msg[numBytes] // Message::Encode() output, starts with the message id
+
+    The send buffer is written without blocking, whatever doesn't fit
+    into the stream is written in the next DoWork(). Received frames are
+    decoded into new messages created through the protocol factory
+    function, and forwarded to the forwarding port.
+
+    Only messages of protocols generated with 'serialize: true' can be
+    sent through a StreamPort. The StreamPort takes ownership of the
+    file descriptors, and closes them in Close() or its destructor.
+
+    @see SocketPort, Message::Encode()
+*/
+#include "Messaging/Port.h"
+#include "Core/Containers/Queue.h"
+
+namespace Oryol {
+
+class StreamPort : public Port {
+    OryolClassDecl(StreamPort);
+public:
+    /// protocol factory function (e.g. MyProtocol::Factory::Create)
+    typedef Ptr<Message> (*CreateFunc)(MessageIdType msgId);
+    /// frames larger than this are treated as a protocol error, bigger messages are dropped when sending
+    static const int32 MaxFrameSize = 16 * 1024 * 1024;
+
+    /// constructor with file descriptors, factory function and forwarding port
+    StreamPort(int readFd, int writeFd, CreateFunc createFunc, const Ptr<Port>& forwardingPort);
+    /// destructor
+    virtual ~StreamPort();
+
+    /// queue a message for sending
+    virtual bool Put(const Ptr<Message>& msg) override;
+    /// send queued and receive pending messages, then call DoWork() on the forwarding port
+    virtual void DoWork() override;
+
+    /// close the file descriptors, drops unsent and received data
+    void Close();
+    /// return true if the stream is open, false after errors or if the other side closed
+    bool IsConnected() const;
+    /// get number of queued messages which haven't been encoded yet
+    int32 GetNumQueuedMessages() const;
+    /// get number of encoded bytes which haven't been sent yet
+    int32 GetNumPendingSendBytes() const;
+
+protected:
+    /// write bytes without blocking, return number of bytes written, 0 if stream is full, -1 on error
+    virtual int32 writeBytes(const uint8* ptr, int32 numBytes);
+    /// read bytes without blocking, return number of bytes read, 0 if nothing available, -1 on error or close
+    virtual int32 readBytes(uint8* ptr, int32 numBytes);
+    /// handle an error, closes the stream and drops unsent and received data
+    void onError(const char* what);
+
+    int readFd;
+    int writeFd;
+
+private:
+    /// encode queued messages into the send buffer
+    void encodeMessages();
+    /// write the send buffer to the stream
+    void send();
+    /// read available data into the receive buffer
+    void receive();
+    /// decode complete frames from the receive buffer and forward them
+    void decodeFrames();
+
+    struct buffer {
+        uint8* data = nullptr;
+        int32 start = 0;
+        int32 end = 0;
+        int32 capacity = 0;
+
+        /// make room for numBytes after end
+        void reserve(int32 numBytes);
+        /// release memory
+        void free();
+    };
+
+    CreateFunc createFunc;
+    Ptr<Port> forwardingPort;
+    Queue<Ptr<Message>> sendQueue;
+    buffer sendBuffer;
+    buffer recvBuffer;
+};
+
+//------------------------------------------------------------------------------
+inline bool
+StreamPort::IsConnected() const {
+    return this->readFd >= 0;
+}
+
+} // namespace Oryol
@@ -0,0 +1,238 @@
+//------------------------------------------------------------------------------
+//  LockFreeQueueTest.cc
+//  Test LockFreeQueue functionality and compare handoff performance
+//  against ThreadedQueue.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Messaging/LockFreeQueue.h"
+#include "Messaging/ThreadedQueue.h"
+#include "Messaging/Dispatcher.h"
+#include "Messaging/UnitTests/TestProtocol.h"
+#include "Core/Containers/Queue.h"
+#include "Core/Threading/mpmcQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+using namespace Oryol;
+using namespace Oryol::_priv;
+using namespace std::chrono;
+
+//------------------------------------------------------------------------------
+TEST(mpmcQueueTest) {
+    mpmcQueue<int32> queue(4);
+    CHECK(queue.Capacity() == 4);
+    CHECK(queue.Empty());
+    int32 val = 0;
+    CHECK(!queue.Dequeue(val));
+    CHECK(queue.Enqueue(1));
+    CHECK(queue.Enqueue(2));
+    CHECK(queue.Enqueue(3));
+    CHECK(queue.Enqueue(4));
+    CHECK(!queue.Enqueue(5));
+    CHECK(queue.Size() == 4);
+    CHECK(queue.Dequeue(val) && (val == 1));
+    CHECK(queue.Enqueue(5));
+    CHECK(queue.Dequeue(val) && (val == 2));
+    CHECK(queue.Dequeue(val) && (val == 3));
+    CHECK(queue.Dequeue(val) && (val == 4));
+    CHECK(queue.Dequeue(val) && (val == 5));
+    CHECK(!queue.Dequeue(val));
+    CHECK(queue.Empty());
+
+    // Ptr<> elements must be moved through the queue without leaking references
+    mpmcQueue<Ptr<Message>> msgQueue(8);
+    Ptr<Message> msg = TestProtocol::TestMsg1::Create();
+    CHECK(msgQueue.Enqueue(msg));
+    CHECK(msg->GetRefCount() == 2);
+    Ptr<Message> outMsg;
+    CHECK(msgQueue.Dequeue(outMsg));
+    CHECK(outMsg == msg);
+    CHECK(msg->GetRefCount() == 2);
+    outMsg = nullptr;
+    CHECK(msg->GetRefCount() == 1);
+}
+
+//------------------------------------------------------------------------------
+static std::atomic<int32> numHandled{0};
+static void HandleTestMsg1(const Ptr<TestProtocol::TestMsg1>& msg) {
+    numHandled++;
+    msg->SetHandled();
+}
+
+TEST(LockFreeQueueTest) {
+    Ptr<Dispatcher<TestProtocol>> disp = Dispatcher<TestProtocol>::Create();
+    disp->Subscribe<TestProtocol::TestMsg1>(&HandleTestMsg1);
+    Ptr<LockFreeQueue> queue = LockFreeQueue::Create(disp, 64);
+    queue->StartThread();
+
+    // messages are picked up without calling DoWork()
+    Ptr<TestProtocol::TestMsg1> msg = TestProtocol::TestMsg1::Create();
+    queue->Put(msg);
+    while (!msg->Handled()) {
+        std::this_thread::yield();
+    }
+    CHECK(numHandled == 1);
+
+    // overflow the small ring buffer from several threads
+    numHandled = 0;
+    const int32 numThreads = 4;
+    const int32 numMsgsPerThread = 10000;
+    std::thread threads[numThreads];
+    for (int32 i = 0; i < numThreads; i++) {
+        threads[i] = std::thread([queue] {
+            for (int32 j = 0; j < numMsgsPerThread; j++) {
+                queue->Put(TestProtocol::TestMsg1::Create());
+            }
+        });
+    }
+    for (int32 i = 0; i < numThreads; i++) {
+        threads[i].join();
+    }
+    while (numHandled < numThreads * numMsgsPerThread) {
+        queue->DoWork();
+        std::this_thread::yield();
+    }
+    CHECK(numHandled == numThreads * numMsgsPerThread);
+
+    queue->StopThread();
+    queue = 0;
+}
+
+//------------------------------------------------------------------------------
+//  Handoff benchmark: N producer threads send timestamped messages
+//  through the queue port, the consumer port on the worker thread
+//  records the handoff latency of each message.
+//
+//  ThreadedQueue::Put() may only be called from the thread which
+//  created the queue, so for ThreadedQueue the producer threads hand
+//  their messages to the creator thread through a locked relay queue
+//  (which is what multi-producer code has to do today), with a single
+//  producer the creator thread puts messages directly and calls DoWork()
+//  every 64 messages.
+//
+class latencyPort : public Port {
+    OryolClassDecl(latencyPort);
+public:
+    latencyPort(int64* latencies_) : latencies(latencies_) { };
+    virtual bool Put(const Ptr<Message>& msg) override {
+        const int64 now = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+        TestProtocol::TestMsg1* testMsg = (TestProtocol::TestMsg1*) msg.get();
+        this->latencies[testMsg->GetInt32Val()] = now - testMsg->GetInt64Val();
+        this->numReceived.fetch_add(1, std::memory_order_release);
+        return true;
+    };
+    int64* latencies;
+    std::atomic<int32> numReceived{0};
+};
+
+static Ptr<TestProtocol::TestMsg1>
+makeBenchMsg(int32 index) {
+    Ptr<TestProtocol::TestMsg1> msg = TestProtocol::TestMsg1::Create();
+    msg->SetInt32Val(index);
+    msg->SetInt64Val(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+    return msg;
+}
+
+static void
+report(const char* name, int32 numProducers, int32 numMsgs, double secs, int64* latencies) {
+    std::sort(latencies, latencies + numMsgs);
+    const double p50 = double(latencies[numMsgs / 2]) / 1000.0;
+    const double p99 = double(latencies[(numMsgs * 99) / 100]) / 1000.0;
+    Log::Info("%s: %2d producers: %10.0f msgs/sec, p50=%8.2f usec, p99=%8.2f usec\n",
+        name, numProducers, double(numMsgs) / secs, p50, p99);
+}
+
+static void
+benchLockFreeQueue(int32 numProducers, int32 numMsgs, int64* latencies) {
+    Ptr<latencyPort> consumer = latencyPort::Create(latencies);
+    Ptr<LockFreeQueue> queue = LockFreeQueue::Create(consumer);
+    queue->StartThread();
+    const int32 msgsPerProducer = numMsgs / numProducers;
+    auto start = steady_clock::now();
+    std::thread threads[16];
+    for (int32 i = 0; i < numProducers; i++) {
+        threads[i] = std::thread([queue, i, msgsPerProducer] {
+            for (int32 j = 0; j < msgsPerProducer; j++) {
+                queue->Put(makeBenchMsg(i * msgsPerProducer + j));
+            }
+        });
+    }
+    while (consumer->numReceived.load(std::memory_order_acquire) < numMsgs) {
+        queue->DoWork();
+        std::this_thread::yield();
+    }
+    duration<double> dur = steady_clock::now() - start;
+    for (int32 i = 0; i < numProducers; i++) {
+        threads[i].join();
+    }
+    queue->StopThread();
+    report("LockFreeQueue", numProducers, numMsgs, dur.count(), latencies);
+}
+
+static void
+benchThreadedQueue(int32 numProducers, int32 numMsgs, int64* latencies) {
+    Ptr<latencyPort> consumer = latencyPort::Create(latencies);
+    Ptr<ThreadedQueue> queue = ThreadedQueue::Create(consumer);
+    queue->StartThread();
+    const int32 msgsPerProducer = numMsgs / numProducers;
+    auto start = steady_clock::now();
+    if (1 == numProducers) {
+        for (int32 i = 0; i < numMsgs; i++) {
+            queue->Put(makeBenchMsg(i));
+            if (0 == (i & 63)) {
+                queue->DoWork();
+            }
+        }
+    }
+    else {
+        std::mutex relayLock;
+        Queue<Ptr<Message>> relay;
+        std::thread threads[16];
+        for (int32 i = 0; i < numProducers; i++) {
+            threads[i] = std::thread([&relayLock, &relay, i, msgsPerProducer] {
+                for (int32 j = 0; j < msgsPerProducer; j++) {
+                    Ptr<Message> msg = makeBenchMsg(i * msgsPerProducer + j);
+                    std::lock_guard<std::mutex> lock(relayLock);
+                    relay.Enqueue(msg);
+                }
+            });
+        }
+        int32 numRelayed = 0;
+        while (numRelayed < numMsgs) {
+            {
+                std::lock_guard<std::mutex> lock(relayLock);
+                while (!relay.Empty()) {
+                    queue->Put(relay.Dequeue());
+                    numRelayed++;
+                }
+            }
+            queue->DoWork();
+            std::this_thread::yield();
+        }
+        for (int32 i = 0; i < numProducers; i++) {
+            threads[i].join();
+        }
+    }
+    while (consumer->numReceived.load(std::memory_order_acquire) < numMsgs) {
+        queue->DoWork();
+        std::this_thread::yield();
+    }
+    duration<double> dur = steady_clock::now() - start;
+    queue->StopThread();
+    report("ThreadedQueue", numProducers, numMsgs, dur.count(), latencies);
+}
+
+TEST(LockFreeQueueBenchmark) {
+    const int32 numMsgs = 16 * 16384;
+    int64* latencies = (int64*) Memory::Alloc(numMsgs * sizeof(int64));
+    const int32 numProducers[] = { 1, 4, 16 };
+    for (int32 n : numProducers) {
+        benchThreadedQueue(n, numMsgs, latencies);
+        benchLockFreeQueue(n, numMsgs, latencies);
+    }
+    Memory::Free(latencies);
+}
@@ -6,6 +6,9 @@
 #include "Messaging/Serializer.h"
 #include "Core/String/String.h"
 #include "Core/String/StringAtom.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Log.h"
+#include <chrono>
 
 using namespace Oryol;
 
@@ -85,3 +88,186 @@ TEST(SerializerTest) {
 }
 
 
+
+//------------------------------------------------------------------------------
+TEST(SerializerViewTest) {
+
+    // scratch space, the encoded data starts at an odd offset
+    uint8* space = (uint8*) Memory::Alloc(256);
+    uint8* encodePtr = space + 3;
+    const uint8* maxPtr = space + 256;
+
+    // aligned array of float64
+    Array<float64> f64ArrayWrite({ 1.0, 2.0, 3.0 });
+    const int32 size = Serializer::EncodedAlignedArraySize<float64>(f64ArrayWrite);
+    CHECK(size == 4 + 8 + 3 * 8);
+    CHECK(Serializer::EncodeAlignedArray<float64>(f64ArrayWrite, encodePtr, maxPtr) == encodePtr + size);
+    CHECK(Serializer::EncodeAlignedArray<float64>(f64ArrayWrite, encodePtr, encodePtr + size - 1) == nullptr);
+    Array<float64> f64ArrayRead;
+    CHECK(Serializer::DecodeAlignedArray<float64>(encodePtr, maxPtr, f64ArrayRead) == encodePtr + size);
+    CHECK(f64ArrayRead.Size() == 3);
+    CHECK((f64ArrayRead[0] == 1.0) && (f64ArrayRead[1] == 2.0) && (f64ArrayRead[2] == 3.0));
+
+    // the view points into the buffer
+    Serializer::ArrayView<float64> f64View;
+    CHECK(Serializer::DecodeArrayView<float64>(encodePtr, maxPtr, f64View) == encodePtr + size);
+    CHECK(f64View.Size == 3);
+    CHECK(((const uint8*)f64View.Data > encodePtr) && ((const uint8*)f64View.Data < encodePtr + size));
+    CHECK((f64View[0] == 1.0) && (f64View[1] == 2.0) && (f64View[2] == 3.0));
+    CHECK(Serializer::DecodeArrayView<float64>(encodePtr, encodePtr + size - 1, f64View) == nullptr);
+
+    // moved to a different alignment, the view can't alias the buffer, but copying still works
+    memmove(encodePtr + 1, encodePtr, size);
+    CHECK(Serializer::DecodeArrayView<float64>(encodePtr + 1, maxPtr, f64View) == nullptr);
+    f64ArrayRead.Clear();
+    CHECK(Serializer::DecodeAlignedArray<float64>(encodePtr + 1, maxPtr, f64ArrayRead) == encodePtr + 1 + size);
+    CHECK((f64ArrayRead.Size() == 3) && (f64ArrayRead[2] == 3.0));
+
+    // empty aligned array
+    Array<int32> emptyArray;
+    CHECK(Serializer::EncodeAlignedArray<int32>(emptyArray, encodePtr, maxPtr) == encodePtr + 8);
+    Serializer::ArrayView<int32> i32View;
+    CHECK(Serializer::DecodeArrayView<int32>(encodePtr, maxPtr, i32View) == encodePtr + 8);
+    CHECK(i32View.Size == 0);
+
+    // string view
+    const String strWrite("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+    CHECK(Serializer::Encode<String>(strWrite, encodePtr, maxPtr) == encodePtr + 30);
+    Serializer::ArrayView<char> strView;
+    CHECK(Serializer::DecodeStringView(encodePtr, maxPtr, strView) == encodePtr + 30);
+    CHECK(strView.Size == 26);
+    CHECK(String(strView.Data, 0, strView.Size) == strWrite);
+    CHECK(Serializer::DecodeStringView(encodePtr, encodePtr + 29, strView) == nullptr);
+
+    // StringAtom decoding doesn't need a null-terminated string
+    StringAtom strAtomRead;
+    CHECK(Serializer::Decode<StringAtom>(encodePtr, maxPtr, strAtomRead) == encodePtr + 30);
+    CHECK(strAtomRead == StringAtom("ABCDEFGHIJKLMNOPQRSTUVWXYZ"));
+
+    // truncated POD array
+    Array<int32> i32ArrayWrite({ 1, 2, 3 });
+    Array<int32> i32ArrayRead;
+    CHECK(Serializer::EncodeArray<int32>(i32ArrayWrite, encodePtr, maxPtr) == encodePtr + 16);
+    CHECK(Serializer::DecodeArray<int32>(encodePtr, encodePtr + 15, i32ArrayRead) == nullptr);
+    CHECK(i32ArrayRead.Empty());
+
+    Memory::Free(space);
+}
+
+//------------------------------------------------------------------------------
+namespace {
+double
+megaBytesPerSec(int32 numBytes, int32 numIter, std::chrono::system_clock::time_point start) {
+    std::chrono::duration<double> dur = std::chrono::system_clock::now() - start;
+    return (double(numBytes) * numIter) / (dur.count() * 1024.0 * 1024.0);
+}
+} // anonymous namespace
+
+TEST(SerializerBenchmark) {
+    using namespace std::chrono;
+    const int32 numElements = 256 * 1024;
+    const int32 numIter = 64;
+    Array<float32> floats;
+    floats.Reserve(numElements);
+    for (int32 i = 0; i < numElements; i++) {
+        floats.Add(float32(i));
+    }
+    const int32 bufSize = Serializer::EncodedAlignedArraySize<float32>(floats);
+    uint8* buf = (uint8*) Memory::Alloc(bufSize);
+    const uint8* maxPtr = buf + bufSize;
+    const int32 numBytes = numElements * sizeof(float32);
+
+    // element-wise, like a non-POD array
+    auto start = system_clock::now();
+    for (int32 iter = 0; iter < numIter; iter++) {
+        uint8* dstPtr = Serializer::Encode<int32>(numElements, buf, maxPtr);
+        for (const float32& f : floats) {
+            dstPtr = Serializer::Encode<float32>(f, dstPtr, maxPtr);
+        }
+    }
+    Log::Info("Serializer: element-wise encode: %8.1f MB/s\n", megaBytesPerSec(numBytes, numIter, start));
+    start = system_clock::now();
+    float64 sum = 0.0;
+    for (int32 iter = 0; iter < numIter; iter++) {
+        Array<float32> dst;
+        dst.Reserve(numElements);
+        const uint8* srcPtr = buf + sizeof(int32);
+        for (int32 i = 0; i < numElements; i++) {
+            float32 f;
+            srcPtr = Serializer::Decode<float32>(srcPtr, maxPtr, f);
+            dst.Add(f);
+        }
+        sum += dst.Back();
+    }
+    Log::Info("Serializer: element-wise decode: %8.1f MB/s\n", megaBytesPerSec(numBytes, numIter, start));
+
+    // bulk copy
+    start = system_clock::now();
+    for (int32 iter = 0; iter < numIter; iter++) {
+        Serializer::EncodeArray<float32>(floats, buf, maxPtr);
+    }
+    Log::Info("Serializer: EncodeArray:         %8.1f MB/s\n", megaBytesPerSec(numBytes, numIter, start));
+    start = system_clock::now();
+    for (int32 iter = 0; iter < numIter; iter++) {
+        Array<float32> dst;
+        Serializer::DecodeArray<float32>(buf, maxPtr, dst);
+        sum += dst.Back();
+    }
+    Log::Info("Serializer: DecodeArray:         %8.1f MB/s\n", megaBytesPerSec(numBytes, numIter, start));
+
+    // aligned and view
+    start = system_clock::now();
+    for (int32 iter = 0; iter < numIter; iter++) {
+        Serializer::EncodeAlignedArray<float32>(floats, buf, maxPtr);
+    }
+    Log::Info("Serializer: EncodeAlignedArray:  %8.1f MB/s\n", megaBytesPerSec(numBytes, numIter, start));
+    start = system_clock::now();
+    for (int32 iter = 0; iter < numIter; iter++) {
+        Array<float32> dst;
+        Serializer::DecodeAlignedArray<float32>(buf, maxPtr, dst);
+        sum += dst.Back();
+    }
+    Log::Info("Serializer: DecodeAlignedArray:  %8.1f MB/s\n", megaBytesPerSec(numBytes, numIter, start));
+    start = system_clock::now();
+    for (int32 iter = 0; iter < numIter; iter++) {
+        Serializer::ArrayView<float32> view;
+        Serializer::DecodeArrayView<float32>(buf, maxPtr, view);
+        sum += view[view.Size - 1];
+    }
+    // the view doesn't copy any data, so report time per call instead of throughput
+    duration<float64, std::nano> viewDur = system_clock::now() - start;
+    Log::Info("Serializer: DecodeArrayView:     %8.1f ns/call\n", viewDur.count() / numIter);
+    CHECK(sum == 4.0 * numIter * float64(numElements - 1));
+
+    // strings
+    const String str("The quick brown fox jumps over the lazy dog");
+    const int32 numStrIter = 1000000;
+    const int32 strBytes = str.Length();
+    Serializer::Encode<String>(str, buf, maxPtr);
+    start = system_clock::now();
+    int32 len = 0;
+    for (int32 iter = 0; iter < numStrIter; iter++) {
+        String dst;
+        Serializer::Decode<String>(buf, maxPtr, dst);
+        len += dst.Length();
+    }
+    Log::Info("Serializer: Decode<String>:      %8.1f MB/s\n", megaBytesPerSec(strBytes, numStrIter, start));
+    start = system_clock::now();
+    for (int32 iter = 0; iter < numStrIter; iter++) {
+        StringAtom dst;
+        Serializer::Decode<StringAtom>(buf, maxPtr, dst);
+        len += dst.Length();
+    }
+    Log::Info("Serializer: Decode<StringAtom>:  %8.1f MB/s\n", megaBytesPerSec(strBytes, numStrIter, start));
+    start = system_clock::now();
+    for (int32 iter = 0; iter < numStrIter; iter++) {
+        Serializer::ArrayView<char> dst;
+        Serializer::DecodeStringView(buf, maxPtr, dst);
+        len += dst.Size;
+    }
+    viewDur = system_clock::now() - start;
+    Log::Info("Serializer: DecodeStringView:    %8.1f ns/call\n", viewDur.count() / numStrIter);
+    CHECK(len == 3 * numStrIter * strBytes);
+
+    Memory::Free(buf);
+}
@@ -0,0 +1,165 @@
+//------------------------------------------------------------------------------
+//  StreamPortTest.cc
+//  Test sending messages through SocketPorts.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Messaging/SocketPort.h"
+#include "Core/Containers/Array.h"
+#include "TestProtocol.h"
+#include <unistd.h>
+
+using namespace Oryol;
+
+namespace {
+
+// a port which collects received messages
+class collectPort : public Port {
+    OryolClassDecl(collectPort);
+public:
+    virtual bool Put(const Ptr<Message>& msg) override {
+        this->msgs.Add(msg);
+        return true;
+    }
+    Array<Ptr<Message>> msgs;
+};
+OryolClassImpl(collectPort);
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(StreamPortTest) {
+    Ptr<collectPort> recvA = collectPort::Create();
+    Ptr<collectPort> recvB = collectPort::Create();
+    Ptr<SocketPort> portA;
+    Ptr<SocketPort> portB;
+    SocketPort::CreatePair(&TestProtocol::Factory::Create, recvA, recvB, portA, portB);
+    CHECK(portA->IsConnected());
+    CHECK(portB->IsConnected());
+
+    // send enough messages from A to B that the socket buffer fills up
+    const int32 numMsgs = 4000;
+    for (int32 i = 0; i < numMsgs; i++) {
+        if (i & 1) {
+            auto msg = TestProtocol::TestArrayMsg::Create();
+            Array<int32> ints;
+            Array<String> strings;
+            for (int32 j = 0; j < (i % 16); j++) {
+                ints.Add(i + j);
+                strings.Add("String");
+            }
+            msg->SetInt32ArrayVal(ints);
+            msg->SetStringArrayVal(strings);
+            CHECK(portA->Put(msg));
+        }
+        else {
+            auto msg = TestProtocol::TestMsg2::Create();
+            msg->SetInt32Val(i);
+            msg->SetUInt64Val(uint64(i) << 32);
+            msg->SetFloat64Val(i * 0.5);
+            msg->SetStringVal("Bla Blub");
+            msg->SetStringAtomVal(StringAtom("Atom"));
+            CHECK(portA->Put(msg));
+        }
+    }
+    CHECK(portA->GetNumQueuedMessages() == numMsgs);
+    portA->DoWork();
+    CHECK(portA->GetNumQueuedMessages() == 0);
+    CHECK(portA->GetNumPendingSendBytes() > 0);
+    int32 numIterations = 0;
+    while ((recvB->msgs.Size() < numMsgs) && (numIterations++ < 100000)) {
+        portB->DoWork();
+        portA->DoWork();
+    }
+    CHECK(portA->GetNumPendingSendBytes() == 0);
+    CHECK(recvB->msgs.Size() == numMsgs);
+    CHECK(recvA->msgs.Empty());
+    bool valid = recvB->msgs.Size() == numMsgs;
+    for (int32 i = 0; valid && (i < numMsgs); i++) {
+        const Ptr<Message>& msg = recvB->msgs[i];
+        if (i & 1) {
+            valid &= msg->IsA<TestProtocol::TestArrayMsg>();
+            Ptr<TestProtocol::TestArrayMsg> arrayMsg = msg->DynamicCast<TestProtocol::TestArrayMsg>();
+            valid &= arrayMsg->GetInt32ArrayVal().Size() == (i % 16);
+            valid &= arrayMsg->GetStringArrayVal().Size() == (i % 16);
+            for (int32 j = 0; valid && (j < (i % 16)); j++) {
+                valid &= arrayMsg->GetInt32ArrayVal()[j] == (i + j);
+                valid &= arrayMsg->GetStringArrayVal()[j] == "String";
+            }
+        }
+        else {
+            valid &= msg->IsA<TestProtocol::TestMsg2>();
+            Ptr<TestProtocol::TestMsg2> msg2 = msg->DynamicCast<TestProtocol::TestMsg2>();
+            valid &= msg2->GetInt32Val() == i;
+            valid &= msg2->GetUInt64Val() == (uint64(i) << 32);
+            valid &= msg2->GetFloat64Val() == i * 0.5;
+            valid &= msg2->GetInt16Val() == -1;
+            valid &= msg2->GetStringVal() == "Bla Blub";
+            valid &= msg2->GetStringAtomVal() == "Atom";
+        }
+    }
+    CHECK(valid);
+
+    // and back from B to A
+    auto reply = TestProtocol::TestMsg1::Create();
+    reply->SetInt8Val(12);
+    portB->Put(reply);
+    portB->DoWork();
+    portA->DoWork();
+    CHECK(recvA->msgs.Size() == 1);
+    if (recvA->msgs.Size() == 1) {
+        CHECK(recvA->msgs[0]->IsA<TestProtocol::TestMsg1>());
+        CHECK(recvA->msgs[0]->DynamicCast<TestProtocol::TestMsg1>()->GetInt8Val() == 12);
+    }
+
+    // closing one side disconnects the other side
+    portA->Close();
+    CHECK(!portA->IsConnected());
+    CHECK(!portA->Put(reply));
+    portB->DoWork();
+    CHECK(!portB->IsConnected());
+}
+
+//------------------------------------------------------------------------------
+TEST(StreamPortErrorTest) {
+    Ptr<collectPort> recvA = collectPort::Create();
+    Ptr<collectPort> recvB = collectPort::Create();
+    Ptr<SocketPort> portA;
+    Ptr<SocketPort> portB;
+    SocketPort::CreatePair(&TestProtocol::Factory::Create, recvA, recvB, portA, portB);
+
+    // a message bigger than MaxFrameSize is dropped, the next one is sent
+    auto bigMsg = TestProtocol::TestArrayMsg::Create();
+    Array<int32> ints;
+    const int32 numInts = StreamPort::MaxFrameSize / sizeof(int32) + 1;
+    ints.Reserve(numInts);
+    for (int32 i = 0; i < numInts; i++) {
+        ints.Add(i);
+    }
+    bigMsg->SetInt32ArrayVal(ints);
+    CHECK(portA->Put(bigMsg));
+    auto msg = TestProtocol::TestMsg1::Create();
+    msg->SetInt8Val(3);
+    CHECK(portA->Put(msg));
+    portA->DoWork();
+    CHECK(portA->IsConnected());
+    CHECK(portA->GetNumQueuedMessages() == 0);
+    portB->DoWork();
+    CHECK(recvB->msgs.Size() == 1);
+    if (recvB->msgs.Size() == 1) {
+        CHECK(recvB->msgs[0]->IsA<TestProtocol::TestMsg1>());
+    }
+
+    // an invalid frame closes the receiving side and drops the received data
+    int fds[2];
+    CHECK(0 == ::pipe(fds));
+    const uint32 badFrame[2] = { 0xFFFFFFFF, 0 };
+    CHECK(ssize_t(sizeof(badFrame)) == ::write(fds[1], badFrame, sizeof(badFrame)));
+    Ptr<collectPort> recvC = collectPort::Create();
+    Ptr<StreamPort> portC = StreamPort::Create(fds[0], fds[1], &TestProtocol::Factory::Create, recvC);
+    portC->DoWork();
+    CHECK(!portC->IsConnected());
+    CHECK(recvC->msgs.Empty());
+    portC->DoWork();
+    CHECK(recvC->msgs.Empty());
+}
@@ -73,6 +73,9 @@ public:
             if (protId == 'TSTP') return true;
             else return Message::IsMemberOf(protId);
         };
+        virtual int32 EncodedSize() const override;
+        virtual uint8* Encode(uint8* dstPtr, const uint8* maxValidPtr) const override;
+        virtual const uint8* Decode(const uint8* srcPtr, const uint8* maxValidPtr) override;
         void SetInt8Val(int8 val) {
             this->int8val = val;
         };
@@ -163,6 +166,9 @@ private:
             if (protId == 'TSTP') return true;
             else return TestMsg1::IsMemberOf(protId);
         };
+        virtual int32 EncodedSize() const override;
+        virtual uint8* Encode(uint8* dstPtr, const uint8* maxValidPtr) const override;
+        virtual const uint8* Decode(const uint8* srcPtr, const uint8* maxValidPtr) override;
         void SetStringVal(const String& val) {
             this->stringval = val;
         };
@@ -196,6 +202,9 @@ private:
             if (protId == 'TSTP') return true;
             else return Message::IsMemberOf(protId);
         };
+        virtual int32 EncodedSize() const override;
+        virtual uint8* Encode(uint8* dstPtr, const uint8* maxValidPtr) const override;
+        virtual const uint8* Decode(const uint8* srcPtr, const uint8* maxValidPtr) override;
         void SetInt32ArrayVal(const Array<int32>& val) {
             this->int32arrayval = val;
         };
@@ -32,4 +32,16 @@ ResourceLoader::Cancel() {
     // empty
 }
 
+//------------------------------------------------------------------------------
+/**
+ Loaders which don't support completion notification are polled
+ each frame, loaders which do must call Push(completionTag) on the
+ completion list (usually by attaching it to their IO request) when
+ Continue() should be called again.
+*/
+bool
+ResourceLoader::SetCompletionList(const Ptr<CompletionList>& list, uint64 tag) {
+    return false;
+}
+
 } // namespace Oryol
\ No newline at end of file
@@ -6,6 +6,7 @@
     @brief base class for resource loaders
 */
 #include "Core/RefCounted.h"
+#include "Core/Threading/CompletionList.h"
 #include "Resource/Id.h"
 #include "Resource/Locator.h"
 #include "Resource/ResourceState.h"
@@ -23,6 +24,12 @@ public:
     virtual ResourceState::Code Continue();
     /// cancel the resource loading process
     virtual void Cancel();
+    /// set a list which receives the tag when Continue() should be called, return false if not supported
+    virtual bool SetCompletionList(const Ptr<CompletionList>& list, uint64 tag);
+
+protected:
+    Ptr<CompletionList> completionList;
+    uint64 completionTag = 0;
 };
 
 } // namespace Oryol
\ No newline at end of file
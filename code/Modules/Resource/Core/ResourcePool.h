@@ -4,7 +4,17 @@
     @class Oryol::ResourcePool
     @ingroup Resource
     @brief generic resource pool
-    @todo ResourcePool description
+
+    A ResourcePool owns a fixed number of resource slots. Each slot has
+    a small 'hot' entry in a separate dense array, with the unique
+    stamp (generation) of the Id which currently occupies the slot, and
+    the slot's resource state. Lookup() and LookupMany() only validate
+    resource ids against this dense array, the resource object itself
+    (with its embedded Setup object) isn't touched until the caller
+    dereferences the returned pointer.
+
+    The Id, State and StateStartFrame members of the resource objects
+    are kept in sync for code which inspects them directly.
 */
 #include "Core/Ptr.h"
 #include "Core/Containers/Queue.h"
@@ -43,6 +53,8 @@ public:
     void Unassign(const Id& id);
     /// return pointer to resource object, may return placeholder or nullptr
     RESOURCE* Lookup(const Id& id) const;
+    /// lookup a batch of resources, writes nullptr for invalid ids, returns number of resources found
+    int32 LookupMany(const Id* ids, int32 numIds, RESOURCE** outResources) const;
     /// get pointer to resource by resource id, only return nullptr if resource is not contained
     RESOURCE* Get(const Id& id) const;
     /// update the resource state of a contained resource
@@ -66,12 +78,21 @@ public:
 protected:
     /// free a resource id
     void freeId(const Id& id);
-    
+    /// return true if the slot of id is occupied by id
+    bool isOccupiedBy(const Id& id) const;
+
+    /// the frequently accessed part of a slot
+    struct hotSlot {
+        Id::UniqueStampT generation = Id::InvalidUniqueStamp;
+        ResourceState::Code state = ResourceState::Initial;
+    };
+
     bool isValid;
     int32 frameCounter;
     int32 uniqueCounter;
     Id::TypeT resourceType;
     
+    Array<hotSlot> hotSlots;
     Array<RESOURCE> slots;
     Queue<uint16> freeSlots;
 };
@@ -99,13 +120,18 @@ ResourcePool<RESOURCE,SETUP>::Setup(Id::TypeT resType, int32 poolSize) {
     o_assert_dbg(Id::InvalidType != resType);
     o_assert_dbg(poolSize > 0);
     
+    o_assert_dbg(poolSize <= int32(MaxNumPoolResources));
+    
     this->resourceType = resType;
+    this->hotSlots.Reserve(poolSize);
+    this->hotSlots.SetAllocStrategy(0, 0);  // disable growing
     this->slots.Reserve(poolSize);
     this->slots.SetAllocStrategy(0, 0);    // disable growing
     this->freeSlots.Reserve(poolSize);
     
     // setup empty slots
     for (int32 i = 0; i < poolSize; i++) {
+        this->hotSlots.Add();
         this->slots.Add();
     }
     
@@ -125,6 +151,7 @@ ResourcePool<RESOURCE,SETUP>::Discard() {
     o_assert_dbg(this->freeSlots.Size() == this->slots.Size());
     this->isValid = false;
     
+    this->hotSlots.Clear();
     this->slots.Clear();
     this->freeSlots.Clear();
 }
@@ -148,10 +175,7 @@ ResourcePool<RESOURCE,SETUP>::AllocId() {
     o_assert_dbg(this->isValid);
     o_assert_dbg(Id::InvalidType != this->resourceType);
     Id newId(this->uniqueCounter++, this->freeSlots.Dequeue(), this->resourceType);
-    #if ORYOL_DEBUG
-        const auto& slot = this->slots[newId.SlotIndex];
-        o_assert_dbg(ResourceState::Initial == slot.State);
-    #endif
+    o_assert_dbg(ResourceState::Initial == this->hotSlots[newId.SlotIndex].state);
     return newId;
 }
 
@@ -159,17 +183,28 @@ ResourcePool<RESOURCE,SETUP>::AllocId() {
 template<class RESOURCE, class SETUP> void
 ResourcePool<RESOURCE,SETUP>::freeId(const Id& id) {
     o_assert_dbg(this->isValid);
-    o_assert_dbg(ResourceState::Initial == this->slots[id.SlotIndex].State);
+    o_assert_dbg(ResourceState::Initial == this->hotSlots[id.SlotIndex].state);
     this->freeSlots.Enqueue(id.SlotIndex);
 }
 
+//------------------------------------------------------------------------------
+template<class RESOURCE, class SETUP> bool
+ResourcePool<RESOURCE,SETUP>::isOccupiedBy(const Id& id) const {
+    // the slot index is implied by the position in the hot slot array
+    return (id.Type == this->resourceType) && (this->hotSlots[id.SlotIndex].generation == id.UniqueStamp);
+}
+
 //------------------------------------------------------------------------------
 template<class RESOURCE, class SETUP> RESOURCE&
 ResourcePool<RESOURCE,SETUP>::Assign(const Id& id, const SETUP& setup, ResourceState::Code state) {
     o_assert_dbg(this->isValid);
     
+    auto& hot = this->hotSlots[id.SlotIndex];
+    o_assert_dbg(ResourceState::Valid != hot.state);
+    o_assert_dbg(id.IsValid());
+    hot.generation = id.UniqueStamp;
+    hot.state = state;
     auto& slot = this->slots[id.SlotIndex];
-    o_assert_dbg(ResourceState::Valid != slot.State);
     slot.State = state;
     slot.StateStartFrame = this->frameCounter;
     slot.Id = id;
@@ -182,9 +217,12 @@ template<class RESOURCE, class SETUP> void
 ResourcePool<RESOURCE,SETUP>::Unassign(const Id& id) {
     o_assert_dbg(this->isValid);
     
-    auto& slot = this->slots[id.SlotIndex];
-    if (id == slot.Id) {
-        o_assert_dbg(ResourceState::Initial != slot.State);
+    if (this->isOccupiedBy(id)) {
+        auto& hot = this->hotSlots[id.SlotIndex];
+        o_assert_dbg(ResourceState::Initial != hot.state);
+        hot.generation = Id::InvalidUniqueStamp;
+        hot.state = ResourceState::Initial;
+        auto& slot = this->slots[id.SlotIndex];
         slot.Id.Invalidate();
         slot.State = ResourceState::Initial;
         slot.StateStartFrame = 0;
@@ -201,25 +239,47 @@ ResourcePool<RESOURCE,SETUP>::Lookup(const Id& id) const {
     o_assert_dbg(this->isValid);
     o_assert_dbg(id.Type == this->resourceType);
     
-    const auto& slot = this->slots[id.SlotIndex];
-    if (id == slot.Id) {
-        if (ResourceState::Valid == slot.State) {
-            // resource exists and is valid or pending, all ok
-            return const_cast<RESOURCE*>(&slot);
-        }
-        // FIXME: return placeholder if one is defined
+    const auto& hot = this->hotSlots[id.SlotIndex];
+    if ((hot.generation == id.UniqueStamp) && (ResourceState::Valid == hot.state)) {
+        // resource exists and is valid, all ok
+        return const_cast<RESOURCE*>(&this->slots[id.SlotIndex]);
     }
+    // FIXME: return placeholder if one is defined
     return nullptr;
 }
 
+//------------------------------------------------------------------------------
+template<class RESOURCE, class SETUP> int32
+ResourcePool<RESOURCE,SETUP>::LookupMany(const Id* ids, int32 numIds, RESOURCE** outResources) const {
+    o_assert_dbg(this->isValid);
+    o_assert_dbg(ids && outResources);
+    
+    const hotSlot* hotSlots = &this->hotSlots[0];
+    RESOURCE* slots = const_cast<RESOURCE*>(&this->slots[0]);
+    int32 numFound = 0;
+    for (int32 i = 0; i < numIds; i++) {
+        const Id& id = ids[i];
+        o_assert_dbg(id.Type == this->resourceType);
+        o_assert_dbg(id.SlotIndex < this->hotSlots.Size());
+        const hotSlot& hot = hotSlots[id.SlotIndex];
+        if ((hot.generation == id.UniqueStamp) && (ResourceState::Valid == hot.state)) {
+            outResources[i] = slots + id.SlotIndex;
+            numFound++;
+        }
+        else {
+            outResources[i] = nullptr;
+        }
+    }
+    return numFound;
+}
+
 //------------------------------------------------------------------------------
 template<class RESOURCE, class SETUP> RESOURCE*
 ResourcePool<RESOURCE,SETUP>::Get(const Id& id) const {
     o_assert_dbg(this->isValid);
     o_assert_dbg(id.Type == this->resourceType);
-    const auto& slot = this->slots[id.SlotIndex];
-    if (id == slot.Id) {
-        return const_cast<RESOURCE*>(&slot);
+    if (this->isOccupiedBy(id)) {
+        return const_cast<RESOURCE*>(&this->slots[id.SlotIndex]);
     }
     else {
         // dangling Id, resource slot has been re-occupied
@@ -231,9 +291,11 @@ ResourcePool<RESOURCE,SETUP>::Get(const Id& id) const {
 template<class RESOURCE, class SETUP> void
 ResourcePool<RESOURCE, SETUP>::UpdateState(const Id& id, ResourceState::Code newState) {
     o_assert_dbg(this->isValid);
-    auto& slot = this->slots[id.SlotIndex];
-    if (id == slot.Id) {
-        o_assert_dbg(ResourceState::Initial != slot.State);
+    if (this->isOccupiedBy(id)) {
+        auto& hot = this->hotSlots[id.SlotIndex];
+        o_assert_dbg(ResourceState::Initial != hot.state);
+        hot.state = newState;
+        auto& slot = this->slots[id.SlotIndex];
         slot.State = newState;
         slot.StateStartFrame = this->frameCounter;
     }
@@ -247,7 +309,7 @@ template<class RESOURCE, class SETUP> bool
 ResourcePool<RESOURCE, SETUP>::Contains(const Id& id) const {
     o_assert_dbg(this->isValid);
     o_assert_dbg(id.Type == this->resourceType);
-    return id == this->slots[id.SlotIndex].Id;
+    return this->isOccupiedBy(id);
 }
 
 //------------------------------------------------------------------------------
@@ -256,9 +318,8 @@ ResourcePool<RESOURCE,SETUP>::QueryState(const Id& id) const {
     o_assert_dbg(this->isValid);
     o_assert_dbg(id.Type == this->resourceType);
     
-    const auto& slot = this->slots[id.SlotIndex];
-    if (id == slot.Id) {
-        return slot.State;
+    if (this->isOccupiedBy(id)) {
+        return this->hotSlots[id.SlotIndex].state;
     }
     else {
         return ResourceState::InvalidState;
@@ -272,9 +333,9 @@ ResourcePool<RESOURCE, SETUP>::QueryResourceInfo(const Id& id) const {
     o_assert_dbg(id.Type == this->resourceType);
     
     ResourceInfo info;
-    const auto& slot = this->slots[id.SlotIndex];
-    if (id == slot.Id) {
-        info.State = slot.State;
+    if (this->isOccupiedBy(id)) {
+        const auto& slot = this->slots[id.SlotIndex];
+        info.State = this->hotSlots[id.SlotIndex].state;
         info.StateAge = this->frameCounter - slot.StateStartFrame;
     }
     return info;
@@ -290,9 +351,9 @@ ResourcePool<RESOURCE, SETUP>::QueryPoolInfo() const {
     poolInfo.NumSlots = this->GetNumSlots();
     poolInfo.NumUsedSlots = this->GetNumUsedSlots();
     poolInfo.NumFreeSlots = this->GetNumFreeSlots();
-    for (const auto& slot : this->slots) {
-        if (ResourceState::InvalidState != slot.State) {
-            poolInfo.NumSlotsByState[slot.State]++;
+    for (const auto& hot : this->hotSlots) {
+        if (ResourceState::InvalidState != hot.state) {
+            poolInfo.NumSlotsByState[hot.state]++;
         }
     }
     return poolInfo;
@@ -5,8 +5,11 @@
 #include "UnitTest++/src/UnitTest++.h"
 #include "Resource/Core/ResourcePool.h"
 #include "Resource/Core/resourceBase.h"
+#include "Core/Log.h"
+#include <chrono>
 
 using namespace Oryol;
+using namespace std::chrono;
 
 class mySetup {
 public:
@@ -65,6 +68,23 @@ TEST(ResourcePoolTest) {
     CHECK(res1->Id == resId1);
     CHECK(resourcePool.QueryResourceInfo(resId1).State == ResourceState::Valid);
     CHECK(res1->Setup.bla == 12345);
+
+    // batch lookup, pending and dangling ids return nullptr
+    Id resId2 = resourcePool.AllocId();
+    resourcePool.Assign(resId2, mySetup(1), ResourceState::Pending);
+    CHECK(nullptr == resourcePool.Lookup(resId2));
+    CHECK(nullptr != resourcePool.Get(resId2));
+    Id danglingId(resId.UniqueStamp + 1000, resId.SlotIndex, myResourceType);
+    CHECK(!resourcePool.Contains(danglingId));
+    CHECK(nullptr == resourcePool.Lookup(danglingId));
+    const Id ids[] = { resId1, resId2, resId, danglingId };
+    myResource* found[4] = { };
+    CHECK(resourcePool.LookupMany(ids, 4, found) == 2);
+    CHECK((found[0] == res1) && (found[1] == nullptr) && (found[2] == res) && (found[3] == nullptr));
+    resourcePool.UpdateState(resId2, ResourceState::Valid);
+    CHECK(resourcePool.Lookup(resId2)->Setup.bla == 1);
+    CHECK(resourcePool.Lookup(resId2)->State == ResourceState::Valid);
+    resourcePool.Unassign(resId2);
     
     const ResourcePoolInfo poolInfo = resourcePool.QueryPoolInfo();
     CHECK(poolInfo.ResourceType == myResourceType);
@@ -86,4 +106,97 @@ TEST(ResourcePoolTest) {
     
     resourcePool.Discard();
     CHECK(!resourcePool.IsValid());
-}
\ No newline at end of file
+}
+//------------------------------------------------------------------------------
+// a resource with a big embedded setup, like MeshSetup or TextureSetup
+class bigSetup {
+public:
+    int32 bla = 0;
+    uint8 payload[512] = { };
+};
+
+class bigResource : public resourceBase<bigSetup> {
+public:
+    uint32 handle = 0;
+};
+
+class bigResourcePool : public ResourcePool<bigResource, bigSetup> { };
+
+TEST(ResourcePoolBenchmark) {
+    const int32 poolSize = 4096;
+    bigResourcePool resourcePool;
+    resourcePool.Setup(1, poolSize);
+    Array<Id> ids;
+    for (int32 i = 0; i < poolSize; i++) {
+        Id id = resourcePool.AllocId();
+        bigSetup setup;
+        setup.bla = i;
+        // every 8th resource is still loading
+        resourcePool.Assign(id, setup, (i & 7) ? ResourceState::Valid : ResourceState::Pending).handle = i;
+        ids.Add(id);
+    }
+
+    // a 'draw list' which references resources in random order
+    const int32 numDraws = 1 << 16;
+    Array<Id> drawList;
+    uint32 rnd = 1;
+    for (int32 i = 0; i < numDraws; i++) {
+        rnd = rnd * 1664525 + 1013904223;
+        drawList.Add(ids[(rnd >> 8) % poolSize]);
+    }
+
+    // validate ids the way the pool used to, on the full resource object
+    const int32 numRuns = 32;
+    uint32 sum0 = 0;
+    auto start = steady_clock::now();
+    for (int32 run = 0; run < numRuns; run++) {
+        for (const Id& id : drawList) {
+            const bigResource* res = resourcePool.Get(id);
+            if ((res->Id == id) && (ResourceState::Valid == res->State)) {
+                sum0 += res->handle;
+            }
+        }
+    }
+    duration<double> fullDur = steady_clock::now() - start;
+
+    // single lookups through the hot slots
+    uint32 sum1 = 0;
+    start = steady_clock::now();
+    for (int32 run = 0; run < numRuns; run++) {
+        for (const Id& id : drawList) {
+            const bigResource* res = resourcePool.Lookup(id);
+            if (res) {
+                sum1 += res->handle;
+            }
+        }
+    }
+    duration<double> lookupDur = steady_clock::now() - start;
+
+    // batch lookups
+    uint32 sum2 = 0;
+    Array<bigResource*> resources;
+    resources.Reserve(numDraws);
+    for (int32 i = 0; i < numDraws; i++) {
+        resources.Add(nullptr);
+    }
+    start = steady_clock::now();
+    for (int32 run = 0; run < numRuns; run++) {
+        resourcePool.LookupMany(&drawList[0], numDraws, &resources[0]);
+        for (const bigResource* res : resources) {
+            if (res) {
+                sum2 += res->handle;
+            }
+        }
+    }
+    duration<double> manyDur = steady_clock::now() - start;
+    CHECK((sum0 == sum1) && (sum1 == sum2));
+
+    const double numLookups = double(numRuns) * numDraws;
+    Log::Info("ResourcePool: %.2f nsec/lookup on resource objects, %.2f nsec/Lookup, %.2f nsec/LookupMany\n",
+        fullDur.count() * 1e9 / numLookups, lookupDur.count() * 1e9 / numLookups, manyDur.count() * 1e9 / numLookups);
+
+    for (const Id& id : ids) {
+        resourcePool.Unassign(id);
+    }
+    resourcePool.Discard();
+}
@@ -8,6 +8,8 @@
 #include "Dbg/Dbg.h"
 #include "Input/Input.h"
 #include "Time/Clock.h"
+#include "Core/Log.h"
+#include "Core/Threading/JobSystem.h"
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtc/random.hpp"
@@ -25,13 +27,15 @@ private:
     void updateCamera();
     void emitParticles();
     void updateParticles();
+    void recordDrawList(int32 listIndex);
 
     Id drawState;
+    static const int32 NumDrawLists = 8;
+    DrawList drawLists[NumDrawLists];
     glm::mat4 view;
     glm::mat4 proj;
     glm::mat4 model;
     Shaders::Main::PerFrameParams perFrameParams;
-    Shaders::Main::PerParticleParams perParticleParams;
     bool updateEnabled = true;
     int32 frameCount = 0;
     int32 curNumParticles = 0;
@@ -49,7 +53,7 @@ OryolMain(DrawCallPerfApp);
 AppState::Code
 DrawCallPerfApp::OnRunning() {
     
-    Duration updTime, drawTime;
+    Duration updTime, recordTime, submitTime;
     this->frameCount++;
     
     // update block
@@ -61,18 +65,24 @@ DrawCallPerfApp::OnRunning() {
         updTime = Clock::Since(updStart);
     }
     
-    // render block
-    TimePoint drawStart = Clock::Now();
+    // record the particle draws into draw lists on the job system...
+    TimePoint recordStart = Clock::Now();
+    JobCounter counter;
+    for (int32 i = 0; i < NumDrawLists; i++) {
+        JobSystem::Run([this, i]() { this->recordDrawList(i); }, &counter);
+    }
+    JobSystem::Wait(&counter);
+    for (const auto& drawList : this->drawLists) {
+        Gfx::Enqueue(drawList);
+    }
+    recordTime = Clock::Since(recordStart);
+
+    // ...and execute them on the render thread
+    TimePoint submitStart = Clock::Now();
     Gfx::ApplyDefaultRenderTarget();
     Gfx::Clear(ClearTarget::All, glm::vec4(0.0f));
-    Gfx::ApplyDrawState(this->drawState);
-    Gfx::ApplyUniformBlock(this->perFrameParams);
-    for (int32 i = 0; i < this->curNumParticles; i++) {
-        this->perParticleParams.Translate = this->particles[i].pos;
-        Gfx::ApplyUniformBlock(this->perParticleParams);
-        Gfx::Draw(0);
-    }
-    drawTime = Clock::Since(drawStart);
+    Gfx::FlushDrawLists();
+    submitTime = Clock::Since(submitStart);
     
     Dbg::DrawTextBuffer();
     Gfx::CommitFrame();
@@ -84,19 +94,62 @@ DrawCallPerfApp::OnRunning() {
     }
     
     Duration frameTime = Clock::LapTime(this->lastFrameTimePoint);
+    const GfxFrameStats& stats = Gfx::FrameStats();
     Dbg::TextColor(glm::vec4(1.0f, 1.0f, 0.0f, 1.0f));
-    Dbg::PrintF("\n %d draws\n\r upd=%.3fms\n\r draw=%.3fms\n\r frame=%.3fms\n\r"
+    Dbg::PrintF("\n %d draws\n\r %d state changes\n\r %d redundant binds\n\r"
+                " upd=%.3fms\n\r record=%.3fms\n\r submit=%.3fms\n\r frame=%.3fms\n\r"
                 " LMB/tap: toggle particle update",
-                this->curNumParticles,
+                stats.NumDraws,
+                stats.NumStateChanges,
+                stats.NumRedundantBinds,
                 updTime.AsMilliSeconds(),
-                drawTime.AsMilliSeconds(),
+                recordTime.AsMilliSeconds(),
+                submitTime.AsMilliSeconds(),
                 frameTime.AsMilliSeconds());
+    #if ORYOL_NULL_GFX
+    // no display with the null backend, dump stats to the log instead
+    if (0 == (this->frameCount % 60)) {
+        Log::Info("frame %d: %d draws, %d state changes, %d redundant binds, %d uniform bytes, "
+                  "upd=%.3fms record=%.3fms submit=%.3fms frame=%.3fms\n",
+                  this->frameCount,
+                  stats.NumDraws,
+                  stats.NumStateChanges,
+                  stats.NumRedundantBinds,
+                  stats.NumUniformBytes,
+                  updTime.AsMilliSeconds(),
+                  recordTime.AsMilliSeconds(),
+                  submitTime.AsMilliSeconds(),
+                  frameTime.AsMilliSeconds());
+    }
+    #endif
     Dbg::TextColor(glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
     Dbg::PrintF("\n\n\r NOTE: this demo will bring down GL fairly quickly!\n");
     
     return Gfx::QuitRequested() ? AppState::Cleanup : AppState::Running;
 }
 
+//------------------------------------------------------------------------------
+void
+DrawCallPerfApp::recordDrawList(int32 listIndex) {
+    // each draw list renders a slice of the particles
+    const int32 sliceSize = (this->curNumParticles + NumDrawLists - 1) / NumDrawLists;
+    const int32 first = listIndex * sliceSize;
+    int32 last = first + sliceSize;
+    if (last > this->curNumParticles) {
+        last = this->curNumParticles;
+    }
+    DrawList& drawList = this->drawLists[listIndex];
+    drawList.Reset(listIndex);
+    drawList.ApplyDrawState(this->drawState);
+    drawList.ApplyUniformBlock(this->perFrameParams);
+    Shaders::Main::PerParticleParams params;
+    for (int32 i = first; i < last; i++) {
+        params.Translate = this->particles[i].pos;
+        drawList.ApplyUniformBlock(params);
+        drawList.Draw(0);
+    }
+}
+
 //------------------------------------------------------------------------------
 void
 DrawCallPerfApp::updateCamera() {
@@ -143,6 +196,7 @@ DrawCallPerfApp::OnInit() {
     Gfx::Setup(GfxSetup::Window(800, 500, "Oryol DrawCallPerf Sample"));
     Dbg::Setup();
     Input::Setup();
+    JobSystem::Setup();
 
     // create resources
     const glm::mat4 rot90 = glm::rotate(glm::mat4(), glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
@@ -173,6 +227,7 @@ DrawCallPerfApp::OnInit() {
 //------------------------------------------------------------------------------
 AppState::Code
 DrawCallPerfApp::OnCleanup() {
+    JobSystem::Discard();
     Dbg::Discard();
     Input::Discard();
     Gfx::Discard();
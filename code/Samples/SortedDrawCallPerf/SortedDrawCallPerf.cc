@@ -0,0 +1,267 @@
+//------------------------------------------------------------------------------
+//  SortedDrawCallPerf.cc
+//  Like DrawCallPerf, but the particles use several draw states in
+//  interleaved order, and the draw lists can be sorted to minimize
+//  state changes.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/App.h"
+#include "Gfx/Gfx.h"
+#include "Assets/Gfx/ShapeBuilder.h"
+#include "Dbg/Dbg.h"
+#include "Input/Input.h"
+#include "Time/Clock.h"
+#include "Core/Log.h"
+#include "Core/Threading/JobSystem.h"
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/random.hpp"
+#include "shaders.h"
+
+using namespace Oryol;
+
+class SortedDrawCallPerfApp : public App {
+public:
+    AppState::Code OnRunning();
+    AppState::Code OnInit();
+    AppState::Code OnCleanup();
+
+private:
+    void updateCamera();
+    void emitParticles();
+    void updateParticles();
+    void recordDrawList(int32 listIndex);
+
+    static const int32 NumDrawStates = 4;
+    Id drawStates[NumDrawStates];
+    static const int32 NumDrawLists = 8;
+    DrawList drawLists[NumDrawLists];
+    glm::mat4 view;
+    glm::mat4 proj;
+    glm::mat4 model;
+    glm::vec3 eyePos;
+    Shaders::Main::PerFrameParams perFrameParams;
+    bool updateEnabled = true;
+    bool sortEnabled = true;
+    int32 frameCount = 0;
+    int32 curNumParticles = 0;
+    TimePoint lastFrameTimePoint;
+    static const int32 NumParticlesEmittedPerFrame = 100;
+    static const int32 MaxNumParticles = 1024 * 1024;
+    struct {
+        glm::vec4 pos;
+        glm::vec4 vec;
+    } particles[MaxNumParticles];
+};
+OryolMain(SortedDrawCallPerfApp);
+
+//------------------------------------------------------------------------------
+AppState::Code
+SortedDrawCallPerfApp::OnRunning() {
+
+    Duration updTime, recordTime, submitTime;
+    this->frameCount++;
+
+    // update block
+    this->updateCamera();
+    if (this->updateEnabled) {
+        TimePoint updStart = Clock::Now();
+        this->emitParticles();
+        this->updateParticles();
+        updTime = Clock::Since(updStart);
+    }
+
+    // record the particle draws into draw lists on the job system...
+    TimePoint recordStart = Clock::Now();
+    JobCounter counter;
+    for (int32 i = 0; i < NumDrawLists; i++) {
+        JobSystem::Run([this, i]() { this->recordDrawList(i); }, &counter);
+    }
+    JobSystem::Wait(&counter);
+    for (const auto& drawList : this->drawLists) {
+        Gfx::Enqueue(drawList);
+    }
+    recordTime = Clock::Since(recordStart);
+
+    // ...and sort and execute them on the render thread
+    TimePoint submitStart = Clock::Now();
+    Gfx::ApplyDefaultRenderTarget();
+    Gfx::Clear(ClearTarget::All, glm::vec4(0.0f));
+    Gfx::FlushDrawLists();
+    submitTime = Clock::Since(submitStart);
+
+    Dbg::DrawTextBuffer();
+    Gfx::CommitFrame();
+
+    // toggle particle update and sorting
+    const Mouse& mouse = Input::Mouse();
+    if (mouse.Attached && mouse.ButtonDown(Mouse::Button::LMB)) {
+        this->updateEnabled = !this->updateEnabled;
+    }
+    if (mouse.Attached && mouse.ButtonDown(Mouse::Button::RMB)) {
+        this->sortEnabled = !this->sortEnabled;
+    }
+
+    Duration frameTime = Clock::LapTime(this->lastFrameTimePoint);
+    const GfxFrameStats& stats = Gfx::FrameStats();
+    Dbg::TextColor(glm::vec4(1.0f, 1.0f, 0.0f, 1.0f));
+    Dbg::PrintF("\n %d draws (sorting %s)\n\r %d state changes\n\r %d state changes avoided\n\r"
+                " %d redundant binds\n\r"
+                " upd=%.3fms\n\r record=%.3fms\n\r submit=%.3fms\n\r frame=%.3fms\n\r"
+                " LMB/tap: toggle particle update\n\r RMB: toggle sorting",
+                stats.NumDraws,
+                this->sortEnabled ? "on" : "off",
+                stats.NumStateChanges,
+                stats.NumStateChangesAvoided,
+                stats.NumRedundantBinds,
+                updTime.AsMilliSeconds(),
+                recordTime.AsMilliSeconds(),
+                submitTime.AsMilliSeconds(),
+                frameTime.AsMilliSeconds());
+    #if ORYOL_NULL_GFX
+    // no display with the null backend, dump stats to the log instead,
+    // and toggle sorting every 300 frames
+    if (0 == (this->frameCount % 60)) {
+        Log::Info("frame %d (sorting %s): %d draws, %d sorted draws, %d state changes, %d avoided, "
+                  "upd=%.3fms record=%.3fms submit=%.3fms frame=%.3fms\n",
+                  this->frameCount,
+                  this->sortEnabled ? "on" : "off",
+                  stats.NumDraws,
+                  stats.NumSortedDraws,
+                  stats.NumStateChanges,
+                  stats.NumStateChangesAvoided,
+                  updTime.AsMilliSeconds(),
+                  recordTime.AsMilliSeconds(),
+                  submitTime.AsMilliSeconds(),
+                  frameTime.AsMilliSeconds());
+    }
+    if (0 == (this->frameCount % 300)) {
+        this->sortEnabled = !this->sortEnabled;
+    }
+    #endif
+
+    return Gfx::QuitRequested() ? AppState::Cleanup : AppState::Running;
+}
+
+//------------------------------------------------------------------------------
+void
+SortedDrawCallPerfApp::recordDrawList(int32 listIndex) {
+    // each draw list renders a slice of the particles, the draw state
+    // changes with every particle, sorted lists all have the same
+    // order so that their draws are sorted together
+    const int32 sliceSize = (this->curNumParticles + NumDrawLists - 1) / NumDrawLists;
+    const int32 first = listIndex * sliceSize;
+    int32 last = first + sliceSize;
+    if (last > this->curNumParticles) {
+        last = this->curNumParticles;
+    }
+    DrawList& drawList = this->drawLists[listIndex];
+    if (this->sortEnabled) {
+        drawList.Reset(0, true);
+    }
+    else {
+        drawList.Reset(listIndex);
+    }
+    Shaders::Main::PerParticleParams params;
+    for (int32 i = first; i < last; i++) {
+        const glm::vec4& pos = this->particles[i].pos;
+        params.Translate = pos;
+        drawList.SetDepth(glm::length(glm::vec3(pos) - this->eyePos));
+        drawList.ApplyDrawState(this->drawStates[i % NumDrawStates]);
+        drawList.ApplyUniformBlock(this->perFrameParams);
+        drawList.ApplyUniformBlock(params);
+        drawList.Draw(0);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+SortedDrawCallPerfApp::updateCamera() {
+    float32 angle = this->frameCount * 0.01f;
+    this->eyePos = glm::vec3(glm::sin(angle) * 10.0f, 2.5f, glm::cos(angle) * 10.0f);
+    this->view = glm::lookAt(this->eyePos, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    this->perFrameParams.ModelViewProjection = this->proj * this->view * this->model;
+}
+
+//------------------------------------------------------------------------------
+void
+SortedDrawCallPerfApp::emitParticles() {
+    for (int32 i = 0; i < NumParticlesEmittedPerFrame; i++) {
+        if (this->curNumParticles < MaxNumParticles) {
+            this->particles[this->curNumParticles].pos = glm::vec4(0.0f, 0.0f, 0.0f, 0.0f);
+            glm::vec3 rnd = glm::ballRand(0.5f);
+            rnd.y += 2.0f;
+            this->particles[this->curNumParticles].vec = glm::vec4(rnd, 0.0f);
+            this->curNumParticles++;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+SortedDrawCallPerfApp::updateParticles() {
+    const float32 frameTime = 1.0f / 60.0f;
+    for (int32 i = 0; i < this->curNumParticles; i++) {
+        auto& curParticle = this->particles[i];
+        curParticle.vec.y -= 1.0f * frameTime;
+        curParticle.pos += curParticle.vec * frameTime;
+        if (curParticle.pos.y < -2.0f) {
+            curParticle.pos.y = -1.8f;
+            curParticle.vec.y = -curParticle.vec.y;
+            curParticle.vec *= 0.8f;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+AppState::Code
+SortedDrawCallPerfApp::OnInit() {
+    // setup rendering system
+    Gfx::Setup(GfxSetup::Window(800, 500, "Oryol SortedDrawCallPerf Sample"));
+    Dbg::Setup();
+    Input::Setup();
+    JobSystem::Setup();
+
+    // create one draw state per particle shape
+    const glm::mat4 rot90 = glm::rotate(glm::mat4(), glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+    ShapeBuilder shapeBuilder;
+    shapeBuilder.RandomColors = true;
+    shapeBuilder.Layout
+        .Add(VertexAttr::Position, VertexFormat::Float3)
+        .Add(VertexAttr::Color0, VertexFormat::Float4);
+    Id prog = Gfx::CreateResource(Shaders::Main::CreateSetup());
+    for (int32 i = 0; i < NumDrawStates; i++) {
+        shapeBuilder.Transform(rot90);
+        switch (i) {
+            case 0: shapeBuilder.Sphere(0.05f, 3, 2); break;
+            case 1: shapeBuilder.Box(0.07f, 0.07f, 0.07f, 1); break;
+            case 2: shapeBuilder.Cylinder(0.04f, 0.08f, 3, 1); break;
+            default: shapeBuilder.Torus(0.02f, 0.04f, 3, 4); break;
+        }
+        shapeBuilder.Build();
+        Id mesh = Gfx::CreateResource(shapeBuilder.Result());
+        auto dss = DrawStateSetup::FromMeshAndProg(mesh, prog);
+        dss.RasterizerState.CullFaceEnabled = true;
+        dss.DepthStencilState.DepthWriteEnabled = true;
+        dss.DepthStencilState.DepthCmpFunc = CompareFunc::LessEqual;
+        this->drawStates[i] = Gfx::CreateResource(dss);
+    }
+
+    // setup projection and view matrices
+    const float32 fbWidth = (const float32) Gfx::DisplayAttrs().FramebufferWidth;
+    const float32 fbHeight = (const float32) Gfx::DisplayAttrs().FramebufferHeight;
+    this->proj = glm::perspectiveFov(glm::radians(45.0f), fbWidth, fbHeight, 0.01f, 100.0f);
+    this->model = glm::mat4();
+
+    return App::OnInit();
+}
+
+//------------------------------------------------------------------------------
+AppState::Code
+SortedDrawCallPerfApp::OnCleanup() {
+    JobSystem::Discard();
+    Dbg::Discard();
+    Input::Discard();
+    Gfx::Discard();
+    return App::OnCleanup();
+}
@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------
+//  pakpack.cc
+//  Pack a directory tree into a pak archive for the PakFileSystem:
+//
+//      pakpack [-store] data.pak data/
+//      pakpack -list data.pak
+//
+//  Entry names are the file paths relative to the packed directory.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Log.h"
+#include "Core/String/StringBuilder.h"
+#include "LocalFS/PakWriter.h"
+#include "LocalFS/PakArchive.h"
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <sys/stat.h>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+static bool
+readFile(const String& path, Array<uint8>& outData) {
+    FILE* fp = std::fopen(path.AsCStr(), "rb");
+    if (nullptr == fp) {
+        return false;
+    }
+    outData.Clear();
+    uint8 buf[64 * 1024];
+    size_t num;
+    while ((num = std::fread(buf, 1, sizeof(buf), fp)) > 0) {
+        outData.AddRange(buf, int32(num));
+    }
+    const bool success = !std::ferror(fp);
+    std::fclose(fp);
+    return success;
+}
+
+//------------------------------------------------------------------------------
+static bool
+packDir(PakWriter& writer, const String& root, const String& relPath, PakFormat::Compression::Code compression) {
+    StringBuilder strBuilder(root);
+    if (relPath.IsValid()) {
+        strBuilder.Append("/");
+        strBuilder.Append(relPath);
+    }
+    const String dirPath = strBuilder.GetString();
+    DIR* dir = opendir(dirPath.AsCStr());
+    if (nullptr == dir) {
+        Log::Error("pakpack: can't open directory '%s'\n", dirPath.AsCStr());
+        return false;
+    }
+    bool success = true;
+    struct dirent* ent;
+    while (success && (nullptr != (ent = readdir(dir)))) {
+        if ((0 == std::strcmp(ent->d_name, ".")) || (0 == std::strcmp(ent->d_name, ".."))) {
+            continue;
+        }
+        strBuilder.Set(relPath);
+        if (relPath.IsValid()) {
+            strBuilder.Append("/");
+        }
+        strBuilder.Append(ent->d_name);
+        const String entryName = strBuilder.GetString();
+        strBuilder.Set(dirPath);
+        strBuilder.Append("/");
+        strBuilder.Append(ent->d_name);
+        const String filePath = strBuilder.GetString();
+
+        struct stat st;
+        if (0 != stat(filePath.AsCStr(), &st)) {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            success = packDir(writer, root, entryName, compression);
+        }
+        else if (S_ISREG(st.st_mode)) {
+            if (st.st_size > 0x7FFFFFFF) {
+                Log::Error("pakpack: '%s' is too big\n", filePath.AsCStr());
+                success = false;
+                continue;
+            }
+            Array<uint8> data;
+            if (!readFile(filePath, data)) {
+                Log::Error("pakpack: failed to read '%s'\n", filePath.AsCStr());
+                success = false;
+                continue;
+            }
+            const uint8* ptr = data.Empty() ? nullptr : &data[0];
+            success = writer.Add(entryName, ptr, data.Size(), compression);
+        }
+    }
+    closedir(dir);
+    return success;
+}
+
+//------------------------------------------------------------------------------
+static int
+listArchive(const String& path) {
+    Ptr<PakArchive> archive = PakArchive::Create();
+    if (IOStatus::OK != archive->Open(path)) {
+        return 10;
+    }
+    for (int32 i = 0; i < archive->NumEntries(); i++) {
+        const PakFormat::Entry& e = archive->EntryAt(i);
+        Log::Info("%10d %10d %-5s %s\n",
+            e.UncompressedSize, e.Size,
+            PakFormat::Compression::ToString(e.Codec),
+            archive->NameAt(i).AsCStr());
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, const char** argv) {
+    PakFormat::Compression::Code compression = PakFormat::Compression::LZ4;
+    int argIndex = 1;
+    if ((argc == 3) && (0 == std::strcmp(argv[1], "-list"))) {
+        return listArchive(argv[2]);
+    }
+    if ((argc > 1) && (0 == std::strcmp(argv[1], "-store"))) {
+        compression = PakFormat::Compression::None;
+        argIndex++;
+    }
+    if (argc - argIndex != 2) {
+        Log::Info("usage: pakpack [-store] archive.pak dir\n"
+                  "       pakpack -list archive.pak\n");
+        return 10;
+    }
+    String root = argv[argIndex + 1];
+    while ((root.Length() > 1) && (root.Back() == '/')) {
+        root = String(root.AsCStr(), 0, root.Length() - 1);
+    }
+
+    PakWriter writer;
+    if (!writer.Begin(argv[argIndex])) {
+        return 10;
+    }
+    const bool packed = packDir(writer, root, String(), compression);
+    const bool written = writer.End();
+    if (!(packed && written)) {
+        std::remove(argv[argIndex]);
+        return 10;
+    }
+    Log::Info("pakpack: %d entries, %lld bytes of data\n", writer.NumEntries(), (long long) writer.DataSize());
+    return 0;
+}
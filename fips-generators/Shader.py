@@ -2,7 +2,7 @@
 Code generator for shader libraries.
 '''
 
-Version = 34
+Version = 35
 
 import os
 import sys
@@ -282,6 +282,21 @@ class UniformBlock :
                 hashString += type
         return hash(hashString)
 
+#-------------------------------------------------------------------------------
+def isStd140Block(uBlock) :
+    '''
+    Return True if the uniform block can be written as std140 uniform block,
+    this needs at least one non-texture uniform, and no mat2/mat3 uniforms
+    (their std140 columns are padded to vec4, which doesn't match glm).
+    '''
+    numUniforms = 0
+    for type in uBlock.uniformsByType :
+        if type not in ['sampler2D', 'samplerCube'] :
+            if type in ['mat2', 'mat3'] and uBlock.uniformsByType[type] :
+                return False
+            numUniforms += len(uBlock.uniformsByType[type])
+    return numUniforms > 0
+
 #-------------------------------------------------------------------------------
 class Attr :
     '''
@@ -708,24 +723,27 @@ class GLSLGenerator :
     #---------------------------------------------------------------------------
     def genUniformBlocks(self, shd, slVersion, lines) :
         for uBlock in shd.uniformBlocks :
-            '''
-            if glslVersionNumber[slVersion] >= 150 :
-                # on GLSL 1.50 and above, write actual uniform blocks
+            if glslVersionNumber[slVersion] >= 150 and isStd140Block(uBlock) :
+                # on GLSL 1.50 and above, write texture samplers as plain
+                # uniforms, and the rest into a std140 uniform block which
+                # matches the uniform block struct in the generated header
+                for type in ['sampler2D', 'samplerCube'] :
+                    for uniform in uBlock.uniformsByType[type] :
+                        lines.append(Line('uniform {} {};'.format(uniform.type, uniform.name), uniform.filePath, uniform.lineNumber))
                 lines.append(Line('layout(std140) uniform {} {{'.format(uBlock.name), uBlock.filePath, uBlock.lineNumber))
                 for type in uBlock.uniformsByType :
-                    for uniform in uBlock.uniformsByType[type] :
-                        lines.append(Line('  {} {};'.format(uniform.type, uniform.name), uniform.filePath, uniform.lineNumber))
+                    if type not in ['sampler2D', 'samplerCube'] :
+                        for uniform in uBlock.uniformsByType[type] :
+                            lines.append(Line('  {} {};'.format(uniform.type, uniform.name), uniform.filePath, uniform.lineNumber))
+                            # pad vec3's to 16 bytes, otherwise std140 would
+                            # move a following float into the vec3's padding
+                            if type == 'vec3' :
+                                lines.append(Line('  float _pad_{};'.format(uniform.name)))
                 lines.append(Line('};', uBlock.filePath, uBlock.lineNumber))
             else :
-                # on old-school GLSL, pack the uniform block members into arrays by type
                 for type in uBlock.uniformsByType :
-                    name = '{}_{}'.format(uBlock.name, type)
-                    size = len(uBlock.uniformsByType[type])
-                    lines.append(Line('uniform {} {}[{}];'.format(type, name, size), uBlock.filePath, uBlock.lineNumber)) 
-            '''
-            for type in uBlock.uniformsByType :
-                for uniform in uBlock.uniformsByType[type] :
-                    lines.append(Line('uniform {} {};'.format(uniform.type, uniform.name), uniform.filePath, uniform.lineNumber))
+                    for uniform in uBlock.uniformsByType[type] :
+                        lines.append(Line('uniform {} {};'.format(uniform.type, uniform.name), uniform.filePath, uniform.lineNumber))
         return lines 
 
     #---------------------------------------------------------------------------
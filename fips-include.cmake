@@ -6,8 +6,14 @@ else()
     option(ORYOL_USE_LIBCURL "Use libcurl instead of native APIs" OFF)
 endif()
 
+option(ORYOL_USE_LIBCURL_MULTI "Run concurrent HTTP transfers over pooled connections with curl_multi" ON)
+option(ORYOL_MEMORY_STATS "Track per-tag memory statistics also in release builds" OFF)
+
 if (ORYOL_USE_LIBCURL)
     add_definitions(-DORYOL_USE_LIBCURL=1)
+    if (ORYOL_USE_LIBCURL_MULTI)
+        add_definitions(-DORYOL_USE_LIBCURL_MULTI=1)
+    endif()
 endif()
 
 # for TurboBadger UI support, override the search path for the 
@@ -92,6 +98,14 @@ if (FIPS_WINDOWS)
     endif()
 endif()
 
+# null Gfx backend (no rendering, for headless testing and profiling)
+option(ORYOL_NULL_GFX "Use the null Gfx backend (no GPU required)" OFF)
+if (ORYOL_NULL_GFX)
+    set(ORYOL_OPENGL 0)
+    set(ORYOL_D3D11 0)
+    add_definitions(-DORYOL_NULL_GFX=1)
+endif()
+
 # OpenGL defines
 if (ORYOL_OPENGL)
     add_definitions(-DORYOL_OPENGL=1)
@@ -120,6 +134,9 @@ endif()
 if (FIPS_ALLOCATOR_DEBUG)
     add_definitions(-DORYOL_ALLOCATOR_DEBUG=1)
 endif()
+if (ORYOL_MEMORY_STATS)
+    add_definitions(-DORYOL_MEMORY_STATS=1)
+endif()
 if (FIPS_UNITTESTS)
     add_definitions(-DORYOL_UNITTESTS=1)
     if (FIPS_UNITTESTS_HEADLESS)